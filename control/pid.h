@@ -8,6 +8,10 @@
  */
 
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 #ifndef PID_H
 #define PID_H
 
@@ -91,3 +95,9 @@ void PID_SetLimits(float PIDmax, float PIDmin, PID_t *Parameters);
 void PID_SetMaxError(float MaxError, PID_t *Parameters);
 
 #endif /* PID_H */
+
+
+
+#ifdef __cplusplus
+}
+#endif
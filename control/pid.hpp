@@ -0,0 +1,121 @@
+/**
+ * @file  pid.hpp
+ * @date  18-October-2026
+ * @brief PID controller templated on the value type (C++).
+ *
+ *   Header-only counterpart of pid.h built on matrix_fixed.hpp, with the
+ *   same discretization (bilinear transform) and the same MaxError hold,
+ *   zero-setpoint and saturation rules as PID_Compute.
+ *
+ * @author
+ * @author
+ */
+
+
+#ifndef PID_HPP
+#define PID_HPP
+
+
+#define PID_HPP_VER_MAJOR                                                   2026
+#define PID_HPP_VER_MINOR                                                     10
+#define PID_HPP_VER_PATCH                                                      1
+#define PID_HPP_BRANCH_MASTER
+
+
+#include <math.h>
+#include "matrix_fixed.hpp"
+
+
+namespace control {
+
+
+/**
+ * @brief PID controller, see PID_t.
+ */
+template<typename T = float>
+class PID
+{
+public:
+  T Kp;
+  T Ki;
+  T Kd;
+  T SamplingTime;
+  T PidMax;
+  T PidMin;
+  T MaxError;
+  linear_algebra::Vector<T, 3> Error;   /*!< Present and past errors */
+  linear_algebra::Vector<T, 2> Uk;      /*!< Present and past outputs */
+  linear_algebra::Vector<T, 3> Coeff;   /*!< PID coefficients */
+
+  /**
+   * @brief  See PID_Init.
+   */
+  void Init(T Kp_, T Ki_, T Kd_, T SamplingTime_)
+  {
+    Kp = Kp_;
+    Ki = Ki_;
+    Kd = Kd_;
+    SamplingTime = SamplingTime_;
+    Error = linear_algebra::Vector<T, 3>::Zero();
+    Uk = linear_algebra::Vector<T, 2>::Zero();
+    PidMax = T(0);
+    PidMin = T(0);
+    MaxError = T(0);
+    Coeff[0] = Kp + (Ki*SamplingTime) + (Kd/SamplingTime);
+    Coeff[1] = T(0.0 - Kp - 2*(Kd/SamplingTime));
+    Coeff[2] = Kd/SamplingTime;
+  }
+
+  /**
+   * @brief  See PID_SetLimits.
+   */
+  void SetLimits(T Max, T Min)
+  {
+    PidMax = (Max > Min) ? Max : Min;
+    PidMin = (Max > Min) ? Min : Max;
+  }
+
+  /**
+   * @brief  See PID_SetMaxError.
+   */
+  void SetMaxError(T Value)
+  {
+    MaxError = Value;
+  }
+
+  /**
+   * @brief  See PID_Compute.
+   */
+  T Compute(T Input, T Setpoint)
+  {
+    Error[0] = Setpoint - Input;
+
+    if(Setpoint == T(0) && Error[0] == T(0)){
+      /* Error is small, turn output off */
+      Uk[0] = T(0);
+    }else if(fabs(Error[0]) < MaxError){
+      /* Error is small, keep previous control output */
+      Uk[0] = Uk[1];
+    }else{
+      /* Same summation order as PID_Compute */
+      Uk[0] = Uk[1];
+      Uk[0] += Coeff[0]*Error[0];
+      Uk[0] += Coeff[1]*Error[1];
+      Uk[0] += Coeff[2]*Error[2];
+      if(Uk[0] < PidMin){
+        Uk[0] = PidMin;
+      }
+      if(Uk[0] > PidMax){
+        Uk[0] = PidMax;
+      }
+    }
+    Uk[1] = Uk[0];
+    Error[2] = Error[1];
+    Error[1] = Error[0];
+    return Uk[0];
+  }
+};
+
+} /* namespace control */
+
+#endif /* PID_HPP */
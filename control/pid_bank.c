@@ -0,0 +1,213 @@
+#include <math.h>
+#include "pid_bank.h"
+
+#ifdef PID_BANK_SIMD_X86
+#include <immintrin.h>
+#define SIMD_TARGET(ISA) __attribute__((target(ISA)))
+#endif
+
+
+/* The passes below round as PID_Compute (see matrix_simd.h). Saturation   */
+/*  and hold are selections, done in the same order as the branches of     */
+/*  PID_Compute.                                                           */
+
+typedef void (*PID_BankPass_t)(float *Inputs, float *Setpoints,
+    float *Outputs, uint32_t Begin, uint32_t End, PID_Bank_t *Bank);
+
+
+static void PID_BankPassScalar(float *Inputs, float *Setpoints,
+    float *Outputs, uint32_t Begin, uint32_t End, PID_Bank_t *Bank)
+{
+  uint32_t i;
+  float e0, u;
+
+  for(i = Begin; i < End; i++){
+    e0 = Setpoints[i] - Inputs[i];
+    u = Bank->Uk1[i];
+    u += Bank->Coeff0[i] * e0;
+    u += Bank->Coeff1[i] * Bank->Error1[i];
+    u += Bank->Coeff2[i] * Bank->Error2[i];
+    u = (u < Bank->PidMin[i]) ? Bank->PidMin[i] : u;
+    u = (u > Bank->PidMax[i]) ? Bank->PidMax[i] : u;
+    /* Small error, keep previous output */
+    u = (fabsf(e0) < Bank->MaxError[i]) ? Bank->Uk1[i] : u;
+    /* Zero setpoint reached, turn output off */
+    u = (Setpoints[i] == 0.0f && e0 == 0.0f) ? 0.0f : u;
+
+    Bank->Uk1[i] = u;
+    Bank->Error2[i] = Bank->Error1[i];
+    Bank->Error1[i] = e0;
+    Outputs[i] = u;
+  }
+}
+
+
+#ifdef PID_BANK_SIMD_X86
+
+/* max(a, b) returns b unless a > b and min(a, b) returns b unless a < b, */
+/*  which is exactly how the saturation branches of PID_Compute behave.    */
+
+SIMD_TARGET("sse2")
+static void PID_BankPassSse2(float *Inputs, float *Setpoints,
+    float *Outputs, uint32_t Begin, uint32_t End, PID_Bank_t *Bank)
+{
+  const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  const __m128 zero = _mm_setzero_ps();
+  __m128 sp, e0, e1, uk1, u, hold, off;
+  uint32_t i = Begin;
+
+  for(; i + 4 <= End; i += 4){
+    sp = _mm_loadu_ps(Setpoints + i);
+    e0 = _mm_sub_ps(sp, _mm_loadu_ps(Inputs + i));
+    e1 = _mm_loadu_ps(Bank->Error1 + i);
+    uk1 = _mm_loadu_ps(Bank->Uk1 + i);
+
+    u = _mm_add_ps(uk1, _mm_mul_ps(_mm_loadu_ps(Bank->Coeff0 + i), e0));
+    u = _mm_add_ps(u, _mm_mul_ps(_mm_loadu_ps(Bank->Coeff1 + i), e1));
+    u = _mm_add_ps(u, _mm_mul_ps(_mm_loadu_ps(Bank->Coeff2 + i),
+        _mm_loadu_ps(Bank->Error2 + i)));
+    u = _mm_max_ps(_mm_loadu_ps(Bank->PidMin + i), u);
+    u = _mm_min_ps(_mm_loadu_ps(Bank->PidMax + i), u);
+
+    hold = _mm_cmplt_ps(_mm_and_ps(e0, absMask),
+        _mm_loadu_ps(Bank->MaxError + i));
+    u = _mm_or_ps(_mm_and_ps(hold, uk1), _mm_andnot_ps(hold, u));
+    off = _mm_and_ps(_mm_cmpeq_ps(sp, zero), _mm_cmpeq_ps(e0, zero));
+    u = _mm_andnot_ps(off, u);
+
+    _mm_storeu_ps(Bank->Uk1 + i, u);
+    _mm_storeu_ps(Bank->Error2 + i, e1);
+    _mm_storeu_ps(Bank->Error1 + i, e0);
+    _mm_storeu_ps(Outputs + i, u);
+  }
+  PID_BankPassScalar(Inputs, Setpoints, Outputs, i, End, Bank);
+}
+
+
+SIMD_TARGET("avx2")
+static void PID_BankPassAvx2(float *Inputs, float *Setpoints,
+    float *Outputs, uint32_t Begin, uint32_t End, PID_Bank_t *Bank)
+{
+  const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+  const __m256 zero = _mm256_setzero_ps();
+  __m256 sp, e0, e1, uk1, u, hold, off;
+  uint32_t i = Begin;
+
+  for(; i + 8 <= End; i += 8){
+    sp = _mm256_loadu_ps(Setpoints + i);
+    e0 = _mm256_sub_ps(sp, _mm256_loadu_ps(Inputs + i));
+    e1 = _mm256_loadu_ps(Bank->Error1 + i);
+    uk1 = _mm256_loadu_ps(Bank->Uk1 + i);
+
+    u = _mm256_add_ps(uk1,
+        _mm256_mul_ps(_mm256_loadu_ps(Bank->Coeff0 + i), e0));
+    u = _mm256_add_ps(u, _mm256_mul_ps(_mm256_loadu_ps(Bank->Coeff1 + i), e1));
+    u = _mm256_add_ps(u, _mm256_mul_ps(_mm256_loadu_ps(Bank->Coeff2 + i),
+        _mm256_loadu_ps(Bank->Error2 + i)));
+    u = _mm256_max_ps(_mm256_loadu_ps(Bank->PidMin + i), u);
+    u = _mm256_min_ps(_mm256_loadu_ps(Bank->PidMax + i), u);
+
+    hold = _mm256_cmp_ps(_mm256_and_ps(e0, absMask),
+        _mm256_loadu_ps(Bank->MaxError + i), _CMP_LT_OQ);
+    u = _mm256_blendv_ps(u, uk1, hold);
+    off = _mm256_and_ps(_mm256_cmp_ps(sp, zero, _CMP_EQ_OQ),
+        _mm256_cmp_ps(e0, zero, _CMP_EQ_OQ));
+    u = _mm256_andnot_ps(off, u);
+
+    _mm256_storeu_ps(Bank->Uk1 + i, u);
+    _mm256_storeu_ps(Bank->Error2 + i, e1);
+    _mm256_storeu_ps(Bank->Error1 + i, e0);
+    _mm256_storeu_ps(Outputs + i, u);
+  }
+  PID_BankPassSse2(Inputs, Setpoints, Outputs, i, End, Bank);
+}
+
+
+SIMD_TARGET("avx512f") MATRIX_SIMD_NO_CONTRACT
+static void PID_BankPassAvx512(float *Inputs, float *Setpoints,
+    float *Outputs, uint32_t Begin, uint32_t End, PID_Bank_t *Bank)
+{
+  const __m512 zero = _mm512_setzero_ps();
+  __m512 sp, e0, e1, uk1, u;
+  __mmask16 hold, off;
+  uint32_t i = Begin;
+
+  for(; i + 16 <= End; i += 16){
+    sp = _mm512_loadu_ps(Setpoints + i);
+    e0 = _mm512_sub_ps(sp, _mm512_loadu_ps(Inputs + i));
+    e1 = _mm512_loadu_ps(Bank->Error1 + i);
+    uk1 = _mm512_loadu_ps(Bank->Uk1 + i);
+
+    u = _mm512_add_ps(uk1,
+        _mm512_mul_ps(_mm512_loadu_ps(Bank->Coeff0 + i), e0));
+    u = _mm512_add_ps(u, _mm512_mul_ps(_mm512_loadu_ps(Bank->Coeff1 + i), e1));
+    u = _mm512_add_ps(u, _mm512_mul_ps(_mm512_loadu_ps(Bank->Coeff2 + i),
+        _mm512_loadu_ps(Bank->Error2 + i)));
+    u = _mm512_max_ps(_mm512_loadu_ps(Bank->PidMin + i), u);
+    u = _mm512_min_ps(_mm512_loadu_ps(Bank->PidMax + i), u);
+
+    hold = _mm512_cmp_ps_mask(_mm512_abs_ps(e0),
+        _mm512_loadu_ps(Bank->MaxError + i), _CMP_LT_OQ);
+    u = _mm512_mask_blend_ps(hold, u, uk1);
+    off = _mm512_cmp_ps_mask(sp, zero, _CMP_EQ_OQ) &
+        _mm512_cmp_ps_mask(e0, zero, _CMP_EQ_OQ);
+    u = _mm512_mask_blend_ps(off, u, zero);
+
+    _mm512_storeu_ps(Bank->Uk1 + i, u);
+    _mm512_storeu_ps(Bank->Error2 + i, e1);
+    _mm512_storeu_ps(Bank->Error1 + i, e0);
+    _mm512_storeu_ps(Outputs + i, u);
+  }
+  PID_BankPassSse2(Inputs, Setpoints, Outputs, i, End, Bank);
+}
+
+#endif /* PID_BANK_SIMD_X86 */
+
+
+static const PID_BankPass_t passes[MATRIX_SIMD_NUMBER_OF_LEVELS] = {
+    [MATRIX_SIMD_SCALAR] = PID_BankPassScalar,
+#ifdef PID_BANK_SIMD_X86
+    [MATRIX_SIMD_SSE2] = PID_BankPassSse2,
+    [MATRIX_SIMD_AVX2] = PID_BankPassAvx2,
+    [MATRIX_SIMD_AVX512] = PID_BankPassAvx512,
+#endif
+};
+
+
+void PID_BankLoad(uint32_t Index, PID_t *Pid, PID_Bank_t *Bank)
+{
+  Bank->Error1[Index] = Pid->InternalUse.Error[1];
+  Bank->Error2[Index] = Pid->InternalUse.Error[2];
+  Bank->Uk1[Index] = Pid->InternalUse.Uk[1];
+  Bank->Coeff0[Index] = Pid->InternalUse.Coeff[0];
+  Bank->Coeff1[Index] = Pid->InternalUse.Coeff[1];
+  Bank->Coeff2[Index] = Pid->InternalUse.Coeff[2];
+  Bank->PidMax[Index] = Pid->PidMax;
+  Bank->PidMin[Index] = Pid->PidMin;
+  Bank->MaxError[Index] = Pid->MaxError;
+}
+
+
+void PID_BankStore(uint32_t Index, PID_t *Pid, PID_Bank_t *Bank)
+{
+  /* After a call, PID_Compute leaves present and past values equal */
+  Pid->InternalUse.Error[0] = Bank->Error1[Index];
+  Pid->InternalUse.Error[1] = Bank->Error1[Index];
+  Pid->InternalUse.Error[2] = Bank->Error2[Index];
+  Pid->InternalUse.Uk[0] = Bank->Uk1[Index];
+  Pid->InternalUse.Uk[1] = Bank->Uk1[Index];
+  Pid->InternalUse.Coeff[0] = Bank->Coeff0[Index];
+  Pid->InternalUse.Coeff[1] = Bank->Coeff1[Index];
+  Pid->InternalUse.Coeff[2] = Bank->Coeff2[Index];
+  Pid->PidMax = Bank->PidMax[Index];
+  Pid->PidMin = Bank->PidMin[Index];
+  Pid->MaxError = Bank->MaxError[Index];
+}
+
+
+void PID_BankCompute(float *Inputs, float *Setpoints, float *Outputs,
+    PID_Bank_t *Bank)
+{
+  MATRIX_SIMD_SELECT(passes)(Inputs, Setpoints, Outputs, 0, Bank->NumPid,
+      Bank);
+}
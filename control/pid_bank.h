@@ -0,0 +1,105 @@
+/**
+ * @file  pid_bank.h
+ * @date  18-October-2026
+ * @brief Bank of PID controllers computed in one vectorized pass.
+ *
+ *   The state of every controller is kept in structure-of-arrays form, so
+ *   a tick only streams the values the control law needs. Each controller
+ *   follows PID_Compute exactly (zero setpoint, MaxError hold and output
+ *   saturation), with bit-identical outputs (see matrix_simd.h).
+ *
+ *   The SSE2, AVX2 or AVX-512 pass is selected at runtime with the level
+ *   of matrix_simd.h. When it is scalar, or PID_BANK_SIMD_DISABLE is
+ *   defined, a portable branch-free loop is used.
+ *
+ * @author
+ * @author
+ */
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef PID_BANK_H
+#define PID_BANK_H
+
+
+#define PID_BANK_VER_MAJOR                                                  2026
+#define PID_BANK_VER_MINOR                                                    10
+#define PID_BANK_VER_PATCH                                                     1
+#define PID_BANK_BRANCH_MASTER
+
+
+#include <stdint.h>
+#include "pid.h"
+#include "matrix_simd.h"
+
+
+#if !defined(PID_BANK_SIMD_DISABLE) && defined(MATRIX_SIMD_X86)
+#define PID_BANK_SIMD_X86
+#endif
+
+
+/**
+ * @brief List of PID bank variables.
+ * @note  Every pointer points to a 1-D array of size NumPid, allocated by
+ *        the user.
+ */
+typedef struct
+{
+  float    *Error1;     /*!< Error of the last call */
+  float    *Error2;     /*!< Error of the call before the last one */
+  float    *Uk1;        /*!< Last controller output */
+  float    *Coeff0;     /*!< PID coefficients, as in PID_Internal_t */
+  float    *Coeff1;
+  float    *Coeff2;
+  float    *PidMax;     /*!< Maximum controller output value */
+  float    *PidMin;     /*!< Minimum controller output value */
+  float    *MaxError;   /*!< Error at which PID can stop updating */
+  uint32_t NumPid;      /*!< Number of controllers in the bank */
+}PID_Bank_t;
+
+
+/**
+ * @brief  Copies a controller into the bank.
+ * @param  Index : Position of the controller in the bank.
+ * @param  Pid : Controller configured by PID_Init, PID_SetLimits and
+ *               PID_SetMaxError (its state is copied too).
+ * @param  Bank : List of PID bank parameters.
+ * @retval void
+ */
+void PID_BankLoad(uint32_t Index, PID_t *Pid, PID_Bank_t *Bank);
+
+
+/**
+ * @brief  Copies the state of a controller of the bank back to a PID_t.
+ * @param  Index : Position of the controller in the bank.
+ * @param  Pid : Controller to be updated. Gains and sampling time are not
+ *               touched.
+ * @param  Bank : List of PID bank parameters.
+ * @retval void
+ */
+void PID_BankStore(uint32_t Index, PID_t *Pid, PID_Bank_t *Bank);
+
+
+/**
+ * @brief  Computes the output of every controller of the bank.
+ * @param  Inputs : 1-D array of size NumPid with the new measurements.
+ * @param  Setpoints : 1-D array of size NumPid with the desired values.
+ * @param  Outputs : 1-D array of size NumPid receiving the outputs.
+ * @param  Bank : List of PID bank parameters.
+ * @retval void
+ * @note   Outputs[i] is the value PID_Compute(Inputs[i], Setpoints[i], ...)
+ *         would return for the controller i.
+ */
+void PID_BankCompute(float *Inputs, float *Setpoints, float *Outputs,
+    PID_Bank_t *Bank);
+
+#endif /* PID_BANK_H */
+
+
+
+#ifdef __cplusplus
+}
+#endif
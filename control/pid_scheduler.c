@@ -0,0 +1,575 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pid_scheduler.h"
+#include "pid_bank.h"
+
+#ifdef PID_SCHEDULER_PTHREADS
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CPU_RELAX() __builtin_ia32_pause()
+#else
+#define CPU_RELAX()
+#endif
+
+/* Controllers per shard are a multiple of this count, the floats of a */
+/*  64 byte cache line: shards then start on a 64 byte boundary of      */
+/*  aligned Outputs, so no two threads write to the same cache line.    */
+#define PID_SCHEDULER_ALIGN ((uint32_t)(64 / sizeof(float)))
+
+
+/**
+ * @brief Contiguous range of controllers run by one thread.
+ */
+typedef struct
+{
+  PID_Bank_t Bank;
+  float      *Memory;   /*!< Arrays of Bank, allocated by the owner thread */
+  uint32_t   Begin;     /*!< Index of the first controller */
+  int32_t    Cpu;       /*!< Processor the thread is pinned to, or -1 */
+  int32_t    Ready;     /*!< 1 once allocated, -1 if allocation failed */
+  void       *Owner;
+#ifdef PID_SCHEDULER_PTHREADS
+  pthread_t  Thread;
+#endif
+}PID_Shard_t;
+
+/**
+ * @brief Scheduler state hidden behind PID_Scheduler_t.Internal.
+ */
+typedef struct
+{
+  PID_Shard_t *Shards;
+  uint32_t    NumShards;
+  uint32_t    ShardSize;
+  float       *Inputs;       /*!< Arrays of the tick being run */
+  float       *Setpoints;
+  float       *Outputs;
+  double      NextWake;      /*!< Start of the next period, 0 before */
+  uint64_t    Ticks;
+  uint64_t    DeadlineMisses;
+  uint64_t    Overruns;
+  float       Max;
+  float       History[PID_SCHEDULER_HISTORY];
+  float       Sorted[PID_SCHEDULER_HISTORY];
+#ifdef PID_SCHEDULER_PTHREADS
+  pthread_mutex_t Lock;
+  pthread_cond_t  Start;     /*!< Signaled when a tick is published */
+  pthread_cond_t  Done;      /*!< Signaled when the last worker is done */
+  unsigned long   Generation; /*!< Number of ticks published */
+  int32_t         Remaining;  /*!< Workers not done with the tick */
+  int32_t         Stop;
+  int32_t         RestoreAffinity;
+#ifdef __linux__
+  cpu_set_t       CallerAffinity;
+#endif
+#endif
+}PID_SchedulerInternal_t;
+
+
+static double PID_SchedulerNow(void)
+{
+#ifdef PID_SCHEDULER_PTHREADS
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+#else
+  return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+
+/**
+ * @brief  Allocates and zeroes the arrays of a shard, from the thread that
+ *         will run it.
+ */
+static int32_t PID_SchedulerAllocShard(PID_Shard_t *Shard)
+{
+  uint32_t n = Shard->Bank.NumPid;
+
+  if(n == 0){
+    return 1;
+  }
+  Shard->Memory = malloc(sizeof(float) * 9 * n);
+  if(Shard->Memory == NULL){
+    return -1;
+  }
+  /* Writing the pages places them on this thread's NUMA node */
+  memset(Shard->Memory, 0, sizeof(float) * 9 * n);
+  Shard->Bank.Error1 = Shard->Memory;
+  Shard->Bank.Error2 = Shard->Memory + n;
+  Shard->Bank.Uk1 = Shard->Memory + 2*n;
+  Shard->Bank.Coeff0 = Shard->Memory + 3*n;
+  Shard->Bank.Coeff1 = Shard->Memory + 4*n;
+  Shard->Bank.Coeff2 = Shard->Memory + 5*n;
+  Shard->Bank.PidMax = Shard->Memory + 6*n;
+  Shard->Bank.PidMin = Shard->Memory + 7*n;
+  Shard->Bank.MaxError = Shard->Memory + 8*n;
+  return 1;
+}
+
+
+static void PID_SchedulerRunShard(PID_SchedulerInternal_t *Sched,
+    PID_Shard_t *Shard)
+{
+  uint32_t b = Shard->Begin;
+  PID_BankCompute(Sched->Inputs + b, Sched->Setpoints + b,
+      Sched->Outputs + b, &Shard->Bank);
+}
+
+
+#ifdef PID_SCHEDULER_PTHREADS
+
+/**
+ * @brief  Gives shard k the k-th CPU of Allowed from FirstCpu on, wrapping
+ *         around, so offline or excluded CPUs are skipped.
+ */
+static void PID_SchedulerAssignCpus(PID_SchedulerInternal_t *Sched,
+    int32_t FirstCpu, long Online, const void *Allowed)
+{
+  uint32_t k;
+#ifdef __linux__
+  const cpu_set_t *set = Allowed;
+  int32_t cpu = FirstCpu % CPU_SETSIZE;
+
+  if(set != NULL && CPU_COUNT(set) > 0){
+    for(k = 0; k < Sched->NumShards; k++){
+      while(!CPU_ISSET(cpu, set)){
+        cpu = (cpu + 1) % CPU_SETSIZE;
+      }
+      Sched->Shards[k].Cpu = cpu;
+      cpu = (cpu + 1) % CPU_SETSIZE;
+    }
+    return;
+  }
+#else
+  (void)Allowed;
+#endif
+  for(k = 0; k < Sched->NumShards; k++){
+    Sched->Shards[k].Cpu = (int32_t)((FirstCpu + k) % Online);
+  }
+}
+
+
+static void PID_SchedulerPin(int32_t Cpu)
+{
+#ifdef __linux__
+  cpu_set_t set;
+  if(Cpu < 0){
+    return;
+  }
+  CPU_ZERO(&set);
+  CPU_SET(Cpu, &set);
+  /* A CPU outside the allowed set only loses the pinning */
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  (void)Cpu;
+#endif
+}
+
+
+static void *PID_SchedulerWorker(void *Arg)
+{
+  PID_Shard_t *shard = (PID_Shard_t *)Arg;
+  PID_SchedulerInternal_t *sched = (PID_SchedulerInternal_t *)shard->Owner;
+  unsigned long seen = 0;
+  int32_t ready, spin;
+
+  PID_SchedulerPin(shard->Cpu);
+  ready = PID_SchedulerAllocShard(shard);
+
+  pthread_mutex_lock(&sched->Lock);
+  shard->Ready = ready;
+  sched->Remaining--;
+  pthread_cond_signal(&sched->Done);
+  pthread_mutex_unlock(&sched->Lock);
+  if(ready < 0){
+    return NULL;
+  }
+
+  for(;;){
+    /* Spin first, ticks usually follow each other closely */
+    for(spin = 0; spin < PID_SCHEDULER_SPIN; spin++){
+      if(__atomic_load_n(&sched->Generation, __ATOMIC_ACQUIRE) != seen ||
+          __atomic_load_n(&sched->Stop, __ATOMIC_ACQUIRE) != 0){
+        break;
+      }
+      CPU_RELAX();
+    }
+    if(spin == PID_SCHEDULER_SPIN){
+      pthread_mutex_lock(&sched->Lock);
+      while(sched->Generation == seen && sched->Stop == 0){
+        pthread_cond_wait(&sched->Start, &sched->Lock);
+      }
+      pthread_mutex_unlock(&sched->Lock);
+    }
+    if(__atomic_load_n(&sched->Stop, __ATOMIC_ACQUIRE) != 0){
+      break;
+    }
+    seen = __atomic_load_n(&sched->Generation, __ATOMIC_ACQUIRE);
+
+    PID_SchedulerRunShard(sched, shard);
+
+    if(__atomic_sub_fetch(&sched->Remaining, 1, __ATOMIC_ACQ_REL) == 0){
+      pthread_mutex_lock(&sched->Lock);
+      pthread_cond_signal(&sched->Done);
+      pthread_mutex_unlock(&sched->Lock);
+    }
+  }
+  return NULL;
+}
+
+
+/**
+ * @brief  Stops and joins the workers that were started.
+ */
+static void PID_SchedulerStopWorkers(PID_SchedulerInternal_t *Sched,
+    uint32_t NumStarted)
+{
+  uint32_t k;
+
+  pthread_mutex_lock(&Sched->Lock);
+  __atomic_store_n(&Sched->Stop, 1, __ATOMIC_RELEASE);
+  pthread_cond_broadcast(&Sched->Start);
+  pthread_mutex_unlock(&Sched->Lock);
+  for(k = 1; k < NumStarted; k++){
+    pthread_join(Sched->Shards[k].Thread, NULL);
+  }
+}
+
+#endif /* PID_SCHEDULER_PTHREADS */
+
+
+static void PID_SchedulerFree(PID_SchedulerInternal_t *Sched)
+{
+  uint32_t k;
+
+  for(k = 0; k < Sched->NumShards; k++){
+    free(Sched->Shards[k].Memory);
+  }
+#ifdef PID_SCHEDULER_PTHREADS
+#ifdef __linux__
+  if(Sched->RestoreAffinity != 0){
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+        &Sched->CallerAffinity);
+  }
+#endif
+  pthread_mutex_destroy(&Sched->Lock);
+  pthread_cond_destroy(&Sched->Start);
+  pthread_cond_destroy(&Sched->Done);
+#endif
+  free(Sched->Shards);
+  free(Sched);
+}
+
+
+int32_t PID_SchedulerInit(PID_Scheduler_t *Scheduler)
+{
+  PID_SchedulerInternal_t *sched;
+  uint32_t numThreads, k;
+  int32_t ok = 1;
+#ifdef PID_SCHEDULER_PTHREADS
+  long online = sysconf(_SC_NPROCESSORS_ONLN);
+  const void *allowed = NULL;
+  uint32_t started;
+#ifdef __linux__
+  cpu_set_t callerAffinity;
+
+  /* The CPUs this thread may run on, which need not be 0 to online - 1 */
+  if(pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t),
+      &callerAffinity) == 0 && CPU_COUNT(&callerAffinity) > 0){
+    allowed = &callerAffinity;
+    online = CPU_COUNT(&callerAffinity);
+  }
+#endif
+
+  if(online < 1){
+    online = 1;
+  }
+  numThreads = Scheduler->NumThreads;
+  if(numThreads == 0){
+    numThreads = (uint32_t)online;
+  }
+  if(numThreads > PID_SCHEDULER_MAX_THREADS){
+    numThreads = PID_SCHEDULER_MAX_THREADS;
+  }
+#else
+  numThreads = 1;
+#endif
+
+  Scheduler->Internal = NULL;
+  if(Scheduler->NumPid == 0){
+    return 0;
+  }
+  sched = calloc(1, sizeof(PID_SchedulerInternal_t));
+  if(sched == NULL){
+    return 0;
+  }
+
+  /* Equal shards, rounded to whole cache lines; tiny banks use fewer */
+  sched->ShardSize = (Scheduler->NumPid + numThreads - 1) / numThreads;
+  sched->ShardSize = (sched->ShardSize + PID_SCHEDULER_ALIGN - 1) /
+      PID_SCHEDULER_ALIGN * PID_SCHEDULER_ALIGN;
+  sched->NumShards = (Scheduler->NumPid + sched->ShardSize - 1) /
+      sched->ShardSize;
+  sched->Shards = calloc(sched->NumShards, sizeof(PID_Shard_t));
+  if(sched->Shards == NULL){
+    free(sched);
+    return 0;
+  }
+  for(k = 0; k < sched->NumShards; k++){
+    sched->Shards[k].Begin = k * sched->ShardSize;
+    sched->Shards[k].Bank.NumPid =
+        (Scheduler->NumPid - sched->Shards[k].Begin < sched->ShardSize) ?
+        Scheduler->NumPid - sched->Shards[k].Begin : sched->ShardSize;
+    sched->Shards[k].Owner = sched;
+    sched->Shards[k].Cpu = -1;
+  }
+
+#ifdef PID_SCHEDULER_PTHREADS
+  pthread_mutex_init(&sched->Lock, NULL);
+  pthread_cond_init(&sched->Start, NULL);
+  pthread_cond_init(&sched->Done, NULL);
+
+  if(Scheduler->FirstCpu >= 0){
+    PID_SchedulerAssignCpus(sched, Scheduler->FirstCpu, online, allowed);
+#ifdef __linux__
+    if(allowed != NULL){
+      sched->CallerAffinity = callerAffinity;
+      sched->RestoreAffinity = 1;
+    }
+#endif
+    PID_SchedulerPin(sched->Shards[0].Cpu);
+  }
+
+  /* Each worker allocates its own shard, then reports */
+  sched->Remaining = (int32_t)sched->NumShards - 1;
+  for(started = 1; started < sched->NumShards; started++){
+    if(pthread_create(&sched->Shards[started].Thread, NULL,
+        PID_SchedulerWorker, &sched->Shards[started]) != 0){
+      break;
+    }
+  }
+  sched->Shards[0].Ready = PID_SchedulerAllocShard(&sched->Shards[0]);
+
+  pthread_mutex_lock(&sched->Lock);
+  sched->Remaining -= (int32_t)(sched->NumShards - started);
+  while(sched->Remaining > 0){
+    pthread_cond_wait(&sched->Done, &sched->Lock);
+  }
+  pthread_mutex_unlock(&sched->Lock);
+
+  for(k = 0; k < started; k++){
+    if(sched->Shards[k].Ready != 1){
+      ok = 0;
+    }
+  }
+  if(ok == 0 || started != sched->NumShards){
+    PID_SchedulerStopWorkers(sched, started);
+    PID_SchedulerFree(sched);
+    return 0;
+  }
+#else
+  if(PID_SchedulerAllocShard(&sched->Shards[0]) != 1){
+    PID_SchedulerFree(sched);
+    return 0;
+  }
+#endif
+
+  Scheduler->NumThreads = sched->NumShards;
+  Scheduler->Internal = sched;
+  return ok;
+}
+
+
+void PID_SchedulerDeInit(PID_Scheduler_t *Scheduler)
+{
+  PID_SchedulerInternal_t *sched =
+      (PID_SchedulerInternal_t *)Scheduler->Internal;
+
+  if(sched == NULL){
+    return;
+  }
+#ifdef PID_SCHEDULER_PTHREADS
+  PID_SchedulerStopWorkers(sched, sched->NumShards);
+#endif
+  PID_SchedulerFree(sched);
+  Scheduler->Internal = NULL;
+}
+
+
+void PID_SchedulerLoad(uint32_t Index, PID_t *Pid,
+    PID_Scheduler_t *Scheduler)
+{
+  PID_SchedulerInternal_t *sched =
+      (PID_SchedulerInternal_t *)Scheduler->Internal;
+  PID_Shard_t *shard = &sched->Shards[Index / sched->ShardSize];
+
+  PID_BankLoad(Index - shard->Begin, Pid, &shard->Bank);
+}
+
+
+void PID_SchedulerStore(uint32_t Index, PID_t *Pid,
+    PID_Scheduler_t *Scheduler)
+{
+  PID_SchedulerInternal_t *sched =
+      (PID_SchedulerInternal_t *)Scheduler->Internal;
+  PID_Shard_t *shard = &sched->Shards[Index / sched->ShardSize];
+
+  PID_BankStore(Index - shard->Begin, Pid, &shard->Bank);
+}
+
+
+int32_t PID_SchedulerTick(float *Inputs, float *Setpoints, float *Outputs,
+    PID_Scheduler_t *Scheduler)
+{
+  PID_SchedulerInternal_t *sched =
+      (PID_SchedulerInternal_t *)Scheduler->Internal;
+  float deadline = (Scheduler->Deadline > 0.0f) ?
+      Scheduler->Deadline : Scheduler->Period;
+  float latency;
+  double t0;
+#ifdef PID_SCHEDULER_PTHREADS
+  int32_t spin;
+#endif
+
+  t0 = PID_SchedulerNow();
+  sched->Inputs = Inputs;
+  sched->Setpoints = Setpoints;
+  sched->Outputs = Outputs;
+
+#ifdef PID_SCHEDULER_PTHREADS
+  if(sched->NumShards > 1){
+    /* Publish the tick; the mutex only matters to sleeping workers */
+    __atomic_store_n(&sched->Remaining, (int32_t)sched->NumShards - 1,
+        __ATOMIC_RELAXED);
+    pthread_mutex_lock(&sched->Lock);
+    __atomic_store_n(&sched->Generation, sched->Generation + 1,
+        __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&sched->Start);
+    pthread_mutex_unlock(&sched->Lock);
+  }
+#endif
+
+  PID_SchedulerRunShard(sched, &sched->Shards[0]);
+
+#ifdef PID_SCHEDULER_PTHREADS
+  /* Barrier: wait for the other shards */
+  for(spin = 0; spin < PID_SCHEDULER_SPIN; spin++){
+    if(__atomic_load_n(&sched->Remaining, __ATOMIC_ACQUIRE) <= 0){
+      break;
+    }
+    CPU_RELAX();
+  }
+  if(spin == PID_SCHEDULER_SPIN){
+    pthread_mutex_lock(&sched->Lock);
+    while(__atomic_load_n(&sched->Remaining, __ATOMIC_ACQUIRE) > 0){
+      pthread_cond_wait(&sched->Done, &sched->Lock);
+    }
+    pthread_mutex_unlock(&sched->Lock);
+  }
+#endif
+
+  latency = (float)(PID_SchedulerNow() - t0);
+  sched->History[sched->Ticks % PID_SCHEDULER_HISTORY] = latency;
+  sched->Ticks++;
+  if(latency > sched->Max){
+    sched->Max = latency;
+  }
+  if(deadline > 0.0f && latency > deadline){
+    sched->DeadlineMisses++;
+    return 0;
+  }
+  return 1;
+}
+
+
+int32_t PID_SchedulerWait(PID_Scheduler_t *Scheduler)
+{
+  PID_SchedulerInternal_t *sched =
+      (PID_SchedulerInternal_t *)Scheduler->Internal;
+  double now = PID_SchedulerNow();
+#ifdef PID_SCHEDULER_PTHREADS
+  struct timespec ts;
+  double remaining;
+#endif
+
+  if(sched->NextWake == 0.0){
+    sched->NextWake = now;
+  }
+  sched->NextWake += Scheduler->Period;
+  if(sched->NextWake <= now){
+    /* Period missed, restart the schedule from now */
+    sched->Overruns++;
+    sched->NextWake = now;
+    return 0;
+  }
+
+#ifdef PID_SCHEDULER_PTHREADS
+  remaining = sched->NextWake - now;
+  ts.tv_sec = (time_t)remaining;
+  ts.tv_nsec = (long)((remaining - (double)ts.tv_sec) * 1e9);
+  nanosleep(&ts, NULL);
+#endif
+  /* Sleeps may return early, finish on the clock */
+  while(PID_SchedulerNow() < sched->NextWake){
+  }
+  return 1;
+}
+
+
+static int PID_SchedulerCompare(const void *A, const void *B)
+{
+  float a = *(const float *)A;
+  float b = *(const float *)B;
+  return (a > b) - (a < b);
+}
+
+
+void PID_SchedulerGetStats(PID_SchedulerStats_t *Stats,
+    PID_Scheduler_t *Scheduler)
+{
+  PID_SchedulerInternal_t *sched =
+      (PID_SchedulerInternal_t *)Scheduler->Internal;
+  uint32_t count = (sched->Ticks < PID_SCHEDULER_HISTORY) ?
+      (uint32_t)sched->Ticks : PID_SCHEDULER_HISTORY;
+
+  Stats->Ticks = sched->Ticks;
+  Stats->DeadlineMisses = sched->DeadlineMisses;
+  Stats->Overruns = sched->Overruns;
+  Stats->Max = sched->Max;
+  if(count == 0){
+    Stats->Percentile50 = 0.0f;
+    Stats->Percentile90 = 0.0f;
+    Stats->Percentile99 = 0.0f;
+    Stats->Percentile999 = 0.0f;
+    return;
+  }
+
+  memcpy(sched->Sorted, sched->History, sizeof(float) * count);
+  qsort(sched->Sorted, count, sizeof(float), PID_SchedulerCompare);
+  Stats->Percentile50 = sched->Sorted[(uint32_t)(0.5 * (count - 1) + 0.5)];
+  Stats->Percentile90 = sched->Sorted[(uint32_t)(0.9 * (count - 1) + 0.5)];
+  Stats->Percentile99 = sched->Sorted[(uint32_t)(0.99 * (count - 1) + 0.5)];
+  Stats->Percentile999 =
+      sched->Sorted[(uint32_t)(0.999 * (count - 1) + 0.5)];
+}
+
+
+void PID_SchedulerResetStats(PID_Scheduler_t *Scheduler)
+{
+  PID_SchedulerInternal_t *sched =
+      (PID_SchedulerInternal_t *)Scheduler->Internal;
+
+  sched->Ticks = 0;
+  sched->DeadlineMisses = 0;
+  sched->Overruns = 0;
+  sched->Max = 0.0f;
+}
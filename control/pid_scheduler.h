@@ -0,0 +1,193 @@
+/**
+ * @file  pid_scheduler.h
+ * @date  18-October-2026
+ * @brief Fixed-rate tick scheduler running big PID banks on several cores.
+ *
+ *   The controllers are split in contiguous shards, one per thread. Each
+ *   thread is pinned to its own processor (Linux) and allocates and fills
+ *   the memory of its shard itself, so the pages end up on the NUMA node
+ *   of the processor that uses them (first touch). A tick publishes the
+ *   inputs, every thread runs PID_BankCompute over its shard and the tick
+ *   returns when all shards are done.
+ *
+ *   Results are bit-identical to calling PID_Compute for every controller
+ *   (see pid_bank.h). Without POSIX threads, or when
+ *   PID_SCHEDULER_DISABLE_THREADS is defined, ticks run on the caller's
+ *   thread only.
+ *
+ * @author
+ * @author
+ */
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef PID_SCHEDULER_H
+#define PID_SCHEDULER_H
+
+
+#define PID_SCHEDULER_VER_MAJOR                                             2026
+#define PID_SCHEDULER_VER_MINOR                                               10
+#define PID_SCHEDULER_VER_PATCH                                                1
+#define PID_SCHEDULER_BRANCH_MASTER
+
+
+#include <stdint.h>
+#include "pid.h"
+
+
+#if !defined(PID_SCHEDULER_DISABLE_THREADS) && \
+    (defined(__unix__) || defined(__APPLE__))
+#define PID_SCHEDULER_PTHREADS
+#endif
+
+/**
+ * @brief Maximum number of threads, caller included.
+ */
+#ifndef PID_SCHEDULER_MAX_THREADS
+#define PID_SCHEDULER_MAX_THREADS                                            256
+#endif
+
+/**
+ * @brief Number of most recent ticks the latency percentiles are taken from.
+ */
+#ifndef PID_SCHEDULER_HISTORY
+#define PID_SCHEDULER_HISTORY                                               4096
+#endif
+
+/**
+ * @brief Polls done by an idle thread before it sleeps on a condition.
+ */
+#ifndef PID_SCHEDULER_SPIN
+#define PID_SCHEDULER_SPIN                                                 20000
+#endif
+
+
+/**
+ * @brief Latency figures of the ticks, in seconds.
+ */
+typedef struct
+{
+  uint64_t Ticks;            /*!< Ticks run since the last reset */
+  uint64_t DeadlineMisses;   /*!< Ticks that took longer than Deadline */
+  uint64_t Overruns;         /*!< Periods missed by PID_SchedulerWait */
+  float    Percentile50;     /*!< Median tick latency */
+  float    Percentile90;
+  float    Percentile99;
+  float    Percentile999;
+  float    Max;              /*!< Worst tick latency since the last reset */
+}PID_SchedulerStats_t;
+
+/**
+ * @brief List of PID scheduler variables.
+ */
+typedef struct
+{
+  uint32_t NumPid;      /*!< Number of controllers */
+  uint32_t NumThreads;  /*!< Threads, caller included, 0 for one per CPU
+                             the caller may run on */
+  int32_t  FirstCpu;    /*!< CPU of the caller's thread; thread k is pinned
+                             to the k-th CPU of the caller's affinity mask
+                             from FirstCpu on, wrapping around. Negative
+                             disables pinning */
+  float    Period;      /*!< Time between ticks, used by PID_SchedulerWait */
+  float    Deadline;    /*!< Maximum tick latency, 0 to use Period */
+  void     *Internal;   /*!< Managed by the scheduler, do not change */
+}PID_Scheduler_t;
+
+
+/**
+ * @brief  Allocates the shards and starts the threads.
+ * @param  Scheduler : List of PID scheduler parameters, NumPid to Deadline
+ *                     filled in by the user.
+ * @retval int32_t
+ * @note   NumThreads is replaced by the number of threads actually used.
+ *         All controllers start zeroed (no output, no limits), load them
+ *         with PID_SchedulerLoad.
+ *         The function returns 1 on success, 0 on failure (memory or
+ *         threads could not be allocated).
+ */
+int32_t PID_SchedulerInit(PID_Scheduler_t *Scheduler);
+
+
+/**
+ * @brief  Stops the threads and frees the memory.
+ * @param  Scheduler : List of PID scheduler parameters.
+ * @retval void
+ */
+void PID_SchedulerDeInit(PID_Scheduler_t *Scheduler);
+
+
+/**
+ * @brief  Copies a controller into the scheduler.
+ * @param  Index : Position of the controller, from 0 to NumPid - 1.
+ * @param  Pid : Controller to be copied.
+ * @param  Scheduler : List of PID scheduler parameters.
+ * @retval void
+ */
+void PID_SchedulerLoad(uint32_t Index, PID_t *Pid,
+    PID_Scheduler_t *Scheduler);
+
+
+/**
+ * @brief  Copies the state of a controller back to a PID_t.
+ * @param  Index : Position of the controller, from 0 to NumPid - 1.
+ * @param  Pid : Controller to be updated.
+ * @param  Scheduler : List of PID scheduler parameters.
+ * @retval void
+ */
+void PID_SchedulerStore(uint32_t Index, PID_t *Pid,
+    PID_Scheduler_t *Scheduler);
+
+
+/**
+ * @brief  Computes the output of every controller.
+ * @param  Inputs : 1-D array of size NumPid with the new measurements.
+ * @param  Setpoints : 1-D array of size NumPid with the desired values.
+ * @param  Outputs : 1-D array of size NumPid receiving the outputs.
+ * @param  Scheduler : List of PID scheduler parameters.
+ * @retval int32_t
+ * @note   The function returns 1 if the tick met its deadline, 0 if not.
+ */
+int32_t PID_SchedulerTick(float *Inputs, float *Setpoints, float *Outputs,
+    PID_Scheduler_t *Scheduler);
+
+
+/**
+ * @brief  Sleeps until the start of the next period.
+ * @param  Scheduler : List of PID scheduler parameters.
+ * @retval int32_t
+ * @note   Periods are counted from the first call, on absolute times, so
+ *         the rate does not drift. When a period was missed the next one
+ *         starts now.
+ *         The function returns 1 if it waited, 0 if the period was missed.
+ */
+int32_t PID_SchedulerWait(PID_Scheduler_t *Scheduler);
+
+
+/**
+ * @brief  Returns the latency figures of the ticks.
+ * @param  Stats : Receives the figures.
+ * @param  Scheduler : List of PID scheduler parameters.
+ * @retval void
+ */
+void PID_SchedulerGetStats(PID_SchedulerStats_t *Stats,
+    PID_Scheduler_t *Scheduler);
+
+
+/**
+ * @brief  Clears the latency figures.
+ * @param  Scheduler : List of PID scheduler parameters.
+ * @retval void
+ */
+void PID_SchedulerResetStats(PID_Scheduler_t *Scheduler);
+
+#endif /* PID_SCHEDULER_H */
+
+
+
+#ifdef __cplusplus
+}
+#endif
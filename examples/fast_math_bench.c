@@ -0,0 +1,142 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+
+#include "fast_math.h"
+#include "matrix_simd.h"
+
+
+/**
+ * Measures the largest relative error of FastInvSqrtArray and FastSqrtArray
+ * for each accuracy tier, and their time per element against sqrtf and
+ * 1 / sqrtf, on every instruction set level of the processor. Then
+ * normalizes a log of 3-axis samples with NormalizeRowsL2 and with a
+ * sqrtf and divide per sample. Small logs are processed several times, so
+ * the times are those of data in cache.
+ *
+ * Usage: fast_math_bench [samples]
+ */
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+float frand(float min, float max)
+{
+  return min + (max - min) * ((float)rand() / RAND_MAX);
+}
+
+
+int main(int argc, char **argv) {
+  uint32_t n = (argc > 1) ? (uint32_t)atol(argv[1]) : 8192;
+  uint32_t reps = (n < (1u << 24)) ? (1u << 24) / n : 1;
+  float *x = malloc(sizeof(float) * n);
+  float *y = malloc(sizeof(float) * n);
+  float *axes = malloc(sizeof(float) * 3 * n);
+  float *work = malloc(sizeof(float) * 3 * n);
+  const char *names[] = {"scalar", "SSE2", "AVX2", "AVX-512"};
+  double t0, tRef, t, errInv, errSqrt, e;
+  int level, tier;
+
+  /* Six decades of magnitudes */
+  srand(1);
+  for(uint32_t i = 0; i < n; i++){
+    x[i] = powf(10.0f, frand(-3.0f, 3.0f));
+  }
+  for(uint32_t i = 0; i < 3 * n; i++){
+    axes[i] = frand(-20.0f, 20.0f);
+  }
+
+  t0 = now_seconds();
+  for(uint32_t r = 0; r < reps; r++){
+    for(uint32_t i = 0; i < n; i++){
+      y[i] = 1.0f / sqrtf(x[i]);
+    }
+  }
+  tRef = now_seconds() - t0;
+  printf("%u values, 1 / sqrtf: %.2f ns per element\n\n", n,
+      1e9 * tRef / ((double)n * reps));
+  printf("%-8s %-6s %12s %12s %12s\n", "level", "tier", "ns / elem",
+      "inv error", "sqrt error");
+  for(level = 0; level < MATRIX_SIMD_NUMBER_OF_LEVELS; level++){
+    if(!MatrixSimd_SetLevel((MatrixSimd_Level_t)level)){
+      continue;
+    }
+    for(tier = FAST_MATH_APPROX; tier <= FAST_MATH_NEWTON2; tier++){
+      t0 = now_seconds();
+      for(uint32_t r = 0; r < reps; r++){
+        FastInvSqrtArray(x, n, (FastMath_Accuracy_t)tier, y);
+      }
+      t = (now_seconds() - t0) / reps;
+      errInv = 0.0;
+      for(uint32_t i = 0; i < n; i++){
+        e = fabs(y[i] * sqrt((double)x[i]) - 1.0);
+        errInv = (e > errInv) ? e : errInv;
+      }
+      FastSqrtArray(x, n, (FastMath_Accuracy_t)tier, y);
+      errSqrt = 0.0;
+      for(uint32_t i = 0; i < n; i++){
+        e = fabs(y[i] / sqrt((double)x[i]) - 1.0);
+        errSqrt = (e > errSqrt) ? e : errSqrt;
+      }
+      printf("%-8s %-6d %12.2f %12.2e %12.2e\n", names[level], tier,
+          1e9 * t / n, errInv, errSqrt);
+    }
+  }
+
+  /* 3-axis samples */
+  /* Already normalized rows are normalized again by the next repetitions */
+  memcpy(work, axes, sizeof(float) * 3 * n);
+  t0 = now_seconds();
+  for(uint32_t r = 0; r < reps; r++){
+    for(uint32_t i = 0; i < n; i++){
+      float *v = work + 3 * i;
+      float norm = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+      v[0] /= norm;
+      v[1] /= norm;
+      v[2] /= norm;
+    }
+  }
+  tRef = (now_seconds() - t0) / reps;
+  printf("\n%u 3-axis samples\n", n);
+  printf("%-8s %-6s %12s %12s\n", "level", "tier", "ns / sample",
+      "max error");
+  printf("%-15s %12.2f\n", "sqrtf, divide", 1e9 * tRef / n);
+  for(level = 0; level < MATRIX_SIMD_NUMBER_OF_LEVELS; level++){
+    if(!MatrixSimd_SetLevel((MatrixSimd_Level_t)level)){
+      continue;
+    }
+    for(tier = FAST_MATH_APPROX; tier <= FAST_MATH_NEWTON2; tier++){
+      memcpy(work, axes, sizeof(float) * 3 * n);
+      NormalizeRowsL2(work, n, 3, (FastMath_Accuracy_t)tier);
+      e = 0.0;
+      for(uint32_t i = 0; i < 3 * n; i++){
+        const float *v = axes + 3 * (i / 3);
+        double ref = v[i % 3] / sqrt((double)v[0] * v[0] +
+            (double)v[1] * v[1] + (double)v[2] * v[2]);
+        e = (fabs(work[i] - ref) > e) ? fabs(work[i] - ref) : e;
+      }
+      t0 = now_seconds();
+      for(uint32_t r = 1; r < reps; r++){
+        NormalizeRowsL2(work, n, 3, (FastMath_Accuracy_t)tier);
+      }
+      t = (now_seconds() - t0) / (reps > 1 ? reps - 1 : 1);
+      printf("%-8s %-6d %12.2f %12.2e\n", names[level], tier, 1e9 * t / n,
+          e);
+    }
+  }
+
+  free(x); free(y); free(axes); free(work);
+  return EXIT_SUCCESS;
+}
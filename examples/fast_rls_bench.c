@@ -0,0 +1,155 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+
+#include "least_squares.h"
+#include "fast_rls.h"
+
+
+/**
+ * Identifies a long FIR impulse response with RLS_Compute (regressor
+ * shifted by the caller, N x N covariance) and with FRLS_Compute (delay
+ * line managed by the filter, O(N) per sample). Prints the time per
+ * sample and the largest coefficient error of both. Then identifies the
+ * ARX system of rls2.c and runs the fast RLS with forgetting for a long
+ * time, reporting the rescues.
+ *
+ * Usage: fast_rls_bench [taps] [samples]
+ */
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+float frand(float min, float max)
+{
+  return min + (max - min) * ((float)rand() / RAND_MAX);
+}
+
+
+double max_error(float *A, float *B, uint32_t n)
+{
+  double err = 0.0;
+  for(uint32_t k = 0; k < n; k++){
+    double e = fabs(A[k] - B[k]);
+    err = (e > err) ? e : err;
+  }
+  return err;
+}
+
+
+int main(int argc, char **argv) {
+  uint32_t n = (argc > 1) ? (uint32_t)atol(argv[1]) : 256;
+  uint32_t samples = (argc > 2) ? (uint32_t)atol(argv[2]) : 4000;
+  float *h = malloc(sizeof(float) * n);
+  float *u = malloc(sizeof(float) * samples);
+  float *y = malloc(sizeof(float) * samples);
+  float *line = calloc(n, sizeof(float));
+  float *rlsCoeffs = calloc(n, sizeof(float));
+  float *rlsCov = calloc((size_t)n * n, sizeof(float));
+  float *rlsGain = malloc(sizeof(float) * n);
+  float *fastCoeffs = calloc(n, sizeof(float));
+  double *fastWork = malloc(sizeof(double) * FRLS_WORK_SIZE(n, 1));
+  RLS_t rls = {rlsCoeffs, rlsCov, rlsGain, 0.0f, 0.0f, n};
+  FRLS_t fast = {fastCoeffs, fastWork, 0.0f, 0.0f, 0.0f, n, 1, 0};
+  double t0, tRls, tFast;
+
+  /* Decaying resonance, plus a little measurement noise */
+  srand(1);
+  for(uint32_t k = 0; k < n; k++){
+    h[k] = expf(-(float)k / (0.15f * n)) * sinf(0.3f * k);
+  }
+  for(uint32_t i = 0; i < samples; i++){
+    u[i] = frand(-1.0f, 1.0f);
+    y[i] = frand(-0.001f, 0.001f);
+    for(uint32_t k = 0; k < n && k <= i; k++){
+      y[i] += h[k] * u[i - k];
+    }
+  }
+
+  for(uint32_t k = 0; k < n; k++){
+    rlsCov[k * n + k] = 100.0f;
+  }
+  t0 = now_seconds();
+  for(uint32_t i = 0; i < samples; i++){
+    memmove(line + 1, line, sizeof(float) * (n - 1));
+    line[0] = u[i];
+    RLS_Compute(line, y[i], &rls);
+  }
+  tRls = now_seconds() - t0;
+
+  FRLS_Init(100.0f, &fast);
+  t0 = now_seconds();
+  for(uint32_t i = 0; i < samples; i++){
+    FRLS_Compute(u[i], y[i], &fast);
+  }
+  tFast = now_seconds() - t0;
+
+  printf("FIR, %u taps, %u samples\n", n, samples);
+  printf("%-14s %14s %12s\n", "", "us / sample", "max error");
+  printf("%-14s %14.2f %12.3g\n", "RLS_Compute", 1e6 * tRls / samples,
+      max_error(rlsCoeffs, h, n));
+  printf("%-14s %14.2f %12.3g\n", "FRLS_Compute", 1e6 * tFast / samples,
+      max_error(fastCoeffs, h, n));
+  printf("speedup %.1f\n\n", tRls / tFast);
+
+  /* y[0] = 0.75*y[1] - 0.126*y[2] + u[0] + 2.45*u[1] + 0.9*u[2] */
+  {
+    float arx[6], arxTrue[6] = {1.0f, 0.75f, 2.45f, -0.126f, 0.9f, 0.0f};
+    double arxWork[FRLS_WORK_SIZE(3, 2)];
+    FRLS_t model = {arx, arxWork, 0.0f, 0.0f, 0.0f, 3, 2, 0};
+    float u0 = 0.0f, u1 = 0.0f, u2 = 0.0f, y1 = 0.0f, y2 = 0.0f, y0;
+
+    memset(arx, 0, sizeof(arx));
+    FRLS_Init(1000.0f, &model);
+    for(int i = 0; i < 100; i++){
+      u2 = u1;
+      u1 = u0;
+      u0 = rand() % 255;
+      y0 = 0.75f*y1 - 0.126f*y2 + u0 + 2.45f*u1 + 0.9f*u2;
+      FRLS_Compute(u0, y0, &model);
+      y2 = y1;
+      y1 = y0;
+    }
+    printf("ARX, order 3, 100 samples: {b0 a0 b1 a1 b2 a2} =\n  ");
+    for(int k = 0; k < 6; k++){
+      printf("%.4f ", arx[k]);
+    }
+    printf("(max error %.3g)\n\n", max_error(arx, arxTrue, 6));
+  }
+
+  /* Forgetting factor, long run */
+  {
+    uint32_t steps = 50 * samples;
+    fast.Lambda = 0.999f;
+    FRLS_Init(100.0f, &fast);
+    memset(fastCoeffs, 0, sizeof(float) * n);
+    memset(line, 0, sizeof(float) * n);
+    for(uint32_t i = 0; i < steps; i++){
+      float yi = frand(-0.001f, 0.001f);
+      memmove(line + 1, line, sizeof(float) * (n - 1));
+      line[0] = frand(-1.0f, 1.0f);
+      for(uint32_t k = 0; k < n; k++){
+        yi += h[k] * line[k];
+      }
+      FRLS_Compute(line[0], yi, &fast);
+    }
+    printf("Lambda 0.999, %u samples: max error %.3g, %u rescues\n", steps,
+        max_error(fastCoeffs, h, n), fast.Rescues);
+  }
+
+  free(h); free(u); free(y); free(line); free(rlsCoeffs); free(rlsCov);
+  free(rlsGain); free(fastCoeffs); free(fastWork);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,90 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+
+#include "matrix_math.h"
+
+
+/* Square sizes to be measured */
+int sizes[] = {16, 32, 64, 128, 256, 384, 512, 768, 1024};
+
+
+/* The plain triple loop MultiplyMatrix used before the blocked engine */
+void multiply_naive(float* A, float* B, int m, int p, int n, float* C)
+{
+  int i, j, k;
+  for (i = 0; i < m; i++)
+  {
+    for(j = 0; j < n; j++)
+    {
+      *(C + n*i + j) = 0;
+      for (k = 0; k < p; k++){
+        *(C + n*i + j) = *(C + n*i + j) + *(A + p*i + k) * (*(B + n*k + j));
+      }
+    }
+  }
+}
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/* Repeats the product until at least 0.2 s elapsed, returns GFLOP/s */
+double measure(void (*mult)(float*, float*, int, int, int, float*),
+    float *A, float *B, float *C, int n)
+{
+  int reps = 0;
+  double t0, t1;
+  t0 = now_seconds();
+  do{
+    mult(A, B, n, n, n, C);
+    reps++;
+    t1 = now_seconds();
+  }while(t1 - t0 < 0.2);
+  return 2.0 * n * n * (double)n * reps / (t1 - t0) * 1e-9;
+}
+
+
+int main(void) {
+  printf("%6s %14s %14s %9s %12s\n", "n", "naive GFLOP/s", "MultiplyMatrix",
+      "speedup", "max |diff|");
+
+  for(int s = 0; s < (int)(sizeof(sizes)/sizeof(sizes[0])); s++){
+    int n = sizes[s];
+    float *A = malloc(sizeof(float) * n * n);
+    float *B = malloc(sizeof(float) * n * n);
+    float *C1 = malloc(sizeof(float) * n * n);
+    float *C2 = malloc(sizeof(float) * n * n);
+    float diff = 0.0;
+
+    srand(n);
+    for(int i = 0; i < n * n; i++){
+      A[i] = (float)rand() / RAND_MAX - 0.5f;
+      B[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+
+    double naive = measure(multiply_naive, A, B, C1, n);
+    double blocked = measure(MultiplyMatrix, A, B, C2, n);
+    for(int i = 0; i < n * n; i++){
+      if(fabsf(C1[i] - C2[i]) > diff){
+        diff = fabsf(C1[i] - C2[i]);
+      }
+    }
+    printf("%6d %14.3f %14.3f %8.2fx %12.3g\n", n, naive, blocked,
+        blocked / naive, diff);
+
+    free(A); free(B); free(C1); free(C2);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+
+#include "matrix_math.h"
+#include "matrix_lu.h"
+#include "matrix_parallel.h"
+
+
+/**
+ * Inverts random matrices with the unblocked Gauss-Jordan that InvertMatrix
+ * uses for small orders, and with the blocked LU for 1, 2, 4, ... threads
+ * up to the number of online processors. Prints the time, the speedup over
+ * Gauss-Jordan and over the LU on one thread, and max |A * inv(A) - I|.
+ */
+int sizes[] = {128, 256, 512, 1024};
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/* Copy of the Gauss-Jordan of InvertMatrix, without the switch to LU */
+int32_t invert_gauss_jordan(float *A, int n, int *pivrows)
+{
+  int pivrow = 0;
+  int k, i, j;
+  float tmp;
+
+  for (k = 0; k < n; k++){
+    tmp = 0;
+    for (i = k; i < n; i++){
+      if (fabs(A[i*n + k]) >= tmp){
+        tmp = fabs(A[i*n + k]);
+        pivrow = i;
+      }
+    }
+    if (A[pivrow*n + k] == 0.0f){
+      return 0;
+    }
+    if (pivrow != k){
+      for (j = 0; j < n; j++){
+        tmp = A[k*n + j];
+        A[k*n + j] = A[pivrow*n + j];
+        A[pivrow*n + j] = tmp;
+      }
+    }
+    pivrows[k] = pivrow;
+    tmp = 1.0f / A[k*n + k];
+    A[k*n + k] = 1.0f;
+    for (j = 0; j < n; j++){
+      A[k*n + j] *= tmp;
+    }
+    for (i = 0; i < n; i++){
+      if (i != k){
+        tmp = A[i*n + k];
+        A[i*n + k] = 0.0f;
+        for (j = 0; j < n; j++){
+          A[i*n + j] -= A[k*n + j] * tmp;
+        }
+      }
+    }
+  }
+  for (k = n - 1; k >= 0; k--){
+    if (pivrows[k] != k){
+      for (i = 0; i < n; i++){
+        tmp = A[i*n + k];
+        A[i*n + k] = A[i*n + pivrows[k]];
+        A[i*n + pivrows[k]] = tmp;
+      }
+    }
+  }
+  return 1;
+}
+
+
+/* Largest component of |A * Ainv - I| */
+double residual(float *A, float *Ainv, int n)
+{
+  double err = 0.0;
+  for(int i = 0; i < n; i++){
+    for(int j = 0; j < n; j++){
+      double sum = (i == j) ? -1.0 : 0.0;
+      for(int k = 0; k < n; k++){
+        sum += (double)A[i * n + k] * Ainv[k * n + j];
+      }
+      if(fabs(sum) > err){
+        err = fabs(sum);
+      }
+    }
+  }
+  return err;
+}
+
+
+int main(void) {
+  int maxThreads = MatrixParallel_GetThreads();
+
+  printf("%d processor(s) online\n\n", maxThreads);
+  printf("%6s %8s %14s %10s %10s %12s\n", "n", "threads", "time (ms)",
+      "vs GJ", "vs 1 thr.", "residual");
+
+  for(int s = 0; s < (int)(sizeof(sizes)/sizeof(sizes[0])); s++){
+    int n = sizes[s];
+    float *A = malloc(sizeof(float) * n * n);
+    float *W = malloc(sizeof(float) * n * n);
+    int *pivrows = malloc(sizeof(int) * n);
+    double t0, tGJ, tLU, tOne = 0.0;
+    int reps;
+
+    /* Diagonally weighted random matrix, well conditioned */
+    srand(n);
+    for(int i = 0; i < n * n; i++){
+      A[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+    for(int i = 0; i < n; i++){
+      A[i * n + i] += 0.1f * n;
+    }
+
+    reps = 0;
+    t0 = now_seconds();
+    do{
+      CopyMatrix(A, n, n, W);
+      invert_gauss_jordan(W, n, pivrows);
+      reps++;
+    }while(now_seconds() - t0 < 0.5);
+    tGJ = (now_seconds() - t0) / reps;
+    printf("%6d %8s %14.2f %10s %10s %12.3g\n", n, "GJ", tGJ * 1e3, "", "",
+        residual(A, W, n));
+
+    for(int t = 1; ; t *= 2){
+      if(t > maxThreads){
+        t = maxThreads;
+      }
+      MatrixParallel_SetThreads(t);
+      reps = 0;
+      t0 = now_seconds();
+      do{
+        CopyMatrix(A, n, n, W);
+        InvertMatrix(W, n);
+        reps++;
+      }while(now_seconds() - t0 < 0.5);
+      tLU = (now_seconds() - t0) / reps;
+      if(t == 1){
+        tOne = tLU;
+      }
+      printf("%6d %8d %14.2f %9.2fx %9.2fx %12.3g\n", n, t, tLU * 1e3,
+          tGJ / tLU, tOne / tLU, residual(A, W, n));
+      if(t == maxThreads){
+        break;
+      }
+    }
+    printf("\n");
+
+    free(A); free(W); free(pivrows);
+  }
+
+  MatrixParallel_SetThreads(0);
+  return EXIT_SUCCESS;
+}
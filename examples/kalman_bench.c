@@ -0,0 +1,334 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+
+#include "arena.h"
+#include "matrix_math.h"
+#include "kalman.h"
+
+
+/**
+ * Tracks numFilters targets with constant velocity models (2-D position
+ * and velocity, 2 position measurements) and constant acceleration models
+ * (3-D, 9 states, 3 measurements). Every track is filtered three times:
+ * with a Kalman filter written on matrix_math.h (MultiplyMatrix,
+ * TransposeMatrix, InvertMatrix and temporaries, Joseph form), with
+ * KF_Predict / KF_Update and with KF_BankPredict / KF_BankUpdate. Prints
+ * the time of a predict plus update per track, the largest state
+ * difference with the matrix_math filter, the number of tracks whose bank
+ * estimate differs from KF_Update and the position error at the end.
+ *
+ * Usage: kalman_bench [filters] [steps]
+ */
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+float frand(float min, float max)
+{
+  return min + (max - min) * ((float)rand() / RAND_MAX);
+}
+
+
+/* Normal noise, Box-Muller */
+float nrand(float sigma)
+{
+  float u = frand(1e-6f, 1.0f), v = frand(0.0f, 1.0f);
+  return sigma * sqrtf(-2.0f * logf(u)) * cosf(6.2831853f * v);
+}
+
+
+/**
+ * Kalman filter step as written with matrix_math.h.
+ */
+typedef struct
+{
+  float *x, *P, *F, *Ft, *Q, *H, *Ht, *R, *I;
+  float *xn, *FP, *S, *PHt, *K, *y, *KH, *IKH, *IKHt, *A, *B, *KR, *Kt;
+  int n, m;
+}Naive_t;
+
+
+void naive_alloc(Naive_t *k, int n, int m)
+{
+  k->n = n;
+  k->m = m;
+  k->x = calloc(n, sizeof(float));
+  k->P = calloc(n * n, sizeof(float));
+  k->F = calloc(n * n, sizeof(float));
+  k->Ft = calloc(n * n, sizeof(float));
+  k->Q = calloc(n * n, sizeof(float));
+  k->H = calloc(m * n, sizeof(float));
+  k->Ht = calloc(n * m, sizeof(float));
+  k->R = calloc(m * m, sizeof(float));
+  k->I = calloc(n * n, sizeof(float));
+  k->xn = calloc(n, sizeof(float));
+  k->FP = calloc(n * n, sizeof(float));
+  k->S = calloc(m * m, sizeof(float));
+  k->PHt = calloc(n * m, sizeof(float));
+  k->K = calloc(n * m, sizeof(float));
+  k->y = calloc(m, sizeof(float));
+  k->KH = calloc(n * n, sizeof(float));
+  k->IKH = calloc(n * n, sizeof(float));
+  k->IKHt = calloc(n * n, sizeof(float));
+  k->A = calloc(n * n, sizeof(float));
+  k->B = calloc(n * n, sizeof(float));
+  k->KR = calloc(n * m, sizeof(float));
+  k->Kt = calloc(m * n, sizeof(float));
+  for(int i = 0; i < n; i++){
+    k->I[i * n + i] = 1.0f;
+  }
+}
+
+
+void naive_free(Naive_t *k)
+{
+  free(k->x); free(k->P); free(k->F); free(k->Ft); free(k->Q); free(k->H);
+  free(k->Ht); free(k->R); free(k->I); free(k->xn); free(k->FP);
+  free(k->S); free(k->PHt); free(k->K); free(k->y); free(k->KH);
+  free(k->IKH); free(k->IKHt); free(k->A); free(k->B); free(k->KR);
+  free(k->Kt);
+}
+
+
+void naive_step(Naive_t *k, float *z)
+{
+  int n = k->n, m = k->m;
+
+  /* x = F x, P = F P F' + Q */
+  MultiplyMatrix(k->F, k->x, n, n, 1, k->xn);
+  CopyMatrix(k->xn, n, 1, k->x);
+  MultiplyMatrix(k->F, k->P, n, n, n, k->FP);
+  TransposeMatrix(k->F, n, n, k->Ft);
+  MultiplyMatrix(k->FP, k->Ft, n, n, n, k->P);
+  AddMatrix(k->P, k->Q, n, n, k->P);
+
+  /* K = P H' inv(H P H' + R) */
+  TransposeMatrix(k->H, m, n, k->Ht);
+  MultiplyMatrix(k->P, k->Ht, n, n, m, k->PHt);
+  MultiplyMatrix(k->H, k->PHt, m, n, m, k->S);
+  AddMatrix(k->S, k->R, m, m, k->S);
+  InvertMatrix(k->S, m);
+  MultiplyMatrix(k->PHt, k->S, n, m, m, k->K);
+
+  /* x = x + K (z - H x) */
+  MultiplyMatrix(k->H, k->x, m, n, 1, k->y);
+  SubtractMatrix(z, k->y, m, 1, k->y);
+  MultiplyMatrix(k->K, k->y, n, m, 1, k->xn);
+  AddMatrix(k->x, k->xn, n, 1, k->x);
+
+  /* P = (I - K H) P (I - K H)' + K R K' */
+  MultiplyMatrix(k->K, k->H, n, m, n, k->KH);
+  SubtractMatrix(k->I, k->KH, n, n, k->IKH);
+  TransposeMatrix(k->IKH, n, n, k->IKHt);
+  MultiplyMatrix(k->IKH, k->P, n, n, n, k->A);
+  MultiplyMatrix(k->A, k->IKHt, n, n, n, k->B);
+  MultiplyMatrix(k->K, k->R, n, m, m, k->KR);
+  TransposeMatrix(k->K, n, m, k->Kt);
+  MultiplyMatrix(k->KR, k->Kt, n, m, n, k->A);
+  AddMatrix(k->B, k->A, n, n, k->P);
+}
+
+
+/**
+ * Constant velocity (Order 1) or acceleration (Order 2) model of Axes
+ * axes, states grouped by axis: {p, v} or {p, v, a}.
+ */
+void model(int Axes, int Order, float dt, float *F, float *Q, float *H,
+    float *R)
+{
+  int d = Order + 1, n = Axes * d;
+  memset(F, 0, sizeof(float) * n * n);
+  memset(Q, 0, sizeof(float) * n * n);
+  memset(H, 0, sizeof(float) * Axes * n);
+  for(int a = 0; a < Axes; a++){
+    int o = a * d;
+    for(int i = 0; i < d; i++){
+      float c = 1.0f;
+      for(int j = i; j < d; j++){
+        F[(o + i) * n + o + j] = c;
+        c = c * dt / (j - i + 1);
+      }
+    }
+    /* White noise on the highest derivative, discretized */
+    Q[(o + d - 1) * n + o + d - 1] = 0.01f * dt;
+    Q[o * n + o] = 1e-6f;
+    H[a * n + o] = 1.0f;
+    R[a] = 0.25f;
+  }
+}
+
+
+void run(int Axes, int Order, uint32_t nf, uint32_t steps)
+{
+  const float dt = 0.05f;
+  int n = Axes * (Order + 1), m = Axes;
+  uint32_t st = KF_BANK_STRIDE(nf);
+  float *F = malloc(sizeof(float) * n * n);
+  float *Q = malloc(sizeof(float) * n * n);
+  float *H = malloc(sizeof(float) * m * n);
+  float *R = malloc(sizeof(float) * m);
+  float *truth = malloc(sizeof(float) * n * nf);
+  float *z = calloc((size_t)steps * m * st, sizeof(float));
+  Naive_t *naive = malloc(sizeof(Naive_t) * nf);
+  KF_t *kf = malloc(sizeof(KF_t) * nf);
+  KF_t stored;
+  KF_Bank_t bank;
+  Arena_t arena;
+  size_t bytes = KF_WorkspaceSize(n, m);
+  double t0, tNaive, tKf, tBank, diff = 0.0, posErr = 0.0;
+  uint32_t differ = 0;
+
+  model(Axes, Order, dt, F, Q, H, R);
+
+  /* Targets, measured with noise */
+  srand(n);
+  for(uint32_t f = 0; f < nf; f++){
+    for(int i = 0; i < n; i++){
+      truth[i * nf + f] = frand(-10.0f, 10.0f) / (1 + i % (Order + 1));
+    }
+  }
+  for(uint32_t s = 0; s < steps; s++){
+    for(uint32_t f = 0; f < nf; f++){
+      float x[9], xn[9];
+      for(int i = 0; i < n; i++){
+        x[i] = truth[i * nf + f];
+      }
+      for(int i = 0; i < n; i++){
+        xn[i] = 0.0f;
+        for(int j = 0; j < n; j++){
+          xn[i] += F[i * n + j] * x[j];
+        }
+        xn[i] += ((i % (Order + 1)) == Order) ? nrand(sqrtf(0.01f * dt)) :
+            0.0f;
+        truth[i * nf + f] = xn[i];
+      }
+      for(int a = 0; a < m; a++){
+        z[((size_t)s * m + a) * st + f] = xn[a * (Order + 1)] + nrand(0.5f);
+      }
+    }
+  }
+
+  /* matrix_math.h */
+  for(uint32_t f = 0; f < nf; f++){
+    naive_alloc(&naive[f], n, m);
+    memcpy(naive[f].F, F, sizeof(float) * n * n);
+    memcpy(naive[f].Q, Q, sizeof(float) * n * n);
+    memcpy(naive[f].H, H, sizeof(float) * m * n);
+    for(int a = 0; a < m; a++){
+      naive[f].R[a * m + a] = R[a];
+    }
+    for(int i = 0; i < n; i++){
+      naive[f].P[i * n + i] = 100.0f;
+    }
+  }
+  t0 = now_seconds();
+  for(uint32_t s = 0; s < steps; s++){
+    for(uint32_t f = 0; f < nf; f++){
+      float zf[3];
+      for(int a = 0; a < m; a++){
+        zf[a] = z[((size_t)s * m + a) * st + f];
+      }
+      naive_step(&naive[f], zf);
+    }
+  }
+  tNaive = now_seconds() - t0;
+
+  /* KF_Predict / KF_Update, every filter in one arena */
+  Arena_Create(&arena, bytes * nf);
+  for(uint32_t f = 0; f < nf; f++){
+    KF_AttachWorkspace(Arena_Alloc(&arena, bytes), n, m, 100.0f, &kf[f]);
+    memcpy(kf[f].F, F, sizeof(float) * n * n);
+    memcpy(kf[f].Q, Q, sizeof(float) * n * n);
+    memcpy(kf[f].H, H, sizeof(float) * m * n);
+    memcpy(kf[f].R, R, sizeof(float) * m);
+  }
+  t0 = now_seconds();
+  for(uint32_t s = 0; s < steps; s++){
+    for(uint32_t f = 0; f < nf; f++){
+      float zf[3];
+      for(int a = 0; a < m; a++){
+        zf[a] = z[((size_t)s * m + a) * st + f];
+      }
+      KF_Predict(&kf[f]);
+      KF_Update(zf, &kf[f]);
+    }
+  }
+  tKf = now_seconds() - t0;
+
+  /* KF_Bank_t */
+  bank.State = malloc(sizeof(float) * n * st);
+  bank.Cov = malloc(sizeof(float) * KF_BANK_COV_SIZE(n, st));
+  bank.Work = malloc(sizeof(float) * KF_BANK_WORK_SIZE(n));
+  bank.F = F;
+  bank.Q = Q;
+  bank.H = H;
+  bank.R = R;
+  bank.NumStates = n;
+  bank.NumMeas = m;
+  bank.NumFilters = nf;
+  bank.Stride = st;
+  KF_BankInit(100.0f, &bank);
+  t0 = now_seconds();
+  for(uint32_t s = 0; s < steps; s++){
+    KF_BankPredict(&bank);
+    KF_BankUpdate(z + (size_t)s * m * st, &bank);
+  }
+  tBank = now_seconds() - t0;
+
+  stored = kf[0];
+  stored.State = malloc(sizeof(float) * n);
+  stored.Cov = malloc(sizeof(float) * n * n);
+  for(uint32_t f = 0; f < nf; f++){
+    KF_BankStore(f, &stored, &bank);
+    differ += (memcmp(stored.State, kf[f].State, sizeof(float) * n) != 0 ||
+        memcmp(stored.Cov, kf[f].Cov, sizeof(float) * n * n) != 0);
+    for(int i = 0; i < n; i++){
+      double d = fabs(naive[f].x[i] - kf[f].State[i]);
+      diff = (d > diff) ? d : diff;
+    }
+    for(int a = 0; a < m; a++){
+      int i = a * (Order + 1);
+      double e = kf[f].State[i] - truth[i * nf + f];
+      posErr += e * e / ((double)nf * m);
+    }
+  }
+
+  printf("%-22s %10.1f %10.1f %10.1f %10.3g %8u %10.3f\n",
+      (Order == 1) ? "2-D const. velocity" : "3-D const. accel.",
+      1e9 * tNaive / ((double)steps * nf), 1e9 * tKf / ((double)steps * nf),
+      1e9 * tBank / ((double)steps * nf), diff, differ, sqrt(posErr));
+
+  for(uint32_t f = 0; f < nf; f++){
+    naive_free(&naive[f]);
+  }
+  Arena_Destroy(&arena);
+  free(F); free(Q); free(H); free(R); free(truth); free(z); free(naive);
+  free(kf); free(stored.State); free(stored.Cov); free(bank.State);
+  free(bank.Cov); free(bank.Work);
+}
+
+
+int main(int argc, char **argv) {
+  uint32_t nf = (argc > 1) ? (uint32_t)atol(argv[1]) : 4096;
+  uint32_t steps = (argc > 2) ? (uint32_t)atol(argv[2]) : 100;
+
+  printf("%u tracks, %u steps, ns per track and step\n", nf, steps);
+  printf("%-22s %10s %10s %10s %10s %8s %10s\n", "model", "matrix",
+      "KF_Update", "KF_Bank", "difference", "differ", "pos. rms");
+  run(2, 1, nf, steps);
+  run(3, 2, nf, steps);
+  return EXIT_SUCCESS;
+}
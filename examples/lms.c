@@ -27,7 +27,7 @@ float inputs2[4][3]  = {  /* {1, x1,x2} */
 };
 float outputs2[4] = {3, -3, -17, -119};                  /* y */
 float sumYiXji2[3];
-float sumXkiXji2[4 * 3];
+float sumXkiXji2[3 * 3];
 float coeffs2[3];
 
 /* Polynomial */
@@ -41,9 +41,9 @@ float sumXkiXji3[3 * 3];
 float coeffs3[3];
 
 
-/* Incomplete polynomial (fails) */
+/* Incomplete polynomial (singular) */
 /* y = 0 + 0 + 5*x^2 */
-/* This will not work because leads to a non-invertible matrix */
+/* Leads to a non-invertible matrix, solved by the LDL' fallback */
 uint32_t numCoeff4 = 3;
 uint32_t numSamples4 = 3;
 float inputs4[3][3]  = {{0, 0, 0},{0, 0, 1},{0, 0, 4}}; /* {0, 0, x^2} */
@@ -60,7 +60,7 @@ uint32_t numSamples5 = 3;
 float inputs5[3][1]  = {{0},{1},{4}}; /* {x^2} */
 float outputs5[3] = {0, 5, 20};               /* y */
 float sumYiXji5[1];
-float sumXkiXji5[3 * 1];
+float sumXkiXji5[1 * 1];
 float coeffs5[1];
 
 
@@ -79,8 +79,9 @@ float outputs10[14] = {                   /* y(t) */
     2.5, 2.4, 1.3, 1.2, 0.8, 0.0,
     0.9, 1.4, 1.9, 2.3, 2.4, 2.3, 1.3, 1.2,
 };
-float sumYiXji10[2];
-float sumXkiXji10[14 * 2];
+double sumYiXji10[2];
+double sumXkiXji10[2 * 2];
+float work10[2 * (2 + 1)];
 float coeffs10[2];
 
 int main(void) {
@@ -119,11 +120,11 @@ int main(void) {
       .SumXkiXji = sumXkiXji5,
       .SysCoeffs = coeffs5,
   };
-  LMS_t LMS10 = {
+  LMS_Inc_t LMS10 = {
       .NumCoeff = numCoeff10,
-      .NumSamples = numSamples10,
       .SumYiXji = sumYiXji10,
       .SumXkiXji = sumXkiXji10,
+      .Work = work10,
       .SysCoeffs = coeffs10,
   };
 
@@ -148,10 +149,14 @@ int main(void) {
   printf("Expected: [5.0] Computed: [%f]\n",coeffs5[0]);
 
   printf("\nFinding coefficients for an unknown difference equation of the form  y(t) = b0u(t) + b1u(t-1) \n");
-  for(int i = 7; i <= 14; i++){
-    LMS10.NumSamples = i;
-    error[i] = LMS_Compute(&inputs10[0][0], outputs10, &LMS10);
-    printf("Using %d samples: b0 = %f, b1 = %f\n", i, coeffs10[0], coeffs10[1]);
+  /* Samples are accumulated as they arrive, the sums are never rebuilt */
+  LMS_IncReset(&LMS10);
+  for(uint32_t i = 1; i <= numSamples10; i++){
+    LMS_IncAdd(&inputs10[i - 1][0], outputs10[i - 1], &LMS10);
+    if(i >= 7){
+      error[i] = LMS_IncCompute(&LMS10);
+      printf("Using %u samples: b0 = %f, b1 = %f\n", i, coeffs10[0], coeffs10[1]);
+    }
   }
   puts("!!!Hello World!!!"); /* prints !!!Hello World!!! */
   return EXIT_SUCCESS;
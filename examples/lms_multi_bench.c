@@ -0,0 +1,113 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+
+#include "least_squares.h"
+
+
+/**
+ * Fits the same regressors against several outputs: once with one
+ * LMS_Compute per output, once with LMS_ComputeMulti (one factorization)
+ * and once more with LMS_ComputeMulti reusing the cached factorization.
+ * Prints the times and the largest coefficient difference.
+ *
+ * Usage: lms_multi_bench [samples] [coeffs] [outputs]
+ */
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+float frand(float min, float max)
+{
+  return min + (max - min) * ((float)rand() / RAND_MAX);
+}
+
+
+int main(int argc, char **argv) {
+  uint32_t samples = (argc > 1) ? (uint32_t)atol(argv[1]) : 20000;
+  uint32_t n = (argc > 2) ? (uint32_t)atol(argv[2]) : 32;
+  uint32_t m = (argc > 3) ? (uint32_t)atol(argv[3]) : 48;
+  float *X = malloc(sizeof(float) * samples * n);
+  float *Y = malloc(sizeof(float) * samples * m);
+  float *y = malloc(sizeof(float) * samples);
+  float *truth = malloc(sizeof(float) * n * m);
+  float *loop = malloc(sizeof(float) * n * m);
+  float *multi = malloc(sizeof(float) * n * m);
+  float *coeffs = malloc(sizeof(float) * n);
+  float *sumYiXji = malloc(sizeof(float) * n);
+  float *sumXkiXji = malloc(sizeof(float) * n * n);
+  LMS_t lms = {
+      .SysCoeffs = coeffs,
+      .SumYiXji = sumYiXji,
+      .SumXkiXji = sumXkiXji,
+      .NumCoeff = n,
+      .NumSamples = samples,
+  };
+  double t0, tLoop, tMulti, tCached, diff = 0.0;
+
+  srand(1);
+  for(uint32_t k = 0; k < n * m; k++){
+    truth[k] = frand(-1.0f, 1.0f);
+  }
+  for(uint32_t i = 0; i < samples; i++){
+    for(uint32_t k = 0; k < n; k++){
+      X[i * n + k] = frand(-1.0f, 1.0f);
+    }
+    for(uint32_t o = 0; o < m; o++){
+      float v = frand(-0.01f, 0.01f);
+      for(uint32_t k = 0; k < n; k++){
+        v += X[i * n + k] * truth[k * m + o];
+      }
+      Y[i * m + o] = v;
+    }
+  }
+
+  t0 = now_seconds();
+  for(uint32_t o = 0; o < m; o++){
+    for(uint32_t i = 0; i < samples; i++){
+      y[i] = Y[i * m + o];
+    }
+    LMS_Compute(X, y, &lms);
+    for(uint32_t k = 0; k < n; k++){
+      loop[k * m + o] = coeffs[k];
+    }
+  }
+  tLoop = now_seconds() - t0;
+
+  LMS_Init(&lms);
+  t0 = now_seconds();
+  LMS_ComputeMulti(X, Y, m, multi, &lms);
+  tMulti = now_seconds() - t0;
+
+  t0 = now_seconds();
+  LMS_ComputeMulti(X, Y, m, multi, &lms);
+  tCached = now_seconds() - t0;
+
+  for(uint32_t k = 0; k < n * m; k++){
+    double d = fabs(loop[k] - multi[k]);
+    diff = (d > diff) ? d : diff;
+  }
+
+  printf("%u samples, %u coefficients, %u outputs\n", samples, n, m);
+  printf("%-28s %10.2f ms\n", "LMS_Compute per output", 1e3 * tLoop);
+  printf("%-28s %10.2f ms\n", "LMS_ComputeMulti", 1e3 * tMulti);
+  printf("%-28s %10.2f ms\n", "LMS_ComputeMulti, cached", 1e3 * tCached);
+  printf("speedup %.1f (cached %.1f), max difference %.3g\n",
+      tLoop / tMulti, tLoop / tCached, diff);
+
+  free(X); free(Y); free(y); free(truth); free(loop); free(multi);
+  free(coeffs); free(sumYiXji); free(sumXkiXji);
+  return EXIT_SUCCESS;
+}
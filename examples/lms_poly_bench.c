@@ -0,0 +1,115 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+
+#include "least_squares.h"
+
+
+/**
+ * Calibration curve of a sensor read as ADC counts: fits polynomials of
+ * growing degree once with LMS_Compute over Vandermonde rows
+ * {1, x, x^2, ...} and once with LMS_PolyCompute over the raw samples.
+ * Prints the time of both and the largest error of the fitted curve
+ * against the true one over the samples.
+ *
+ * Usage: lms_poly_bench [samples]
+ */
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+float frand(float min, float max)
+{
+  return min + (max - min) * ((float)rand() / RAND_MAX);
+}
+
+
+/* Temperature (deg C) of a thermistor divider, read in counts */
+double curve(double x)
+{
+  double r = 10000.0 * x / (4096.0 - x);
+  return 1.0 / (1.0 / 298.15 + log(r / 10000.0) / 3950.0) - 273.15;
+}
+
+
+/* Largest |fit(x) - curve(x)| over the samples */
+double fit_error(float *Coeffs, uint32_t n, float *x, uint32_t samples)
+{
+  double err = 0.0;
+  for(uint32_t i = 0; i < samples; i++){
+    double v = 0.0;
+    for(uint32_t j = n; j-- > 0;){
+      v = v * x[i] + Coeffs[j];
+    }
+    v = fabs(v - curve(x[i]));
+    err = (v > err) ? v : err;
+  }
+  return err;
+}
+
+
+int main(int argc, char **argv) {
+  uint32_t samples = (argc > 1) ? (uint32_t)atol(argv[1]) : 100000;
+  float *x = malloc(sizeof(float) * samples);
+  float *y = malloc(sizeof(float) * samples);
+
+  srand(1);
+  for(uint32_t i = 0; i < samples; i++){
+    x[i] = (float)(int)frand(1000.0f, 3000.0f);
+    y[i] = (float)curve(x[i]);
+  }
+
+  printf("%u samples\n", samples);
+  printf("%6s %14s %14s %9s %14s %14s\n", "degree", "LMS (ms)",
+      "Poly (ms)", "speedup", "LMS error", "Poly error");
+  for(uint32_t n = 2; n <= 6; n++){
+    float *vander = malloc(sizeof(float) * samples * n);
+    float coeffsLms[6], coeffsPoly[6], sumYiXji[6], sumXkiXji[36];
+    double work[LMS_POLY_WORK_SIZE(6)];
+    LMS_t lms = {
+        .SysCoeffs = coeffsLms,
+        .SumYiXji = sumYiXji,
+        .SumXkiXji = sumXkiXji,
+        .NumCoeff = n,
+        .NumSamples = samples,
+    };
+    LMS_Poly_t poly = {coeffsPoly, work, n, samples};
+    double t0, tLms, tPoly;
+
+    /* The Vandermonde rows are part of the cost of the generic path */
+    t0 = now_seconds();
+    for(uint32_t i = 0; i < samples; i++){
+      float v = 1.0f;
+      for(uint32_t j = 0; j < n; j++){
+        vander[i * n + j] = v;
+        v *= x[i];
+      }
+    }
+    LMS_Compute(vander, y, &lms);
+    tLms = now_seconds() - t0;
+
+    t0 = now_seconds();
+    LMS_PolyCompute(x, y, &poly);
+    tPoly = now_seconds() - t0;
+
+    printf("%6u %14.3f %14.3f %9.1f %14.3g %14.3g\n", n - 1, 1e3 * tLms,
+        1e3 * tPoly, tLms / tPoly, fit_error(coeffsLms, n, x, samples),
+        fit_error(coeffsPoly, n, x, samples));
+    free(vander);
+  }
+
+  free(x); free(y);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,103 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+
+#include "matrix_math.h"
+
+
+/**
+ * Solves the normal equations (X'X) * A = X'Y of a LMS fit by explicit
+ * inversion (InvertMatrix followed by MultiplyMatrix, as LMS_Compute used
+ * to do) and by Cholesky factorization with triangular solves.
+ */
+int sizes[] = {10, 20, 50, 100, 200, 500, 1000};
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/* Largest component of |G * a - y| */
+double residual(float *G, float *a, float *y, int n)
+{
+  double err = 0.0;
+  for(int i = 0; i < n; i++){
+    double sum = 0.0;
+    for(int j = 0; j < n; j++){
+      sum += (double)G[i * n + j] * a[j];
+    }
+    if(fabs(sum - y[i]) > err){
+      err = fabs(sum - y[i]);
+    }
+  }
+  return err;
+}
+
+
+int main(void) {
+  printf("%6s %16s %16s %9s %14s %14s\n", "n", "inversion (us)",
+      "Cholesky (us)", "speedup", "resid. inv.", "resid. chol.");
+
+  for(int s = 0; s < (int)(sizeof(sizes)/sizeof(sizes[0])); s++){
+    int n = sizes[s];
+    int samples = 2 * n;
+    float *X = malloc(sizeof(float) * samples * n);
+    float *Xt = malloc(sizeof(float) * samples * n);
+    float *G = malloc(sizeof(float) * n * n);
+    float *W = malloc(sizeof(float) * n * n);
+    float *y = malloc(sizeof(float) * n);
+    float *a1 = malloc(sizeof(float) * n);
+    float *a2 = malloc(sizeof(float) * n);
+    int reps = 0;
+    double t0, tInv, tChol;
+
+    /* Gram matrix of random regressors, well conditioned */
+    srand(n);
+    for(int i = 0; i < samples * n; i++){
+      X[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+    for(int i = 0; i < n; i++){
+      y[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+    TransposeMatrix(X, samples, n, Xt);
+    MultiplyMatrix(Xt, X, n, samples, n, G);
+
+    t0 = now_seconds();
+    do{
+      CopyMatrix(G, n, n, W);
+      InvertMatrix(W, n);
+      MultiplyMatrix(W, y, n, n, 1, a1);
+      reps++;
+    }while(now_seconds() - t0 < 0.2);
+    tInv = (now_seconds() - t0) / reps;
+
+    reps = 0;
+    t0 = now_seconds();
+    do{
+      CopyMatrix(G, n, n, W);
+      CopyMatrix(y, n, 1, a2);
+      CholeskyDecomposition(W, n);
+      CholeskySolve(W, n, a2, 1);
+      reps++;
+    }while(now_seconds() - t0 < 0.2);
+    tChol = (now_seconds() - t0) / reps;
+
+    printf("%6d %16.1f %16.1f %8.2fx %14.3g %14.3g\n", n, tInv * 1e6,
+        tChol * 1e6, tInv / tChol, residual(G, a1, y, n),
+        residual(G, a2, y, n));
+
+    free(X); free(Xt); free(G); free(W); free(y); free(a1); free(a2);
+  }
+
+  return EXIT_SUCCESS;
+}
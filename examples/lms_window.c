@@ -0,0 +1,130 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+
+#include "least_squares.h"
+
+
+/**
+ * Fits y = a0 + a1*x + a2*x^2 over a sliding window of a ring-buffered
+ * sample log with rows {1, x, x^2, y}. Every window is fitted twice: by
+ * copying it into separate input and output arrays for LMS_Compute, and in
+ * place with LMS_ComputeView. The log is written twice (at i and
+ * i + CAPACITY), so windows that wrap around are contiguous too.
+ * Prints the time per fit and the largest coefficient difference.
+ *
+ * Usage: lms_window [window] [fits]
+ */
+#define CAPACITY                                                       (1 << 18)
+#define LOG_COLS                                                               4
+#define NUM_COEFF                                                              3
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/* Appends one sample at position Index of the mirrored log */
+void log_push(float *Log, uint32_t Index, float x, float y)
+{
+  float *row1 = Log + (Index % CAPACITY) * LOG_COLS;
+  float *row2 = row1 + CAPACITY * LOG_COLS;
+  row1[0] = row2[0] = 1.0f;
+  row1[1] = row2[1] = x;
+  row1[2] = row2[2] = x * x;
+  row1[3] = row2[3] = y;
+}
+
+
+int main(int argc, char **argv) {
+  uint32_t window = (argc > 1) ? (uint32_t)atol(argv[1]) : 100000;
+  uint32_t fits = (argc > 2) ? (uint32_t)atol(argv[2]) : 50;
+  float *log = malloc(sizeof(float) * 2 * CAPACITY * LOG_COLS);
+  float *inputs = malloc(sizeof(float) * window * NUM_COEFF);
+  float *outputs = malloc(sizeof(float) * window);
+  float sumYiXji[NUM_COEFF], sumXkiXji[NUM_COEFF * NUM_COEFF];
+  float coeffsCopy[NUM_COEFF], coeffsView[NUM_COEFF];
+  LMS_t lmsCopy = {
+      .SysCoeffs = coeffsCopy,
+      .SumYiXji = sumYiXji,
+      .SumXkiXji = sumXkiXji,
+      .NumCoeff = NUM_COEFF,
+  };
+  LMS_t lmsView = {
+      .SysCoeffs = coeffsView,
+      .SumYiXji = sumYiXji,
+      .SumXkiXji = sumXkiXji,
+      .NumCoeff = NUM_COEFF,
+  };
+  MatrixView_t logView, inputView, outputView;
+  double tCopy = 0.0, tView = 0.0, t0, diff = 0.0;
+  uint32_t head = 0, done = 0, f, i, k;
+  float x;
+
+  if(log == NULL || inputs == NULL || outputs == NULL || window > CAPACITY){
+    printf("Window must fit in %u samples\n", CAPACITY);
+    return EXIT_FAILURE;
+  }
+  lmsCopy.NumSamples = window;
+  lmsView.NumSamples = window;
+  MatrixViewInit(&logView, log, 2 * CAPACITY, LOG_COLS, LOG_COLS);
+
+  srand(1);
+  for(f = 0; f < fits; f++){
+    /* New samples of a slowly drifting parabola */
+    for(i = 0; i < window / 4 + 1; i++, head++){
+      x = -1.0f + 2.0f * (float)rand() / RAND_MAX;
+      log_push(log, head, x, 1.0f + 0.001f * f - 2.0f * x + 0.5f * x * x +
+          0.01f * ((float)rand() / RAND_MAX - 0.5f));
+    }
+    if(head < window){
+      continue;
+    }
+
+    /* Staging copies, as needed by LMS_Compute */
+    t0 = now_seconds();
+    for(i = 0; i < window; i++){
+      float *row = log + ((head - window + i) % CAPACITY) * LOG_COLS;
+      for(k = 0; k < NUM_COEFF; k++){
+        inputs[i * NUM_COEFF + k] = row[k];
+      }
+      outputs[i] = row[NUM_COEFF];
+    }
+    LMS_Compute(inputs, outputs, &lmsCopy);
+    tCopy += now_seconds() - t0;
+
+    /* Same window, read in place */
+    t0 = now_seconds();
+    MatrixViewBlock(&logView, (head - window) % CAPACITY, 0, window,
+        NUM_COEFF, &inputView);
+    MatrixViewBlock(&logView, (head - window) % CAPACITY, NUM_COEFF, window,
+        1, &outputView);
+    LMS_ComputeView(&inputView, &outputView, &lmsView);
+    tView += now_seconds() - t0;
+    done++;
+
+    for(k = 0; k < NUM_COEFF; k++){
+      double d = fabs(coeffsCopy[k] - coeffsView[k]);
+      diff = (d > diff) ? d : diff;
+    }
+  }
+
+  printf("window %u samples, %u fits\n", window, done);
+  printf("coefficients: %.4f %.4f %.4f\n", coeffsView[0], coeffsView[1],
+      coeffsView[2]);
+  printf("copy + LMS_Compute : %8.3f ms per fit\n", 1e3 * tCopy / done);
+  printf("LMS_ComputeView    : %8.3f ms per fit\n", 1e3 * tView / done);
+  printf("largest difference : %g\n", diff);
+
+  free(log); free(inputs); free(outputs);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,215 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+
+#include "madgwick.h"
+
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+/**
+ * Simulates numStreams sensors, each turning at its own constant rate from
+ * its own initial attitude, with noisy gyroscope, accelerometer and
+ * magnetometer. Every stream is filtered once by Madgwick_Update and once
+ * by Madgwick_BankUpdate, one time step after the other. For each
+ * accuracy of the normalizations it prints the samples per second of
+ * both, the mean and largest attitude error at the end and the number of
+ * streams whose bank quaternion differs from the single filter one.
+ *
+ * Build with -DMADGWICK_SIMD_DISABLE for the portable bank loop.
+ *
+ * Usage: madgwick_bench [streams] [steps]
+ */
+
+
+#define PI_F 3.14159265f
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+float frand(float min, float max)
+{
+  return min + (max - min) * ((float)rand() / RAND_MAX);
+}
+
+
+/* v_sensor = R(q)' * v_earth */
+void to_sensor(const double *q, const double *e, double *v)
+{
+  double r[9] = {
+      1 - 2*(q[2]*q[2] + q[3]*q[3]), 2*(q[1]*q[2] - q[0]*q[3]),
+      2*(q[1]*q[3] + q[0]*q[2]),
+      2*(q[1]*q[2] + q[0]*q[3]), 1 - 2*(q[1]*q[1] + q[3]*q[3]),
+      2*(q[2]*q[3] - q[0]*q[1]),
+      2*(q[1]*q[3] - q[0]*q[2]), 2*(q[2]*q[3] + q[0]*q[1]),
+      1 - 2*(q[1]*q[1] + q[2]*q[2])};
+  for(int i = 0; i < 3; i++){
+    v[i] = r[i]*e[0] + r[3 + i]*e[1] + r[6 + i]*e[2];
+  }
+}
+
+
+/* Angle, in degrees, of the rotation between two attitudes */
+double attitude_error(const float *q, const double *t)
+{
+  double d = fabs(q[0]*t[0] + q[1]*t[1] + q[2]*t[2] + q[3]*t[3]);
+  return 2.0 * acos((d < 1.0) ? d : 1.0) * 180.0 / M_PI;
+}
+
+
+int main(int argc, char **argv) {
+  uint32_t ns = (argc > 1) ? (uint32_t)atol(argv[1]) : 256;
+  uint32_t steps = (argc > 2) ? (uint32_t)atol(argv[2]) : 6000;
+  const float dt = 0.01f;
+  const double gravity[3] = {0.0, 0.0, 1.0};
+  const double field[3] = {0.6, 0.0, -0.8};  /* 53 degrees of dip */
+  /* Planes gx gy gz ax ay az mx my mz of every step, [step][plane][stream] */
+  float *log = malloc(sizeof(float) * 9 * ns * steps);
+  double *truth = malloc(sizeof(double) * 4 * ns);
+  float *quat = malloc(sizeof(float) * 4 * ns);
+  Madgwick_t *single = malloc(sizeof(Madgwick_t) * ns);
+  Madgwick_Bank_t bank;
+
+  /* Trajectories, integrated in double precision */
+  srand(1);
+  for(uint32_t s = 0; s < ns; s++){
+    double *q = truth + 4*s;
+    double w[3], a[3], m[3], n = 0.0;
+    for(int c = 0; c < 4; c++){
+      q[c] = frand(-1.0f, 1.0f);
+      n += q[c] * q[c];
+    }
+    for(int c = 0; c < 4; c++){
+      q[c] /= sqrt(n);
+    }
+    for(int c = 0; c < 3; c++){
+      w[c] = frand(-0.5f, 0.5f);
+    }
+    for(uint32_t i = 0; i < steps; i++){
+      float *p = log + (size_t)9 * ns * i + s;
+      double d[4];
+      to_sensor(q, gravity, a);
+      to_sensor(q, field, m);
+      for(int c = 0; c < 3; c++){
+        p[c * ns] = (float)w[c] + frand(-0.01f, 0.01f);
+        p[(3 + c) * ns] = (float)a[c] + frand(-0.02f, 0.02f);
+        p[(6 + c) * ns] = (float)m[c] + frand(-0.02f, 0.02f);
+      }
+      d[0] = -0.5 * (q[1]*w[0] + q[2]*w[1] + q[3]*w[2]);
+      d[1] = 0.5 * (q[0]*w[0] + q[2]*w[2] - q[3]*w[1]);
+      d[2] = 0.5 * (q[0]*w[1] - q[1]*w[2] + q[3]*w[0]);
+      d[3] = 0.5 * (q[0]*w[2] + q[1]*w[1] - q[2]*w[0]);
+      n = 0.0;
+      for(int c = 0; c < 4; c++){
+        q[c] += d[c] * dt;
+        n += q[c] * q[c];
+      }
+      for(int c = 0; c < 4; c++){
+        q[c] /= sqrt(n);
+      }
+    }
+  }
+
+  printf("%u streams, %u steps of %g s\n", ns, steps, dt);
+  printf("%-9s %14s %14s %8s %10s %10s %9s\n", "accuracy", "Update",
+      "BankUpdate", "speedup", "mean err", "max err", "differ");
+  printf("%-9s %14s %14s %8s %10s %10s\n", "", "(Msamples/s)",
+      "(Msamples/s)", "", "(deg)", "(deg)");
+
+  for(int acc = FAST_MATH_APPROX; acc <= FAST_MATH_NEWTON2; acc++){
+    double t0, tSingle, tBank, errMean = 0.0, errMax = 0.0;
+    uint32_t differ = 0;
+
+    /* One Madgwick_Update per stream and time step */
+    t0 = now_seconds();
+    for(uint32_t s = 0; s < ns; s++){
+      single[s].Beta = 0.2f;
+      single[s].SamplePeriod = dt;
+      single[s].Gravity = 1.0f;
+      single[s].Accuracy = (FastMath_Accuracy_t)acc;
+      Madgwick_Init(&single[s]);
+    }
+    for(uint32_t i = 0; i < steps; i++){
+      const float *p = log + (size_t)9 * ns * i;
+      for(uint32_t s = 0; s < ns; s++){
+        IMU_Data_t data;
+        data.AngVel.x = p[s];
+        data.AngVel.y = p[ns + s];
+        data.AngVel.z = p[2 * ns + s];
+        data.LinAccel.x = p[3 * ns + s];
+        data.LinAccel.y = p[4 * ns + s];
+        data.LinAccel.z = p[5 * ns + s];
+        data.MagField.x = p[6 * ns + s];
+        data.MagField.y = p[7 * ns + s];
+        data.MagField.z = p[8 * ns + s];
+        Madgwick_Update(&data, &single[s], NULL);
+      }
+    }
+    tSingle = now_seconds() - t0;
+
+    /* Every stream at once, one time step after the other */
+    bank.Quat = quat;
+    bank.Beta = 0.2f;
+    bank.SamplePeriod = dt;
+    bank.Accuracy = (FastMath_Accuracy_t)acc;
+    bank.NumStreams = ns;
+    t0 = now_seconds();
+    Madgwick_BankInit(&bank);
+    for(uint32_t i = 0; i < steps; i++){
+      float *p = log + (size_t)9 * ns * i;
+      VectorPlanes_t gyro = {p, p + ns, p + 2 * ns};
+      VectorPlanes_t accel = {p + 3 * ns, p + 4 * ns, p + 5 * ns};
+      VectorPlanes_t mag = {p + 6 * ns, p + 7 * ns, p + 8 * ns};
+      Madgwick_BankUpdate(&gyro, &accel, &mag, &bank);
+    }
+    tBank = now_seconds() - t0;
+
+    for(uint32_t s = 0; s < ns; s++){
+      Madgwick_t stored;
+      double e = attitude_error(single[s].Quat, truth + 4*s);
+      Madgwick_BankStore(s, &stored, &bank);
+      differ += (memcmp(stored.Quat, single[s].Quat, sizeof(stored.Quat)) !=
+          0);
+      errMean += e / ns;
+      errMax = (e > errMax) ? e : errMax;
+    }
+    printf("%-9d %14.2f %14.2f %8.1f %10.3f %10.3f %9u\n", acc,
+        1e-6 * ns * steps / tSingle, 1e-6 * ns * steps / tBank,
+        tSingle / tBank, errMean, errMax, differ);
+  }
+
+  /* A stream taken over from the bank goes on in real time */
+  {
+    AHRS_t ahrs;
+    IMU_Data_t data = {{0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f},
+        {0.6f, 0.0f, -0.8f}, {0.0f, 0.0f, 0.0f}, 0.0f};
+    Madgwick_t filter = {{1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f},
+        0.2f, dt, 1.0f, FAST_MATH_NEWTON1};
+    Madgwick_BankStore(0, &filter, &bank);
+    for(int i = 0; i < 3000; i++){
+      Madgwick_Update(&data, &filter, &ahrs);
+    }
+    printf("\nflat, facing north: roll %.2f pitch %.2f yaw %.2f deg, "
+        "tilt %.2f deg\n", ahrs.AngPos.x * 180.0f / PI_F,
+        ahrs.AngPos.y * 180.0f / PI_F, ahrs.AngPos.z * 180.0f / PI_F,
+        ahrs.Tilt * 180.0f / PI_F);
+  }
+
+  free(log); free(truth); free(quat); free(single);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,223 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+
+#include "matrix_math.h"
+#include "matrix_expr.hpp"
+#include "least_squares.h"
+
+
+/**
+ * Compares chains of matrix_math.h calls, each a pass over memory with a
+ * scratch buffer, against the same chains written as expressions over
+ * linear_algebra::Map, evaluated in one pass without scratch:
+ *  - D = 2*A + B - C on large matrices,
+ *  - the RLS update, also timed against RLS_Compute.
+ * Prints the times and the largest difference between the results. Then
+ * checks that expressions reading their destination inside a product or a
+ * transpose (Cov -= k*(x'*Cov), Cov = Cov') are reported as aliasing, and
+ * the update written with the row x'*Cov assigned first against the calls.
+ */
+using linear_algebra::Map;
+using linear_algebra::Transpose;
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+float frand(float min, float max)
+{
+  return min + (max - min) * ((float)rand() / RAND_MAX);
+}
+
+
+double max_difference(const float *A, const float *B, int n)
+{
+  double d = 0.0;
+  for(int k = 0; k < n; k++){
+    double e = fabs(A[k] - B[k]);
+    d = (e <= d) ? d : e;  /* NaN counts as a difference */
+  }
+  return d;
+}
+
+
+void bench_elementwise(int n, int reps)
+{
+  float *A = new float[n * n], *B = new float[n * n], *C = new float[n * n];
+  float *D1 = new float[n * n], *D2 = new float[n * n];
+  float *aux = new float[n * n];
+  Map a(A, n, n), b(B, n, n), c(C, n, n), d2(D2, n, n);
+  double t0, tCalls, tExpr;
+
+  for(int k = 0; k < n * n; k++){
+    A[k] = frand(-1.0f, 1.0f);
+    B[k] = frand(-1.0f, 1.0f);
+    C[k] = frand(-1.0f, 1.0f);
+    D1[k] = D2[k] = 0.0f;
+  }
+
+  t0 = now_seconds();
+  for(int r = 0; r < reps; r++){
+    ScaleMatrix(A, n, n, 2.0f, aux);
+    AddMatrix(aux, B, n, n, aux);
+    SubtractMatrix(aux, C, n, n, D1);
+  }
+  tCalls = (now_seconds() - t0) / reps;
+
+  t0 = now_seconds();
+  for(int r = 0; r < reps; r++){
+    d2 = 2.0f * a + b - c;
+  }
+  tExpr = (now_seconds() - t0) / reps;
+
+  printf("D = 2*A + B - C, %d x %d\n", n, n);
+  printf("  calls %8.3f ms, expression %8.3f ms, speedup %.2f, "
+      "difference %.3g\n\n", 1e3 * tCalls, 1e3 * tExpr, tCalls / tExpr,
+      max_difference(D1, D2, n * n));
+
+  delete[] A; delete[] B; delete[] C; delete[] D1; delete[] D2;
+  delete[] aux;
+}
+
+
+void bench_rls(int n, int samples)
+{
+  float *inputs = new float[samples * n], *outputs = new float[samples];
+  float *truth = new float[n];
+  float *cov1 = new float[n * n], *cov2 = new float[n * n];
+  float *cov3 = new float[n * n];
+  float *coeffs1 = new float[n], *coeffs2 = new float[n];
+  float *coeffs3 = new float[n];
+  float *gain = new float[n], *aux1 = new float[n * n], *aux2 = new float[n];
+  const float lambda = 0.99f;
+  Map cov(cov2, n, n), coeffs(coeffs2, n, 1), g(gain, n, 1);
+  RLS_t rls = {coeffs3, cov3, new float[n], 0.0f, lambda, (uint32_t)n};
+  double t0, tCalls, tExpr, tRls;
+  float err, alpha;
+
+  srand(n);
+  for(int j = 0; j < n; j++){
+    truth[j] = frand(-1.0f, 1.0f);
+  }
+  for(int i = 0; i < samples; i++){
+    outputs[i] = frand(-0.01f, 0.01f);
+    for(int j = 0; j < n; j++){
+      inputs[i * n + j] = frand(-1.0f, 1.0f);
+      outputs[i] += truth[j] * inputs[i * n + j];
+    }
+  }
+  for(int k = 0; k < n * n; k++){
+    cov1[k] = cov2[k] = cov3[k] = (k % (n + 1) == 0) ? 100.0f : 0.0f;
+  }
+  for(int j = 0; j < n; j++){
+    coeffs1[j] = coeffs2[j] = coeffs3[j] = 0.0f;
+  }
+
+  /* g = cov*x, alpha = 1/(lambda + x'*g), cov = (cov - g*g'*alpha)/lambda, */
+  /*  coeffs = coeffs + g*alpha*erro, one call per step                     */
+  t0 = now_seconds();
+  for(int i = 0; i < samples; i++){
+    float *x = inputs + i * n;
+    DotProduct(coeffs1, x, n, &err);
+    err = outputs[i] - err;
+    MultiplyMatrix(cov1, x, n, n, 1, gain);
+    DotProduct(gain, x, n, &alpha);
+    alpha = 1.0f / (lambda + alpha);
+    MultiplyMatrix(gain, gain, n, 1, n, aux1);
+    ScaleMatrix(aux1, n, n, alpha, aux1);
+    SubtractMatrix(cov1, aux1, n, n, cov1);
+    ScaleMatrix(cov1, n, n, 1.0f / lambda, cov1);
+    ScaleMatrix(gain, n, 1, alpha * err, aux2);
+    AddMatrix(coeffs1, aux2, n, 1, coeffs1);
+  }
+  tCalls = now_seconds() - t0;
+
+  /* Same steps as expressions, no scratch besides the gain */
+  t0 = now_seconds();
+  for(int i = 0; i < samples; i++){
+    Map x(inputs + i * n, n, 1);
+    err = outputs[i] - linear_algebra::Dot(coeffs, x);
+    g = cov * x;
+    alpha = 1.0f / (lambda + linear_algebra::Dot(g, x));
+    cov = (cov - g * Transpose(g) * alpha) / lambda;
+    coeffs += g * (alpha * err);
+  }
+  tExpr = now_seconds() - t0;
+
+  t0 = now_seconds();
+  for(int i = 0; i < samples; i++){
+    RLS_Compute(inputs + i * n, outputs[i], &rls);
+  }
+  tRls = now_seconds() - t0;
+
+  printf("RLS update, %d coefficients\n", n);
+  printf("  calls %8.3f us, expression %8.3f us, RLS_Compute %8.3f us\n",
+      1e6 * tCalls / samples, 1e6 * tExpr / samples, 1e6 * tRls / samples);
+  printf("  difference calls / expression %.3g, expression / RLS_Compute "
+      "%.3g\n\n", max_difference(coeffs1, coeffs2, n),
+      max_difference(coeffs2, coeffs3, n));
+
+  delete[] inputs; delete[] outputs; delete[] truth; delete[] cov1;
+  delete[] cov2; delete[] cov3; delete[] coeffs1; delete[] coeffs2;
+  delete[] coeffs3; delete[] gain; delete[] aux1; delete[] aux2;
+  delete[] rls.Gain;
+}
+
+
+void check_aliasing(int n)
+{
+  float *cov1 = new float[n * n], *cov2 = new float[n * n];
+  float *k = new float[n], *x = new float[n], *row = new float[n];
+  float *row2 = new float[n], *aux = new float[n * n];
+  Map cov(cov2, n, n), km(k, n, 1), xm(x, n, 1), rowm(row2, 1, n);
+  bool detected, fused;
+  double dUpdate;
+
+  for(int j = 0; j < n * n; j++){
+    cov1[j] = cov2[j] = frand(-1.0f, 1.0f);
+  }
+  for(int j = 0; j < n; j++){
+    k[j] = frand(-1.0f, 1.0f);
+    x[j] = frand(-1.0f, 1.0f);
+  }
+
+  detected = (km * (Transpose(xm) * cov)).Aliases(cov) &&
+      Transpose(cov).Aliases(cov) && cov.Block(1, 0, n - 1, n).Aliases(
+      cov.Block(0, 0, n - 1, n));
+  fused = !(cov - km * Transpose(xm) * 2.0f).Aliases(cov);
+
+  MultiplyMatrix(x, cov1, 1, n, n, row);
+  MultiplyMatrix(k, row, n, 1, n, aux);
+  SubtractMatrix(cov1, aux, n, n, cov1);
+  rowm = Transpose(xm) * cov;
+  cov -= km * rowm;
+  dUpdate = max_difference(cov1, cov2, n * n);
+
+  printf("destination read in the expression, %d x %d\n", n, n);
+  printf("  aliasing detected %s, element-wise reads allowed %s, "
+      "difference row = x'*Cov; Cov -= k*row %.3g\n\n",
+      detected ? "yes" : "NO", fused ? "yes" : "NO", dUpdate);
+
+  delete[] cov1; delete[] cov2; delete[] k; delete[] x; delete[] row;
+  delete[] row2; delete[] aux;
+}
+
+
+int main(void) {
+  bench_elementwise(1000, 50);
+  bench_elementwise(4000, 5);
+  bench_rls(16, 20000);
+  bench_rls(64, 5000);
+  check_aliasing(16);
+  return EXIT_SUCCESS;
+}
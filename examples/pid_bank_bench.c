@@ -0,0 +1,121 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+
+#include "pid.h"
+#include "pid_bank.h"
+
+
+/**
+ * Runs banks of controllers with mixed gains, limits, MaxError and zero
+ * setpoints, once by looping PID_Compute over an array of PID_t and once
+ * with PID_BankCompute. Prints millions of controller updates per second
+ * and checks that both give bit-identical outputs.
+ */
+uint32_t sizes[] = {1024, 16384, 262144, 1048576};
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+float frand(float min, float max)
+{
+  return min + (max - min) * ((float)rand() / RAND_MAX);
+}
+
+
+int main(void) {
+  printf("%9s %16s %16s %9s %10s\n", "pids", "PID_Compute", "PID_Bank",
+      "speedup", "identical");
+  printf("%9s %16s %16s\n", "", "(Mupdates/s)", "(Mupdates/s)");
+
+  for(int s = 0; s < (int)(sizeof(sizes)/sizeof(sizes[0])); s++){
+    uint32_t n = sizes[s];
+    PID_t *pids = malloc(sizeof(PID_t) * n);
+    PID_t *init = malloc(sizeof(PID_t) * n);
+    float *inputs[2], *setpoints, *out1, *out2;
+    float *state = malloc(sizeof(float) * n * 9);
+    PID_Bank_t bank;
+    double t0, tLoop, tBank;
+    int ticks, identical = 1;
+
+    inputs[0] = malloc(sizeof(float) * n);
+    inputs[1] = malloc(sizeof(float) * n);
+    setpoints = malloc(sizeof(float) * n);
+    out1 = malloc(sizeof(float) * n);
+    out2 = malloc(sizeof(float) * n);
+
+    bank.Error1 = state;
+    bank.Error2 = state + n;
+    bank.Uk1 = state + 2*n;
+    bank.Coeff0 = state + 3*n;
+    bank.Coeff1 = state + 4*n;
+    bank.Coeff2 = state + 5*n;
+    bank.PidMax = state + 6*n;
+    bank.PidMin = state + 7*n;
+    bank.MaxError = state + 8*n;
+    bank.NumPid = n;
+
+    srand(n);
+    for(uint32_t i = 0; i < n; i++){
+      PID_Init(frand(0.1f, 2.0f), frand(0.0f, 1.0f), frand(0.0f, 0.1f),
+          0.001f, &init[i]);
+      PID_SetLimits(frand(1.0f, 10.0f), frand(-10.0f, -1.0f), &init[i]);
+      PID_SetMaxError((i % 3 == 0) ? 0.0f : frand(0.0f, 0.2f), &init[i]);
+      setpoints[i] = (i % 7 == 0) ? 0.0f : frand(-1.0f, 1.0f);
+      inputs[0][i] = (i % 5 == 0) ? setpoints[i] : frand(-1.0f, 1.0f);
+      inputs[1][i] = (i % 11 == 0) ? setpoints[i] : frand(-1.0f, 1.0f);
+    }
+
+    /* Same sequence of ticks through both paths */
+    memcpy(pids, init, sizeof(PID_t) * n);
+    for(uint32_t i = 0; i < n; i++){
+      PID_BankLoad(i, &init[i], &bank);
+    }
+    for(int t = 0; t < 50; t++){
+      for(uint32_t i = 0; i < n; i++){
+        out1[i] = PID_Compute(inputs[t & 1][i], setpoints[i], &pids[i]);
+      }
+      PID_BankCompute(inputs[t & 1], setpoints, out2, &bank);
+      if(memcmp(out1, out2, sizeof(float) * n) != 0){
+        identical = 0;
+      }
+    }
+
+    ticks = 0;
+    t0 = now_seconds();
+    do{
+      for(uint32_t i = 0; i < n; i++){
+        out1[i] = PID_Compute(inputs[ticks & 1][i], setpoints[i], &pids[i]);
+      }
+      ticks++;
+    }while(now_seconds() - t0 < 0.5);
+    tLoop = (now_seconds() - t0) / ((double)ticks * n);
+
+    ticks = 0;
+    t0 = now_seconds();
+    do{
+      PID_BankCompute(inputs[ticks & 1], setpoints, out2, &bank);
+      ticks++;
+    }while(now_seconds() - t0 < 0.5);
+    tBank = (now_seconds() - t0) / ((double)ticks * n);
+
+    printf("%9u %16.1f %16.1f %8.2fx %10s\n", n, 1e-6 / tLoop, 1e-6 / tBank,
+        tLoop / tBank, identical ? "yes" : "NO");
+
+    free(pids); free(init); free(state); free(inputs[0]); free(inputs[1]);
+    free(setpoints); free(out1); free(out2);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+
+#include "pid.h"
+#include "pid_scheduler.h"
+
+
+/**
+ * Steps a bank of controllers (default 2^20) at a fixed rate (default
+ * 5 ms) with 1, 2, 4, ... threads up to the number of online processors.
+ * Checks that the outputs are bit-identical to looping PID_Compute, then
+ * prints the tick latency percentiles and the deadline misses.
+ *
+ * Usage: pid_scheduler_bench [controllers] [period in ms] [ticks]
+ */
+
+
+float frand(float min, float max)
+{
+  return min + (max - min) * ((float)rand() / RAND_MAX);
+}
+
+
+int main(int argc, char **argv) {
+  uint32_t n = (argc > 1) ? (uint32_t)atol(argv[1]) : (1u << 20);
+  float period = (argc > 2) ? (float)atof(argv[2]) * 1e-3f : 5e-3f;
+  int ticks = (argc > 3) ? atoi(argv[3]) : 400;
+  PID_t *pids = malloc(sizeof(PID_t) * n);
+  PID_t *serial = malloc(sizeof(PID_t) * n);
+  float *inputs = malloc(sizeof(float) * n);
+  float *setpoints = malloc(sizeof(float) * n);
+  float *out1 = malloc(sizeof(float) * n);
+  float *out2 = malloc(sizeof(float) * n);
+  PID_Scheduler_t sched;
+  PID_SchedulerStats_t stats;
+  uint32_t maxThreads;
+
+  srand(1);
+  for(uint32_t i = 0; i < n; i++){
+    PID_Init(frand(0.1f, 2.0f), frand(0.0f, 1.0f), frand(0.0f, 0.1f),
+        period, &pids[i]);
+    PID_SetLimits(frand(1.0f, 10.0f), frand(-10.0f, -1.0f), &pids[i]);
+    PID_SetMaxError((i % 3 == 0) ? 0.0f : frand(0.0f, 0.2f), &pids[i]);
+    setpoints[i] = (i % 7 == 0) ? 0.0f : frand(-1.0f, 1.0f);
+  }
+
+  /* One thread per processor, only to learn how many there are */
+  memset(&sched, 0, sizeof(sched));
+  sched.NumPid = n;
+  sched.FirstCpu = -1;
+  if(PID_SchedulerInit(&sched) == 0){
+    printf("Could not start the scheduler\n");
+    return EXIT_FAILURE;
+  }
+  maxThreads = sched.NumThreads;
+  PID_SchedulerDeInit(&sched);
+
+  printf("%u controllers, period %.2f ms, %d ticks\n\n", n, period * 1e3,
+      ticks);
+  printf("%8s %10s %10s %10s %10s %10s %8s %9s\n", "threads", "p50 (us)",
+      "p90 (us)", "p99 (us)", "p99.9 (us)", "max (us)", "misses",
+      "identical");
+
+  for(uint32_t t = 1; ; t *= 2){
+    int identical = 1;
+
+    if(t > maxThreads){
+      t = maxThreads;
+    }
+    memset(&sched, 0, sizeof(sched));
+    sched.NumPid = n;
+    sched.NumThreads = t;
+    sched.FirstCpu = 0;
+    sched.Period = period;
+    if(PID_SchedulerInit(&sched) == 0){
+      printf("Could not start the scheduler\n");
+      return EXIT_FAILURE;
+    }
+    memcpy(serial, pids, sizeof(PID_t) * n);
+    for(uint32_t i = 0; i < n; i++){
+      PID_SchedulerLoad(i, &pids[i], &sched);
+    }
+
+    for(int k = 0; k < ticks; k++){
+      /* Plant outputs of this tick, outside the timed section */
+      for(uint32_t i = 0; i < n; i++){
+        inputs[i] = (i % 5 == (uint32_t)k % 5) ? setpoints[i] :
+            0.5f * out2[i] * (k > 0) + 0.01f * (float)(k % 13);
+      }
+      PID_SchedulerWait(&sched);
+      PID_SchedulerTick(inputs, setpoints, out2, &sched);
+
+      if(k < 20){
+        for(uint32_t i = 0; i < n; i++){
+          out1[i] = PID_Compute(inputs[i], setpoints[i], &serial[i]);
+        }
+        if(memcmp(out1, out2, sizeof(float) * n) != 0){
+          identical = 0;
+        }
+      }
+    }
+
+    PID_SchedulerGetStats(&stats, &sched);
+    printf("%8u %10.1f %10.1f %10.1f %10.1f %10.1f %8llu %9s\n",
+        sched.NumThreads, stats.Percentile50 * 1e6, stats.Percentile90 * 1e6,
+        stats.Percentile99 * 1e6, stats.Percentile999 * 1e6, stats.Max * 1e6,
+        (unsigned long long)stats.DeadlineMisses, identical ? "yes" : "NO");
+    PID_SchedulerDeInit(&sched);
+
+    if(t == maxThreads){
+      break;
+    }
+  }
+
+  free(pids); free(serial); free(inputs); free(setpoints);
+  free(out1); free(out2);
+  return EXIT_SUCCESS;
+}
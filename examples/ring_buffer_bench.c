@@ -0,0 +1,319 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+
+#include "custom_types.h"
+#include "ring_buffer.h"
+#include "least_squares.h"
+
+
+/**
+ * Moves samples from acquisition threads to a thread identifying a model
+ * with RLS_Compute, through a ring guarded by a mutex and through the
+ * lock-free RingSPSC_t (one producer) and RingMPSC_t (two producers). The
+ * consumer runs RLS_Compute on the records in place (Peek / Release) for
+ * the lock-free rings. Prints the samples per second, the time spent in a
+ * push call (median, 99.9th percentile and largest) and whether every
+ * sample arrived once and in order. Then prints the cost of a push and a
+ * pop of an IMU_Data_t on a single thread, one by one and in batches.
+ *
+ * Usage: ring_buffer_bench [samples]
+ */
+
+
+#define CAPACITY 1024
+#define BATCH 32
+
+
+/* Regressor and output, tagged by its producer */
+typedef struct
+{
+  float Inputs[4];
+  float Output;
+  uint32_t Producer;
+  uint32_t Seq;
+}Sample_t;
+
+
+/* The ring this bench replaces: a deque behind a mutex */
+typedef struct
+{
+  pthread_mutex_t Lock;
+  Sample_t *Data;
+  size_t Head, Tail;
+}MutexRing_t;
+
+
+EStatus_t mutex_push(MutexRing_t *Ring, const Sample_t *Sample)
+{
+  EStatus_t status = ERR_OVERFLOW;
+  pthread_mutex_lock(&Ring->Lock);
+  if(Ring->Head - Ring->Tail < CAPACITY){
+    Ring->Data[Ring->Head++ % CAPACITY] = *Sample;
+    status = ANSWERED_REQUEST;
+  }
+  pthread_mutex_unlock(&Ring->Lock);
+  return status;
+}
+
+
+EStatus_t mutex_pop(MutexRing_t *Ring, Sample_t *Sample)
+{
+  EStatus_t status = OPERATION_IDLE;
+  pthread_mutex_lock(&Ring->Lock);
+  if(Ring->Head != Ring->Tail){
+    *Sample = Ring->Data[Ring->Tail++ % CAPACITY];
+    status = ANSWERED_REQUEST;
+  }
+  pthread_mutex_unlock(&Ring->Lock);
+  return status;
+}
+
+
+typedef enum {KIND_MUTEX, KIND_SPSC, KIND_MPSC} Kind_t;
+
+
+typedef struct
+{
+  Kind_t Kind;
+  MutexRing_t *Mutex;
+  RingSPSC_t *Spsc;
+  RingMPSC_t *Mpsc;
+  uint32_t Producer;
+  uint32_t Count;
+  uint32_t *PushNs;     /* Time of each push call */
+}Producer_t;
+
+
+uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+
+void *producer(void *Arg)
+{
+  Producer_t *p = Arg;
+  Sample_t s;
+  const float coeffs[4] = {0.5f, -1.0f, 0.25f, 2.0f};
+  uint32_t seed = p->Producer + 1;
+
+  for(uint32_t i = 0; i < p->Count; i++){
+    EStatus_t status;
+    s.Output = 0.0f;
+    for(int k = 0; k < 4; k++){
+      seed = seed * 1664525u + 1013904223u;
+      s.Inputs[k] = (float)(seed >> 8) / (1 << 24) - 0.5f;
+      s.Output += coeffs[k] * s.Inputs[k];
+    }
+    s.Producer = p->Producer;
+    s.Seq = i;
+    do{
+      uint64_t t0 = now_ns();
+      switch(p->Kind){
+        case KIND_MUTEX: status = mutex_push(p->Mutex, &s); break;
+        case KIND_SPSC: status = RingSPSC_Push(p->Spsc, &s); break;
+        default: status = RingMPSC_Push(p->Mpsc, &s); break;
+      }
+      p->PushNs[i] = (uint32_t)(now_ns() - t0);
+      if(status == ERR_OVERFLOW){
+        sched_yield();
+      }
+    }while(status == ERR_OVERFLOW);
+  }
+  return NULL;
+}
+
+
+int compare_u32(const void *A, const void *B)
+{
+  uint32_t a = *(const uint32_t *)A, b = *(const uint32_t *)B;
+  return (a > b) - (a < b);
+}
+
+
+void pipeline(Kind_t Kind, uint32_t NumProducers, uint32_t Samples)
+{
+  static const char *names[] = {"mutex", "RingSPSC_t", "RingMPSC_t"};
+  static _Alignas(RING_BUFFER_ALIGN) RingSPSC_t spsc;
+  static _Alignas(RING_BUFFER_ALIGN) RingMPSC_t mpsc;
+  MutexRing_t mutex;
+  Producer_t prod[2];
+  pthread_t threads[2];
+  uint32_t next[2] = {0, 0};
+  uint32_t perProducer = Samples / NumProducers;
+  uint32_t total = perProducer * NumProducers, received = 0, errors = 0;
+  void *buffer = aligned_alloc(RING_BUFFER_ALIGN,
+      RING_MPSC_BUFFER_SIZE(sizeof(Sample_t), CAPACITY));
+  uint32_t *pushNs = malloc(sizeof(uint32_t) * total);
+  float sysCoeffs[4] = {0}, cov[16] = {0}, gain[4];
+  RLS_t rls = {sysCoeffs, cov, gain, 0.0f, 0.0f, 4};
+  uint64_t t0, elapsed;
+
+  for(int k = 0; k < 4; k++){
+    cov[k * 4 + k] = 1000.0f;
+  }
+  pthread_mutex_init(&mutex.Lock, NULL);
+  mutex.Data = buffer;
+  mutex.Head = mutex.Tail = 0;
+  RingSPSC_Init(&spsc, buffer, sizeof(Sample_t), CAPACITY);
+  RingMPSC_Init(&mpsc, buffer, sizeof(Sample_t), CAPACITY);
+
+  t0 = now_ns();
+  for(uint32_t p = 0; p < NumProducers; p++){
+    prod[p] = (Producer_t){Kind, &mutex, &spsc, &mpsc, p, perProducer,
+        pushNs + p * perProducer};
+    pthread_create(&threads[p], NULL, producer, &prod[p]);
+  }
+
+  while(received < total){
+    Sample_t one, *run = &one;
+    size_t count = 0;
+    EStatus_t status;
+    switch(Kind){
+      case KIND_MUTEX:
+        status = mutex_pop(&mutex, &one);
+        count = (status == ANSWERED_REQUEST) ? 1 : 0;
+        break;
+      case KIND_SPSC:
+        status = RingSPSC_Peek(&spsc, (void **)&run, &count);
+        break;
+      default:
+        status = RingMPSC_Peek(&mpsc, (void **)&run, &count);
+        break;
+    }
+    if(status == OPERATION_IDLE){
+      sched_yield();
+      continue;
+    }
+    /* Identification straight from the slots */
+    for(size_t i = 0; i < count; i++){
+      errors += (run[i].Seq != next[run[i].Producer]);
+      next[run[i].Producer] = run[i].Seq + 1;
+      RLS_Compute(run[i].Inputs, run[i].Output, &rls);
+    }
+    if(Kind == KIND_SPSC){
+      RingSPSC_Release(&spsc, count);
+    }else if(Kind == KIND_MPSC){
+      RingMPSC_Release(&mpsc, count);
+    }
+    received += count;
+  }
+  elapsed = now_ns() - t0;
+  for(uint32_t p = 0; p < NumProducers; p++){
+    pthread_join(threads[p], NULL);
+  }
+
+  qsort(pushNs, total, sizeof(uint32_t), compare_u32);
+  printf("%-12s %9u %12.2f %10u %10u %10u %8s %8.3f\n", names[Kind],
+      NumProducers, 1e3 * total / elapsed, pushNs[total / 2],
+      pushNs[(uint32_t)(total * 0.999)], pushNs[total - 1],
+      (errors == 0) ? "yes" : "NO", rls.SysCoeffs[3]);
+
+  pthread_mutex_destroy(&mutex.Lock);
+  free(buffer);
+  free(pushNs);
+}
+
+
+int main(int argc, char **argv) {
+  uint32_t samples = (argc > 1) ? (uint32_t)atol(argv[1]) : 2000000;
+  static _Alignas(RING_BUFFER_ALIGN) RingSPSC_t spsc;
+  static _Alignas(RING_BUFFER_ALIGN) RingMPSC_t mpsc;
+  IMU_Data_t *in = calloc(BATCH, sizeof(IMU_Data_t));
+  IMU_Data_t *out = calloc(BATCH, sizeof(IMU_Data_t));
+  void *buffer = aligned_alloc(RING_BUFFER_ALIGN,
+      RING_MPSC_BUFFER_SIZE(sizeof(IMU_Data_t), CAPACITY));
+  MutexRing_t mutex;
+  uint64_t t0;
+  double tMutex, tSpsc, tMpsc, tSpscBatch, tMpscBatch;
+  int ok;
+
+  printf("%u samples, RLS_Compute on each, %d slots\n", samples, CAPACITY);
+  printf("%-12s %9s %12s %10s %10s %10s %8s %8s\n", "ring", "producers",
+      "Msamples/s", "push ns", "99.9%", "max", "ordered", "coeff 3");
+  pipeline(KIND_MUTEX, 1, samples);
+  pipeline(KIND_SPSC, 1, samples);
+  pipeline(KIND_MUTEX, 2, samples);
+  pipeline(KIND_MPSC, 2, samples);
+
+  /* Single thread, IMU_Data_t records */
+  pthread_mutex_init(&mutex.Lock, NULL);
+  mutex.Data = malloc(sizeof(Sample_t) * CAPACITY);
+  mutex.Head = mutex.Tail = 0;
+  RingSPSC_Init(&spsc, buffer, sizeof(IMU_Data_t), CAPACITY);
+  t0 = now_ns();
+  for(uint32_t i = 0; i < samples; i++){
+    Sample_t s = {{0}, (float)i, 0, i};
+    mutex_push(&mutex, &s);
+    mutex_pop(&mutex, &s);
+  }
+  tMutex = (double)(now_ns() - t0) / samples;
+  t0 = now_ns();
+  for(uint32_t i = 0; i < samples; i++){
+    in[0].Temperature = (float)i;
+    RingSPSC_Push(&spsc, in);
+    RingSPSC_Pop(&spsc, out);
+  }
+  tSpsc = (double)(now_ns() - t0) / samples;
+  t0 = now_ns();
+  for(uint32_t i = 0; i < samples; i += BATCH){
+    RingSPSC_PushBatch(&spsc, in, BATCH);
+    RingSPSC_PopBatch(&spsc, out, BATCH, NULL);
+  }
+  tSpscBatch = (double)(now_ns() - t0) / samples;
+  RingMPSC_Init(&mpsc, buffer, sizeof(IMU_Data_t), CAPACITY);
+  t0 = now_ns();
+  for(uint32_t i = 0; i < samples; i++){
+    in[0].Temperature = (float)i;
+    RingMPSC_Push(&mpsc, in);
+    RingMPSC_Pop(&mpsc, out);
+  }
+  tMpsc = (double)(now_ns() - t0) / samples;
+  t0 = now_ns();
+  for(uint32_t i = 0; i < samples; i += BATCH){
+    RingMPSC_PushBatch(&mpsc, in, BATCH);
+    RingMPSC_PopBatch(&mpsc, out, BATCH, NULL);
+  }
+  tMpscBatch = (double)(now_ns() - t0) / samples;
+
+  printf("\nsingle thread, ns per record (IMU_Data_t, batches of %d)\n",
+      BATCH);
+  printf("%-12s %10s %10s\n", "ring", "one by one", "batches");
+  printf("%-12s %10.1f %10s\n", "mutex", tMutex, "-");
+  printf("%-12s %10.1f %10.1f\n", "RingSPSC_t", tSpsc, tSpscBatch);
+  printf("%-12s %10.1f %10.1f\n", "RingMPSC_t", tMpsc, tMpscBatch);
+
+  /* Smallest rings: one slot can not tell a published record from a */
+  /*  slot free for the next lap, two slots fill, overflow and drain  */
+  ok = (RingMPSC_Init(&mpsc, buffer, sizeof(IMU_Data_t), 1) ==
+      ERR_PARAM_VALUE);
+  ok &= (RingMPSC_Init(&mpsc, buffer, sizeof(IMU_Data_t), 2) ==
+      ANSWERED_REQUEST);
+  for(uint32_t i = 0; i < 3; i++){
+    in[i].Temperature = (float)i;
+  }
+  ok &= (RingMPSC_Push(&mpsc, &in[0]) == ANSWERED_REQUEST);
+  ok &= (RingMPSC_Push(&mpsc, &in[1]) == ANSWERED_REQUEST);
+  ok &= (RingMPSC_Push(&mpsc, &in[2]) == ERR_OVERFLOW);
+  ok &= (RingMPSC_Pop(&mpsc, out) == ANSWERED_REQUEST);
+  ok &= (out[0].Temperature == 0.0f);
+  ok &= (RingMPSC_Pop(&mpsc, out) == ANSWERED_REQUEST);
+  ok &= (out[0].Temperature == 1.0f);
+  ok &= (RingMPSC_Pop(&mpsc, out) == OPERATION_IDLE);
+  printf("\nRingMPSC_t of 1 slot rejected, of 2 slots in order: %s\n",
+      ok ? "yes" : "NO");
+
+  pthread_mutex_destroy(&mutex.Lock);
+  free(mutex.Data); free(in); free(out); free(buffer);
+  return EXIT_SUCCESS;
+}
@@ -22,11 +22,10 @@ float outputs[14] = {                   /* y(t) */
     0.9, 1.4, 1.9, 2.3, 2.4, 2.3, 1.3, 1.2,
 };
 float sumYiXji[2];
-float sumXkiXji[14 * 2];
+float sumXkiXji[2 * 2];
 float coeffs[2];
 float coeffs_2[2] = {0.0, 0.0};
 float cov[2 * 2] = {1000.0, 0.0, 0.0, 1000.0};
-float aux_1[2], aux_2[2*2];
 float gain[2];
 
 int main(void) {
@@ -42,8 +41,6 @@ int main(void) {
       .SysCoeffs = coeffs_2,
       .Cov = cov,
       .Gain = gain,
-      .Aux1 = aux_1,
-      .Aux2 = aux_2,
   };
 
 
@@ -58,6 +55,7 @@ int main(void) {
   printf("\nFinding coefficients for an unknown difference equation of the form  y(t) = b0u(t) + b1u(t-1) using RLS\n");
   for(int i = 0; i < 14; i++){
     RLS_Compute(&inputs[i][0], outputs[i], &RLS);
+    RLS_MirrorCov(&RLS);
     printf("Iteration %d: b0 = %f, b1 = %f, cov matrix: [%f %f; %f %f]\n", i, coeffs_2[0], coeffs_2[1], cov[0], cov[1], cov[2], cov[3]);
   }
   printf("\n\n\n");
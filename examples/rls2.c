@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 
 
 #include "least_squares.h"
@@ -22,7 +23,6 @@ float inputs[5];
 float outputs = 0.0;
 float coeffs[5];
 float cov[5 * 5];
-float aux_1[5], aux_2[5 * 5];
 float gain[5];
 
 
@@ -47,8 +47,6 @@ int main(void) {
       .SysCoeffs = coeffs,
       .Cov = cov,
       .Gain = gain,
-      .Aux1 = aux_1,
-      .Aux2 = aux_2,
   };
 
   memset(inputs, 0, sizeof(inputs));
@@ -0,0 +1,139 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+
+#include "least_squares.h"
+#include "rls_bank.h"
+
+
+/**
+ * Identifies banks of independent ARX-like models, one per channel, once
+ * by looping RLS_Compute over separately allocated RLS_t and once with
+ * RLS_BankCompute. Prints millions of filter updates per second and the
+ * largest coefficient difference between both paths.
+ */
+uint32_t numCoeffs[] = {2, 4, 8};
+uint32_t numFilters = 4096;
+uint32_t numSteps = 200;
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+float frand(float min, float max)
+{
+  return min + (max - min) * ((float)rand() / RAND_MAX);
+}
+
+
+int main(void) {
+  printf("%6s %9s %16s %16s %9s %12s\n", "coeffs", "filters", "RLS_Compute",
+      "RLS_Bank", "speedup", "difference");
+  printf("%6s %9s %16s %16s\n", "", "", "(Mupdates/s)", "(Mupdates/s)");
+
+  for(int s = 0; s < (int)(sizeof(numCoeffs)/sizeof(numCoeffs[0])); s++){
+    uint32_t n = numCoeffs[s];
+    uint32_t nf = numFilters;
+    uint32_t st = RLS_BANK_STRIDE(nf);
+    RLS_t *rls = malloc(sizeof(RLS_t) * nf);
+    RLS_t stored;
+    RLS_Bank_t bank;
+    float *truth = malloc(sizeof(float) * n * nf);
+    float *inputs = malloc(sizeof(float) * n * st * numSteps);
+    float *outputs = malloc(sizeof(float) * nf * numSteps);
+    float *x = malloc(sizeof(float) * n);
+    float *state = malloc(sizeof(float) * (RLS_BANK_COV_SIZE(n, st) +
+        2*n*st + 2*nf));
+    float coeffs[8], gain[8], cov[64];
+    double t0, tLoop, tBank, diff = 0.0;
+
+    bank.SysCoeffs = state;
+    bank.Gain = state + n*st;
+    bank.Error = state + 2*n*st;
+    bank.Lambda = bank.Error + nf;
+    bank.Cov = bank.Lambda + nf;
+    bank.NumCoeff = n;
+    bank.NumFilters = nf;
+    bank.Stride = st;
+
+    /* Every filter in its own allocations, as an array of RLS_t would be */
+    srand(n);
+    for(uint32_t f = 0; f < nf; f++){
+      rls[f].SysCoeffs = calloc(n, sizeof(float));
+      rls[f].Cov = calloc(n * n, sizeof(float));
+      rls[f].Gain = calloc(n, sizeof(float));
+      rls[f].Error = 0.0f;
+      rls[f].Lambda = (f % 2 == 0) ? 0.0f : 0.99f;
+      rls[f].NumCoeff = n;
+      for(uint32_t k = 0; k < n; k++){
+        rls[f].Cov[k * n + k] = 1000.0f;
+        truth[f * n + k] = frand(-1.0f, 1.0f);
+      }
+      RLS_BankLoad(f, &rls[f], &bank);
+    }
+
+    /* Samples stored interleaved, step by step */
+    for(uint32_t t = 0; t < numSteps; t++){
+      float *in = inputs + (size_t)t * n * st;
+      for(uint32_t f = 0; f < nf; f++){
+        float y = 0.0f;
+        for(uint32_t k = 0; k < n; k++){
+          in[k * st + f] = frand(-1.0f, 1.0f);
+          y += truth[f * n + k] * in[k * st + f];
+        }
+        outputs[t * nf + f] = y + frand(-0.01f, 0.01f);
+      }
+    }
+
+    t0 = now_seconds();
+    for(uint32_t t = 0; t < numSteps; t++){
+      float *in = inputs + (size_t)t * n * st;
+      for(uint32_t f = 0; f < nf; f++){
+        for(uint32_t k = 0; k < n; k++){
+          x[k] = in[k * st + f];
+        }
+        RLS_Compute(x, outputs[t * nf + f], &rls[f]);
+      }
+    }
+    tLoop = now_seconds() - t0;
+
+    t0 = now_seconds();
+    for(uint32_t t = 0; t < numSteps; t++){
+      RLS_BankCompute(inputs + (size_t)t * n * st, outputs + t * nf, &bank);
+    }
+    tBank = now_seconds() - t0;
+
+    stored.SysCoeffs = coeffs;
+    stored.Gain = gain;
+    stored.Cov = cov;
+    for(uint32_t f = 0; f < nf; f++){
+      RLS_BankStore(f, &stored, &bank);
+      for(uint32_t k = 0; k < n; k++){
+        double d = fabs(coeffs[k] - rls[f].SysCoeffs[k]);
+        diff = (d > diff) ? d : diff;
+      }
+    }
+
+    printf("%6u %9u %16.1f %16.1f %9.2f %12.3g\n", n, nf,
+        1e-6 * nf * numSteps / tLoop, 1e-6 * nf * numSteps / tBank,
+        tLoop / tBank, diff);
+
+    for(uint32_t f = 0; f < nf; f++){
+      free(rls[f].SysCoeffs); free(rls[f].Cov); free(rls[f].Gain);
+    }
+    free(rls); free(truth); free(inputs); free(outputs); free(x);
+    free(state);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,177 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+
+#include "least_squares.h"
+
+
+/**
+ * Compares, on the same data, the classic RLS (infinite memory), the RLS
+ * with a forgetting factor and the UD factorized RLS.
+ * Usage: rls_bench [number of samples] [number of coefficients]
+ * Defaults to 10^8 samples of a 5 coefficients model.
+ */
+#define MAX_COEFF 64
+#define FORGETTING_FACTOR 0.9999
+#define BLOCK 1024
+
+
+enum { CLASSIC, FORGETTING, UD, NUMBER_OF_FILTERS };
+const char *names[NUMBER_OF_FILTERS] = {
+    "RLS lambda = 1", "RLS lambda < 1", "UD RLS lambda < 1"
+};
+
+
+uint32_t seed;
+float coeffsTrue[MAX_COEFF];
+float inputs[BLOCK][MAX_COEFF];
+float outputs[BLOCK];
+float coeffs[NUMBER_OF_FILTERS][MAX_COEFF];
+float gain[NUMBER_OF_FILTERS][MAX_COEFF];
+float cov[2][MAX_COEFF * MAX_COEFF];
+float ud[MAX_COEFF * (MAX_COEFF + 1) / 2];
+
+
+/* Uniform value in [-0.5, 0.5), cheap enough not to hide the filters */
+float uniform(void)
+{
+  seed = seed * 1664525u + 1013904223u;
+  return (float)(seed >> 8) / 16777216.0f - 0.5f;
+}
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/* Largest distance between estimated and true coefficients */
+float coeff_error(float *c, uint32_t n)
+{
+  float err = 0.0;
+  for(uint32_t i = 0; i < n; i++){
+    if(fabsf(c[i] - coeffsTrue[i]) > err){
+      err = fabsf(c[i] - coeffsTrue[i]);
+    }
+  }
+  return err;
+}
+
+
+/* Smallest diagonal element of the covariance (D for the UD filter) */
+float min_diagonal(int filter, uint32_t n)
+{
+  float m = INFINITY;
+  for(uint32_t i = 0; i < n; i++){
+    float d = (filter == UD) ? ud[i * (i + 1) / 2 + i] :
+        cov[filter][i * n + i];
+    if(d < m){
+      m = d;
+    }
+  }
+  return m;
+}
+
+
+int main(int argc, char *argv[]) {
+  uint64_t numSamples = 100000000ULL;
+  uint32_t numCoeff = 5;
+
+  if(argc > 1){
+    numSamples = strtoull(argv[1], NULL, 10);
+  }
+  if(argc > 2){
+    numCoeff = (uint32_t)atoi(argv[2]);
+    if(numCoeff < 1 || numCoeff > MAX_COEFF){
+      printf("Number of coefficients must be between 1 and %d\n", MAX_COEFF);
+      return EXIT_FAILURE;
+    }
+  }
+
+  seed = 12345;
+  for(uint32_t i = 0; i < numCoeff; i++){
+    coeffsTrue[i] = 4.0f * uniform();
+  }
+
+  printf("%llu samples, %u coefficients, forgetting factor %g\n\n",
+      (unsigned long long)numSamples, numCoeff, FORGETTING_FACTOR);
+  printf("%-18s %12s %12s %14s %14s\n", "filter", "samples", "ns/update",
+      "coeff error", "min diag cov");
+
+  for(int filter = 0; filter < NUMBER_OF_FILTERS; filter++){
+    RLS_t rls = {
+        .NumCoeff = numCoeff,
+        .SysCoeffs = coeffs[filter],
+        .Cov = cov[filter < UD ? filter : 0],
+        .Gain = gain[filter],
+        .Lambda = (filter == CLASSIC) ? 1.0 : FORGETTING_FACTOR,
+    };
+    RLS_UD_t rlsUd = {
+        .NumCoeff = numCoeff,
+        .SysCoeffs = coeffs[filter],
+        .UD = ud,
+        .Gain = gain[filter],
+        .Lambda = FORGETTING_FACTOR,
+    };
+    uint64_t checkpoint = 1000;
+    double elapsed = 0.0, t0;
+
+    memset(coeffs[filter], 0, sizeof(coeffs[filter]));
+    if(filter == UD){
+      RLS_UD_Init(1000.0, &rlsUd);
+    }else{
+      memset(rls.Cov, 0, sizeof(cov[0]));
+      for(uint32_t i = 0; i < numCoeff; i++){
+        rls.Cov[i * numCoeff + i] = 1000.0;
+      }
+    }
+
+    /* Every filter sees the same stream of samples. They are generated in */
+    /*  blocks, out of the timed section.                                  */
+    seed = 67890;
+    for(uint64_t s = 0; s < numSamples; s += BLOCK){
+      uint32_t count = (numSamples - s < BLOCK) ? numSamples - s : BLOCK;
+      for(uint32_t b = 0; b < count; b++){
+        outputs[b] = 0.001f * uniform();
+        for(uint32_t i = 0; i < numCoeff; i++){
+          inputs[b][i] = uniform();
+          outputs[b] += coeffsTrue[i] * inputs[b][i];
+        }
+      }
+
+      t0 = now_seconds();
+      if(filter == UD){
+        for(uint32_t b = 0; b < count; b++){
+          RLS_UD_Compute(inputs[b], outputs[b], &rlsUd);
+        }
+      }else{
+        for(uint32_t b = 0; b < count; b++){
+          RLS_Compute(inputs[b], outputs[b], &rls);
+        }
+      }
+      elapsed += now_seconds() - t0;
+
+      if(s + count >= checkpoint || s + count == numSamples){
+        printf("%-18s %12llu %12.1f %14.3g %14.3g\n", names[filter],
+            (unsigned long long)(s + count), elapsed / (s + count) * 1e9,
+            coeff_error(coeffs[filter], numCoeff),
+            min_diagonal(filter, numCoeff));
+        while(checkpoint <= s + count){
+          checkpoint *= 10;
+        }
+      }
+    }
+    printf("\n");
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+
+#include "least_squares.h"
+#include "least_squares.hpp"
+#include "pid.h"
+#include "pid.hpp"
+
+
+/**
+ * Times one RLS update of RLS_Compute (sizes passed at runtime) against
+ * RLS<N> (sizes known at compile time) for a few small N, on the same
+ * data, and prints the largest difference between their coefficients.
+ * Then does the same for PID_Compute against PID<float>.
+ */
+#define SAMPLES 4096
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+template<size_t N>
+void bench_rls(void)
+{
+  static float inputs[SAMPLES][N];
+  static float outputs[SAMPLES];
+  float coeffs[N], cov[N * N], gain[N], truth[N];
+  sys_identification::RLS<N> fixed;
+  RLS_t rls;
+  double t0, tC, tFixed;
+  long updates;
+  float diff = 0.0f;
+
+  srand(N);
+  for(size_t j = 0; j < N; j++){
+    truth[j] = (float)rand() / RAND_MAX - 0.5f;
+  }
+  for(int k = 0; k < SAMPLES; k++){
+    outputs[k] = 0.0f;
+    for(size_t j = 0; j < N; j++){
+      inputs[k][j] = (float)rand() / RAND_MAX - 0.5f;
+      outputs[k] += truth[j] * inputs[k][j];
+    }
+    outputs[k] += 1e-3f * ((float)rand() / RAND_MAX - 0.5f);
+  }
+
+  rls.SysCoeffs = coeffs;
+  rls.Cov = cov;
+  rls.Gain = gain;
+  rls.Lambda = 0.999f;
+  rls.NumCoeff = N;
+  memset(coeffs, 0, sizeof(coeffs));
+  memset(cov, 0, sizeof(cov));
+  for(size_t j = 0; j < N; j++){
+    cov[j * N + j] = 1000.0f;
+  }
+  fixed.Init(1000.0f, 0.999f);
+
+  updates = 0;
+  t0 = now_seconds();
+  do{
+    for(int k = 0; k < SAMPLES; k++){
+      RLS_Compute(inputs[k], outputs[k], &rls);
+    }
+    updates += SAMPLES;
+  }while(now_seconds() - t0 < 0.3);
+  tC = (now_seconds() - t0) / updates;
+
+  updates = 0;
+  t0 = now_seconds();
+  do{
+    for(int k = 0; k < SAMPLES; k++){
+      fixed.Compute(inputs[k], outputs[k]);
+    }
+    updates += SAMPLES;
+  }while(now_seconds() - t0 < 0.3);
+  tFixed = (now_seconds() - t0) / updates;
+
+  for(size_t j = 0; j < N; j++){
+    if(fabsf(coeffs[j] - fixed.SysCoeffs[j]) > diff){
+      diff = fabsf(coeffs[j] - fixed.SysCoeffs[j]);
+    }
+  }
+  printf("%4u %14.1f %14.1f %9.2fx %14.3g\n", (unsigned)N, tC * 1e9,
+      tFixed * 1e9, tC / tFixed, diff);
+}
+
+
+void bench_pid(void)
+{
+  static float inputs[SAMPLES];
+  PID_t pid;
+  control::PID<float> fixed;
+  volatile float sink;
+  double t0, tC, tFixed;
+  long updates;
+  int identical = 1;
+
+  for(int k = 0; k < SAMPLES; k++){
+    inputs[k] = (k % 9 == 0) ? 1.0f : (float)rand() / RAND_MAX;
+  }
+  PID_Init(1.2f, 0.5f, 0.01f, 0.001f, &pid);
+  PID_SetLimits(5.0f, -5.0f, &pid);
+  PID_SetMaxError(0.05f, &pid);
+  fixed.Init(1.2f, 0.5f, 0.01f, 0.001f);
+  fixed.SetLimits(5.0f, -5.0f);
+  fixed.SetMaxError(0.05f);
+  for(int k = 0; k < SAMPLES; k++){
+    if(PID_Compute(inputs[k], 1.0f, &pid) != fixed.Compute(inputs[k], 1.0f)){
+      identical = 0;
+    }
+  }
+
+  updates = 0;
+  t0 = now_seconds();
+  do{
+    for(int k = 0; k < SAMPLES; k++){
+      sink = PID_Compute(inputs[k], 1.0f, &pid);
+    }
+    updates += SAMPLES;
+  }while(now_seconds() - t0 < 0.3);
+  tC = (now_seconds() - t0) / updates;
+
+  updates = 0;
+  t0 = now_seconds();
+  do{
+    for(int k = 0; k < SAMPLES; k++){
+      sink = fixed.Compute(inputs[k], 1.0f);
+    }
+    updates += SAMPLES;
+  }while(now_seconds() - t0 < 0.3);
+  tFixed = (now_seconds() - t0) / updates;
+  (void)sink;
+
+  printf("\nPID: C %.2f ns, template %.2f ns, outputs %s\n", tC * 1e9,
+      tFixed * 1e9, identical ? "identical" : "DIFFERENT");
+}
+
+
+int main(void) {
+  printf("%4s %14s %14s %10s %14s\n", "N", "RLS_Compute", "RLS<N>",
+      "speedup", "max coef diff");
+  printf("%4s %14s %14s\n", "", "(ns/update)", "(ns/update)");
+  bench_rls<2>();
+  bench_rls<3>();
+  bench_rls<4>();
+  bench_rls<5>();
+  bench_rls<6>();
+  bench_rls<8>();
+  bench_pid();
+  return EXIT_SUCCESS;
+}
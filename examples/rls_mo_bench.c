@@ -0,0 +1,124 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+
+#include "least_squares.h"
+
+
+/**
+ * Identifies several outputs driven by the same inputs, once with one
+ * RLS_t per output and once with RLS_MO_Compute sharing the covariance.
+ * Prints the time per sample and the largest coefficient difference
+ * between both paths.
+ */
+uint32_t numCoeffs[] = {8, 32, 64};
+uint32_t numOutputs[] = {4, 16, 64};
+uint32_t numSteps = 2000;
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+float frand(float min, float max)
+{
+  return min + (max - min) * ((float)rand() / RAND_MAX);
+}
+
+
+int main(void) {
+  printf("%6s %8s %16s %16s %9s %12s\n", "coeffs", "outputs", "RLS_Compute",
+      "RLS_MO_Compute", "speedup", "difference");
+  printf("%6s %8s %16s %16s\n", "", "", "(us/sample)", "(us/sample)");
+
+  for(int s = 0; s < (int)(sizeof(numCoeffs)/sizeof(numCoeffs[0])); s++){
+    for(int q = 0; q < (int)(sizeof(numOutputs)/sizeof(numOutputs[0]));
+        q++){
+      uint32_t n = numCoeffs[s];
+      uint32_t m = numOutputs[q];
+      RLS_t *rls = malloc(sizeof(RLS_t) * m);
+      RLS_MO_t mo;
+      float *truth = malloc(sizeof(float) * m * n);
+      float *inputs = malloc(sizeof(float) * n * numSteps);
+      float *outputs = malloc(sizeof(float) * m * numSteps);
+      double t0, tLoop, tShared, diff = 0.0;
+
+      mo.SysCoeffs = calloc(m * n, sizeof(float));
+      mo.Cov = calloc(n * n, sizeof(float));
+      mo.Gain = calloc(n, sizeof(float));
+      mo.Error = calloc(m, sizeof(float));
+      mo.Lambda = 0.995f;
+      mo.NumCoeff = n;
+      mo.NumOutputs = m;
+      srand(n * m);
+      for(uint32_t k = 0; k < n; k++){
+        mo.Cov[k * n + k] = 1000.0f;
+      }
+      for(uint32_t o = 0; o < m; o++){
+        rls[o].SysCoeffs = calloc(n, sizeof(float));
+        rls[o].Cov = calloc(n * n, sizeof(float));
+        rls[o].Gain = calloc(n, sizeof(float));
+        rls[o].Error = 0.0f;
+        rls[o].Lambda = mo.Lambda;
+        rls[o].NumCoeff = n;
+        for(uint32_t k = 0; k < n; k++){
+          rls[o].Cov[k * n + k] = 1000.0f;
+          truth[o * n + k] = frand(-1.0f, 1.0f);
+        }
+      }
+      for(uint32_t t = 0; t < numSteps; t++){
+        float *x = inputs + t * n;
+        for(uint32_t k = 0; k < n; k++){
+          x[k] = frand(-1.0f, 1.0f);
+        }
+        for(uint32_t o = 0; o < m; o++){
+          float y = frand(-0.01f, 0.01f);
+          for(uint32_t k = 0; k < n; k++){
+            y += truth[o * n + k] * x[k];
+          }
+          outputs[t * m + o] = y;
+        }
+      }
+
+      t0 = now_seconds();
+      for(uint32_t t = 0; t < numSteps; t++){
+        for(uint32_t o = 0; o < m; o++){
+          RLS_Compute(inputs + t * n, outputs[t * m + o], &rls[o]);
+        }
+      }
+      tLoop = now_seconds() - t0;
+
+      t0 = now_seconds();
+      for(uint32_t t = 0; t < numSteps; t++){
+        RLS_MO_Compute(inputs + t * n, outputs + t * m, &mo);
+      }
+      tShared = now_seconds() - t0;
+
+      for(uint32_t o = 0; o < m; o++){
+        for(uint32_t k = 0; k < n; k++){
+          double d = fabs(mo.SysCoeffs[o * n + k] - rls[o].SysCoeffs[k]);
+          diff = (d > diff) ? d : diff;
+        }
+        free(rls[o].SysCoeffs); free(rls[o].Cov); free(rls[o].Gain);
+      }
+
+      printf("%6u %8u %16.2f %16.2f %9.2f %12.3g\n", n, m,
+          1e6 * tLoop / numSteps, 1e6 * tShared / numSteps,
+          tLoop / tShared, diff);
+
+      free(rls); free(truth); free(inputs); free(outputs);
+      free(mo.SysCoeffs); free(mo.Cov); free(mo.Gain); free(mo.Error);
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,134 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+
+#include "matrix_gemm.h"
+#include "matrix_parallel.h"
+
+
+/**
+ * Accumulates the normal equations X'X (lower triangle) and X'Y of a LMS
+ * fit with the loop LMS_Compute used to have (all samples scanned again
+ * for every pair of coefficients) and with SyrkMatrix (each sample read
+ * once), for 1, 2, 4, ... threads. Prints the time, the bandwidth reached
+ * and the largest relative error against a double precision reference.
+ *
+ * Usage: syrk_bench [samples] [coefficients]
+ */
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/* Former accumulation of LMS_Compute */
+void accumulate_by_pairs(float *X, float *Y, uint32_t m, uint32_t n,
+    float *S, float *Sy)
+{
+  for(uint32_t k = 0; k < n; k++){
+    for(uint32_t j = 0; j <= k; j++){
+      S[j + k * n] = 0;
+      Sy[j] = 0;
+      for(uint32_t i = 0; i < m; i++){
+        if(k == n - 1){
+          Sy[j] += Y[i] * X[j + i * n];
+        }
+        S[j + k * n] += X[k + i * n] * X[j + i * n];
+      }
+    }
+  }
+}
+
+
+/* Largest |a - ref| / |ref| over the lower triangle and the vector */
+double relative_error(float *S, float *Sy, double *R, double *Ry,
+    uint32_t n)
+{
+  double err = 0.0;
+  for(uint32_t k = 0; k < n; k++){
+    for(uint32_t j = 0; j <= k; j++){
+      double e = fabs(S[j + k * n] - R[j + k * n]) / fabs(R[j + k * n]);
+      err = (e > err) ? e : err;
+    }
+    double e = fabs(Sy[k] - Ry[k]) / fabs(Ry[k]);
+    err = (e > err) ? e : err;
+  }
+  return err;
+}
+
+
+int main(int argc, char **argv) {
+  uint32_t m = (argc > 1) ? (uint32_t)atol(argv[1]) : 200000;
+  uint32_t n = (argc > 2) ? (uint32_t)atol(argv[2]) : 64;
+  float *X = malloc(sizeof(float) * m * n);
+  float *Y = malloc(sizeof(float) * m);
+  float *S = malloc(sizeof(float) * n * n);
+  float *Sy = malloc(sizeof(float) * n);
+  double *R = calloc(n * n, sizeof(double));
+  double *Ry = calloc(n, sizeof(double));
+  double gbytes = (double)m * (n + 1) * sizeof(float) * 1e-9;
+  int maxThreads = MatrixParallel_GetThreads();
+  double t0, t;
+
+  if(X == NULL || Y == NULL){
+    printf("Not enough memory for %u x %u samples\n", m, n);
+    return EXIT_FAILURE;
+  }
+
+  /* Positive regressors with an offset, so no sum is close to zero */
+  srand(1);
+  for(uint64_t i = 0; i < (uint64_t)m * n; i++){
+    X[i] = 1.0f + (float)rand() / RAND_MAX;
+  }
+  for(uint32_t i = 0; i < m; i++){
+    Y[i] = 1.0f + (float)rand() / RAND_MAX;
+  }
+  for(uint32_t i = 0; i < m; i++){
+    for(uint32_t k = 0; k < n; k++){
+      double xk = X[(uint64_t)i * n + k];
+      for(uint32_t j = 0; j <= k; j++){
+        R[j + k * n] += xk * X[(uint64_t)i * n + j];
+      }
+      Ry[k] += (double)Y[i] * xk;
+    }
+  }
+
+  printf("%u samples x %u coefficients (%.2f GB)\n\n", m, n, gbytes);
+  printf("%-22s %10s %10s %12s\n", "", "time (s)", "GB/s", "rel. error");
+
+  t0 = now_seconds();
+  accumulate_by_pairs(X, Y, m, n, S, Sy);
+  t = now_seconds() - t0;
+  printf("%-22s %10.3f %10.2f %12.3g\n", "scan per pair", t, gbytes / t,
+      relative_error(S, Sy, R, Ry, n));
+
+  for(int th = 1; ; th *= 2){
+    char label[32];
+    if(th > maxThreads){
+      th = maxThreads;
+    }
+    MatrixParallel_SetThreads(th);
+    t0 = now_seconds();
+    SyrkMatrix(X, Y, m, n, n, 1, S, n, Sy);
+    t = now_seconds() - t0;
+    snprintf(label, sizeof(label), "SyrkMatrix, %d thr.", th);
+    printf("%-22s %10.3f %10.2f %12.3g\n", label, t, gbytes / t,
+        relative_error(S, Sy, R, Ry, n));
+    if(th == maxThreads){
+      break;
+    }
+  }
+
+  MatrixParallel_SetThreads(0);
+  free(X); free(Y); free(S); free(Sy); free(R); free(Ry);
+  return EXIT_SUCCESS;
+}
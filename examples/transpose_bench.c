@@ -0,0 +1,110 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+
+#include "matrix_math.h"
+#include "matrix_simd.h"
+
+
+/**
+ * Transposes sample logs of several shapes with the element by element
+ * loop TransposeMatrix used to run, with the blocked TransposeMatrix and
+ * with TransposeMatrixInPlace. Prints the bandwidth of each (bytes read
+ * plus written per second, best of three runs) and checks the results
+ * against each other.
+ */
+int shapes[][2] = {{256, 256}, {1024, 1024}, {4096, 4096}, {1000, 1000},
+    {100000, 16}, {16, 100000}, {3000, 2000}};
+const char *levels[] = {"scalar", "sse2", "avx2", "avx512"};
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+void transpose_naive(float *A, int m, int n, float *C)
+{
+  for(int i = 0; i < m; i++){
+    for(int j = 0; j < n; j++){
+      C[m*j + i] = A[n*i + j];
+    }
+  }
+}
+
+
+int main(void) {
+  for(int level = MATRIX_SIMD_NUMBER_OF_LEVELS - 1; level >= 0; level--){
+    if(MatrixSimd_SetLevel(level)){
+      break;
+    }
+  }
+  printf("kernels: %s\n", levels[MatrixSimd_Get()->Level]);
+  printf("%13s %12s %12s %12s %8s %8s\n", "m x n", "loop GB/s",
+      "blocked GB/s", "in place", "speedup", "check");
+
+  for(int s = 0; s < (int)(sizeof(shapes)/sizeof(shapes[0])); s++){
+    int m = shapes[s][0], n = shapes[s][1];
+    size_t size = (size_t)m * n;
+    float *A = malloc(sizeof(float) * size);
+    float *C1 = malloc(sizeof(float) * size);
+    float *C2 = malloc(sizeof(float) * size);
+    double t0, tLoop, tBlock, tInPlace, bytes = 2.0 * sizeof(float) * size;
+    int reps = (int)(1 + 50000000 / size), ok;
+    char shape[32];
+
+    /* Pages of the outputs mapped before timing */
+    for(size_t k = 0; k < size; k++){
+      A[k] = (float)k;
+      C1[k] = 0.0f;
+      C2[k] = 0.0f;
+    }
+
+    tLoop = tBlock = 1e9;
+    for(int b = 0; b < 3; b++){
+      t0 = now_seconds();
+      for(int r = 0; r < reps; r++){
+        transpose_naive(A, m, n, C1);
+      }
+      t0 = (now_seconds() - t0) / reps;
+      tLoop = (t0 < tLoop) ? t0 : tLoop;
+
+      t0 = now_seconds();
+      for(int r = 0; r < reps; r++){
+        TransposeMatrix(A, m, n, C2);
+      }
+      t0 = (now_seconds() - t0) / reps;
+      tBlock = (t0 < tBlock) ? t0 : tBlock;
+    }
+    ok = (memcmp(C1, C2, sizeof(float) * size) == 0);
+
+    /* There and back, so C2 is A again before the next run */
+    memcpy(C2, A, sizeof(float) * size);
+    tInPlace = 1e9;
+    for(int b = 0; b < 3; b++){
+      t0 = now_seconds();
+      TransposeMatrixInPlace(C2, m, n);
+      t0 = now_seconds() - t0;
+      tInPlace = (t0 < tInPlace) ? t0 : tInPlace;
+      ok = ok && (memcmp(C1, C2, sizeof(float) * size) == 0);
+      TransposeMatrixInPlace(C2, n, m);
+      ok = ok && (memcmp(A, C2, sizeof(float) * size) == 0);
+    }
+
+    snprintf(shape, sizeof(shape), "%d x %d", m, n);
+    printf("%13s %12.2f %12.2f %12.2f %8.1f %8s\n", shape,
+        1e-9 * bytes / tLoop, 1e-9 * bytes / tBlock,
+        1e-9 * bytes / tInPlace, tLoop / tBlock, ok ? "ok" : "FAILED");
+
+    free(A); free(C1); free(C2);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,148 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+
+#include "vector3.h"
+#include "matrix_simd.h"
+
+
+/**
+ * Preprocesses a log of accelerometer and magnetometer samples: both are
+ * rotated to the body frame, normalized, and the east axis (mag x accel,
+ * normalized) and the inclination (accel . mag) are computed. Once with a
+ * loop over Vector_t samples, then with the plane functions of vector3.h
+ * (conversions included) on every instruction set level of the processor.
+ * Prints the time per sample and the largest difference between both.
+ *
+ * Usage: vector3_bench [samples]
+ */
+
+
+double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+float frand(float min, float max)
+{
+  return min + (max - min) * ((float)rand() / RAND_MAX);
+}
+
+
+static Vector_t rotate(const float *R, Vector_t v)
+{
+  Vector_t r = {R[0] * v.x + R[1] * v.y + R[2] * v.z,
+      R[3] * v.x + R[4] * v.y + R[5] * v.z,
+      R[6] * v.x + R[7] * v.y + R[8] * v.z};
+  return r;
+}
+
+
+static Vector_t normalize(Vector_t v)
+{
+  float norm = sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
+  Vector_t r = {v.x / norm, v.y / norm, v.z / norm};
+  return r;
+}
+
+
+static Vector_t cross(Vector_t a, Vector_t b)
+{
+  Vector_t r = {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z,
+      a.x * b.y - a.y * b.x};
+  return r;
+}
+
+
+static double max_difference(const Vector_t *A, const Vector_t *B,
+    uint32_t n)
+{
+  double e = 0.0, d;
+  for(uint32_t i = 0; i < n; i++){
+    d = fabs(A[i].x - B[i].x) + fabs(A[i].y - B[i].y) +
+        fabs(A[i].z - B[i].z);
+    e = (d > e || d != d) ? d : e;
+  }
+  return e;
+}
+
+
+int main(int argc, char **argv) {
+  uint32_t n = (argc > 1) ? (uint32_t)atol(argv[1]) : 8192;
+  uint32_t reps = (n < (1u << 22)) ? (1u << 22) / n : 1;
+  Vector_t *accel = malloc(sizeof(Vector_t) * n);
+  Vector_t *mag = malloc(sizeof(Vector_t) * n);
+  Vector_t *east = malloc(sizeof(Vector_t) * n);
+  Vector_t *eastRef = malloc(sizeof(Vector_t) * n);
+  float *incl = malloc(sizeof(float) * n);
+  float *inclRef = malloc(sizeof(float) * n);
+  float *planes = malloc(sizeof(float) * 6 * n);
+  VectorPlanes_t a = {planes, planes + n, planes + 2 * n};
+  VectorPlanes_t m = {planes + 3 * n, planes + 4 * n, planes + 5 * n};
+  const float R[9] = {0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+  const char *names[] = {"scalar", "SSE2", "AVX2", "AVX-512"};
+  double t0, t, e;
+
+  srand(1);
+  for(uint32_t i = 0; i < n; i++){
+    accel[i].x = frand(-1.0f, 1.0f);
+    accel[i].y = frand(-1.0f, 1.0f);
+    accel[i].z = frand(8.0f, 10.0f);
+    mag[i].x = frand(20.0f, 25.0f);
+    mag[i].y = frand(-5.0f, 5.0f);
+    mag[i].z = frand(-45.0f, -40.0f);
+  }
+
+  t0 = now_seconds();
+  for(uint32_t r = 0; r < reps; r++){
+    for(uint32_t i = 0; i < n; i++){
+      Vector_t ab = normalize(rotate(R, accel[i]));
+      Vector_t mb = normalize(rotate(R, mag[i]));
+      eastRef[i] = normalize(cross(mb, ab));
+      inclRef[i] = ab.x * mb.x + ab.y * mb.y + ab.z * mb.z;
+    }
+  }
+  t = (now_seconds() - t0) / reps;
+  printf("%u samples\n%-10s %12s %12s %12s\n", n, "", "ns / sample",
+      "east error", "incl error");
+  printf("%-10s %12.2f\n", "Vector_t", 1e9 * t / n);
+
+  for(int level = 0; level < MATRIX_SIMD_NUMBER_OF_LEVELS; level++){
+    if(!MatrixSimd_SetLevel((MatrixSimd_Level_t)level)){
+      continue;
+    }
+    t0 = now_seconds();
+    for(uint32_t r = 0; r < reps; r++){
+      Vector3_ToPlanes(accel, n, &a);
+      Vector3_ToPlanes(mag, n, &m);
+      Vector3_Rotate(R, &a, n, &a);
+      Vector3_Rotate(R, &m, n, &m);
+      Vector3_Normalize(&a, n, FAST_MATH_NEWTON2, &a);
+      Vector3_Normalize(&m, n, FAST_MATH_NEWTON2, &m);
+      Vector3_Dot(&a, &m, n, incl);
+      Vector3_Cross(&m, &a, n, &a);
+      Vector3_Normalize(&a, n, FAST_MATH_NEWTON2, &a);
+      Vector3_FromPlanes(&a, n, east);
+    }
+    t = (now_seconds() - t0) / reps;
+    e = 0.0;
+    for(uint32_t i = 0; i < n; i++){
+      e = (fabs(incl[i] - inclRef[i]) > e) ? fabs(incl[i] - inclRef[i]) : e;
+    }
+    printf("%-10s %12.2f %12.2e %12.2e\n", names[level], 1e9 * t / n,
+        max_difference(east, eastRef, n), e);
+  }
+
+  free(accel); free(mag); free(east); free(eastRef); free(incl);
+  free(inclRef); free(planes);
+  return EXIT_SUCCESS;
+}
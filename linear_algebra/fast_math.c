@@ -0,0 +1,116 @@
+#include "fast_math.h"
+#include "matrix_simd.h"
+
+
+float Sqrt_approx(float x)
+{
+  typedef union{int32_t asint32; float asfloat;}FLOAT_INT32;
+  FLOAT_INT32 val;
+  val.asfloat = x;
+
+  val.asint32 = (val.asint32 >> 1) + MATRIX_SIMD_SQRT_MAGIC;
+
+  return val.asfloat;
+}
+
+
+float InvSqrt_approx(float x)
+{
+  typedef union{int32_t asint32; float asfloat;}FLOAT_INT32;
+  FLOAT_INT32 val;
+  val.asfloat = x;
+  val.asint32 = MATRIX_SIMD_INVSQRT_MAGIC - (val.asint32 >> 1);
+  return val.asfloat;
+}
+
+
+float FastInvSqrt(float x, FastMath_Accuracy_t Accuracy)
+{
+  float xhalf = 0.5f * x;
+  float y = InvSqrt_approx(x);
+  int32_t it;
+
+  for(it = 0; it < (int32_t)Accuracy; it++){
+    y *= 1.5f - xhalf * y * y;
+  }
+  return y;
+}
+
+
+float FastSqrt(float x, FastMath_Accuracy_t Accuracy)
+{
+  if(Accuracy == FAST_MATH_APPROX){
+    return Sqrt_approx(x);
+  }
+  return x * FastInvSqrt(x, Accuracy);
+}
+
+
+void FastSqrtArray(const float *X, uint32_t Size, FastMath_Accuracy_t Accuracy,
+    float *Y)
+{
+  MatrixSimd_Get()->Sqrt(X, (int32_t)Size, (int32_t)Accuracy, Y);
+}
+
+
+void FastInvSqrtArray(const float *X, uint32_t Size,
+    FastMath_Accuracy_t Accuracy, float *Y)
+{
+  MatrixSimd_Get()->InvSqrt(X, (int32_t)Size, (int32_t)Accuracy, Y);
+}
+
+
+/**
+ * @brief  Squared norms of Rows rows. The 3-axis case is unrolled, since a
+ *         kernel call per row of 3 would cost more than the row.
+ */
+static void FastMath_SquaredNorms(const MatrixSimd_t *Simd, const float *A,
+    uint32_t Rows, uint32_t Cols, float *Norms)
+{
+  uint32_t i;
+
+  if(Cols == 3){
+    for(i = 0; i < Rows; i++){
+      const float *v = A + 3 * i;
+      Norms[i] = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+    }
+  }else{
+    for(i = 0; i < Rows; i++){
+      Norms[i] = Simd->NormL2Squared(A + i * Cols, (int32_t)Cols);
+    }
+  }
+}
+
+
+void NormRowsL2(const float *A, uint32_t Rows, uint32_t Cols,
+    FastMath_Accuracy_t Accuracy, float *Norms)
+{
+  const MatrixSimd_t *simd = MatrixSimd_Get();
+
+  FastMath_SquaredNorms(simd, A, Rows, Cols, Norms);
+  simd->Sqrt(Norms, (int32_t)Rows, (int32_t)Accuracy, Norms);
+}
+
+
+void NormalizeRowsL2(float *A, uint32_t Rows, uint32_t Cols,
+    FastMath_Accuracy_t Accuracy)
+{
+  const MatrixSimd_t *simd = MatrixSimd_Get();
+  float k[FAST_MATH_BLOCK];
+  uint32_t rb, nb, i;
+  float *v;
+
+  if(Cols == 3){
+    simd->NormalizeRows3(A, (int32_t)Rows, (int32_t)Accuracy);
+    return;
+  }
+  for(rb = 0; rb < Rows; rb += FAST_MATH_BLOCK){
+    nb = (Rows - rb < FAST_MATH_BLOCK) ? Rows - rb : FAST_MATH_BLOCK;
+    v = A + rb * Cols;
+    FastMath_SquaredNorms(simd, v, nb, Cols, k);
+    simd->InvSqrt(k, (int32_t)nb, (int32_t)Accuracy, k);
+    for(i = 0; i < nb; i++){
+      simd->Scale(v + i * Cols, (int32_t)Cols, k[i], v + i * Cols);
+    }
+  }
+}
@@ -0,0 +1,161 @@
+/**
+ * @file  fast_math.h
+ * @date  18-October-2026
+ * @brief Fast square roots, inverse square roots and row normalization.
+ *
+ *   The approximations start from the IEEE 754 bit tricks of Sqrt_approx
+ *   and InvSqrt_approx and refine them with Newton steps for 1 / sqrt(x),
+ *   y = y * (1.5 - 0.5 * x * y * y). Each step squares the relative error,
+ *   so the accuracy is chosen per call (FastMath_Accuracy_t) and paid only
+ *   where it is needed. The array versions run on the SIMD kernels of
+ *   matrix_simd.h: no square root or divide instruction is issued.
+ *
+ * @author
+ * @author
+ */
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+
+#define FAST_MATH_VER_MAJOR                                                 2026
+#define FAST_MATH_VER_MINOR                                                   10
+#define FAST_MATH_VER_PATCH                                                    1
+#define FAST_MATH_BRANCH_MASTER
+
+
+#include <stdint.h>
+
+
+/**
+ * @brief Rows normalized per pass by NormalizeRowsL2, their squared norms
+ *        being kept on the stack.
+ */
+#ifndef FAST_MATH_BLOCK
+#define FAST_MATH_BLOCK                                                      256
+#endif
+
+
+/**
+ * @brief Accuracy tiers: the number of Newton steps after the bit trick.
+ * @note  Largest relative error of 1 / sqrt(x) over the normal floats.
+ */
+typedef enum
+{
+  FAST_MATH_APPROX = 0,   /*!< Bit trick only, 3.4e-2 (5 bits) */
+  FAST_MATH_NEWTON1 = 1,  /*!< One step, 1.8e-3 (9 bits) */
+  FAST_MATH_NEWTON2 = 2,  /*!< Two steps, 5e-6 (17 bits) */
+  FAST_MATH_NEWTON3 = 3,  /*!< Three steps, 1.4e-7 (float rounding) */
+}FastMath_Accuracy_t;
+
+
+/**
+ * @brief  Computes aproximation for square root of a floating point number.
+ * @param  x : Number to compute the square root.
+ * @retval float
+ * @note   Assumes that float is in the IEEE 754 single precision floating
+ *         point format and that int is 32 bits.
+ *         Source:
+ *         https://en.wikipedia.org/wiki/Methods_of_computing_square_roots
+ */
+float Sqrt_approx(float x);
+
+
+/**
+ * @brief  Computes aproximation for inverse square root of a float number.
+ * @param  x : Number to compute the inverse square root.
+ * @retval float
+ * @note   Same as FastInvSqrt(x, FAST_MATH_APPROX).
+ *         Source:
+ *         https://en.wikipedia.org/wiki/Methods_of_computing_square_roots
+ */
+float InvSqrt_approx(float x);
+
+
+/**
+ * @brief  Computes the square root of a number.
+ * @param  x : Number, zero or positive and normal.
+ * @param  Accuracy : Newton steps to take.
+ * @retval float
+ * @note   FAST_MATH_APPROX gives Sqrt_approx(x), the other tiers
+ *         x * FastInvSqrt(x, Accuracy), so zero gives zero.
+ */
+float FastSqrt(float x, FastMath_Accuracy_t Accuracy);
+
+
+/**
+ * @brief  Computes the inverse square root of a number.
+ * @param  x : Number, positive and normal.
+ * @param  Accuracy : Newton steps to take.
+ * @retval float
+ * @note   Zero gives a large finite number (about 1e19), not infinity.
+ */
+float FastInvSqrt(float x, FastMath_Accuracy_t Accuracy);
+
+
+/**
+ * @brief  Computes the square root of every element of an array.
+ * @param  X : Input array.
+ * @param  Size : Number of elements.
+ * @param  Accuracy : Newton steps to take.
+ * @param  Y : Output array, may be X.
+ * @retval void
+ * @note   Same results as FastSqrt, bit for bit.
+ */
+void FastSqrtArray(const float *X, uint32_t Size, FastMath_Accuracy_t Accuracy,
+    float *Y);
+
+
+/**
+ * @brief  Computes the inverse square root of every element of an array.
+ * @param  X : Input array.
+ * @param  Size : Number of elements.
+ * @param  Accuracy : Newton steps to take.
+ * @param  Y : Output array, may be X.
+ * @retval void
+ * @note   Same results as FastInvSqrt, bit for bit.
+ */
+void FastInvSqrtArray(const float *X, uint32_t Size,
+    FastMath_Accuracy_t Accuracy, float *Y);
+
+
+/**
+ * @brief  Computes the euclidian norm of every row of a matrix, as
+ *         NormVectorL2 would for each of them.
+ * @param  A : Row-major matrix (e.g. one 3-axis sample per row).
+ * @param  Rows : Number of rows.
+ * @param  Cols : Number of columns.
+ * @param  Accuracy : Newton steps of the square roots.
+ * @param  Norms : Output array of size Rows.
+ * @retval void
+ */
+void NormRowsL2(const float *A, uint32_t Rows, uint32_t Cols,
+    FastMath_Accuracy_t Accuracy, float *Norms);
+
+
+/**
+ * @brief  Divides every row of a matrix by its euclidian norm.
+ * @param  A : Row-major matrix, normalized in place.
+ * @param  Rows : Number of rows.
+ * @param  Cols : Number of columns.
+ * @param  Accuracy : Newton steps of the inverse square roots.
+ * @retval void
+ * @note   Rows are multiplied by FastInvSqrt of their squared norm, so a
+ *         row of zeros stays zero. Rows of 3 (3-axis samples) are split
+ *         into x, y and z vectors in registers, 8 rows at a time with AVX2.
+ */
+void NormalizeRowsL2(float *A, uint32_t Rows, uint32_t Cols,
+    FastMath_Accuracy_t Accuracy);
+
+#endif /* FAST_MATH_H */
+
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,379 @@
+/**
+ * @file  matrix_expr.hpp
+ * @date  18-October-2026
+ * @brief Expression templates over matrix_math.h storage (C++).
+ *
+ *   Map wraps a row-major float array (or a MatrixView_t) whose dimensions
+ *   are only known at run time. Sums, differences, scalings, transposes and
+ *   products of Maps build a tree of lightweight nodes instead of a result,
+ *   and the tree is evaluated when it is assigned to a Map: one loop over
+ *   the destination, each element computed from its operands. A chain such
+ *   as
+ *
+ *     Cov = (Cov - g * Transpose(g) * alpha) / lambda;
+ *     coeffs += g * (alpha * err);
+ *
+ *   makes a single pass over Cov and over coeffs, where the C calls
+ *   (MultiplyMatrix, ScaleMatrix, SubtractMatrix...) need a pass and a
+ *   scratch matrix per step.
+ *
+ *   Products are not materialized either: element (i, j) of A * B is the
+ *   dot product of row i of A and column j of B, computed when read. That
+ *   is what an outer product (inner dimension 1) or a matrix-vector product
+ *   assigned to a vector needs, but a product read several times per
+ *   element (e.g. k * (Transpose(x) * Cov), where each element of the row
+ *   x' * Cov would be computed once per row of k) should be assigned to a
+ *   vector first, as RLS_Compute does with Gain.
+ *
+ *   The destination may appear in the expression at the element being
+ *   assigned (Cov = Cov - ..., coeffs += ...) at no cost. It must not be
+ *   read elsewhere, inside a product or a transpose (Cov = Transpose(Cov))
+ *   or through an overlapping Map, since the elements already written would
+ *   be read back: such an assignment fails an assert. Assign the part that
+ *   reads it to a vector or a matrix first.
+ *
+ * @author
+ * @author
+ */
+
+
+#ifndef MATRIX_EXPR_HPP
+#define MATRIX_EXPR_HPP
+
+
+#define MATRIX_EXPR_VER_MAJOR                                               2026
+#define MATRIX_EXPR_VER_MINOR                                                 10
+#define MATRIX_EXPR_VER_PATCH                                                  1
+#define MATRIX_EXPR_BRANCH_MASTER
+
+
+#include <assert.h>
+#include "matrix_math.h"
+
+
+namespace linear_algebra {
+
+
+/**
+ * @brief Base of every node, so that the operators below only take part
+ *        in overload resolution for expressions.
+ * @note  A node E provides Rows(), Cols() and operator()(i, j) returning
+ *        element (i, j) by value. Overlaps(Dest) tells whether it reads
+ *        any element of the Map Dest, Aliases(Dest) whether element (i, j)
+ *        reads an element of Dest other than (i, j).
+ */
+template<typename E>
+struct Expr
+{
+  const E &Derived() const { return static_cast<const E &>(*this); }
+};
+
+
+class Map;
+
+
+/**
+ * @brief Element-wise sum or difference of two expressions.
+ */
+template<typename L, typename R, bool Subtract>
+struct ExprSum : public Expr<ExprSum<L, R, Subtract> >
+{
+  L A;
+  R B;
+
+  ExprSum(const L &A_, const R &B_) : A(A_), B(B_)
+  {
+    assert(A.Rows() == B.Rows() && A.Cols() == B.Cols());
+  }
+  int Rows() const { return A.Rows(); }
+  int Cols() const { return A.Cols(); }
+  float operator()(int i, int j) const
+  {
+    return Subtract ? A(i, j) - B(i, j) : A(i, j) + B(i, j);
+  }
+  bool Overlaps(const Map &D) const { return A.Overlaps(D) || B.Overlaps(D); }
+  bool Aliases(const Map &D) const { return A.Aliases(D) || B.Aliases(D); }
+};
+
+
+/**
+ * @brief Expression times a scalar.
+ */
+template<typename E>
+struct ExprScale : public Expr<ExprScale<E> >
+{
+  E A;
+  float K;
+
+  ExprScale(const E &A_, float K_) : A(A_), K(K_) {}
+  int Rows() const { return A.Rows(); }
+  int Cols() const { return A.Cols(); }
+  float operator()(int i, int j) const { return A(i, j) * K; }
+  bool Overlaps(const Map &D) const { return A.Overlaps(D); }
+  bool Aliases(const Map &D) const { return A.Aliases(D); }
+};
+
+
+/**
+ * @brief Transpose of an expression.
+ */
+template<typename E>
+struct ExprTranspose : public Expr<ExprTranspose<E> >
+{
+  E A;
+
+  explicit ExprTranspose(const E &A_) : A(A_) {}
+  int Rows() const { return A.Cols(); }
+  int Cols() const { return A.Rows(); }
+  float operator()(int i, int j) const { return A(j, i); }
+  bool Overlaps(const Map &D) const { return A.Overlaps(D); }
+  bool Aliases(const Map &D) const { return A.Overlaps(D); }
+};
+
+
+/**
+ * @brief Matrix product, each element computed when read.
+ */
+template<typename L, typename R>
+struct ExprProduct : public Expr<ExprProduct<L, R> >
+{
+  L A;
+  R B;
+
+  ExprProduct(const L &A_, const R &B_) : A(A_), B(B_)
+  {
+    assert(A.Cols() == B.Rows());
+  }
+  int Rows() const { return A.Rows(); }
+  int Cols() const { return B.Cols(); }
+  float operator()(int i, int j) const
+  {
+    float s;
+    if(A.Cols() == 0){
+      return 0.0f;
+    }
+    s = A(i, 0) * B(0, j);
+    for(int k = 1; k < A.Cols(); k++){
+      s += A(i, k) * B(k, j);
+    }
+    return s;
+  }
+  bool Overlaps(const Map &D) const { return A.Overlaps(D) || B.Overlaps(D); }
+  bool Aliases(const Map &D) const { return Overlaps(D); }
+};
+
+
+/**
+ * @brief Row-major matrix stored elsewhere (a C array or a MatrixView_t).
+ * @note  Copying a Map copies the reference, assigning to a Map writes the
+ *        elements.
+ */
+class Map : public Expr<Map>
+{
+public:
+  float *Data;
+  int NumRows;
+  int NumCols;
+  int Stride;
+
+  Map(float *Data_, int Rows_, int Cols_) :
+    Data(Data_), NumRows(Rows_), NumCols(Cols_), Stride(Cols_) {}
+  Map(float *Data_, int Rows_, int Cols_, int Stride_) :
+    Data(Data_), NumRows(Rows_), NumCols(Cols_), Stride(Stride_) {}
+  explicit Map(const MatrixView_t &View) :
+    Data(View.Data), NumRows(View.Rows), NumCols(View.Cols),
+    Stride(View.Stride) {}
+  Map(const Map &) = default;
+
+  int Rows() const { return NumRows; }
+  int Cols() const { return NumCols; }
+  float operator()(int i, int j) const { return Data[i * Stride + j]; }
+  float &operator()(int i, int j) { return Data[i * Stride + j]; }
+  float &operator[](int k) { return Data[k]; }
+  float operator[](int k) const { return Data[k]; }
+
+  /**
+   * @brief  Whether the elements of D and of this Map share storage.
+   */
+  bool Overlaps(const Map &D) const
+  {
+    return NumRows > 0 && NumCols > 0 && D.NumRows > 0 && D.NumCols > 0 &&
+        Data < D.Data + (D.NumRows - 1) * D.Stride + D.NumCols &&
+        D.Data < Data + (NumRows - 1) * Stride + NumCols;
+  }
+
+  /**
+   * @brief  Whether element (i, j) of this Map may be an element of D
+   *         other than (i, j).
+   */
+  bool Aliases(const Map &D) const
+  {
+    return Overlaps(D) && (Data != D.Data || Stride != D.Stride);
+  }
+
+  /**
+   * @brief  Returns the view of the same elements, for matrix_math.h.
+   */
+  MatrixView_t View() const
+  {
+    MatrixView_t v;
+    MatrixViewInit(&v, Data, NumRows, NumCols, Stride);
+    return v;
+  }
+
+  /**
+   * @brief  Sub-matrix of Rows_ x Cols_ elements from (Row, Col).
+   */
+  Map Block(int Row, int Col, int Rows_, int Cols_) const
+  {
+    assert(Row + Rows_ <= NumRows && Col + Cols_ <= NumCols);
+    return Map(Data + Row * Stride + Col, Rows_, Cols_, Stride);
+  }
+
+  Map &operator=(const Map &B) { return Assign(B, AssignOp()); }
+
+  template<typename E>
+  Map &operator=(const Expr<E> &B) { return Assign(B.Derived(), AssignOp()); }
+
+  template<typename E>
+  Map &operator+=(const Expr<E> &B) { return Assign(B.Derived(), AddOp()); }
+
+  template<typename E>
+  Map &operator-=(const Expr<E> &B) { return Assign(B.Derived(), SubOp()); }
+
+  Map &operator*=(float K)
+  {
+    for(int i = 0; i < NumRows; i++){
+      float *row = Data + i * Stride;
+      for(int j = 0; j < NumCols; j++){
+        row[j] *= K;
+      }
+    }
+    return *this;
+  }
+
+  Map &operator/=(float K) { return *this *= 1.0f / K; }
+
+  /**
+   * @brief  Sets every element to Value.
+   */
+  Map &Fill(float Value)
+  {
+    for(int i = 0; i < NumRows; i++){
+      float *row = Data + i * Stride;
+      for(int j = 0; j < NumCols; j++){
+        row[j] = Value;
+      }
+    }
+    return *this;
+  }
+
+private:
+  struct AssignOp { void operator()(float &d, float v) const { d = v; } };
+  struct AddOp { void operator()(float &d, float v) const { d += v; } };
+  struct SubOp { void operator()(float &d, float v) const { d -= v; } };
+
+  /* The one loop every expression is evaluated in. B may only read this */
+  /*  Map at the element being written, there is no temporary.            */
+  template<typename E, typename Op>
+  Map &Assign(const E &B, Op op)
+  {
+    assert(B.Rows() == NumRows && B.Cols() == NumCols);
+    assert(!B.Aliases(*this));
+    for(int i = 0; i < NumRows; i++){
+      float *row = Data + i * Stride;
+      for(int j = 0; j < NumCols; j++){
+        op(row[j], B(i, j));
+      }
+    }
+    return *this;
+  }
+};
+
+
+template<typename L, typename R>
+inline ExprSum<L, R, false> operator+(const Expr<L> &A, const Expr<R> &B)
+{
+  return ExprSum<L, R, false>(A.Derived(), B.Derived());
+}
+
+
+template<typename L, typename R>
+inline ExprSum<L, R, true> operator-(const Expr<L> &A, const Expr<R> &B)
+{
+  return ExprSum<L, R, true>(A.Derived(), B.Derived());
+}
+
+
+template<typename E>
+inline ExprScale<E> operator*(const Expr<E> &A, float K)
+{
+  return ExprScale<E>(A.Derived(), K);
+}
+
+
+template<typename E>
+inline ExprScale<E> operator*(float K, const Expr<E> &A)
+{
+  return ExprScale<E>(A.Derived(), K);
+}
+
+
+template<typename E>
+inline ExprScale<E> operator/(const Expr<E> &A, float K)
+{
+  return ExprScale<E>(A.Derived(), 1.0f / K);
+}
+
+
+template<typename E>
+inline ExprScale<E> operator-(const Expr<E> &A)
+{
+  return ExprScale<E>(A.Derived(), -1.0f);
+}
+
+
+/**
+ * @brief  A * B, see MultiplyMatrix. Evaluated element by element.
+ */
+template<typename L, typename R>
+inline ExprProduct<L, R> operator*(const Expr<L> &A, const Expr<R> &B)
+{
+  return ExprProduct<L, R>(A.Derived(), B.Derived());
+}
+
+
+/**
+ * @brief  Transpose of A, see TransposeMatrix. Evaluated element by
+ *         element.
+ */
+template<typename E>
+inline ExprTranspose<E> Transpose(const Expr<E> &A)
+{
+  return ExprTranspose<E>(A.Derived());
+}
+
+
+/**
+ * @brief  Returns the sum of the products of the elements of A and B,
+ *         see DotProduct (for vectors, either rows or columns).
+ */
+template<typename L, typename R>
+inline float Dot(const Expr<L> &A, const Expr<R> &B)
+{
+  const L &a = A.Derived();
+  const R &b = B.Derived();
+  float s = 0.0f;
+
+  assert(a.Rows() == b.Rows() && a.Cols() == b.Cols());
+  for(int i = 0; i < a.Rows(); i++){
+    for(int j = 0; j < a.Cols(); j++){
+      s += a(i, j) * b(i, j);
+    }
+  }
+  return s;
+}
+
+} /* namespace linear_algebra */
+
+#endif /* MATRIX_EXPR_HPP */
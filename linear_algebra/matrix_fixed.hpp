@@ -0,0 +1,279 @@
+/**
+ * @file  matrix_fixed.hpp
+ * @date  18-October-2026
+ * @brief Vectors and matrices with dimensions fixed at compile time (C++).
+ *
+ *   Header-only counterpart of matrix_math.h for the small matrices (2x2
+ *   to 8x8) used inside sampling loops. Elements are stored row-major, as
+ *   in matrix_math.h, so data() can be handed to the C functions. As the
+ *   dimensions are template parameters, every loop is unrolled and the
+ *   values can stay in registers.
+ *
+ * @author
+ * @author
+ */
+
+
+#ifndef MATRIX_FIXED_HPP
+#define MATRIX_FIXED_HPP
+
+
+#define MATRIX_FIXED_VER_MAJOR                                              2026
+#define MATRIX_FIXED_VER_MINOR                                                10
+#define MATRIX_FIXED_VER_PATCH                                                 1
+#define MATRIX_FIXED_BRANCH_MASTER
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+
+
+/**
+ * @brief Placed before loops with compile-time trip counts to have them
+ *        fully unrolled.
+ */
+#if defined(__clang__)
+#define MATRIX_FIXED_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__) && (__GNUC__ >= 8)
+#define MATRIX_FIXED_UNROLL _Pragma("GCC unroll 64")
+#else
+#define MATRIX_FIXED_UNROLL
+#endif
+
+
+namespace linear_algebra {
+
+
+/**
+ * @brief Matrix of M rows and N columns, stored row-major.
+ */
+template<typename T, size_t M, size_t N>
+struct Matrix
+{
+  static const size_t Rows = M;
+  static const size_t Cols = N;
+
+  T Data[M * N];
+
+  T &operator()(size_t i, size_t j) { return Data[i * N + j]; }
+  const T &operator()(size_t i, size_t j) const { return Data[i * N + j]; }
+  T &operator[](size_t k) { return Data[k]; }
+  const T &operator[](size_t k) const { return Data[k]; }
+  T *data() { return Data; }
+  const T *data() const { return Data; }
+
+  static Matrix Zero()
+  {
+    Matrix r;
+    MATRIX_FIXED_UNROLL
+    for(size_t k = 0; k < M * N; k++){
+      r.Data[k] = T(0);
+    }
+    return r;
+  }
+
+  static Matrix Identity()
+  {
+    Matrix r = Zero();
+    MATRIX_FIXED_UNROLL
+    for(size_t k = 0; k < M && k < N; k++){
+      r.Data[k * N + k] = T(1);
+    }
+    return r;
+  }
+
+  Matrix &operator+=(const Matrix &B)
+  {
+    MATRIX_FIXED_UNROLL
+    for(size_t k = 0; k < M * N; k++){
+      Data[k] += B.Data[k];
+    }
+    return *this;
+  }
+
+  Matrix &operator-=(const Matrix &B)
+  {
+    MATRIX_FIXED_UNROLL
+    for(size_t k = 0; k < M * N; k++){
+      Data[k] -= B.Data[k];
+    }
+    return *this;
+  }
+
+  Matrix &operator*=(T Scale)
+  {
+    MATRIX_FIXED_UNROLL
+    for(size_t k = 0; k < M * N; k++){
+      Data[k] *= Scale;
+    }
+    return *this;
+  }
+};
+
+
+/**
+ * @brief Column vector of N elements.
+ */
+template<typename T, size_t N>
+using Vector = Matrix<T, N, 1>;
+
+
+template<typename T, size_t M, size_t N>
+inline Matrix<T, M, N> operator+(Matrix<T, M, N> A, const Matrix<T, M, N> &B)
+{
+  return A += B;
+}
+
+
+template<typename T, size_t M, size_t N>
+inline Matrix<T, M, N> operator-(Matrix<T, M, N> A, const Matrix<T, M, N> &B)
+{
+  return A -= B;
+}
+
+
+template<typename T, size_t M, size_t N>
+inline Matrix<T, M, N> operator*(Matrix<T, M, N> A, T Scale)
+{
+  return A *= Scale;
+}
+
+
+template<typename T, size_t M, size_t N>
+inline Matrix<T, M, N> operator*(T Scale, Matrix<T, M, N> A)
+{
+  return A *= Scale;
+}
+
+
+/**
+ * @brief  C = A * B, see MultiplyMatrix.
+ */
+template<typename T, size_t M, size_t P, size_t N>
+inline Matrix<T, M, N> operator*(const Matrix<T, M, P> &A,
+    const Matrix<T, P, N> &B)
+{
+  Matrix<T, M, N> C = Matrix<T, M, N>::Zero();
+  MATRIX_FIXED_UNROLL
+  for(size_t i = 0; i < M; i++){
+    MATRIX_FIXED_UNROLL
+    for(size_t k = 0; k < P; k++){
+      MATRIX_FIXED_UNROLL
+      for(size_t j = 0; j < N; j++){
+        C.Data[i * N + j] += A.Data[i * P + k] * B.Data[k * N + j];
+      }
+    }
+  }
+  return C;
+}
+
+
+/**
+ * @brief  Returns the transpose of A, see TransposeMatrix.
+ */
+template<typename T, size_t M, size_t N>
+inline Matrix<T, N, M> Transpose(const Matrix<T, M, N> &A)
+{
+  Matrix<T, N, M> C;
+  MATRIX_FIXED_UNROLL
+  for(size_t i = 0; i < M; i++){
+    MATRIX_FIXED_UNROLL
+    for(size_t j = 0; j < N; j++){
+      C.Data[j * M + i] = A.Data[i * N + j];
+    }
+  }
+  return C;
+}
+
+
+/**
+ * @brief  Returns the dot product of two vectors, see DotProduct.
+ */
+template<typename T, size_t N>
+inline T Dot(const Vector<T, N> &A, const Vector<T, N> &B)
+{
+  T s = T(0);
+  MATRIX_FIXED_UNROLL
+  for(size_t k = 0; k < N; k++){
+    s += A.Data[k] * B.Data[k];
+  }
+  return s;
+}
+
+
+/**
+ * @brief  Invert matrix A, store result in A, see InvertMatrix.
+ * @retval bool
+ * @note   Gauss-Jordan with partial pivoting, as InvertMatrix. Returns
+ *         false (A partially modified) if A is singular.
+ */
+template<typename T, size_t N>
+inline bool Invert(Matrix<T, N, N> &A)
+{
+  size_t pivrows[N];
+  size_t pivrow;
+  T tmp;
+
+  MATRIX_FIXED_UNROLL
+  for(size_t k = 0; k < N; k++){
+    /* find pivot row, the row with biggest entry in current column */
+    pivrow = k;
+    tmp = fabs(A.Data[k * N + k]);
+    for(size_t i = k + 1; i < N; i++){
+      if(fabs(A.Data[i * N + k]) > tmp){
+        tmp = fabs(A.Data[i * N + k]);
+        pivrow = i;
+      }
+    }
+    if(A.Data[pivrow * N + k] == T(0)){
+      return false;
+    }
+    if(pivrow != k){
+      MATRIX_FIXED_UNROLL
+      for(size_t j = 0; j < N; j++){
+        tmp = A.Data[k * N + j];
+        A.Data[k * N + j] = A.Data[pivrow * N + j];
+        A.Data[pivrow * N + j] = tmp;
+      }
+    }
+    pivrows[k] = pivrow;
+
+    tmp = T(1) / A.Data[k * N + k];
+    A.Data[k * N + k] = T(1);
+    MATRIX_FIXED_UNROLL
+    for(size_t j = 0; j < N; j++){
+      A.Data[k * N + j] *= tmp;
+    }
+
+    /* eliminate all other entries in this column */
+    MATRIX_FIXED_UNROLL
+    for(size_t i = 0; i < N; i++){
+      if(i != k){
+        tmp = A.Data[i * N + k];
+        A.Data[i * N + k] = T(0);
+        MATRIX_FIXED_UNROLL
+        for(size_t j = 0; j < N; j++){
+          A.Data[i * N + j] -= A.Data[k * N + j] * tmp;
+        }
+      }
+    }
+  }
+
+  /* undo pivot row swaps by doing column swaps in reverse order */
+  for(size_t k = N; k-- > 0;){
+    if(pivrows[k] != k){
+      MATRIX_FIXED_UNROLL
+      for(size_t i = 0; i < N; i++){
+        tmp = A.Data[i * N + k];
+        A.Data[i * N + k] = A.Data[i * N + pivrows[k]];
+        A.Data[i * N + pivrows[k]] = tmp;
+      }
+    }
+  }
+  return true;
+}
+
+} /* namespace linear_algebra */
+
+#endif /* MATRIX_FIXED_HPP */
@@ -0,0 +1,377 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include "matrix_gemm.h"
+#include "matrix_simd.h"
+#include "matrix_parallel.h"
+
+
+#define GEMM_MR MATRIX_GEMM_MR
+#define GEMM_NR MATRIX_GEMM_NR
+#define GEMM_MC MATRIX_GEMM_MC
+#define GEMM_KC MATRIX_GEMM_KC
+#define GEMM_NC MATRIX_GEMM_NC
+
+/* Packing buffers are aligned to a cache line */
+#define GEMM_ALIGN 64
+
+
+/**
+ * @brief  Copies a kc x nc block of B into NR wide column slivers.
+ * @note   Sliver s holds, for each k, the NR elements B[k][s*NR ...]
+ *         contiguously. Columns past nc are filled with zeros so the
+ *         micro-kernel never needs to test for edges.
+ */
+static void GemmPackB(float *B, int Ldb, int kc, int nc, float *Bp)
+{
+  int j, k, jj, nr;
+  for(j = 0; j < nc; j += GEMM_NR){
+    nr = (nc - j) < GEMM_NR ? (nc - j) : GEMM_NR;
+    for(k = 0; k < kc; k++){
+      float *src = B + k*Ldb + j;
+      for(jj = 0; jj < nr; jj++){
+        Bp[jj] = src[jj];
+      }
+      for(; jj < GEMM_NR; jj++){
+        Bp[jj] = 0.0f;
+      }
+      Bp += GEMM_NR;
+    }
+  }
+}
+
+
+/**
+ * @brief  Copies a mc x kc block of A into MR tall row slivers.
+ * @note   Sliver s holds, for each k, the MR elements A[s*MR ...][k]
+ *         contiguously. Rows past mc are filled with zeros.
+ */
+static void GemmPackA(float *A, int Lda, int mc, int kc, float *Ap)
+{
+  int i, k, ii, mr;
+  for(i = 0; i < mc; i += GEMM_MR){
+    mr = (mc - i) < GEMM_MR ? (mc - i) : GEMM_MR;
+    for(k = 0; k < kc; k++){
+      for(ii = 0; ii < mr; ii++){
+        Ap[ii] = A[(i + ii)*Lda + k];
+      }
+      for(; ii < GEMM_MR; ii++){
+        Ap[ii] = 0.0f;
+      }
+      Ap += GEMM_MR;
+    }
+  }
+}
+
+
+/**
+ * @brief  Computes a MR x NR tile of C from packed slivers of A and B.
+ * @note   The whole tile is accumulated in local variables (registers) and
+ *         C is touched once, at the end. Only the top-left mr x nr part of
+ *         the tile is written back.
+ */
+static void GemmMicroKernel(int kc, const float *Ap, const float *Bp,
+    float *C, int Ldc, int mr, int nr, float Alpha, float Beta)
+{
+  float acc[GEMM_MR][GEMM_NR];
+  int i, j, k;
+
+  for(i = 0; i < GEMM_MR; i++){
+    for(j = 0; j < GEMM_NR; j++){
+      acc[i][j] = 0.0f;
+    }
+  }
+
+  for(k = 0; k < kc; k++){
+    for(i = 0; i < GEMM_MR; i++){
+      float a = Ap[i];
+      for(j = 0; j < GEMM_NR; j++){
+        acc[i][j] += a * Bp[j];
+      }
+    }
+    Ap += GEMM_MR;
+    Bp += GEMM_NR;
+  }
+
+  for(i = 0; i < mr; i++){
+    float *c = C + i*Ldc;
+    if(Beta == 0.0f){
+      for(j = 0; j < nr; j++){
+        c[j] = Alpha * acc[i][j];
+      }
+    }else{
+      for(j = 0; j < nr; j++){
+        c[j] = Alpha * acc[i][j] + Beta * c[j];
+      }
+    }
+  }
+}
+
+
+int32_t GemmMatrix(float *A, float *B, int m, int p, int n, float *C,
+    int Lda, int Ldb, int Ldc, float Alpha, float Beta)
+{
+  int ic, jc, pc, ir, jr;
+  int mc, nc, kc;
+  float beta;
+  void *mem;
+  float *Ap, *Bp;
+  uintptr_t addr;
+  void (*kernel)(int, const float *, const float *, float *, int, int, int,
+      float, float);
+
+  if(m <= 0 || n <= 0){
+    return 1;
+  }
+
+  /* Both packing buffers come from a single allocation */
+  mem = malloc((GEMM_MC*GEMM_KC + GEMM_KC*GEMM_NC)*sizeof(float) +
+      GEMM_ALIGN);
+  if(mem == NULL){
+    return 0;
+  }
+  /* Widest micro-kernel available on this processor */
+  kernel = MatrixSimd_Get()->GemmKernel;
+  if(kernel == NULL){
+    kernel = GemmMicroKernel;
+  }
+
+  addr = ((uintptr_t)mem + GEMM_ALIGN - 1) & ~(uintptr_t)(GEMM_ALIGN - 1);
+  Ap = (float *)addr;
+  Bp = Ap + GEMM_MC*GEMM_KC;
+
+  for(jc = 0; jc < n; jc += GEMM_NC){
+    nc = (n - jc) < GEMM_NC ? (n - jc) : GEMM_NC;
+
+    if(p <= 0){
+      /* Empty product, only the scaling of C remains */
+      for(ic = 0; ic < m; ic++){
+        for(jr = 0; jr < nc; jr++){
+          C[ic*Ldc + jc + jr] = (Beta == 0.0f) ? 0.0f :
+              Beta * C[ic*Ldc + jc + jr];
+        }
+      }
+      continue;
+    }
+
+    for(pc = 0; pc < p; pc += GEMM_KC){
+      kc = (p - pc) < GEMM_KC ? (p - pc) : GEMM_KC;
+      /* Only the first pass over k applies Beta, later ones accumulate */
+      beta = (pc == 0) ? Beta : 1.0f;
+
+      GemmPackB(B + pc*Ldb + jc, Ldb, kc, nc, Bp);
+
+      for(ic = 0; ic < m; ic += GEMM_MC){
+        mc = (m - ic) < GEMM_MC ? (m - ic) : GEMM_MC;
+
+        GemmPackA(A + ic*Lda + pc, Lda, mc, kc, Ap);
+
+        for(jr = 0; jr < nc; jr += GEMM_NR){
+          for(ir = 0; ir < mc; ir += GEMM_MR){
+            kernel(kc, Ap + ir*kc, Bp + jr*kc,
+                C + (ic + ir)*Ldc + jc + jr, Ldc,
+                (mc - ir) < GEMM_MR ? (mc - ir) : GEMM_MR,
+                (nc - jr) < GEMM_NR ? (nc - jr) : GEMM_NR,
+                Alpha, beta);
+          }
+        }
+      }
+    }
+  }
+
+  free(mem);
+  return 1;
+}
+
+
+/**
+ * @brief Data shared by the threads of SyrkMatrix.
+ */
+typedef struct
+{
+  float *A;
+  float *y;
+  int m;
+  int n;
+  int Lda;
+  int Incy;
+  int NumParts;
+  double **Partials;    /*!< Totals of each part of the rows */
+  int Failed;
+}GemmSyrk_t;
+
+
+/**
+ * @brief  Copies kc rows of A into slivers of the given width, as
+ *         GemmPackA (width MR) or GemmPackB (width NR) would lay out A'
+ *         or A respectively.
+ */
+static void GemmSyrkPack(float *A, int Lda, int kc, int n, int Width,
+    float *P)
+{
+  int j, k, jj, w;
+  for(j = 0; j < n; j += Width){
+    w = (n - j) < Width ? (n - j) : Width;
+    for(k = 0; k < kc; k++){
+      float *src = A + k*Lda + j;
+      for(jj = 0; jj < w; jj++){
+        P[jj] = src[jj];
+      }
+      for(; jj < Width; jj++){
+        P[jj] = 0.0f;
+      }
+      P += Width;
+    }
+  }
+}
+
+
+/**
+ * @brief  Accumulates the rows of the parts Begin to End, each in its own
+ *         double precision totals.
+ */
+static void GemmSyrkTask(void *Context, int Begin, int End)
+{
+  GemmSyrk_t *ctx = (GemmSyrk_t *)Context;
+  int n = ctx->n;
+  int Lda = ctx->Lda;
+  int nm = (n + GEMM_MR - 1) / GEMM_MR * GEMM_MR;
+  int nn = (n + GEMM_NR - 1) / GEMM_NR * GEMM_NR;
+  int part, r, r0, r1, kc, i, j, k, i0, j0;
+  double *total, *totalv;
+  float *Ap, *Bp, *Cb, *vb, *X;
+  uintptr_t addr;
+  void *mem;
+  void (*kernel)(int, const float *, const float *, float *, int, int, int,
+      float, float);
+
+  kernel = MatrixSimd_Get()->GemmKernel;
+  if(kernel == NULL){
+    kernel = GemmMicroKernel;
+  }
+
+  for(part = Begin; part < End; part++){
+    /* Totals first, then the aligned packing and block buffers */
+    mem = malloc(sizeof(double)*(n*n + n) + GEMM_ALIGN + sizeof(float)*
+        (GEMM_KC*nm + GEMM_KC*nn + nm*nn + n));
+    if(mem == NULL){
+      __atomic_store_n(&ctx->Failed, 1, __ATOMIC_RELAXED);
+      return;
+    }
+    ctx->Partials[part] = (double *)mem;
+    total = (double *)mem;
+    totalv = total + n*n;
+    addr = ((uintptr_t)(totalv + n) + GEMM_ALIGN - 1) &
+        ~(uintptr_t)(GEMM_ALIGN - 1);
+    Ap = (float *)addr;
+    Bp = Ap + GEMM_KC*nm;
+    Cb = Bp + GEMM_KC*nn;
+    vb = Cb + nm*nn;
+
+    for(i = 0; i < n*n + n; i++){
+      total[i] = 0.0;
+    }
+
+    r0 = (int)((int64_t)ctx->m * part / ctx->NumParts);
+    r1 = (int)((int64_t)ctx->m * (part + 1) / ctx->NumParts);
+    for(r = r0; r < r1; r += GEMM_KC){
+      kc = (r1 - r) < GEMM_KC ? (r1 - r) : GEMM_KC;
+      X = ctx->A + (int64_t)r*Lda;
+
+      /* The block of rows is read once, into both packed layouts */
+      GemmSyrkPack(X, Lda, kc, n, GEMM_MR, Ap);
+      GemmSyrkPack(X, Lda, kc, n, GEMM_NR, Bp);
+
+      /* Block of A' * A, tiles touching the lower triangle only */
+      for(i0 = 0; i0 < n; i0 += GEMM_MR){
+        for(j0 = 0; j0 < n && j0 < i0 + GEMM_MR; j0 += GEMM_NR){
+          kernel(kc, Ap + i0*kc, Bp + j0*kc, Cb + i0*nn + j0, nn,
+              GEMM_MR, GEMM_NR, 1.0f, 0.0f);
+        }
+      }
+      for(i = 0; i < n; i++){
+        for(j = 0; j <= i; j++){
+          total[i*n + j] += Cb[i*nn + j];
+        }
+      }
+
+      if(ctx->y != NULL){
+        for(j = 0; j < n; j++){
+          vb[j] = 0.0f;
+        }
+        for(k = 0; k < kc; k++){
+          float yk = ctx->y[(int64_t)(r + k)*ctx->Incy];
+          for(j = 0; j < n; j++){
+            vb[j] += yk * X[k*Lda + j];
+          }
+        }
+        for(j = 0; j < n; j++){
+          totalv[j] += vb[j];
+        }
+      }
+    }
+  }
+}
+
+
+int32_t SyrkMatrix(float *A, float *y, int m, int n, int Lda, int Incy,
+    float *C, int Ldc, float *v)
+{
+  GemmSyrk_t ctx;
+  double *partials[MATRIX_PARALLEL_MAX_THREADS];
+  double sum;
+  int i, j, b, parts;
+
+  if(n <= 0){
+    return 1;
+  }
+
+  /* One part per thread, none shorter than a block of rows */
+  parts = MatrixParallel_GetThreads();
+  if(parts > (m + GEMM_KC - 1) / GEMM_KC){
+    parts = (m + GEMM_KC - 1) / GEMM_KC;
+  }
+  if(parts < 1){
+    parts = 1;
+  }
+  for(b = 0; b < parts; b++){
+    partials[b] = NULL;
+  }
+
+  ctx.A = A;
+  ctx.y = y;
+  ctx.m = m;
+  ctx.n = n;
+  ctx.Lda = Lda;
+  ctx.Incy = Incy;
+  ctx.NumParts = parts;
+  ctx.Partials = partials;
+  ctx.Failed = 0;
+  MatrixParallel_For(parts, 1, GemmSyrkTask, &ctx);
+
+  if(ctx.Failed == 0){
+    /* Fixed order, so the result does not depend on thread timing */
+    for(i = 0; i < n; i++){
+      for(j = 0; j <= i; j++){
+        sum = 0.0;
+        for(b = 0; b < parts; b++){
+          sum += partials[b][i*n + j];
+        }
+        C[i*Ldc + j] = (float)sum;
+      }
+    }
+    if(y != NULL){
+      for(j = 0; j < n; j++){
+        sum = 0.0;
+        for(b = 0; b < parts; b++){
+          sum += partials[b][n*n + j];
+        }
+        v[j] = (float)sum;
+      }
+    }
+  }
+
+  for(b = 0; b < parts; b++){
+    free(partials[b]);
+  }
+  return (ctx.Failed == 0) ? 1 : 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file  matrix_gemm.h
+ * @date  18-October-2026
+ * @brief Cache-blocked general matrix multiplication (GEMM) engine.
+ *
+ *   Packed, cache-blocked and register-tiled implementation of the
+ *   product used by MultiplyMatrix for large operands. Matrices are
+ *   stored in row-major order, as everywhere else in this library.
+ *
+ * @author
+ * @author
+ */
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MATRIX_GEMM_H
+#define MATRIX_GEMM_H
+
+
+#define MATRIX_GEMM_VER_MAJOR                                               2026
+#define MATRIX_GEMM_VER_MINOR                                                 10
+#define MATRIX_GEMM_VER_PATCH                                                  1
+#define MATRIX_GEMM_BRANCH_MASTER
+
+
+#include <stdint.h>
+
+
+/**
+ * @brief Register tile computed by the micro-kernel (rows x columns of C).
+ */
+#define MATRIX_GEMM_MR                                                         6
+#define MATRIX_GEMM_NR                                                        16
+
+/**
+ * @brief Cache blocking parameters. MC x KC floats of A are packed to stay
+ *        in L2, KC x NR floats of B stay in L1 while a panel of C is swept.
+ */
+#ifndef MATRIX_GEMM_MC
+#define MATRIX_GEMM_MC                                                        72
+#endif
+#ifndef MATRIX_GEMM_KC
+#define MATRIX_GEMM_KC                                                       256
+#endif
+#ifndef MATRIX_GEMM_NC
+#define MATRIX_GEMM_NC                                                      1024
+#endif
+
+/**
+ * @brief Number of multiply-adds (m * p * n) above which MultiplyMatrix
+ *        uses the blocked engine instead of the plain triple loop.
+ */
+#ifndef MATRIX_GEMM_THRESHOLD
+#define MATRIX_GEMM_THRESHOLD                                    (32 * 32 * 32)
+#endif
+
+
+/**
+ * @brief  Computes C = Alpha * A * B + Beta * C using the blocked engine.
+ * @param  A : Pointer to input matrix (m x p).
+ * @param  B : Pointer to input matrix (p x n).
+ * @param  m : Number of rows in A.
+ * @param  p : Number of columns in A = number of rows in B.
+ * @param  n : Number of columns in B.
+ * @param  C : Pointer to output matrix (m x n).
+ * @param  Lda : Distance, in elements, between two rows of A (>= p).
+ * @param  Ldb : Distance, in elements, between two rows of B (>= n).
+ * @param  Ldc : Distance, in elements, between two rows of C (>= n).
+ * @param  Alpha : Scale applied to the product.
+ * @param  Beta : Scale applied to the previous content of C. When zero,
+ *                C is not read, so it may hold uninitialized values.
+ * @retval int32_t
+ * @note   The function returns 1 on success, 0 on failure (the packing
+ *         buffers could not be allocated). C is left untouched on failure.
+ */
+int32_t GemmMatrix(float *A, float *B, int m, int p, int n, float *C,
+    int Lda, int Ldb, int Ldc, float Alpha, float Beta);
+
+
+/**
+ * @brief  Computes the lower triangle of C = A' * A and, optionally,
+ *         v = A' * y, reading every row of A once.
+ * @param  A : Pointer to input matrix (m x n), one sample per row.
+ * @param  y : Optional pointer to a 1-D array of size m, may be NULL.
+ * @param  m : Number of rows in A.
+ * @param  n : Number of columns in A.
+ * @param  Lda : Distance, in elements, between two rows of A (>= n).
+ * @param  Incy : Distance, in elements, between two values of y (>= 1).
+ * @param  C : Pointer to output matrix (n x n). Only the lower triangle
+ *             (diagonal included) is written.
+ * @param  Ldc : Distance, in elements, between two rows of C (>= n).
+ * @param  v : Pointer to output 1-D array of size n, used only with y.
+ * @retval int32_t
+ * @note   Rows of A are taken in blocks of MATRIX_GEMM_KC, packed once and
+ *         multiplied with the GEMM micro-kernel, only for tiles touching
+ *         the lower triangle. Sums of each block are added to double
+ *         precision totals, so long inputs keep their accuracy. The rows
+ *         are split among the threads of matrix_parallel.h, each with its
+ *         own totals, added at the end in a fixed order.
+ *         The function returns 1 on success, 0 on failure (buffers could
+ *         not be allocated). C and v are left untouched on failure.
+ */
+int32_t SyrkMatrix(float *A, float *y, int m, int n, int Lda, int Incy,
+    float *C, int Ldc, float *v);
+
+#endif /* MATRIX_GEMM_H */
+
+
+
+#ifdef __cplusplus
+}
+#endif
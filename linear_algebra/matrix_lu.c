@@ -0,0 +1,267 @@
+#include <math.h>
+#include <stdlib.h>
+#include "matrix_lu.h"
+#include "matrix_gemm.h"
+#include "matrix_parallel.h"
+
+
+#define LU_NB MATRIX_LU_BLOCK
+
+/* Columns given to a thread at once, a multiple of the GEMM tile width */
+#define LU_GRAIN (4 * MATRIX_GEMM_NR)
+
+
+/**
+ * @brief Data shared by the threads of a parallel step.
+ */
+typedef struct
+{
+  float *A;        /*!< Matrix being factored, or L and U when solving */
+  float *B;        /*!< Right-hand sides when solving */
+  int n;
+  int NumRhs;
+  int k0;          /*!< First column of the current panel */
+  int kb;          /*!< Width of the current panel */
+}LU_Context_t;
+
+
+/**
+ * @brief  C = C - A * B, through the blocked engine when memory allows.
+ */
+static void LU_MultiplySubtract(float *A, float *B, int m, int p, int n,
+    float *C, int Lda, int Ldb, int Ldc)
+{
+  int i, j, k;
+  float a;
+
+  if(GemmMatrix(A, B, m, p, n, C, Lda, Ldb, Ldc, -1.0f, 1.0f) == 1){
+    return;
+  }
+  for(i = 0; i < m; i++){
+    for(k = 0; k < p; k++){
+      a = A[i*Lda + k];
+      for(j = 0; j < n; j++){
+        C[i*Ldc + j] -= a * B[k*Ldb + j];
+      }
+    }
+  }
+}
+
+
+/**
+ * @brief  Unblocked LU of the panel A[k0:n, k0:k0+kb], swapping whole rows.
+ */
+static int32_t LU_FactorPanel(float *A, int n, int k0, int kb,
+    int32_t *Perm)
+{
+  int i, j, c, p;
+  float tmp, l;
+  float *rowj, *rowi;
+
+  for(j = k0; j < k0 + kb; j++){
+    /* find pivot row, the row with biggest entry in current column */
+    p = j;
+    tmp = fabsf(A[j*n + j]);
+    for(i = j + 1; i < n; i++){
+      if(fabsf(A[i*n + j]) > tmp){
+        tmp = fabsf(A[i*n + j]);
+        p = i;
+      }
+    }
+    Perm[j] = p;
+    if(A[p*n + j] == 0.0f){
+      return 0;
+    }
+    if(p != j){
+      for(c = 0; c < n; c++){
+        tmp = A[j*n + c];
+        A[j*n + c] = A[p*n + c];
+        A[p*n + c] = tmp;
+      }
+    }
+
+    rowj = A + j*n;
+    tmp = 1.0f / rowj[j];
+    for(i = j + 1; i < n; i++){
+      rowi = A + i*n;
+      rowi[j] *= tmp;
+      l = rowi[j];
+      for(c = j + 1; c < k0 + kb; c++){
+        rowi[c] -= l * rowj[c];
+      }
+    }
+  }
+  return 1;
+}
+
+
+/**
+ * @brief  Columns Begin to End (counted from the end of the panel) of the
+ *         block row U12 = inv(L11) * A12 and of A22 = A22 - L21 * U12.
+ */
+static void LU_UpdateTask(void *Context, int Begin, int End)
+{
+  LU_Context_t *ctx = (LU_Context_t *)Context;
+  float *A = ctx->A;
+  int n = ctx->n;
+  int k0 = ctx->k0;
+  int kb = ctx->kb;
+  int c0 = k0 + kb + Begin;
+  int w = End - Begin;
+  int i, k, c;
+  float l;
+
+  /* U12 = inv(L11) * A12, L11 unit lower triangular */
+  for(i = k0 + 1; i < k0 + kb; i++){
+    for(k = k0; k < i; k++){
+      l = A[i*n + k];
+      for(c = c0; c < c0 + w; c++){
+        A[i*n + c] -= l * A[k*n + c];
+      }
+    }
+  }
+
+  /* A22 = A22 - L21 * U12 */
+  if(k0 + kb < n){
+    LU_MultiplySubtract(A + (k0 + kb)*n + k0, A + k0*n + c0,
+        n - k0 - kb, kb, w, A + (k0 + kb)*n + c0, n, n, n);
+  }
+}
+
+
+int32_t LUDecomposition(float *A, int n, int32_t *Perm)
+{
+  LU_Context_t ctx;
+  int k0, kb;
+
+  ctx.A = A;
+  ctx.n = n;
+  for(k0 = 0; k0 < n; k0 += LU_NB){
+    kb = (n - k0) < LU_NB ? (n - k0) : LU_NB;
+    if(LU_FactorPanel(A, n, k0, kb, Perm) == 0){
+      return 0;
+    }
+    /* Trailing update, columns split among threads */
+    ctx.k0 = k0;
+    ctx.kb = kb;
+    MatrixParallel_For(n - k0 - kb, LU_GRAIN, LU_UpdateTask, &ctx);
+  }
+  return 1;
+}
+
+
+/**
+ * @brief  Solves L * U * X = B for the columns Begin to End of B.
+ */
+static void LU_SolveTask(void *Context, int Begin, int End)
+{
+  LU_Context_t *ctx = (LU_Context_t *)Context;
+  float *LU = ctx->A;
+  int n = ctx->n;
+  int ld = ctx->NumRhs;
+  float *B = ctx->B + Begin;
+  int w = End - Begin;
+  int i0, ib, i, k, c;
+  float l;
+
+  /* Forward substitution with the unit lower triangular L */
+  for(i0 = 0; i0 < n; i0 += LU_NB){
+    ib = (n - i0) < LU_NB ? (n - i0) : LU_NB;
+    if(i0 > 0){
+      LU_MultiplySubtract(LU + i0*n, B, ib, i0, w, B + i0*ld, n, ld, ld);
+    }
+    for(i = i0 + 1; i < i0 + ib; i++){
+      for(k = i0; k < i; k++){
+        l = LU[i*n + k];
+        for(c = 0; c < w; c++){
+          B[i*ld + c] -= l * B[k*ld + c];
+        }
+      }
+    }
+  }
+
+  /* Back substitution with U */
+  for(i0 = ((n - 1) / LU_NB) * LU_NB; i0 >= 0; i0 -= LU_NB){
+    ib = (n - i0) < LU_NB ? (n - i0) : LU_NB;
+    if(i0 + ib < n){
+      LU_MultiplySubtract(LU + i0*n + i0 + ib, B + (i0 + ib)*ld,
+          ib, n - i0 - ib, w, B + i0*ld, n, ld, ld);
+    }
+    for(i = i0 + ib - 1; i >= i0; i--){
+      for(k = i + 1; k < i0 + ib; k++){
+        l = LU[i*n + k];
+        for(c = 0; c < w; c++){
+          B[i*ld + c] -= l * B[k*ld + c];
+        }
+      }
+      l = 1.0f / LU[i*n + i];
+      for(c = 0; c < w; c++){
+        B[i*ld + c] *= l;
+      }
+    }
+  }
+}
+
+
+void LUSolve(float *LU, int n, int32_t *Perm, float *B, int NumRhs)
+{
+  LU_Context_t ctx;
+  int k, c;
+  float tmp;
+
+  /* B = P * B */
+  for(k = 0; k < n; k++){
+    if(Perm[k] != k){
+      for(c = 0; c < NumRhs; c++){
+        tmp = B[k*NumRhs + c];
+        B[k*NumRhs + c] = B[Perm[k]*NumRhs + c];
+        B[Perm[k]*NumRhs + c] = tmp;
+      }
+    }
+  }
+
+  /* Right-hand sides are independent, split them among threads */
+  ctx.A = LU;
+  ctx.B = B;
+  ctx.n = n;
+  ctx.NumRhs = NumRhs;
+  MatrixParallel_For(NumRhs, LU_GRAIN, LU_SolveTask, &ctx);
+}
+
+
+int32_t InvertMatrixLU(float *A, int n)
+{
+  float *lu;
+  int32_t *perm;
+  int i;
+
+  lu = malloc(sizeof(float) * n * n);
+  perm = malloc(sizeof(int32_t) * n);
+  if(lu == NULL || perm == NULL){
+    free(lu);
+    free(perm);
+    return 0;
+  }
+
+  for(i = 0; i < n * n; i++){
+    lu[i] = A[i];
+  }
+  if(LUDecomposition(lu, n, perm) == 0){
+    free(lu);
+    free(perm);
+    return 0;
+  }
+
+  /* inv(A) solves A * X = I */
+  for(i = 0; i < n * n; i++){
+    A[i] = 0.0f;
+  }
+  for(i = 0; i < n; i++){
+    A[i*n + i] = 1.0f;
+  }
+  LUSolve(lu, n, perm, A, n);
+
+  free(lu);
+  free(perm);
+  return 1;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file  matrix_lu.h
+ * @date  18-October-2026
+ * @brief Blocked LU factorization, solve and inversion for big matrices.
+ *
+ *   Right-looking LU with partial pivoting. The trailing updates and the
+ *   solves are done by the cache-blocked GEMM engine and are spread over
+ *   the worker pool of matrix_parallel.h.
+ *
+ * @author
+ * @author
+ */
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MATRIX_LU_H
+#define MATRIX_LU_H
+
+
+#define MATRIX_LU_VER_MAJOR                                                 2026
+#define MATRIX_LU_VER_MINOR                                                   10
+#define MATRIX_LU_VER_PATCH                                                    1
+#define MATRIX_LU_BRANCH_MASTER
+
+
+#include <stdint.h>
+
+
+/**
+ * @brief Width of the panels factored between two trailing updates.
+ */
+#ifndef MATRIX_LU_BLOCK
+#define MATRIX_LU_BLOCK                                                       64
+#endif
+
+/**
+ * @brief Order from which InvertMatrix switches from Gauss-Jordan to LU.
+ */
+#ifndef MATRIX_LU_THRESHOLD
+#define MATRIX_LU_THRESHOLD                                                  128
+#endif
+
+
+/**
+ * @brief  Computes the factorization P * A = L * U, in place.
+ * @param  A : Pointer to input matrix (n x n).
+ * @param  n : Number of rows and columns in A.
+ * @param  Perm : 1-D array of size n receiving the row swaps (step k
+ *                swapped rows k and Perm[k]).
+ * @retval int32_t
+ * @note   On return the strictly lower triangle of A holds the unit lower
+ *         triangular L and the upper triangle holds U.
+ *         The function returns 1 on success, 0 if A is singular (A is
+ *         left partially factored).
+ */
+int32_t LUDecomposition(float *A, int n, int32_t *Perm);
+
+
+/**
+ * @brief  Solves A * X = B given the LU factorization of A, store X in B.
+ * @param  LU : Pointer to the factors computed by LUDecomposition (n x n).
+ * @param  n : Number of rows and columns in LU.
+ * @param  Perm : Swaps recorded by LUDecomposition.
+ * @param  B : Pointer to right-hand side matrix (n x NumRhs), replaced by X.
+ * @param  NumRhs : Number of columns in B.
+ * @retval void
+ */
+void LUSolve(float *LU, int n, int32_t *Perm, float *B, int NumRhs);
+
+
+/**
+ * @brief  Invert matrix A through its LU factorization, store result in A.
+ * @param  A : Pointer to input matrix (n x n).
+ * @param  n : Number of rows and columns in A.
+ * @retval int32_t
+ * @note   Used by InvertMatrix from MATRIX_LU_THRESHOLD on. Needs a
+ *         n * n heap buffer; A is left untouched on failure.
+ *         The function returns 1 on success, 0 on failure (A is singular
+ *         or memory could not be allocated).
+ */
+int32_t InvertMatrixLU(float *A, int n);
+
+#endif /* MATRIX_LU_H */
+
+
+
+#ifdef __cplusplus
+}
+#endif
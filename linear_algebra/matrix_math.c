@@ -1,70 +1,21 @@
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include "matrix_math.h"
-
-
-/**
- * @brief  Computes aproximation for square root of a floating point number.
- * @param  x : Number to compute the square root.
- * @retval float
- * @note   Assumes that float is in the IEEE 754 single precision floating
- *         point format and that int is 32 bits.
- *         Source:
- *         https://en.wikipedia.org/wiki/Methods_of_computing_square_roots
- */
-float Sqrt_approx(float x)
-{
-  typedef union{int32_t asint32; float asfloat;}FLOAT_INT32;
-  FLOAT_INT32 val;
-  val.asfloat = x;
-
-  val.asint32 = (val.asint32 >> 1) + 532676608L - 0x4B0D2L;
-
-  return val.asfloat;
-}
-
-
-/**
- * @brief  Computes aproximation for inverse square root of a float number.
- * @param  x : Number to compute the inverse square root.
- * @retval float
- * @note   Assumes that float is in the IEEE 754 single precision floating
- *         point format and that int is 32 bits.
- *         Source:
- *         https://en.wikipedia.org/wiki/Methods_of_computing_square_roots
- */
-float InvSqrt_approx(float x)
-{
-  //float xhalf = 0.5f*x;
-  typedef union{int32_t asint32; float asfloat;}FLOAT_INT32;
-  FLOAT_INT32 val;
-  val.asfloat = x;
-  val.asint32 = 0x5f375a86 - (val.asint32 >> 1);
-  /* The next line can be repeated any number of times to increase accuracy */
-  //val.asint32 = val.asint32 * (1.5f - xhalf * u.x * u.x);
-  return val.asfloat;
-}
+#include "matrix_gemm.h"
+#include "matrix_lu.h"
+#include "matrix_simd.h"
 
 
 float NormVectorL1(float *V, int Size)
 {
-  int32_t i;
-  float norm = 0.0;
-  for(i = 0; i < Size; i++){
-    norm += fabsf(*(V+i));
-  }
-  return norm;
+  return MatrixSimd_Get()->NormL1(V, Size);
 }
 
 
 float NormVectorL2Squared(float *V, uint32_t Size)
 {
-  int32_t i;
-  float norm = 0.0;
-  for(i = 0; i < Size; i++){
-    norm += (*(V+i)) * (*(V+i));
-  }
-  return norm;
+  return MatrixSimd_Get()->NormL2Squared(V, (int32_t)Size);
 }
 
 
@@ -94,97 +45,323 @@ void ConcatenateVector(float *V1, int32_t SizeV1, float *V2, int32_t SizeV2,
 
 void DotProduct(float *V1, float *V2, int32_t Size, float  *Result)
 {
-  int i;
-  *Result = 0.0;
-  for(i = 0; i < Size; i++){
-    *Result += (*V1) * (*V2);
-    V1++; V2++;
-  }
+  *Result = MatrixSimd_Get()->Dot(V1, V2, Size);
 }
 
 
 void CopyMatrix(float *A, int m, int n, float *B)
 {
-  int i,j;
-  j = m*n;
-  for (i = 0; i < j ; i++){
-    *B = *A;
-    A++;B++;
-  }
+  MatrixSimd_Get()->Copy(A, m*n, B);
 }
 
 
-void MultiplyMatrix(float* A, float* B, int m, int p, int n, float* C)
+/**
+ * @brief  C = A * B for row-major matrices with row strides Lda, Ldb and
+ *         Ldc, shared by MultiplyMatrix and MultiplyMatrixView.
+ */
+static void MultiplyMatrixStrided(float *A, float *B, int m, int p, int n,
+    float *C, int Lda, int Ldb, int Ldc)
 {
   int i, j, k;
+  float sum;
+
+  /* Big products go to the cache-blocked engine */
+  if(m >= MATRIX_GEMM_MR && n >= MATRIX_GEMM_NR &&
+      (int64_t)m * p * n >= MATRIX_GEMM_THRESHOLD){
+    if(GemmMatrix(A, B, m, p, n, C, Lda, Ldb, Ldc, 1.0f, 0.0f) == 1){
+      return;
+    }
+  }
+
   for (i = 0; i < m; i++)
   {
     for(j = 0; j < n; j++)
     {
-      *(C + n*i + j) = 0;
+      sum = 0;
       for (k = 0; k < p; k++){
-        *(C + n*i + j) = *(C + n*i + j) + *(A + p*i + k) * (*(B + n*k + j));
+        sum = sum + *(A + Lda*i + k) * (*(B + Ldb*k + j));
       }
+      *(C + Ldc*i + j) = sum;
     }
   }
 }
 
 
+void MultiplyMatrix(float* A, float* B, int m, int p, int n, float* C)
+{
+  MultiplyMatrixStrided(A, B, m, p, n, C, p, n, n);
+}
+
+
 void AddMatrix(float *A, float *B, int m, int n, float *C)
 {
-  int i,j;
-  j = m*n;
-  for (i = 0; i < j ; i++)
-  {
-    *C = *A + *B;
-    A++;B++;C++;
-  }
+  MatrixSimd_Get()->Add(A, B, m*n, C);
 }
 
 
 void SubtractMatrix(float *A, float *B, int m, int n, float *C)
 {
-  int i,j;
-  j = m*n;
-  for (i = 0; i < j ; i++)
-  {
-    *C = *A - *B;
-    A++;B++;C++;
+  MatrixSimd_Get()->Subtract(A, B, m*n, C);
+}
+
+
+/**
+ * @brief  C = A' for a group of up to 2 x 2 tiles of A (Rows x Cols, both
+ *         at most 2 * MATRIX_SIMD_TILE). A whole group reads and writes
+ *         whole cache lines, so none has to be fetched twice.
+ */
+static void TransposeTileGroup(void (*Tile)(const float *, int, float *,
+    int), float *A, int Lda, float *C, int Ldc, int Rows, int Cols)
+{
+  int i, j, r, c;
+
+  for(i = 0; i + MATRIX_SIMD_TILE <= Rows; i += MATRIX_SIMD_TILE){
+    for(j = 0; j + MATRIX_SIMD_TILE <= Cols; j += MATRIX_SIMD_TILE){
+      Tile(A + (int64_t)i*Lda + j, Lda, C + (int64_t)j*Ldc + i, Ldc);
+    }
+    for(c = j; c < Cols; c++){
+      for(r = i; r < i + MATRIX_SIMD_TILE; r++){
+        C[(int64_t)c*Ldc + r] = A[(int64_t)r*Lda + c];
+      }
+    }
+  }
+  for(r = i; r < Rows; r++){
+    for(c = 0; c < Cols; c++){
+      C[(int64_t)c*Ldc + r] = A[(int64_t)r*Lda + c];
+    }
+  }
+}
+
+
+/**
+ * @brief  C = A' for A (m x n) and C (n x m) with rows Lda and Ldc apart.
+ * @note   C is filled block row by block row, each block of
+ *         MATRIX_TRANSPOSE_BLOCK as groups of tiles transposed in
+ *         registers.
+ */
+static void TransposeMatrixStrided(float *A, int m, int n, int Lda, float *C,
+    int Ldc)
+{
+  void (*tile)(const float *, int, float *, int) =
+      MatrixSimd_Get()->TransposeTile;
+  const int group = 2 * MATRIX_SIMD_TILE;
+  int ib, jb, ie, je, i, j;
+
+  for(jb = 0; jb < n; jb += MATRIX_TRANSPOSE_BLOCK){
+    je = (jb + MATRIX_TRANSPOSE_BLOCK < n) ? jb + MATRIX_TRANSPOSE_BLOCK : n;
+    for(ib = 0; ib < m; ib += MATRIX_TRANSPOSE_BLOCK){
+      ie = (ib + MATRIX_TRANSPOSE_BLOCK < m) ?
+          ib + MATRIX_TRANSPOSE_BLOCK : m;
+      for(j = jb; j < je; j += group){
+        for(i = ib; i < ie; i += group){
+          TransposeTileGroup(tile, A + (int64_t)i*Lda + j, Lda,
+              C + (int64_t)j*Ldc + i, Ldc,
+              (ie - i < group) ? ie - i : group,
+              (je - j < group) ? je - j : group);
+        }
+      }
+    }
   }
 }
 
 
 void TransposeMatrix(float *A, int m, int n, float *C)
 {
-  int i, j;
-  for (i = 0; i < m; i++)
-  {
-    for(j = 0; j < n; j++){
-      *(C+m*j+i) = *(A+n*i+j);
+  TransposeMatrixStrided(A, m, n, n, C, m);
+}
+
+
+/**
+ * @brief  In place transpose of a square matrix: tiles (i, j) and (j, i)
+ *         are exchanged, each transposed in registers on the way.
+ */
+static void TransposeSquareInPlace(float *A, int n)
+{
+  void (*tile)(const float *, int, float *, int) =
+      MatrixSimd_Get()->TransposeTile;
+  float buf[MATRIX_SIMD_TILE * MATRIX_SIMD_TILE];
+  float *aij, *aji, aux;
+  int nt = n - n % MATRIX_SIMD_TILE;
+  int ib, jb, ie, je, i, j, r;
+
+  for(ib = 0; ib < nt; ib += MATRIX_TRANSPOSE_BLOCK){
+    ie = (ib + MATRIX_TRANSPOSE_BLOCK < nt) ? ib + MATRIX_TRANSPOSE_BLOCK : nt;
+    for(jb = ib; jb < nt; jb += MATRIX_TRANSPOSE_BLOCK){
+      je = (jb + MATRIX_TRANSPOSE_BLOCK < nt) ?
+          jb + MATRIX_TRANSPOSE_BLOCK : nt;
+      for(i = ib; i < ie; i += MATRIX_SIMD_TILE){
+        for(j = (jb == ib) ? i : jb; j < je; j += MATRIX_SIMD_TILE){
+          aij = A + (int64_t)i*n + j;
+          aji = A + (int64_t)j*n + i;
+          /* buf = Aij', Aij = Aji', Aji = buf */
+          tile(aij, n, buf, MATRIX_SIMD_TILE);
+          if(i != j){
+            tile(aji, n, aij, n);
+          }
+          for(r = 0; r < MATRIX_SIMD_TILE; r++){
+            CopyMatrix(buf + r*MATRIX_SIMD_TILE, 1, MATRIX_SIMD_TILE,
+                aji + (int64_t)r*n);
+          }
+        }
+      }
+    }
+  }
+
+  /* Rows and columns past the last whole tile */
+  for(i = 0; i < n; i++){
+    for(j = (i + 1 > nt) ? i + 1 : nt; j < n; j++){
+      aux = A[(int64_t)i*n + j];
+      A[(int64_t)i*n + j] = A[(int64_t)j*n + i];
+      A[(int64_t)j*n + i] = aux;
     }
   }
 }
 
 
-void ScaleMatrix(float *A, int m, int n, float k, float *C)
+/**
+ * @brief  Returns the width b of the strips TransposeMatrixInPlace moves:
+ *         the largest divisor of m (ByRows = 1) or n (ByRows = 0) up to
+ *         MATRIX_TRANSPOSE_STRIP, smaller than the dimension it divides.
+ *         When both qualify, the one needing the smaller scratch (b * n
+ *         or m * b floats) is taken.
+ */
+static int TransposeStripWidth(int m, int n, int *ByRows)
 {
-  int i,j;
-  j = m*n;
-  for (i = 0; i < j ; i++)
-  {
-    *C = (*A)*k;
-    A++; C++;
+  int b, rows, cols;
+
+  for(b = MATRIX_TRANSPOSE_STRIP; b > 1; b--){
+    rows = (m % b == 0 && m > b);
+    cols = (n % b == 0 && n > b);
+    if(rows && (!cols || n <= m)){
+      *ByRows = 1;
+      return b;
+    }
+    if(cols){
+      *ByRows = 0;
+      return b;
+    }
   }
+  *ByRows = 1;
+  return 1;
 }
 
 
-int32_t InvertMatrix(float *A, int n)
+/**
+ * @brief  Moves the strips of Width floats of A, seen as a Rows x Cols
+ *         matrix of strips, to their place in its transpose.
+ * @note   Strip k goes to k*Rows mod (Rows*Cols - 1). Each cycle of that
+ *         permutation is followed once, a bit per strip of Moved (cleared
+ *         by the caller) recording the ones already in place.
+ */
+static void TransposeStrips(float *A, int64_t Rows, int64_t Cols, int Width,
+    uint8_t *Moved)
+{
+  float hold[2][MATRIX_TRANSPOSE_STRIP];
+  size_t bytes = sizeof(float) * Width;
+  int64_t last = Rows * Cols - 1;
+  int64_t start, k;
+  float value, aux;
+  int cur;
+
+  for(start = 1; start < last; start++){
+    if(Moved[start >> 3] & (1u << (start & 7))){
+      continue;
+    }
+    k = start;
+    if(Width == 1){
+      value = A[start];
+      do{
+        k = (k * Rows) % last;
+        aux = A[k];
+        A[k] = value;
+        value = aux;
+        Moved[k >> 3] |= (uint8_t)(1u << (k & 7));
+      }while(k != start);
+      continue;
+    }
+    memcpy(hold[0], A + start * Width, bytes);
+    cur = 0;
+    do{
+      k = (k * Rows) % last;
+      memcpy(hold[cur ^ 1], A + k * Width, bytes);
+      memcpy(A + k * Width, hold[cur], bytes);
+      cur ^= 1;
+      Moved[k >> 3] |= (uint8_t)(1u << (k & 7));
+    }while(k != start);
+  }
+}
+
+
+int32_t TransposeMatrixInPlace(float *A, int m, int n)
+{
+  int64_t strips, k;
+  int width, byRows;
+  float *scratch = NULL, *block;
+  uint8_t *moved;
+
+  if(m == n){
+    TransposeSquareInPlace(A, n);
+    return 1;
+  }
+  if(m <= 1 || n <= 1){
+    return 1;
+  }
+
+  width = TransposeStripWidth(m, n, &byRows);
+  strips = (int64_t)m * n / width;
+  moved = calloc((size_t)(strips + 7) / 8, 1);
+  if(width > 1){
+    scratch = malloc(sizeof(float) * width * (byRows ? n : m));
+  }
+  if(moved == NULL || (width > 1 && scratch == NULL)){
+    free(moved);
+    free(scratch);
+    return 0;
+  }
+
+  if(byRows){
+    /* Each block of width rows becomes n x width, then strip j of block */
+    /*  k (row j of block k) goes to column block k of row j of A'       */
+    for(k = 0; k < m / width && width > 1; k++){
+      block = A + k * width * n;
+      memcpy(scratch, block, sizeof(float) * width * n);
+      TransposeMatrixStrided(scratch, width, n, n, block, width);
+    }
+    TransposeStrips(A, m / width, n, width, moved);
+  }else{
+    /* Strips of A (m x n/width) moved so that column block k is an m x */
+    /*  width block, then each block becomes rows k*width.. of A'       */
+    TransposeStrips(A, m, n / width, width, moved);
+    for(k = 0; k < n / width; k++){
+      block = A + k * m * width;
+      memcpy(scratch, block, sizeof(float) * m * width);
+      TransposeMatrixStrided(scratch, m, width, width, block, m);
+    }
+  }
+
+  free(moved);
+  free(scratch);
+  return 1;
+}
+
+
+void ScaleMatrix(float *A, int m, int n, float k, float *C)
+{
+  MatrixSimd_Get()->Scale(A, m*n, k, C);
+}
+
+
+/**
+ * @brief  Gauss-Jordan inversion of a matrix whose rows are Lda elements
+ *         apart, for n < MATRIX_LU_THRESHOLD.
+ */
+static int32_t InvertMatrixGaussJordan(float *A, int n, int Lda)
 {
   // A = input matrix AND result matrix
   // n = number of rows = number of columns in A (n x n)
   int pivrow = 0;   // keeps track of current pivot row
   int k, i, j;    // k: overall index along diagonal; i: row index; j: col index
-  int pivrows[n]; // keeps track of rows swaps to undo at end
+  int pivrows[MATRIX_LU_THRESHOLD]; // keeps track of rows swaps to undo at end
   float tmp;    // used for finding max value and making column swaps
 
   for (k = 0; k < n; k++){
@@ -192,14 +369,14 @@ int32_t InvertMatrix(float *A, int n)
     tmp = 0;
     for (i = k; i < n; i++){
       // 'Avoid using other functions inside abs()?'
-      if (fabs(*(A + i*n + k)) >= tmp){
-        tmp = fabs(*(A + i*n + k));
+      if (fabs(*(A + i*Lda + k)) >= tmp){
+        tmp = fabs(*(A + i*Lda + k));
         pivrow = i;
       }
     }
 
     // check for singular matrix
-    if (*(A + pivrow*n + k) == 0.0f){
+    if (*(A + pivrow*Lda + k) == 0.0f){
       //Serial.println("Inversion failed due to singular matrix");
       return 0;
     }
@@ -208,30 +385,30 @@ int32_t InvertMatrix(float *A, int n)
     if (pivrow != k){
       // swap row k with pivrow
       for (j = 0; j < n; j++){
-        tmp = *(A + k*n + j);
-        *(A + k*n + j) = *(A + pivrow*n + j);
-        *(A + pivrow*n + j) = tmp;
+        tmp = *(A + k*Lda + j);
+        *(A + k*Lda + j) = *(A + pivrow*Lda + j);
+        *(A + pivrow*Lda + j) = tmp;
       }
     }
     pivrows[k] = pivrow;  // record row swap (even if no swap happened)
 
-    tmp = 1.0f / *(A + k*n + k);  // invert pivot element
+    tmp = 1.0f / *(A + k*Lda + k);  // invert pivot element
     // This element of input matrix becomes result matrix
-    *(A + k*n + k) = 1.0f;
+    *(A + k*Lda + k) = 1.0f;
 
     // Perform row reduction (divide every element by pivot)
     for (j = 0; j < n; j++){
-      *(A + k*n + j) = (*(A + k*n + j)) * tmp;
+      *(A + k*Lda + j) = (*(A + k*Lda + j)) * tmp;
     }
 
     // Now eliminate all other entries in this column
     for (i = 0; i < n; i++){
       if (i != k){
-        tmp = *(A + i*n + k);
+        tmp = *(A + i*Lda + k);
         // The other place where in matrix becomes result mat
-        *(A + i*n + k) = 0.0f;
+        *(A + i*Lda + k) = 0.0f;
         for (j = 0; j < n; j++){
-          *(A + i*n + j) = *(A + i*n + j) - *(A + k*n + j) * tmp;
+          *(A + i*Lda + j) = *(A + i*Lda + j) - *(A + k*Lda + j) * tmp;
         }
       }
     }
@@ -242,11 +419,415 @@ int32_t InvertMatrix(float *A, int n)
   for (k = n - 1; k >= 0; k--){
     if (pivrows[k] != k){
       for (i = 0; i < n; i++){
-        tmp = *(A + i*n + k);
-        *(A + i*n + k) = *(A + i*n + pivrows[k]);
-        *(A + i*n + pivrows[k]) = tmp;
+        tmp = *(A + i*Lda + k);
+        *(A + i*Lda + k) = *(A + i*Lda + pivrows[k]);
+        *(A + i*Lda + pivrows[k]) = tmp;
+      }
+    }
+  }
+  return 1;
+}
+
+
+int32_t InvertMatrix(float *A, int n)
+{
+  // Big matrices go through the blocked LU
+  if (n >= MATRIX_LU_THRESHOLD){
+    return InvertMatrixLU(A, n);
+  }
+  return InvertMatrixGaussJordan(A, n, n);
+}
+
+
+int32_t CholeskyDecomposition(float *A, int n)
+{
+  int i, j, k;
+  float sum, tmp;
+  float *rowi, *rowj;
+
+  /* Row by row (Cholesky-Banachiewicz), so inner products run over */
+  /*  contiguous rows of L                                           */
+  for(i = 0; i < n; i++){
+    rowi = A + i*n;
+    for(j = 0; j <= i; j++){
+      rowj = A + j*n;
+      sum = rowi[j];
+      if(j < 32){
+        /* Too short to pay for the SIMD kernel call */
+        for(k = 0; k < j; k++){
+          sum -= rowi[k] * rowj[k];
+        }
+      }else{
+        DotProduct(rowi, rowj, j, &tmp);
+        sum -= tmp;
+      }
+      if(i == j){
+        if(!(sum > 0.0f)){
+          return 0;
+        }
+        rowi[i] = sqrtf(sum);
+      }else{
+        rowi[j] = sum / rowj[j];
       }
     }
   }
   return 1;
 }
+
+
+void CholeskySolve(float *L, int n, float *B, int NumRhs)
+{
+  SolveLowerTriangular(L, n, B, NumRhs, 0);
+  SolveLowerTriangularTransposed(L, n, B, NumRhs, 0);
+}
+
+
+void SolveLowerTriangular(float *L, int n, float *B, int NumRhs,
+    int UnitDiagonal)
+{
+  int i, k, r;
+  float lik;
+  float *bi, *bk;
+
+  for(i = 0; i < n; i++){
+    bi = B + i*NumRhs;
+    for(k = 0; k < i; k++){
+      lik = L[i*n + k];
+      bk = B + k*NumRhs;
+      for(r = 0; r < NumRhs; r++){
+        bi[r] -= lik * bk[r];
+      }
+    }
+    if(UnitDiagonal == 0){
+      lik = 1.0f / L[i*n + i];
+      for(r = 0; r < NumRhs; r++){
+        bi[r] *= lik;
+      }
+    }
+  }
+}
+
+
+void SolveLowerTriangularTransposed(float *L, int n, float *B, int NumRhs,
+    int UnitDiagonal)
+{
+  int i, k, r;
+  float lki;
+  float *bi, *bk;
+
+  /* Column i of L' is row i of L, so B[i] is finished first and then */
+  /*  removed from all rows above it                                   */
+  for(i = n - 1; i >= 0; i--){
+    bi = B + i*NumRhs;
+    if(UnitDiagonal == 0){
+      lki = 1.0f / L[i*n + i];
+      for(r = 0; r < NumRhs; r++){
+        bi[r] *= lki;
+      }
+    }
+    for(k = 0; k < i; k++){
+      lki = L[i*n + k];
+      bk = B + k*NumRhs;
+      for(r = 0; r < NumRhs; r++){
+        bk[r] -= lki * bi[r];
+      }
+    }
+  }
+}
+
+
+int32_t LDLDecomposition(float *A, int n, int32_t *Perm, float Tolerance)
+{
+  int i, j, k, p;
+  int32_t rank = 0;
+  float tmp, d, vi, maxDiag = 0.0f;
+
+  for(i = 0; i < n; i++){
+    if(fabsf(A[i*n + i]) > maxDiag){
+      maxDiag = fabsf(A[i*n + i]);
+    }
+  }
+  Tolerance *= maxDiag;
+
+  for(k = 0; k < n; k++){
+    if(Perm != NULL){
+      /* Symmetric pivoting: bring the largest remaining diagonal to k */
+      p = k;
+      for(i = k + 1; i < n; i++){
+        if(fabsf(A[i*n + i]) > fabsf(A[p*n + p])){
+          p = i;
+        }
+      }
+      Perm[k] = p;
+      if(p != k){
+        for(j = 0; j < n; j++){
+          tmp = A[k*n + j]; A[k*n + j] = A[p*n + j]; A[p*n + j] = tmp;
+        }
+        for(i = 0; i < n; i++){
+          tmp = A[i*n + k]; A[i*n + k] = A[i*n + p]; A[i*n + p] = tmp;
+        }
+      }
+    }
+
+    d = A[k*n + k];
+    if(!(fabsf(d) > Tolerance)){
+      /* Singular direction: zero pivot and empty column of L */
+      A[k*n + k] = 0.0f;
+      for(i = k + 1; i < n; i++){
+        A[i*n + k] = 0.0f;
+      }
+      continue;
+    }
+    rank++;
+
+    /* Update of the trailing matrix, both triangles kept for pivoting */
+    for(i = k + 1; i < n; i++){
+      vi = A[i*n + k] / d;
+      for(j = k + 1; j < n; j++){
+        A[i*n + j] -= vi * A[k*n + j];
+      }
+    }
+    for(i = k + 1; i < n; i++){
+      A[i*n + k] /= d;
+    }
+  }
+  return rank;
+}
+
+
+void LDLSolve(float *LD, int n, int32_t *Perm, float *B, int NumRhs)
+{
+  int i, k, r;
+  float tmp, d;
+
+  if(Perm != NULL){
+    for(k = 0; k < n; k++){
+      if(Perm[k] != k){
+        for(r = 0; r < NumRhs; r++){
+          tmp = B[k*NumRhs + r];
+          B[k*NumRhs + r] = B[Perm[k]*NumRhs + r];
+          B[Perm[k]*NumRhs + r] = tmp;
+        }
+      }
+    }
+  }
+
+  SolveLowerTriangular(LD, n, B, NumRhs, 1);
+  for(i = 0; i < n; i++){
+    d = LD[i*n + i];
+    ScaleMatrix(B + i*NumRhs, 1, NumRhs, (d != 0.0f) ? 1.0f / d : 0.0f,
+        B + i*NumRhs);
+  }
+  SolveLowerTriangularTransposed(LD, n, B, NumRhs, 1);
+
+  if(Perm != NULL){
+    for(k = n - 1; k >= 0; k--){
+      if(Perm[k] != k){
+        for(r = 0; r < NumRhs; r++){
+          tmp = B[k*NumRhs + r];
+          B[k*NumRhs + r] = B[Perm[k]*NumRhs + r];
+          B[Perm[k]*NumRhs + r] = tmp;
+        }
+      }
+    }
+  }
+}
+
+
+void MatrixViewInit(MatrixView_t *View, float *Data, int Rows, int Cols,
+    int Stride)
+{
+  View->Data = Data;
+  View->Rows = Rows;
+  View->Cols = Cols;
+  View->Stride = Stride;
+}
+
+
+int32_t MatrixViewBlock(MatrixView_t *View, int Row, int Col, int Rows,
+    int Cols, MatrixView_t *Block)
+{
+  if(Row < 0 || Col < 0 || Rows < 0 || Cols < 0 ||
+      Row + Rows > View->Rows || Col + Cols > View->Cols){
+    return 0;
+  }
+  Block->Data = View->Data + (int64_t)Row * View->Stride + Col;
+  Block->Rows = Rows;
+  Block->Cols = Cols;
+  Block->Stride = View->Stride;
+  return 1;
+}
+
+
+/**
+ * @brief  Returns 1 if the rows of the view follow each other in memory.
+ */
+static int MatrixViewIsDense(MatrixView_t *V)
+{
+  return (V->Stride == V->Cols || V->Rows <= 1) ? 1 : 0;
+}
+
+
+static int MatrixViewSameSize(MatrixView_t *A, MatrixView_t *B)
+{
+  return (A->Rows == B->Rows && A->Cols == B->Cols) ? 1 : 0;
+}
+
+
+int32_t CopyMatrixView(MatrixView_t *A, MatrixView_t *C)
+{
+  int i;
+
+  if(MatrixViewSameSize(A, C) == 0){
+    return 0;
+  }
+  if(MatrixViewIsDense(A) && MatrixViewIsDense(C)){
+    CopyMatrix(A->Data, A->Rows, A->Cols, C->Data);
+    return 1;
+  }
+  for(i = 0; i < A->Rows; i++){
+    CopyMatrix(A->Data + (int64_t)i*A->Stride, 1, A->Cols,
+        C->Data + (int64_t)i*C->Stride);
+  }
+  return 1;
+}
+
+
+int32_t MultiplyMatrixView(MatrixView_t *A, MatrixView_t *B, MatrixView_t *C)
+{
+  if(A->Cols != B->Rows || C->Rows != A->Rows || C->Cols != B->Cols){
+    return 0;
+  }
+  MultiplyMatrixStrided(A->Data, B->Data, A->Rows, A->Cols, B->Cols,
+      C->Data, A->Stride, B->Stride, C->Stride);
+  return 1;
+}
+
+
+int32_t AddMatrixView(MatrixView_t *A, MatrixView_t *B, MatrixView_t *C)
+{
+  int i;
+
+  if(MatrixViewSameSize(A, B) == 0 || MatrixViewSameSize(A, C) == 0){
+    return 0;
+  }
+  if(MatrixViewIsDense(A) && MatrixViewIsDense(B) && MatrixViewIsDense(C)){
+    AddMatrix(A->Data, B->Data, A->Rows, A->Cols, C->Data);
+    return 1;
+  }
+  for(i = 0; i < A->Rows; i++){
+    AddMatrix(A->Data + (int64_t)i*A->Stride, B->Data + (int64_t)i*B->Stride,
+        1, A->Cols, C->Data + (int64_t)i*C->Stride);
+  }
+  return 1;
+}
+
+
+int32_t SubtractMatrixView(MatrixView_t *A, MatrixView_t *B,
+    MatrixView_t *C)
+{
+  int i;
+
+  if(MatrixViewSameSize(A, B) == 0 || MatrixViewSameSize(A, C) == 0){
+    return 0;
+  }
+  if(MatrixViewIsDense(A) && MatrixViewIsDense(B) && MatrixViewIsDense(C)){
+    SubtractMatrix(A->Data, B->Data, A->Rows, A->Cols, C->Data);
+    return 1;
+  }
+  for(i = 0; i < A->Rows; i++){
+    SubtractMatrix(A->Data + (int64_t)i*A->Stride,
+        B->Data + (int64_t)i*B->Stride, 1, A->Cols,
+        C->Data + (int64_t)i*C->Stride);
+  }
+  return 1;
+}
+
+
+int32_t TransposeMatrixView(MatrixView_t *A, MatrixView_t *C)
+{
+  if(C->Rows != A->Cols || C->Cols != A->Rows){
+    return 0;
+  }
+  TransposeMatrixStrided(A->Data, A->Rows, A->Cols, A->Stride, C->Data,
+      C->Stride);
+  return 1;
+}
+
+
+int32_t ScaleMatrixView(MatrixView_t *A, float k, MatrixView_t *C)
+{
+  int i;
+
+  if(MatrixViewSameSize(A, C) == 0){
+    return 0;
+  }
+  if(MatrixViewIsDense(A) && MatrixViewIsDense(C)){
+    ScaleMatrix(A->Data, A->Rows, A->Cols, k, C->Data);
+    return 1;
+  }
+  for(i = 0; i < A->Rows; i++){
+    ScaleMatrix(A->Data + (int64_t)i*A->Stride, 1, A->Cols, k,
+        C->Data + (int64_t)i*C->Stride);
+  }
+  return 1;
+}
+
+
+int32_t DotProductView(MatrixView_t *V1, MatrixView_t *V2, float *Result)
+{
+  int i, size, inc1, inc2;
+  float sum;
+
+  if((V1->Rows != 1 && V1->Cols != 1) || (V2->Rows != 1 && V2->Cols != 1)){
+    return 0;
+  }
+  size = V1->Rows * V1->Cols;
+  if(size != V2->Rows * V2->Cols){
+    return 0;
+  }
+
+  /* Rows are contiguous, columns step by the stride */
+  inc1 = (V1->Rows == 1) ? 1 : V1->Stride;
+  inc2 = (V2->Rows == 1) ? 1 : V2->Stride;
+  if(inc1 == 1 && inc2 == 1){
+    DotProduct(V1->Data, V2->Data, size, Result);
+    return 1;
+  }
+  sum = 0.0f;
+  for(i = 0; i < size; i++){
+    sum += V1->Data[(int64_t)i*inc1] * V2->Data[(int64_t)i*inc2];
+  }
+  *Result = sum;
+  return 1;
+}
+
+
+int32_t InvertMatrixView(MatrixView_t *A)
+{
+  MatrixView_t packed;
+  int32_t ok;
+  int n = A->Rows;
+
+  if(A->Cols != n){
+    return 0;
+  }
+  if(n < MATRIX_LU_THRESHOLD){
+    return InvertMatrixGaussJordan(A->Data, n, A->Stride);
+  }
+  if(MatrixViewIsDense(A)){
+    return InvertMatrixLU(A->Data, n);
+  }
+
+  MatrixViewInit(&packed, malloc(sizeof(float) * n * n), n, n, n);
+  if(packed.Data == NULL){
+    return 0;
+  }
+  CopyMatrixView(A, &packed);
+  ok = InvertMatrixLU(packed.Data, n);
+  if(ok == 1){
+    CopyMatrixView(&packed, A);
+  }
+  free(packed.Data);
+  return ok;
+}
@@ -12,7 +12,7 @@
 
 
 #ifdef __cplusplus
-"C" {
+extern "C" {
 #endif
 
 #ifndef MATRIX_MATH_H
@@ -20,14 +20,46 @@
 
 
 #define MATRIX_MATH_VER_MAJOR                                               2021
-#define MATRIX_MATH_VER_MINOR                                                  1
-#define MATRIX_MATH_VER_PATCH                                                  2
+#define MATRIX_MATH_VER_MINOR                                                  3
+#define MATRIX_MATH_VER_PATCH                                                  0
 #define MATRIX_MATH_BRANCH_MASTER
 
 
 #include <stdint.h>
 
 
+/**
+ * @brief Rows and columns of the blocks swept by TransposeMatrix: a block
+ *        of A and the matching block of C stay in L2 together.
+ */
+#ifndef MATRIX_TRANSPOSE_BLOCK
+#define MATRIX_TRANSPOSE_BLOCK                                               128
+#endif
+
+/**
+ * @brief Widest strip, in floats, moved as one piece by the rectangular
+ *        TransposeMatrixInPlace (32 floats are two 64-byte cache lines).
+ */
+#ifndef MATRIX_TRANSPOSE_STRIP
+#define MATRIX_TRANSPOSE_STRIP                                                32
+#endif
+
+
+/**
+ * @brief Rectangular part of a row-major matrix, used in place.
+ * @note  Element (i, j) of the view is Data[i * Stride + j]. A block, a
+ *        column or a window of rows of a bigger matrix (e.g. a sample log)
+ *        is described without copying it.
+ */
+typedef struct
+{
+  float *Data;  /*!< Pointer to element (0, 0) */
+  int   Rows;   /*!< Number of rows */
+  int   Cols;   /*!< Number of columns */
+  int   Stride; /*!< Distance, in elements, between two rows (>= Cols) */
+}MatrixView_t;
+
+
 /**
  * @brief  Computes absolute-value norm of a row or column vector.
  * @param  v : Vector.
@@ -130,6 +162,8 @@ void CopyMatrix(float *A, int m, int n, float *B);
  * @param  n : Number of columns in B.
  * @param  C : Pointer to output matrix (m x n).
  * @retval void
+ * @note   Products bigger than MATRIX_GEMM_THRESHOLD multiply-adds are
+ *         computed by the cache-blocked engine in matrix_gemm.c.
  */
 void MultiplyMatrix(float *A, float *B, int m, int p, int n, float *C);
 
@@ -161,15 +195,39 @@ void SubtractMatrix(float *A, float *B, int m, int n, float *C);
 /**
  * @brief  Transpose A, store result in C.
  * @param  A : Pointer to input matrix (m x n).
- * @param  B : Pointer to input matrix (m x n).
  * @param  m : Number of rows in A.
  * @param  n : Number of columns A.
- * @param  C : Pointer to output matrix = transpose of A (n x m).
+ * @param  C : Pointer to output matrix = transpose of A (n x m), it must
+ *             not overlap A.
  * @retval void
+ * @note   A is swept in MATRIX_TRANSPOSE_BLOCK blocks, transposed as
+ *         8 x 8 tiles in SIMD registers, so both the reads and the writes
+ *         go through whole cache lines, a few pages at a time.
  */
 void TransposeMatrix(float *A, int m, int n, float *C);
 
 
+/**
+ * @brief  Transpose A in place.
+ * @param  A : Pointer to input matrix (m x n), replaced by its transpose
+ *             (n x m).
+ * @param  m : Number of rows in A.
+ * @param  n : Number of columns A.
+ * @retval int32_t
+ * @note   A square A is transposed tile by tile as in TransposeMatrix.
+ *         Otherwise A is cut in strips of b floats, b being the largest
+ *         divisor of m or n up to MATRIX_TRANSPOSE_STRIP: blocks of b rows
+ *         (or columns) are transposed through a b * max(m, n) scratch
+ *         buffer, and the strips are moved once along the cycles of the
+ *         transposition permutation, with m * n / (8 * b) bytes of
+ *         bookkeeping. When m and n have no such divisor (b = 1), single
+ *         elements are moved and it is much slower than TransposeMatrix.
+ *         The function returns 1 on success, 0 on failure (the scratch
+ *         could not be allocated, A is left untouched).
+ */
+int32_t TransposeMatrixInPlace(float *A, int m, int n);
+
+
 /**
  * @brief  Multiply A by constant K, store result in C.
  * @param  A : Pointer to input matrix (m x n).
@@ -192,6 +250,8 @@ void ScaleMatrix(float *A, int m, int n, float k, float *C);
  * Specifically, it uses partial pivoting to improve numeric stability.
  * The algorithm is drawn from those presented in
  * NUMERICAL RECIPES: The Art of Scientific Computing.
+ * From MATRIX_LU_THRESHOLD on, the blocked multithreaded LU of
+ * matrix_lu.h is used instead (it needs a n * n heap buffer).
  * The function returns 1 on success, 0 on failure.
  *
  * Returns 0 if no success
@@ -202,6 +262,219 @@ void ScaleMatrix(float *A, int m, int n, float k, float *C);
  */
 int32_t InvertMatrix(float *A, int n);
 
+
+/**
+ * @brief  Computes the Cholesky factorization A = L * L' of a symmetric
+ *         positive definite matrix, in place.
+ * @param  A : Pointer to input matrix (n x n).
+ * @param  n : Number of rows and columns in A.
+ * @retval int32_t
+ * @note   Only the lower triangle of A (diagonal included) is read, and it
+ *         is replaced by L. The strictly upper triangle is not touched.
+ *         Takes about n^3 / 3 flops, a third of InvertMatrix.
+ *         The function returns 1 on success, 0 if A is not (numerically)
+ *         positive definite.
+ */
+int32_t CholeskyDecomposition(float *A, int n);
+
+
+/**
+ * @brief  Solves A * X = B given the Cholesky factor of A, store X in B.
+ * @param  L : Pointer to the factor computed by CholeskyDecomposition
+ *             (n x n, lower triangle).
+ * @param  n : Number of rows and columns in L.
+ * @param  B : Pointer to right-hand side matrix (n x NumRhs), replaced by X.
+ * @param  NumRhs : Number of columns in B.
+ * @retval void
+ */
+void CholeskySolve(float *L, int n, float *B, int NumRhs);
+
+
+/**
+ * @brief  Solves L * X = B for a lower triangular L, store X in B.
+ * @param  L : Pointer to lower triangular matrix (n x n).
+ * @param  n : Number of rows and columns in L.
+ * @param  B : Pointer to right-hand side matrix (n x NumRhs), replaced by X.
+ * @param  NumRhs : Number of columns in B.
+ * @param  UnitDiagonal : When not zero, the diagonal of L is taken as ones
+ *                        and is not read.
+ * @retval void
+ * @note   The strictly upper triangle of L is not read.
+ */
+void SolveLowerTriangular(float *L, int n, float *B, int NumRhs,
+    int UnitDiagonal);
+
+
+/**
+ * @brief  Solves L' * X = B for a lower triangular L, store X in B.
+ * @param  L : Pointer to lower triangular matrix (n x n).
+ * @param  n : Number of rows and columns in L.
+ * @param  B : Pointer to right-hand side matrix (n x NumRhs), replaced by X.
+ * @param  NumRhs : Number of columns in B.
+ * @param  UnitDiagonal : When not zero, the diagonal of L is taken as ones
+ *                        and is not read.
+ * @retval void
+ * @note   The strictly upper triangle of L is not read.
+ */
+void SolveLowerTriangularTransposed(float *L, int n, float *B, int NumRhs,
+    int UnitDiagonal);
+
+
+/**
+ * @brief  Computes the factorization P * A * P' = L * D * L' of a symmetric
+ *         matrix, in place, with symmetric diagonal pivoting.
+ * @param  A : Pointer to input matrix (n x n), both triangles filled.
+ * @param  n : Number of rows and columns in A.
+ * @param  Perm : 1-D array of size n receiving the row/column swaps
+ *                (step k swapped k and Perm[k]), or NULL for no pivoting.
+ * @param  Tolerance : Pivots smaller than Tolerance times the largest
+ *                     diagonal element of A are taken as zero.
+ * @retval int32_t
+ * @note   On return the strictly lower triangle of A holds the unit lower
+ *         triangular L and the diagonal holds D. Zero pivots mark directions
+ *         in which A is (numerically) singular; LDLSolve gives them a zero
+ *         component, so rank deficient normal equations still get a
+ *         solution instead of a failure.
+ *         The function returns the number of non-zero pivots (the
+ *         numerical rank of A).
+ */
+int32_t LDLDecomposition(float *A, int n, int32_t *Perm, float Tolerance);
+
+
+/**
+ * @brief  Solves A * X = B given the LDL' factorization of A, store X in B.
+ * @param  LD : Pointer to the factors computed by LDLDecomposition (n x n).
+ * @param  n : Number of rows and columns in LD.
+ * @param  Perm : Swaps recorded by LDLDecomposition, or NULL if it was
+ *                called without pivoting.
+ * @param  B : Pointer to right-hand side matrix (n x NumRhs), replaced by X.
+ * @param  NumRhs : Number of columns in B.
+ * @retval void
+ */
+void LDLSolve(float *LD, int n, int32_t *Perm, float *B, int NumRhs);
+
+
+/**
+ * @brief  Describes a matrix stored row-major with the given row stride.
+ * @param  View : View to be filled.
+ * @param  Data : Pointer to element (0, 0).
+ * @param  Rows : Number of rows.
+ * @param  Cols : Number of columns.
+ * @param  Stride : Distance, in elements, between two rows (>= Cols).
+ * @retval void
+ */
+void MatrixViewInit(MatrixView_t *View, float *Data, int Rows, int Cols,
+    int Stride);
+
+
+/**
+ * @brief  Describes a block of a view.
+ * @param  View : Parent view.
+ * @param  Row : Row of the parent where the block starts.
+ * @param  Col : Column of the parent where the block starts.
+ * @param  Rows : Number of rows of the block.
+ * @param  Cols : Number of columns of the block.
+ * @param  Block : View to be filled, it shares the parent's Stride.
+ * @retval int32_t
+ * @note   The function returns 1 on success, 0 if the block does not fit
+ *         in the parent (Block is not changed).
+ */
+int32_t MatrixViewBlock(MatrixView_t *View, int Row, int Col, int Rows,
+    int Cols, MatrixView_t *Block);
+
+
+/**
+ * @brief  Copy A to C, see CopyMatrix.
+ * @param  A : Input view (m x n).
+ * @param  C : Output view (m x n).
+ * @retval int32_t
+ * @note   The function returns 1 on success, 0 if dimensions differ.
+ */
+int32_t CopyMatrixView(MatrixView_t *A, MatrixView_t *C);
+
+
+/**
+ * @brief  Multiply A by B, store result in C, see MultiplyMatrix.
+ * @param  A : Input view (m x p).
+ * @param  B : Input view (p x n).
+ * @param  C : Output view (m x n), it must not overlap A or B.
+ * @retval int32_t
+ * @note   The strides are handed to the blocked engine, which reads the
+ *         operands in place.
+ *         The function returns 1 on success, 0 if dimensions do not agree.
+ */
+int32_t MultiplyMatrixView(MatrixView_t *A, MatrixView_t *B, MatrixView_t *C);
+
+
+/**
+ * @brief  Add A and B, store result in C, see AddMatrix.
+ * @param  A : Input view (m x n).
+ * @param  B : Input view (m x n).
+ * @param  C : Output view = A + B (m x n), may be A or B.
+ * @retval int32_t
+ * @note   The function returns 1 on success, 0 if dimensions differ.
+ */
+int32_t AddMatrixView(MatrixView_t *A, MatrixView_t *B, MatrixView_t *C);
+
+
+/**
+ * @brief  Subtract A and B, store result in C, see SubtractMatrix.
+ * @param  A : Input view (m x n).
+ * @param  B : Input view (m x n).
+ * @param  C : Output view = A - B (m x n), may be A or B.
+ * @retval int32_t
+ * @note   The function returns 1 on success, 0 if dimensions differ.
+ */
+int32_t SubtractMatrixView(MatrixView_t *A, MatrixView_t *B,
+    MatrixView_t *C);
+
+
+/**
+ * @brief  Transpose A, store result in C, see TransposeMatrix.
+ * @param  A : Input view (m x n).
+ * @param  C : Output view = transpose of A (n x m), it must not overlap A.
+ * @retval int32_t
+ * @note   The function returns 1 on success, 0 if dimensions do not agree.
+ */
+int32_t TransposeMatrixView(MatrixView_t *A, MatrixView_t *C);
+
+
+/**
+ * @brief  Multiply A by constant K, store result in C, see ScaleMatrix.
+ * @param  A : Input view (m x n).
+ * @param  k : Real constant.
+ * @param  C : Output view = k * A (m x n), may be A.
+ * @retval int32_t
+ * @note   The function returns 1 on success, 0 if dimensions differ.
+ */
+int32_t ScaleMatrixView(MatrixView_t *A, float k, MatrixView_t *C);
+
+
+/**
+ * @brief  Compute the dot product between two vectors, see DotProduct.
+ * @param  V1 : First input view, a row (1 x Size) or a column (Size x 1).
+ * @param  V2 : Second input view, a row or a column of the same size.
+ * @param  Result : Scalar where dot product result will be stored.
+ * @retval int32_t
+ * @note   A column of a matrix is read with its stride, without copy.
+ *         The function returns 1 on success, 0 if a view is not a vector
+ *         or sizes differ.
+ */
+int32_t DotProductView(MatrixView_t *V1, MatrixView_t *V2, float *Result);
+
+
+/**
+ * @brief  Invert matrix A, store result in A, see InvertMatrix.
+ * @param  A : View of the matrix (n x n), replaced by its inverse.
+ * @retval int32_t
+ * @note   Below MATRIX_LU_THRESHOLD, Gauss-Jordan runs in place on the
+ *         view. Bigger views that are not densely packed are copied to a
+ *         heap buffer for the blocked LU (n^2 copies against n^3 flops).
+ *         The function returns 1 on success, 0 on failure (A not square,
+ *         singular, or memory could not be allocated).
+ */
+int32_t InvertMatrixView(MatrixView_t *A);
+
 #endif /* MATRIX_MATH_H */
 
 
@@ -0,0 +1,226 @@
+#include <stddef.h>
+#include "matrix_parallel.h"
+
+#ifdef MATRIX_PARALLEL_PTHREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef MATRIX_PARALLEL_PTHREADS
+
+/**
+ * @brief Job currently shared by the pool.
+ */
+typedef struct
+{
+  MatrixParallel_Task_t Task;
+  void *Context;
+  int Count;
+  int Chunk;
+  int Next;             /*!< First item not yet taken, updated atomically */
+  int Pending;          /*!< Workers still busy with the job */
+}MatrixParallel_Job_t;
+
+
+/* Held by the thread that owns the pool for the duration of a job */
+static pthread_mutex_t poolLock = PTHREAD_MUTEX_INITIALIZER;
+/* Protects the job and wakes workers up / the caller up */
+static pthread_mutex_t jobLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t jobStart = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t jobDone = PTHREAD_COND_INITIALIZER;
+
+static pthread_t workers[MATRIX_PARALLEL_MAX_THREADS - 1];
+static int numThreads = 0;
+static int numWorkers = 0;
+static int stopWorkers = 0;
+static unsigned long generation = 0;
+static MatrixParallel_Job_t job;
+
+
+/**
+ * @brief  Takes chunks of the current job until none is left.
+ */
+static void MatrixParallel_RunChunks(void)
+{
+  int begin, end;
+  for(;;){
+    begin = __atomic_fetch_add(&job.Next, job.Chunk, __ATOMIC_RELAXED);
+    if(begin >= job.Count){
+      break;
+    }
+    end = (begin + job.Chunk < job.Count) ? begin + job.Chunk : job.Count;
+    job.Task(job.Context, begin, end);
+  }
+}
+
+
+static void *MatrixParallel_Worker(void *Arg)
+{
+  /* Job generation current when the worker was created; reading it here
+     could already see the first job meant for this worker */
+  unsigned long seen = (unsigned long)(uintptr_t)Arg;
+
+  pthread_mutex_lock(&jobLock);
+  for(;;){
+    while(generation == seen && stopWorkers == 0){
+      pthread_cond_wait(&jobStart, &jobLock);
+    }
+    if(stopWorkers != 0){
+      break;
+    }
+    seen = generation;
+    pthread_mutex_unlock(&jobLock);
+
+    MatrixParallel_RunChunks();
+
+    pthread_mutex_lock(&jobLock);
+    job.Pending--;
+    if(job.Pending == 0){
+      pthread_cond_signal(&jobDone);
+    }
+  }
+  pthread_mutex_unlock(&jobLock);
+  return NULL;
+}
+
+
+/**
+ * @brief  Joins all workers. poolLock must be held.
+ */
+static void MatrixParallel_StopWorkers(void)
+{
+  int i;
+  pthread_mutex_lock(&jobLock);
+  stopWorkers = 1;
+  pthread_cond_broadcast(&jobStart);
+  pthread_mutex_unlock(&jobLock);
+  for(i = 0; i < numWorkers; i++){
+    pthread_join(workers[i], NULL);
+  }
+  numWorkers = 0;
+  stopWorkers = 0;
+}
+
+
+/**
+ * @brief  Starts the missing workers. poolLock must be held.
+ */
+static void MatrixParallel_StartWorkers(void)
+{
+  while(numWorkers < numThreads - 1){
+    if(pthread_create(&workers[numWorkers], NULL, MatrixParallel_Worker,
+        (void *)(uintptr_t)generation) != 0){
+      /* Go on with the threads we have */
+      numThreads = numWorkers + 1;
+      break;
+    }
+    numWorkers++;
+  }
+}
+
+
+int MatrixParallel_GetThreads(void)
+{
+  long online;
+  if(numThreads == 0){
+    online = sysconf(_SC_NPROCESSORS_ONLN);
+    if(online < 1){
+      online = 1;
+    }
+    if(online > MATRIX_PARALLEL_MAX_THREADS){
+      online = MATRIX_PARALLEL_MAX_THREADS;
+    }
+    numThreads = (int)online;
+  }
+  return numThreads;
+}
+
+
+int32_t MatrixParallel_SetThreads(int NumThreads)
+{
+  if(NumThreads < 0 || NumThreads > MATRIX_PARALLEL_MAX_THREADS){
+    return 0;
+  }
+  if(pthread_mutex_trylock(&poolLock) != 0){
+    return 0;
+  }
+  MatrixParallel_StopWorkers();
+  numThreads = NumThreads;
+  MatrixParallel_GetThreads();
+  pthread_mutex_unlock(&poolLock);
+  return 1;
+}
+
+
+void MatrixParallel_For(int Count, int Grain, MatrixParallel_Task_t Task,
+    void *Context)
+{
+  int chunk;
+
+  if(Count <= 0){
+    return;
+  }
+  if(Grain < 1){
+    Grain = 1;
+  }
+  if(MatrixParallel_GetThreads() <= 1 || Count <= Grain ||
+      pthread_mutex_trylock(&poolLock) != 0){
+    Task(Context, 0, Count);
+    return;
+  }
+
+  MatrixParallel_StartWorkers();
+
+  /* A few chunks per thread, so uneven items still balance */
+  chunk = (Count + 4*numThreads - 1) / (4*numThreads);
+  if(chunk < Grain){
+    chunk = Grain;
+  }
+
+  pthread_mutex_lock(&jobLock);
+  job.Task = Task;
+  job.Context = Context;
+  job.Count = Count;
+  job.Chunk = chunk;
+  job.Next = 0;
+  job.Pending = numWorkers;
+  generation++;
+  pthread_cond_broadcast(&jobStart);
+  pthread_mutex_unlock(&jobLock);
+
+  MatrixParallel_RunChunks();
+
+  pthread_mutex_lock(&jobLock);
+  while(job.Pending > 0){
+    pthread_cond_wait(&jobDone, &jobLock);
+  }
+  pthread_mutex_unlock(&jobLock);
+
+  pthread_mutex_unlock(&poolLock);
+}
+
+#else
+
+int MatrixParallel_GetThreads(void)
+{
+  return 1;
+}
+
+
+int32_t MatrixParallel_SetThreads(int NumThreads)
+{
+  return (NumThreads <= 1) ? 1 : 0;
+}
+
+
+void MatrixParallel_For(int Count, int Grain, MatrixParallel_Task_t Task,
+    void *Context)
+{
+  (void)Grain;
+  if(Count > 0){
+    Task(Context, 0, Count);
+  }
+}
+
+#endif /* MATRIX_PARALLEL_PTHREADS */
@@ -0,0 +1,91 @@
+/**
+ * @file  matrix_parallel.h
+ * @date  18-October-2026
+ * @brief Worker pool used to spread big matrix operations over cores.
+ *
+ *   On POSIX systems the work is run by a pool of threads created the
+ *   first time it is needed. Everywhere else, or when
+ *   MATRIX_PARALLEL_DISABLE is defined, the work runs on the caller's
+ *   thread and no threading library is needed.
+ *
+ * @author
+ * @author
+ */
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MATRIX_PARALLEL_H
+#define MATRIX_PARALLEL_H
+
+
+#define MATRIX_PARALLEL_VER_MAJOR                                           2026
+#define MATRIX_PARALLEL_VER_MINOR                                             10
+#define MATRIX_PARALLEL_VER_PATCH                                              1
+#define MATRIX_PARALLEL_BRANCH_MASTER
+
+
+#include <stdint.h>
+
+
+#if !defined(MATRIX_PARALLEL_DISABLE) && \
+    (defined(__unix__) || defined(__APPLE__))
+#define MATRIX_PARALLEL_PTHREADS
+#endif
+
+/**
+ * @brief Maximum number of threads in the pool, caller included.
+ */
+#ifndef MATRIX_PARALLEL_MAX_THREADS
+#define MATRIX_PARALLEL_MAX_THREADS                                           64
+#endif
+
+
+/**
+ * @brief  Work executed for the items Begin (included) to End (excluded).
+ */
+typedef void (*MatrixParallel_Task_t)(void *Context, int Begin, int End);
+
+
+/**
+ * @brief  Runs Task over the items 0 to Count - 1, split among the threads.
+ * @param  Count : Number of items.
+ * @param  Grain : Minimum number of items given to a thread at once.
+ * @param  Task : Work to be done.
+ * @param  Context : Passed unchanged to every call of Task.
+ * @retval void
+ * @note   Returns when all items are done. The caller's thread also takes
+ *         items. If the pool is already busy (e.g. a call from inside a
+ *         Task, or from another thread), the items run on the caller's
+ *         thread only.
+ */
+void MatrixParallel_For(int Count, int Grain, MatrixParallel_Task_t Task,
+    void *Context);
+
+
+/**
+ * @brief  Sets the number of threads used by MatrixParallel_For.
+ * @param  NumThreads : Number of threads, caller included. Zero selects the
+ *                      number of online processors.
+ * @retval int32_t
+ * @note   The function returns 1 on success, 0 on failure (threads could
+ *         not be created, or the pool is busy).
+ */
+int32_t MatrixParallel_SetThreads(int NumThreads);
+
+
+/**
+ * @brief  Returns the number of threads used by MatrixParallel_For.
+ * @retval int
+ */
+int MatrixParallel_GetThreads(void);
+
+#endif /* MATRIX_PARALLEL_H */
+
+
+
+#ifdef __cplusplus
+}
+#endif
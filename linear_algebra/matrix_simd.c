@@ -0,0 +1,1524 @@
+#include <math.h>
+#include <stdatomic.h>
+#include "matrix_simd.h"
+#include "matrix_gemm.h"
+
+#ifdef MATRIX_SIMD_X86
+#include <immintrin.h>
+#define SIMD_TARGET(ISA) __attribute__((target(ISA)))
+#endif
+
+
+/******************************************************************************/
+/**                         Scalar kernels                                   **/
+/******************************************************************************/
+
+/* Reductions use four independent accumulators so consecutive additions do */
+/*  not wait on each other.                                                  */
+
+static float ScalarNormL1(const float *V, int32_t Size)
+{
+  float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+  int32_t i;
+  for(i = 0; i + 4 <= Size; i += 4){
+    s0 += fabsf(V[i]);
+    s1 += fabsf(V[i + 1]);
+    s2 += fabsf(V[i + 2]);
+    s3 += fabsf(V[i + 3]);
+  }
+  for(; i < Size; i++){
+    s0 += fabsf(V[i]);
+  }
+  return (s0 + s1) + (s2 + s3);
+}
+
+
+static float ScalarDot(const float *V1, const float *V2, int32_t Size)
+{
+  float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+  int32_t i;
+  for(i = 0; i + 4 <= Size; i += 4){
+    s0 += V1[i] * V2[i];
+    s1 += V1[i + 1] * V2[i + 1];
+    s2 += V1[i + 2] * V2[i + 2];
+    s3 += V1[i + 3] * V2[i + 3];
+  }
+  for(; i < Size; i++){
+    s0 += V1[i] * V2[i];
+  }
+  return (s0 + s1) + (s2 + s3);
+}
+
+
+static float ScalarNormL2Squared(const float *V, int32_t Size)
+{
+  return ScalarDot(V, V, Size);
+}
+
+
+static void ScalarAdd(const float *A, const float *B, int32_t Size, float *C)
+{
+  int32_t i;
+  for(i = 0; i < Size; i++){
+    C[i] = A[i] + B[i];
+  }
+}
+
+
+static void ScalarSubtract(const float *A, const float *B, int32_t Size,
+    float *C)
+{
+  int32_t i;
+  for(i = 0; i < Size; i++){
+    C[i] = A[i] - B[i];
+  }
+}
+
+
+static void ScalarScale(const float *A, int32_t Size, float k, float *C)
+{
+  int32_t i;
+  for(i = 0; i < Size; i++){
+    C[i] = A[i] * k;
+  }
+}
+
+
+static void ScalarCopy(const float *A, int32_t Size, float *B)
+{
+  int32_t i;
+  for(i = 0; i < Size; i++){
+    B[i] = A[i];
+  }
+}
+
+
+static void ScalarTransposeTile(const float *A, int Lda, float *C, int Ldc)
+{
+  int i, j;
+  for(i = 0; i < MATRIX_SIMD_TILE; i++){
+    for(j = 0; j < MATRIX_SIMD_TILE; j++){
+      C[j * Ldc + i] = A[i * Lda + j];
+    }
+  }
+}
+
+
+/* Scalar square roots, also used for the tails of the SIMD kernels */
+static inline float ScalarInvSqrtOne(float x, int32_t Iterations)
+{
+  union{int32_t asint32; float asfloat;} val;
+  float xhalf = 0.5f * x;
+  int32_t it;
+
+  val.asfloat = x;
+  val.asint32 = MATRIX_SIMD_INVSQRT_MAGIC - (val.asint32 >> 1);
+  for(it = 0; it < Iterations; it++){
+    val.asfloat *= 1.5f - xhalf * val.asfloat * val.asfloat;
+  }
+  return val.asfloat;
+}
+
+
+static inline float ScalarSqrtOne(float x, int32_t Iterations)
+{
+  union{int32_t asint32; float asfloat;} val;
+
+  if(Iterations > 0){
+    return x * ScalarInvSqrtOne(x, Iterations);
+  }
+  val.asfloat = x;
+  val.asint32 = (val.asint32 >> 1) + MATRIX_SIMD_SQRT_MAGIC;
+  return val.asfloat;
+}
+
+
+static void ScalarInvSqrt(const float *X, int32_t Size, int32_t Iterations,
+    float *Y)
+{
+  int32_t i;
+  for(i = 0; i < Size; i++){
+    Y[i] = ScalarInvSqrtOne(X[i], Iterations);
+  }
+}
+
+
+static void ScalarSqrt(const float *X, int32_t Size, int32_t Iterations,
+    float *Y)
+{
+  int32_t i;
+  for(i = 0; i < Size; i++){
+    Y[i] = ScalarSqrtOne(X[i], Iterations);
+  }
+}
+
+
+static void ScalarNormalizeRows3(float *A, int32_t Rows, int32_t Iterations)
+{
+  float k;
+  int32_t i;
+  for(i = 0; i < Rows; i++, A += 3){
+    k = ScalarInvSqrtOne(A[0] * A[0] + A[1] * A[1] + A[2] * A[2],
+        Iterations);
+    A[0] *= k;
+    A[1] *= k;
+    A[2] *= k;
+  }
+}
+
+
+static void ScalarMultiply(const float *A, const float *B, int32_t Size,
+    float *C)
+{
+  int32_t i;
+  for(i = 0; i < Size; i++){
+    C[i] = A[i] * B[i];
+  }
+}
+
+
+static void ScalarDeinterleave3(const float *A, int32_t Size,
+    float *const P[3])
+{
+  int32_t i;
+  for(i = 0; i < Size; i++){
+    P[0][i] = A[3 * i];
+    P[1][i] = A[3 * i + 1];
+    P[2][i] = A[3 * i + 2];
+  }
+}
+
+
+static void ScalarInterleave3(const float *const P[3], int32_t Size,
+    float *A)
+{
+  int32_t i;
+  for(i = 0; i < Size; i++){
+    A[3 * i] = P[0][i];
+    A[3 * i + 1] = P[1][i];
+    A[3 * i + 2] = P[2][i];
+  }
+}
+
+
+static void ScalarDot3(const float *const A[3], const float *const B[3],
+    int32_t Size, float *D)
+{
+  int32_t i;
+  for(i = 0; i < Size; i++){
+    D[i] = A[0][i] * B[0][i] + A[1][i] * B[1][i] + A[2][i] * B[2][i];
+  }
+}
+
+
+static void ScalarCross3(const float *const A[3], const float *const B[3],
+    int32_t Size, float *const C[3])
+{
+  float x, y, z;
+  int32_t i;
+  for(i = 0; i < Size; i++){
+    x = A[1][i] * B[2][i] - A[2][i] * B[1][i];
+    y = A[2][i] * B[0][i] - A[0][i] * B[2][i];
+    z = A[0][i] * B[1][i] - A[1][i] * B[0][i];
+    C[0][i] = x;
+    C[1][i] = y;
+    C[2][i] = z;
+  }
+}
+
+
+static void ScalarRotate3(const float *R, const float *const A[3],
+    int32_t Size, float *const C[3])
+{
+  float x, y, z;
+  int32_t i;
+  for(i = 0; i < Size; i++){
+    x = A[0][i];
+    y = A[1][i];
+    z = A[2][i];
+    C[0][i] = R[0] * x + R[1] * y + R[2] * z;
+    C[1][i] = R[3] * x + R[4] * y + R[5] * z;
+    C[2][i] = R[6] * x + R[7] * y + R[8] * z;
+  }
+}
+
+
+static const MatrixSimd_t scalarKernels = {
+    .Level = MATRIX_SIMD_SCALAR,
+    .NormL1 = ScalarNormL1,
+    .NormL2Squared = ScalarNormL2Squared,
+    .Dot = ScalarDot,
+    .Add = ScalarAdd,
+    .Subtract = ScalarSubtract,
+    .Scale = ScalarScale,
+    .Copy = ScalarCopy,
+    .GemmKernel = 0,
+    .TransposeTile = ScalarTransposeTile,
+    .InvSqrt = ScalarInvSqrt,
+    .Sqrt = ScalarSqrt,
+    .NormalizeRows3 = ScalarNormalizeRows3,
+    .Multiply = ScalarMultiply,
+    .Deinterleave3 = ScalarDeinterleave3,
+    .Interleave3 = ScalarInterleave3,
+    .Dot3 = ScalarDot3,
+    .Cross3 = ScalarCross3,
+    .Rotate3 = ScalarRotate3,
+};
+
+
+#ifdef MATRIX_SIMD_X86
+
+/******************************************************************************/
+/**                         SSE2 kernels                                     **/
+/******************************************************************************/
+
+SIMD_TARGET("sse2")
+static float Sse2HorizontalSum(__m128 v)
+{
+  __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+  __m128 sums = _mm_add_ps(v, shuf);
+  shuf = _mm_movehl_ps(shuf, sums);
+  sums = _mm_add_ss(sums, shuf);
+  return _mm_cvtss_f32(sums);
+}
+
+
+SIMD_TARGET("sse2")
+static float Sse2NormL1(const float *V, int32_t Size)
+{
+  const __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  __m128 s0 = _mm_setzero_ps(), s1 = _mm_setzero_ps();
+  __m128 s2 = _mm_setzero_ps(), s3 = _mm_setzero_ps();
+  int32_t i;
+  for(i = 0; i + 16 <= Size; i += 16){
+    s0 = _mm_add_ps(s0, _mm_and_ps(mask, _mm_loadu_ps(V + i)));
+    s1 = _mm_add_ps(s1, _mm_and_ps(mask, _mm_loadu_ps(V + i + 4)));
+    s2 = _mm_add_ps(s2, _mm_and_ps(mask, _mm_loadu_ps(V + i + 8)));
+    s3 = _mm_add_ps(s3, _mm_and_ps(mask, _mm_loadu_ps(V + i + 12)));
+  }
+  for(; i + 4 <= Size; i += 4){
+    s0 = _mm_add_ps(s0, _mm_and_ps(mask, _mm_loadu_ps(V + i)));
+  }
+  float sum = Sse2HorizontalSum(_mm_add_ps(_mm_add_ps(s0, s1),
+      _mm_add_ps(s2, s3)));
+  for(; i < Size; i++){
+    sum += fabsf(V[i]);
+  }
+  return sum;
+}
+
+
+SIMD_TARGET("sse2")
+static float Sse2Dot(const float *V1, const float *V2, int32_t Size)
+{
+  __m128 s0 = _mm_setzero_ps(), s1 = _mm_setzero_ps();
+  __m128 s2 = _mm_setzero_ps(), s3 = _mm_setzero_ps();
+  int32_t i;
+  for(i = 0; i + 16 <= Size; i += 16){
+    s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(V1 + i),
+        _mm_loadu_ps(V2 + i)));
+    s1 = _mm_add_ps(s1, _mm_mul_ps(_mm_loadu_ps(V1 + i + 4),
+        _mm_loadu_ps(V2 + i + 4)));
+    s2 = _mm_add_ps(s2, _mm_mul_ps(_mm_loadu_ps(V1 + i + 8),
+        _mm_loadu_ps(V2 + i + 8)));
+    s3 = _mm_add_ps(s3, _mm_mul_ps(_mm_loadu_ps(V1 + i + 12),
+        _mm_loadu_ps(V2 + i + 12)));
+  }
+  for(; i + 4 <= Size; i += 4){
+    s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(V1 + i),
+        _mm_loadu_ps(V2 + i)));
+  }
+  float sum = Sse2HorizontalSum(_mm_add_ps(_mm_add_ps(s0, s1),
+      _mm_add_ps(s2, s3)));
+  for(; i < Size; i++){
+    sum += V1[i] * V2[i];
+  }
+  return sum;
+}
+
+
+SIMD_TARGET("sse2")
+static float Sse2NormL2Squared(const float *V, int32_t Size)
+{
+  return Sse2Dot(V, V, Size);
+}
+
+
+SIMD_TARGET("sse2")
+static void Sse2Add(const float *A, const float *B, int32_t Size, float *C)
+{
+  int32_t i;
+  for(i = 0; i + 4 <= Size; i += 4){
+    _mm_storeu_ps(C + i, _mm_add_ps(_mm_loadu_ps(A + i), _mm_loadu_ps(B + i)));
+  }
+  for(; i < Size; i++){
+    C[i] = A[i] + B[i];
+  }
+}
+
+
+SIMD_TARGET("sse2")
+static void Sse2Subtract(const float *A, const float *B, int32_t Size,
+    float *C)
+{
+  int32_t i;
+  for(i = 0; i + 4 <= Size; i += 4){
+    _mm_storeu_ps(C + i, _mm_sub_ps(_mm_loadu_ps(A + i), _mm_loadu_ps(B + i)));
+  }
+  for(; i < Size; i++){
+    C[i] = A[i] - B[i];
+  }
+}
+
+
+SIMD_TARGET("sse2")
+static void Sse2Scale(const float *A, int32_t Size, float k, float *C)
+{
+  const __m128 kv = _mm_set1_ps(k);
+  int32_t i;
+  for(i = 0; i + 4 <= Size; i += 4){
+    _mm_storeu_ps(C + i, _mm_mul_ps(_mm_loadu_ps(A + i), kv));
+  }
+  for(; i < Size; i++){
+    C[i] = A[i] * k;
+  }
+}
+
+
+SIMD_TARGET("sse2")
+static void Sse2Copy(const float *A, int32_t Size, float *B)
+{
+  int32_t i;
+  for(i = 0; i + 4 <= Size; i += 4){
+    _mm_storeu_ps(B + i, _mm_loadu_ps(A + i));
+  }
+  for(; i < Size; i++){
+    B[i] = A[i];
+  }
+}
+
+
+/* Four 4 x 4 transposes in registers */
+SIMD_TARGET("sse2")
+static void Sse2TransposeTile(const float *A, int Lda, float *C, int Ldc)
+{
+  __m128 r0, r1, r2, r3;
+  int i, j;
+  for(i = 0; i < MATRIX_SIMD_TILE; i += 4){
+    for(j = 0; j < MATRIX_SIMD_TILE; j += 4){
+      r0 = _mm_loadu_ps(A + i * Lda + j);
+      r1 = _mm_loadu_ps(A + (i + 1) * Lda + j);
+      r2 = _mm_loadu_ps(A + (i + 2) * Lda + j);
+      r3 = _mm_loadu_ps(A + (i + 3) * Lda + j);
+      _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+      _mm_storeu_ps(C + j * Ldc + i, r0);
+      _mm_storeu_ps(C + (j + 1) * Ldc + i, r1);
+      _mm_storeu_ps(C + (j + 2) * Ldc + i, r2);
+      _mm_storeu_ps(C + (j + 3) * Ldc + i, r3);
+    }
+  }
+}
+
+
+/* Bit trick guess of 1 / sqrt(x), refined by Newton steps */
+SIMD_TARGET("sse2")
+static __m128 Sse2InvSqrtVector(__m128 x, int32_t Iterations)
+{
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 threeHalves = _mm_set1_ps(1.5f);
+  __m128 xhalf = _mm_mul_ps(x, half);
+  __m128 y = _mm_castsi128_ps(_mm_sub_epi32(
+      _mm_set1_epi32(MATRIX_SIMD_INVSQRT_MAGIC),
+      _mm_srli_epi32(_mm_castps_si128(x), 1)));
+  int32_t it;
+  for(it = 0; it < Iterations; it++){
+    y = _mm_mul_ps(y, _mm_sub_ps(threeHalves,
+        _mm_mul_ps(_mm_mul_ps(xhalf, y), y)));
+  }
+  return y;
+}
+
+
+SIMD_TARGET("sse2")
+static void Sse2InvSqrt(const float *X, int32_t Size, int32_t Iterations,
+    float *Y)
+{
+  int32_t i;
+  for(i = 0; i + 4 <= Size; i += 4){
+    _mm_storeu_ps(Y + i, Sse2InvSqrtVector(_mm_loadu_ps(X + i), Iterations));
+  }
+  for(; i < Size; i++){
+    Y[i] = ScalarInvSqrtOne(X[i], Iterations);
+  }
+}
+
+
+SIMD_TARGET("sse2")
+static void Sse2Sqrt(const float *X, int32_t Size, int32_t Iterations,
+    float *Y)
+{
+  const __m128i magic = _mm_set1_epi32(MATRIX_SIMD_SQRT_MAGIC);
+  __m128 x;
+  int32_t i;
+  for(i = 0; i + 4 <= Size; i += 4){
+    x = _mm_loadu_ps(X + i);
+    if(Iterations > 0){
+      x = _mm_mul_ps(x, Sse2InvSqrtVector(x, Iterations));
+    }else{
+      x = _mm_castsi128_ps(_mm_add_epi32(
+          _mm_srli_epi32(_mm_castps_si128(x), 1), magic));
+    }
+    _mm_storeu_ps(Y + i, x);
+  }
+  for(; i < Size; i++){
+    Y[i] = ScalarSqrtOne(X[i], Iterations);
+  }
+}
+
+
+/* Four rows of 3 are loaded as x0y0z0x1 y1z1x2y2 z2x3y3z3 and split into */
+/*  x, y and z vectors by five shuffles. The inverse norms are spread back */
+/*  to the layout of the rows by three more.                               */
+SIMD_TARGET("sse2")
+static void Sse2NormalizeRows3(float *A, int32_t Rows, int32_t Iterations)
+{
+  __m128 m0, m1, m2, xy, yz, x, y, z, k;
+  int32_t i;
+  for(i = 0; i + 4 <= Rows; i += 4, A += 12){
+    m0 = _mm_loadu_ps(A);
+    m1 = _mm_loadu_ps(A + 4);
+    m2 = _mm_loadu_ps(A + 8);
+    xy = _mm_shuffle_ps(m1, m2, _MM_SHUFFLE(2, 1, 3, 2));
+    yz = _mm_shuffle_ps(m0, m1, _MM_SHUFFLE(1, 0, 2, 1));
+    x = _mm_shuffle_ps(m0, xy, _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+    z = _mm_shuffle_ps(yz, m2, _MM_SHUFFLE(3, 0, 3, 1));
+    k = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+        _mm_mul_ps(z, z));
+    k = Sse2InvSqrtVector(k, Iterations);
+    _mm_storeu_ps(A, _mm_mul_ps(m0,
+        _mm_shuffle_ps(k, k, _MM_SHUFFLE(1, 0, 0, 0))));
+    _mm_storeu_ps(A + 4, _mm_mul_ps(m1,
+        _mm_shuffle_ps(k, k, _MM_SHUFFLE(2, 2, 1, 1))));
+    _mm_storeu_ps(A + 8, _mm_mul_ps(m2,
+        _mm_shuffle_ps(k, k, _MM_SHUFFLE(3, 3, 3, 2))));
+  }
+  ScalarNormalizeRows3(A, Rows - i, Iterations);
+}
+
+
+SIMD_TARGET("sse2")
+static void Sse2Multiply(const float *A, const float *B, int32_t Size,
+    float *C)
+{
+  int32_t i;
+  for(i = 0; i + 4 <= Size; i += 4){
+    _mm_storeu_ps(C + i, _mm_mul_ps(_mm_loadu_ps(A + i),
+        _mm_loadu_ps(B + i)));
+  }
+  for(; i < Size; i++){
+    C[i] = A[i] * B[i];
+  }
+}
+
+
+/* Same shuffles as Sse2NormalizeRows3, and their inverse */
+SIMD_TARGET("sse2")
+static void Sse2Deinterleave3(const float *A, int32_t Size,
+    float *const P[3])
+{
+  __m128 m0, m1, m2, xy, yz;
+  int32_t i;
+  for(i = 0; i + 4 <= Size; i += 4){
+    m0 = _mm_loadu_ps(A + 3 * i);
+    m1 = _mm_loadu_ps(A + 3 * i + 4);
+    m2 = _mm_loadu_ps(A + 3 * i + 8);
+    xy = _mm_shuffle_ps(m1, m2, _MM_SHUFFLE(2, 1, 3, 2));
+    yz = _mm_shuffle_ps(m0, m1, _MM_SHUFFLE(1, 0, 2, 1));
+    _mm_storeu_ps(P[0] + i, _mm_shuffle_ps(m0, xy, _MM_SHUFFLE(2, 0, 3, 0)));
+    _mm_storeu_ps(P[1] + i, _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0)));
+    _mm_storeu_ps(P[2] + i, _mm_shuffle_ps(yz, m2, _MM_SHUFFLE(3, 0, 3, 1)));
+  }
+  for(; i < Size; i++){
+    P[0][i] = A[3 * i];
+    P[1][i] = A[3 * i + 1];
+    P[2][i] = A[3 * i + 2];
+  }
+}
+
+
+SIMD_TARGET("sse2")
+static void Sse2Interleave3(const float *const P[3], int32_t Size,
+    float *A)
+{
+  __m128 x, y, z, xy, yz, zx;
+  int32_t i;
+  for(i = 0; i + 4 <= Size; i += 4){
+    x = _mm_loadu_ps(P[0] + i);
+    y = _mm_loadu_ps(P[1] + i);
+    z = _mm_loadu_ps(P[2] + i);
+    xy = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+    yz = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+    zx = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+    _mm_storeu_ps(A + 3 * i, _mm_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(A + 3 * i + 4,
+        _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0)));
+    _mm_storeu_ps(A + 3 * i + 8,
+        _mm_shuffle_ps(zx, yz, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+  for(; i < Size; i++){
+    A[3 * i] = P[0][i];
+    A[3 * i + 1] = P[1][i];
+    A[3 * i + 2] = P[2][i];
+  }
+}
+
+
+SIMD_TARGET("sse2")
+static void Sse2Dot3(const float *const A[3], const float *const B[3],
+    int32_t Size, float *D)
+{
+  __m128 d;
+  int32_t i;
+  for(i = 0; i + 4 <= Size; i += 4){
+    d = _mm_mul_ps(_mm_loadu_ps(A[0] + i), _mm_loadu_ps(B[0] + i));
+    d = _mm_add_ps(d, _mm_mul_ps(_mm_loadu_ps(A[1] + i),
+        _mm_loadu_ps(B[1] + i)));
+    d = _mm_add_ps(d, _mm_mul_ps(_mm_loadu_ps(A[2] + i),
+        _mm_loadu_ps(B[2] + i)));
+    _mm_storeu_ps(D + i, d);
+  }
+  for(; i < Size; i++){
+    D[i] = A[0][i] * B[0][i] + A[1][i] * B[1][i] + A[2][i] * B[2][i];
+  }
+}
+
+
+SIMD_TARGET("sse2")
+static void Sse2Cross3(const float *const A[3], const float *const B[3],
+    int32_t Size, float *const C[3])
+{
+  __m128 ax, ay, az, bx, by, bz;
+  float x, y, z;
+  int32_t i;
+  for(i = 0; i + 4 <= Size; i += 4){
+    ax = _mm_loadu_ps(A[0] + i);
+    ay = _mm_loadu_ps(A[1] + i);
+    az = _mm_loadu_ps(A[2] + i);
+    bx = _mm_loadu_ps(B[0] + i);
+    by = _mm_loadu_ps(B[1] + i);
+    bz = _mm_loadu_ps(B[2] + i);
+    _mm_storeu_ps(C[0] + i, _mm_sub_ps(_mm_mul_ps(ay, bz),
+        _mm_mul_ps(az, by)));
+    _mm_storeu_ps(C[1] + i, _mm_sub_ps(_mm_mul_ps(az, bx),
+        _mm_mul_ps(ax, bz)));
+    _mm_storeu_ps(C[2] + i, _mm_sub_ps(_mm_mul_ps(ax, by),
+        _mm_mul_ps(ay, bx)));
+  }
+  for(; i < Size; i++){
+    x = A[1][i] * B[2][i] - A[2][i] * B[1][i];
+    y = A[2][i] * B[0][i] - A[0][i] * B[2][i];
+    z = A[0][i] * B[1][i] - A[1][i] * B[0][i];
+    C[0][i] = x;
+    C[1][i] = y;
+    C[2][i] = z;
+  }
+}
+
+
+SIMD_TARGET("sse2")
+static void Sse2Rotate3(const float *R, const float *const A[3],
+    int32_t Size, float *const C[3])
+{
+  __m128 x, y, z;
+  int32_t i, r;
+  for(i = 0; i + 4 <= Size; i += 4){
+    x = _mm_loadu_ps(A[0] + i);
+    y = _mm_loadu_ps(A[1] + i);
+    z = _mm_loadu_ps(A[2] + i);
+    for(r = 0; r < 3; r++){
+      _mm_storeu_ps(C[r] + i, _mm_add_ps(_mm_add_ps(
+          _mm_mul_ps(_mm_set1_ps(R[3 * r]), x),
+          _mm_mul_ps(_mm_set1_ps(R[3 * r + 1]), y)),
+          _mm_mul_ps(_mm_set1_ps(R[3 * r + 2]), z)));
+    }
+  }
+  if(i < Size){
+    const float *a[3] = {A[0] + i, A[1] + i, A[2] + i};
+    float *const c[3] = {C[0] + i, C[1] + i, C[2] + i};
+    ScalarRotate3(R, a, Size - i, c);
+  }
+}
+
+
+static const MatrixSimd_t sse2Kernels = {
+    .Level = MATRIX_SIMD_SSE2,
+    .NormL1 = Sse2NormL1,
+    .NormL2Squared = Sse2NormL2Squared,
+    .Dot = Sse2Dot,
+    .Add = Sse2Add,
+    .Subtract = Sse2Subtract,
+    .Scale = Sse2Scale,
+    .Copy = Sse2Copy,
+    .GemmKernel = 0,
+    .TransposeTile = Sse2TransposeTile,
+    .InvSqrt = Sse2InvSqrt,
+    .Sqrt = Sse2Sqrt,
+    .NormalizeRows3 = Sse2NormalizeRows3,
+    .Multiply = Sse2Multiply,
+    .Deinterleave3 = Sse2Deinterleave3,
+    .Interleave3 = Sse2Interleave3,
+    .Dot3 = Sse2Dot3,
+    .Cross3 = Sse2Cross3,
+    .Rotate3 = Sse2Rotate3,
+};
+
+
+/******************************************************************************/
+/**                         AVX2 kernels                                     **/
+/******************************************************************************/
+
+SIMD_TARGET("avx2,fma")
+static float Avx2HorizontalSum(__m256 v)
+{
+  __m128 lo = _mm256_castps256_ps128(v);
+  __m128 hi = _mm256_extractf128_ps(v, 1);
+  lo = _mm_add_ps(lo, hi);
+  hi = _mm_movehl_ps(hi, lo);
+  lo = _mm_add_ps(lo, hi);
+  hi = _mm_shuffle_ps(lo, lo, 0x1);
+  lo = _mm_add_ss(lo, hi);
+  return _mm_cvtss_f32(lo);
+}
+
+
+SIMD_TARGET("avx2,fma")
+static float Avx2NormL1(const float *V, int32_t Size)
+{
+  const __m256 mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+  __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+  __m256 s2 = _mm256_setzero_ps(), s3 = _mm256_setzero_ps();
+  int32_t i;
+  for(i = 0; i + 32 <= Size; i += 32){
+    s0 = _mm256_add_ps(s0, _mm256_and_ps(mask, _mm256_loadu_ps(V + i)));
+    s1 = _mm256_add_ps(s1, _mm256_and_ps(mask, _mm256_loadu_ps(V + i + 8)));
+    s2 = _mm256_add_ps(s2, _mm256_and_ps(mask, _mm256_loadu_ps(V + i + 16)));
+    s3 = _mm256_add_ps(s3, _mm256_and_ps(mask, _mm256_loadu_ps(V + i + 24)));
+  }
+  for(; i + 8 <= Size; i += 8){
+    s0 = _mm256_add_ps(s0, _mm256_and_ps(mask, _mm256_loadu_ps(V + i)));
+  }
+  float sum = Avx2HorizontalSum(_mm256_add_ps(_mm256_add_ps(s0, s1),
+      _mm256_add_ps(s2, s3)));
+  for(; i < Size; i++){
+    sum += fabsf(V[i]);
+  }
+  return sum;
+}
+
+
+SIMD_TARGET("avx2,fma")
+static float Avx2Dot(const float *V1, const float *V2, int32_t Size)
+{
+  __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+  __m256 s2 = _mm256_setzero_ps(), s3 = _mm256_setzero_ps();
+  int32_t i;
+  for(i = 0; i + 32 <= Size; i += 32){
+    s0 = _mm256_fmadd_ps(_mm256_loadu_ps(V1 + i),
+        _mm256_loadu_ps(V2 + i), s0);
+    s1 = _mm256_fmadd_ps(_mm256_loadu_ps(V1 + i + 8),
+        _mm256_loadu_ps(V2 + i + 8), s1);
+    s2 = _mm256_fmadd_ps(_mm256_loadu_ps(V1 + i + 16),
+        _mm256_loadu_ps(V2 + i + 16), s2);
+    s3 = _mm256_fmadd_ps(_mm256_loadu_ps(V1 + i + 24),
+        _mm256_loadu_ps(V2 + i + 24), s3);
+  }
+  for(; i + 8 <= Size; i += 8){
+    s0 = _mm256_fmadd_ps(_mm256_loadu_ps(V1 + i),
+        _mm256_loadu_ps(V2 + i), s0);
+  }
+  float sum = Avx2HorizontalSum(_mm256_add_ps(_mm256_add_ps(s0, s1),
+      _mm256_add_ps(s2, s3)));
+  for(; i < Size; i++){
+    sum += V1[i] * V2[i];
+  }
+  return sum;
+}
+
+
+SIMD_TARGET("avx2,fma")
+static float Avx2NormL2Squared(const float *V, int32_t Size)
+{
+  return Avx2Dot(V, V, Size);
+}
+
+
+SIMD_TARGET("avx2,fma")
+static void Avx2Add(const float *A, const float *B, int32_t Size, float *C)
+{
+  int32_t i;
+  for(i = 0; i + 8 <= Size; i += 8){
+    _mm256_storeu_ps(C + i, _mm256_add_ps(_mm256_loadu_ps(A + i),
+        _mm256_loadu_ps(B + i)));
+  }
+  for(; i < Size; i++){
+    C[i] = A[i] + B[i];
+  }
+}
+
+
+SIMD_TARGET("avx2,fma")
+static void Avx2Subtract(const float *A, const float *B, int32_t Size,
+    float *C)
+{
+  int32_t i;
+  for(i = 0; i + 8 <= Size; i += 8){
+    _mm256_storeu_ps(C + i, _mm256_sub_ps(_mm256_loadu_ps(A + i),
+        _mm256_loadu_ps(B + i)));
+  }
+  for(; i < Size; i++){
+    C[i] = A[i] - B[i];
+  }
+}
+
+
+SIMD_TARGET("avx2,fma")
+static void Avx2Scale(const float *A, int32_t Size, float k, float *C)
+{
+  const __m256 kv = _mm256_set1_ps(k);
+  int32_t i;
+  for(i = 0; i + 8 <= Size; i += 8){
+    _mm256_storeu_ps(C + i, _mm256_mul_ps(_mm256_loadu_ps(A + i), kv));
+  }
+  for(; i < Size; i++){
+    C[i] = A[i] * k;
+  }
+}
+
+
+SIMD_TARGET("avx2,fma")
+static void Avx2Copy(const float *A, int32_t Size, float *B)
+{
+  int32_t i;
+  for(i = 0; i + 8 <= Size; i += 8){
+    _mm256_storeu_ps(B + i, _mm256_loadu_ps(A + i));
+  }
+  for(; i < Size; i++){
+    B[i] = A[i];
+  }
+}
+
+
+/**
+ * @brief  6 x 16 GEMM micro-kernel, 12 accumulators held in registers.
+ */
+SIMD_TARGET("avx2,fma")
+static void Avx2GemmKernel(int kc, const float *Ap, const float *Bp,
+    float *C, int Ldc, int mr, int nr, float Alpha, float Beta)
+{
+  __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+  __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+  __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+  __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+  __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+  __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+  __m256 b0, b1, a;
+  float tile[MATRIX_GEMM_MR][MATRIX_GEMM_NR];
+  int i, j, k;
+
+  for(k = 0; k < kc; k++){
+    b0 = _mm256_loadu_ps(Bp);
+    b1 = _mm256_loadu_ps(Bp + 8);
+    a = _mm256_broadcast_ss(Ap);
+    c00 = _mm256_fmadd_ps(a, b0, c00); c01 = _mm256_fmadd_ps(a, b1, c01);
+    a = _mm256_broadcast_ss(Ap + 1);
+    c10 = _mm256_fmadd_ps(a, b0, c10); c11 = _mm256_fmadd_ps(a, b1, c11);
+    a = _mm256_broadcast_ss(Ap + 2);
+    c20 = _mm256_fmadd_ps(a, b0, c20); c21 = _mm256_fmadd_ps(a, b1, c21);
+    a = _mm256_broadcast_ss(Ap + 3);
+    c30 = _mm256_fmadd_ps(a, b0, c30); c31 = _mm256_fmadd_ps(a, b1, c31);
+    a = _mm256_broadcast_ss(Ap + 4);
+    c40 = _mm256_fmadd_ps(a, b0, c40); c41 = _mm256_fmadd_ps(a, b1, c41);
+    a = _mm256_broadcast_ss(Ap + 5);
+    c50 = _mm256_fmadd_ps(a, b0, c50); c51 = _mm256_fmadd_ps(a, b1, c51);
+    Ap += MATRIX_GEMM_MR;
+    Bp += MATRIX_GEMM_NR;
+  }
+
+  _mm256_storeu_ps(tile[0], c00); _mm256_storeu_ps(tile[0] + 8, c01);
+  _mm256_storeu_ps(tile[1], c10); _mm256_storeu_ps(tile[1] + 8, c11);
+  _mm256_storeu_ps(tile[2], c20); _mm256_storeu_ps(tile[2] + 8, c21);
+  _mm256_storeu_ps(tile[3], c30); _mm256_storeu_ps(tile[3] + 8, c31);
+  _mm256_storeu_ps(tile[4], c40); _mm256_storeu_ps(tile[4] + 8, c41);
+  _mm256_storeu_ps(tile[5], c50); _mm256_storeu_ps(tile[5] + 8, c51);
+
+  for(i = 0; i < mr; i++){
+    float *c = C + i*Ldc;
+    if(Beta == 0.0f){
+      for(j = 0; j < nr; j++){
+        c[j] = Alpha * tile[i][j];
+      }
+    }else{
+      for(j = 0; j < nr; j++){
+        c[j] = Alpha * tile[i][j] + Beta * c[j];
+      }
+    }
+  }
+}
+
+
+/* 8 x 8 in registers: pairs of rows interleaved, then pairs of pairs, */
+/*  then the 128-bit halves exchanged                                   */
+SIMD_TARGET("avx2,fma")
+static void Avx2TransposeTile(const float *A, int Lda, float *C, int Ldc)
+{
+  __m256 r0, r1, r2, r3, r4, r5, r6, r7;
+  __m256 t0, t1, t2, t3, t4, t5, t6, t7;
+
+  r0 = _mm256_loadu_ps(A);
+  r1 = _mm256_loadu_ps(A + Lda);
+  r2 = _mm256_loadu_ps(A + 2 * Lda);
+  r3 = _mm256_loadu_ps(A + 3 * Lda);
+  r4 = _mm256_loadu_ps(A + 4 * Lda);
+  r5 = _mm256_loadu_ps(A + 5 * Lda);
+  r6 = _mm256_loadu_ps(A + 6 * Lda);
+  r7 = _mm256_loadu_ps(A + 7 * Lda);
+
+  t0 = _mm256_unpacklo_ps(r0, r1);
+  t1 = _mm256_unpackhi_ps(r0, r1);
+  t2 = _mm256_unpacklo_ps(r2, r3);
+  t3 = _mm256_unpackhi_ps(r2, r3);
+  t4 = _mm256_unpacklo_ps(r4, r5);
+  t5 = _mm256_unpackhi_ps(r4, r5);
+  t6 = _mm256_unpacklo_ps(r6, r7);
+  t7 = _mm256_unpackhi_ps(r6, r7);
+
+  r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+  r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+  r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  r4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+  r5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+  r6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+  r7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+  _mm256_storeu_ps(C, _mm256_permute2f128_ps(r0, r4, 0x20));
+  _mm256_storeu_ps(C + Ldc, _mm256_permute2f128_ps(r1, r5, 0x20));
+  _mm256_storeu_ps(C + 2 * Ldc, _mm256_permute2f128_ps(r2, r6, 0x20));
+  _mm256_storeu_ps(C + 3 * Ldc, _mm256_permute2f128_ps(r3, r7, 0x20));
+  _mm256_storeu_ps(C + 4 * Ldc, _mm256_permute2f128_ps(r0, r4, 0x31));
+  _mm256_storeu_ps(C + 5 * Ldc, _mm256_permute2f128_ps(r1, r5, 0x31));
+  _mm256_storeu_ps(C + 6 * Ldc, _mm256_permute2f128_ps(r2, r6, 0x31));
+  _mm256_storeu_ps(C + 7 * Ldc, _mm256_permute2f128_ps(r3, r7, 0x31));
+}
+
+
+/* Bit trick guess of 1 / sqrt(x), refined by Newton steps. Not fused, */
+/*  so every level rounds as ScalarInvSqrtOne (and FastInvSqrt).        */
+SIMD_TARGET("avx2,fma") MATRIX_SIMD_NO_CONTRACT
+static __m256 Avx2InvSqrtVector(__m256 x, int32_t Iterations)
+{
+  const __m256 threeHalves = _mm256_set1_ps(1.5f);
+  __m256 xhalf = _mm256_mul_ps(x, _mm256_set1_ps(0.5f));
+  __m256 y = _mm256_castsi256_ps(_mm256_sub_epi32(
+      _mm256_set1_epi32(MATRIX_SIMD_INVSQRT_MAGIC),
+      _mm256_srli_epi32(_mm256_castps_si256(x), 1)));
+  int32_t it;
+  for(it = 0; it < Iterations; it++){
+    y = _mm256_mul_ps(y, _mm256_sub_ps(threeHalves,
+        _mm256_mul_ps(_mm256_mul_ps(xhalf, y), y)));
+  }
+  return y;
+}
+
+
+SIMD_TARGET("avx2,fma") MATRIX_SIMD_NO_CONTRACT
+static void Avx2InvSqrt(const float *X, int32_t Size, int32_t Iterations,
+    float *Y)
+{
+  int32_t i;
+  for(i = 0; i + 8 <= Size; i += 8){
+    _mm256_storeu_ps(Y + i,
+        Avx2InvSqrtVector(_mm256_loadu_ps(X + i), Iterations));
+  }
+  for(; i < Size; i++){
+    Y[i] = ScalarInvSqrtOne(X[i], Iterations);
+  }
+}
+
+
+SIMD_TARGET("avx2,fma") MATRIX_SIMD_NO_CONTRACT
+static void Avx2Sqrt(const float *X, int32_t Size, int32_t Iterations,
+    float *Y)
+{
+  const __m256i magic = _mm256_set1_epi32(MATRIX_SIMD_SQRT_MAGIC);
+  __m256 x;
+  int32_t i;
+  for(i = 0; i + 8 <= Size; i += 8){
+    x = _mm256_loadu_ps(X + i);
+    if(Iterations > 0){
+      x = _mm256_mul_ps(x, Avx2InvSqrtVector(x, Iterations));
+    }else{
+      x = _mm256_castsi256_ps(_mm256_add_epi32(
+          _mm256_srli_epi32(_mm256_castps_si256(x), 1), magic));
+    }
+    _mm256_storeu_ps(Y + i, x);
+  }
+  for(; i < Size; i++){
+    Y[i] = ScalarSqrtOne(X[i], Iterations);
+  }
+}
+
+
+/* Eight rows of 3, as in Sse2NormalizeRows3 with rows 0-3 in the low */
+/*  128-bit lanes and rows 4-7 in the high ones                         */
+SIMD_TARGET("avx2,fma") MATRIX_SIMD_NO_CONTRACT
+static void Avx2NormalizeRows3(float *A, int32_t Rows, int32_t Iterations)
+{
+  __m256 m0, m1, m2, xy, yz, x, y, z, k;
+  int32_t i;
+  for(i = 0; i + 8 <= Rows; i += 8, A += 24){
+    m0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(A)),
+        _mm_loadu_ps(A + 12), 1);
+    m1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(A + 4)),
+        _mm_loadu_ps(A + 16), 1);
+    m2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(A + 8)),
+        _mm_loadu_ps(A + 20), 1);
+    xy = _mm256_shuffle_ps(m1, m2, _MM_SHUFFLE(2, 1, 3, 2));
+    yz = _mm256_shuffle_ps(m0, m1, _MM_SHUFFLE(1, 0, 2, 1));
+    x = _mm256_shuffle_ps(m0, xy, _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+    z = _mm256_shuffle_ps(yz, m2, _MM_SHUFFLE(3, 0, 3, 1));
+    k = _mm256_fmadd_ps(z, z, _mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x)));
+    k = Avx2InvSqrtVector(k, Iterations);
+    m0 = _mm256_mul_ps(m0, _mm256_shuffle_ps(k, k, _MM_SHUFFLE(1, 0, 0, 0)));
+    m1 = _mm256_mul_ps(m1, _mm256_shuffle_ps(k, k, _MM_SHUFFLE(2, 2, 1, 1)));
+    m2 = _mm256_mul_ps(m2, _mm256_shuffle_ps(k, k, _MM_SHUFFLE(3, 3, 3, 2)));
+    _mm_storeu_ps(A, _mm256_castps256_ps128(m0));
+    _mm_storeu_ps(A + 4, _mm256_castps256_ps128(m1));
+    _mm_storeu_ps(A + 8, _mm256_castps256_ps128(m2));
+    _mm_storeu_ps(A + 12, _mm256_extractf128_ps(m0, 1));
+    _mm_storeu_ps(A + 16, _mm256_extractf128_ps(m1, 1));
+    _mm_storeu_ps(A + 20, _mm256_extractf128_ps(m2, 1));
+  }
+  ScalarNormalizeRows3(A, Rows - i, Iterations);
+}
+
+
+SIMD_TARGET("avx2,fma")
+static void Avx2Multiply(const float *A, const float *B, int32_t Size,
+    float *C)
+{
+  int32_t i;
+  for(i = 0; i + 8 <= Size; i += 8){
+    _mm256_storeu_ps(C + i, _mm256_mul_ps(_mm256_loadu_ps(A + i),
+        _mm256_loadu_ps(B + i)));
+  }
+  for(; i < Size; i++){
+    C[i] = A[i] * B[i];
+  }
+}
+
+
+/* Eight vectors, rows 0-3 in the low lanes and 4-7 in the high ones */
+SIMD_TARGET("avx2,fma")
+static void Avx2Deinterleave3(const float *A, int32_t Size,
+    float *const P[3])
+{
+  __m256 m0, m1, m2, xy, yz;
+  const float *a;
+  int32_t i;
+  for(i = 0; i + 8 <= Size; i += 8){
+    a = A + 3 * i;
+    m0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(a)),
+        _mm_loadu_ps(a + 12), 1);
+    m1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(a + 4)),
+        _mm_loadu_ps(a + 16), 1);
+    m2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(a + 8)),
+        _mm_loadu_ps(a + 20), 1);
+    xy = _mm256_shuffle_ps(m1, m2, _MM_SHUFFLE(2, 1, 3, 2));
+    yz = _mm256_shuffle_ps(m0, m1, _MM_SHUFFLE(1, 0, 2, 1));
+    _mm256_storeu_ps(P[0] + i,
+        _mm256_shuffle_ps(m0, xy, _MM_SHUFFLE(2, 0, 3, 0)));
+    _mm256_storeu_ps(P[1] + i,
+        _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0)));
+    _mm256_storeu_ps(P[2] + i,
+        _mm256_shuffle_ps(yz, m2, _MM_SHUFFLE(3, 0, 3, 1)));
+  }
+  for(; i < Size; i++){
+    P[0][i] = A[3 * i];
+    P[1][i] = A[3 * i + 1];
+    P[2][i] = A[3 * i + 2];
+  }
+}
+
+
+SIMD_TARGET("avx2,fma")
+static void Avx2Interleave3(const float *const P[3], int32_t Size,
+    float *A)
+{
+  __m256 x, y, z, xy, yz, zx, m0, m1, m2;
+  float *a;
+  int32_t i;
+  for(i = 0; i + 8 <= Size; i += 8){
+    a = A + 3 * i;
+    x = _mm256_loadu_ps(P[0] + i);
+    y = _mm256_loadu_ps(P[1] + i);
+    z = _mm256_loadu_ps(P[2] + i);
+    xy = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+    yz = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+    zx = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+    m0 = _mm256_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0));
+    m1 = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+    m2 = _mm256_shuffle_ps(zx, yz, _MM_SHUFFLE(3, 1, 3, 1));
+    _mm_storeu_ps(a, _mm256_castps256_ps128(m0));
+    _mm_storeu_ps(a + 4, _mm256_castps256_ps128(m1));
+    _mm_storeu_ps(a + 8, _mm256_castps256_ps128(m2));
+    _mm_storeu_ps(a + 12, _mm256_extractf128_ps(m0, 1));
+    _mm_storeu_ps(a + 16, _mm256_extractf128_ps(m1, 1));
+    _mm_storeu_ps(a + 20, _mm256_extractf128_ps(m2, 1));
+  }
+  for(; i < Size; i++){
+    A[3 * i] = P[0][i];
+    A[3 * i + 1] = P[1][i];
+    A[3 * i + 2] = P[2][i];
+  }
+}
+
+
+SIMD_TARGET("avx2,fma")
+static void Avx2Dot3(const float *const A[3], const float *const B[3],
+    int32_t Size, float *D)
+{
+  __m256 d;
+  int32_t i;
+  for(i = 0; i + 8 <= Size; i += 8){
+    d = _mm256_mul_ps(_mm256_loadu_ps(A[0] + i), _mm256_loadu_ps(B[0] + i));
+    d = _mm256_fmadd_ps(_mm256_loadu_ps(A[1] + i),
+        _mm256_loadu_ps(B[1] + i), d);
+    d = _mm256_fmadd_ps(_mm256_loadu_ps(A[2] + i),
+        _mm256_loadu_ps(B[2] + i), d);
+    _mm256_storeu_ps(D + i, d);
+  }
+  for(; i < Size; i++){
+    D[i] = A[0][i] * B[0][i] + A[1][i] * B[1][i] + A[2][i] * B[2][i];
+  }
+}
+
+
+SIMD_TARGET("avx2,fma")
+static void Avx2Cross3(const float *const A[3], const float *const B[3],
+    int32_t Size, float *const C[3])
+{
+  __m256 ax, ay, az, bx, by, bz;
+  int32_t i;
+  for(i = 0; i + 8 <= Size; i += 8){
+    ax = _mm256_loadu_ps(A[0] + i);
+    ay = _mm256_loadu_ps(A[1] + i);
+    az = _mm256_loadu_ps(A[2] + i);
+    bx = _mm256_loadu_ps(B[0] + i);
+    by = _mm256_loadu_ps(B[1] + i);
+    bz = _mm256_loadu_ps(B[2] + i);
+    _mm256_storeu_ps(C[0] + i,
+        _mm256_fmsub_ps(ay, bz, _mm256_mul_ps(az, by)));
+    _mm256_storeu_ps(C[1] + i,
+        _mm256_fmsub_ps(az, bx, _mm256_mul_ps(ax, bz)));
+    _mm256_storeu_ps(C[2] + i,
+        _mm256_fmsub_ps(ax, by, _mm256_mul_ps(ay, bx)));
+  }
+  if(i < Size){
+    const float *a[3] = {A[0] + i, A[1] + i, A[2] + i};
+    const float *b[3] = {B[0] + i, B[1] + i, B[2] + i};
+    float *const c[3] = {C[0] + i, C[1] + i, C[2] + i};
+    ScalarCross3(a, b, Size - i, c);
+  }
+}
+
+
+SIMD_TARGET("avx2,fma")
+static void Avx2Rotate3(const float *R, const float *const A[3],
+    int32_t Size, float *const C[3])
+{
+  __m256 r[9], x, y, z;
+  int32_t i, k;
+  for(k = 0; k < 9; k++){
+    r[k] = _mm256_set1_ps(R[k]);
+  }
+  for(i = 0; i + 8 <= Size; i += 8){
+    x = _mm256_loadu_ps(A[0] + i);
+    y = _mm256_loadu_ps(A[1] + i);
+    z = _mm256_loadu_ps(A[2] + i);
+    for(k = 0; k < 3; k++){
+      _mm256_storeu_ps(C[k] + i, _mm256_fmadd_ps(r[3 * k + 2], z,
+          _mm256_fmadd_ps(r[3 * k + 1], y, _mm256_mul_ps(r[3 * k], x))));
+    }
+  }
+  if(i < Size){
+    const float *a[3] = {A[0] + i, A[1] + i, A[2] + i};
+    float *const c[3] = {C[0] + i, C[1] + i, C[2] + i};
+    ScalarRotate3(R, a, Size - i, c);
+  }
+}
+
+
+static const MatrixSimd_t avx2Kernels = {
+    .Level = MATRIX_SIMD_AVX2,
+    .NormL1 = Avx2NormL1,
+    .NormL2Squared = Avx2NormL2Squared,
+    .Dot = Avx2Dot,
+    .Add = Avx2Add,
+    .Subtract = Avx2Subtract,
+    .Scale = Avx2Scale,
+    .Copy = Avx2Copy,
+    .GemmKernel = Avx2GemmKernel,
+    .TransposeTile = Avx2TransposeTile,
+    .InvSqrt = Avx2InvSqrt,
+    .Sqrt = Avx2Sqrt,
+    .NormalizeRows3 = Avx2NormalizeRows3,
+    .Multiply = Avx2Multiply,
+    .Deinterleave3 = Avx2Deinterleave3,
+    .Interleave3 = Avx2Interleave3,
+    .Dot3 = Avx2Dot3,
+    .Cross3 = Avx2Cross3,
+    .Rotate3 = Avx2Rotate3,
+};
+
+
+/******************************************************************************/
+/**                         AVX-512 kernels                                  **/
+/******************************************************************************/
+
+SIMD_TARGET("avx512f")
+static float Avx512NormL1(const float *V, int32_t Size)
+{
+  __m512 s0 = _mm512_setzero_ps(), s1 = _mm512_setzero_ps();
+  __m512 s2 = _mm512_setzero_ps(), s3 = _mm512_setzero_ps();
+  int32_t i;
+  for(i = 0; i + 64 <= Size; i += 64){
+    s0 = _mm512_add_ps(s0, _mm512_abs_ps(_mm512_loadu_ps(V + i)));
+    s1 = _mm512_add_ps(s1, _mm512_abs_ps(_mm512_loadu_ps(V + i + 16)));
+    s2 = _mm512_add_ps(s2, _mm512_abs_ps(_mm512_loadu_ps(V + i + 32)));
+    s3 = _mm512_add_ps(s3, _mm512_abs_ps(_mm512_loadu_ps(V + i + 48)));
+  }
+  for(; i + 16 <= Size; i += 16){
+    s0 = _mm512_add_ps(s0, _mm512_abs_ps(_mm512_loadu_ps(V + i)));
+  }
+  if(i < Size){
+    __mmask16 m = (__mmask16)((1u << (Size - i)) - 1u);
+    s1 = _mm512_add_ps(s1, _mm512_abs_ps(_mm512_maskz_loadu_ps(m, V + i)));
+  }
+  return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(s0, s1),
+      _mm512_add_ps(s2, s3)));
+}
+
+
+SIMD_TARGET("avx512f")
+static float Avx512Dot(const float *V1, const float *V2, int32_t Size)
+{
+  __m512 s0 = _mm512_setzero_ps(), s1 = _mm512_setzero_ps();
+  __m512 s2 = _mm512_setzero_ps(), s3 = _mm512_setzero_ps();
+  int32_t i;
+  for(i = 0; i + 64 <= Size; i += 64){
+    s0 = _mm512_fmadd_ps(_mm512_loadu_ps(V1 + i),
+        _mm512_loadu_ps(V2 + i), s0);
+    s1 = _mm512_fmadd_ps(_mm512_loadu_ps(V1 + i + 16),
+        _mm512_loadu_ps(V2 + i + 16), s1);
+    s2 = _mm512_fmadd_ps(_mm512_loadu_ps(V1 + i + 32),
+        _mm512_loadu_ps(V2 + i + 32), s2);
+    s3 = _mm512_fmadd_ps(_mm512_loadu_ps(V1 + i + 48),
+        _mm512_loadu_ps(V2 + i + 48), s3);
+  }
+  for(; i + 16 <= Size; i += 16){
+    s0 = _mm512_fmadd_ps(_mm512_loadu_ps(V1 + i),
+        _mm512_loadu_ps(V2 + i), s0);
+  }
+  if(i < Size){
+    __mmask16 m = (__mmask16)((1u << (Size - i)) - 1u);
+    s1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, V1 + i),
+        _mm512_maskz_loadu_ps(m, V2 + i), s1);
+  }
+  return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(s0, s1),
+      _mm512_add_ps(s2, s3)));
+}
+
+
+SIMD_TARGET("avx512f")
+static float Avx512NormL2Squared(const float *V, int32_t Size)
+{
+  return Avx512Dot(V, V, Size);
+}
+
+
+SIMD_TARGET("avx512f")
+static void Avx512Add(const float *A, const float *B, int32_t Size, float *C)
+{
+  int32_t i;
+  for(i = 0; i + 16 <= Size; i += 16){
+    _mm512_storeu_ps(C + i, _mm512_add_ps(_mm512_loadu_ps(A + i),
+        _mm512_loadu_ps(B + i)));
+  }
+  if(i < Size){
+    __mmask16 m = (__mmask16)((1u << (Size - i)) - 1u);
+    _mm512_mask_storeu_ps(C + i, m, _mm512_add_ps(
+        _mm512_maskz_loadu_ps(m, A + i), _mm512_maskz_loadu_ps(m, B + i)));
+  }
+}
+
+
+SIMD_TARGET("avx512f")
+static void Avx512Subtract(const float *A, const float *B, int32_t Size,
+    float *C)
+{
+  int32_t i;
+  for(i = 0; i + 16 <= Size; i += 16){
+    _mm512_storeu_ps(C + i, _mm512_sub_ps(_mm512_loadu_ps(A + i),
+        _mm512_loadu_ps(B + i)));
+  }
+  if(i < Size){
+    __mmask16 m = (__mmask16)((1u << (Size - i)) - 1u);
+    _mm512_mask_storeu_ps(C + i, m, _mm512_sub_ps(
+        _mm512_maskz_loadu_ps(m, A + i), _mm512_maskz_loadu_ps(m, B + i)));
+  }
+}
+
+
+SIMD_TARGET("avx512f")
+static void Avx512Scale(const float *A, int32_t Size, float k, float *C)
+{
+  const __m512 kv = _mm512_set1_ps(k);
+  int32_t i;
+  for(i = 0; i + 16 <= Size; i += 16){
+    _mm512_storeu_ps(C + i, _mm512_mul_ps(_mm512_loadu_ps(A + i), kv));
+  }
+  if(i < Size){
+    __mmask16 m = (__mmask16)((1u << (Size - i)) - 1u);
+    _mm512_mask_storeu_ps(C + i, m,
+        _mm512_mul_ps(_mm512_maskz_loadu_ps(m, A + i), kv));
+  }
+}
+
+
+SIMD_TARGET("avx512f")
+static void Avx512Copy(const float *A, int32_t Size, float *B)
+{
+  int32_t i;
+  for(i = 0; i + 16 <= Size; i += 16){
+    _mm512_storeu_ps(B + i, _mm512_loadu_ps(A + i));
+  }
+  if(i < Size){
+    __mmask16 m = (__mmask16)((1u << (Size - i)) - 1u);
+    _mm512_mask_storeu_ps(B + i, m, _mm512_maskz_loadu_ps(m, A + i));
+  }
+}
+
+
+/* Bit trick guess of 1 / sqrt(x), refined by Newton steps. Not fused, */
+/*  so every level rounds as ScalarInvSqrtOne (and FastInvSqrt).        */
+SIMD_TARGET("avx512f") MATRIX_SIMD_NO_CONTRACT
+static __m512 Avx512InvSqrtVector(__m512 x, int32_t Iterations)
+{
+  const __m512 threeHalves = _mm512_set1_ps(1.5f);
+  __m512 xhalf = _mm512_mul_ps(x, _mm512_set1_ps(0.5f));
+  __m512 y = _mm512_castsi512_ps(_mm512_sub_epi32(
+      _mm512_set1_epi32(MATRIX_SIMD_INVSQRT_MAGIC),
+      _mm512_srli_epi32(_mm512_castps_si512(x), 1)));
+  int32_t it;
+  for(it = 0; it < Iterations; it++){
+    y = _mm512_mul_ps(y, _mm512_sub_ps(threeHalves,
+        _mm512_mul_ps(_mm512_mul_ps(xhalf, y), y)));
+  }
+  return y;
+}
+
+
+SIMD_TARGET("avx512f") MATRIX_SIMD_NO_CONTRACT
+static __m512 Avx512SqrtVector(__m512 x, int32_t Iterations)
+{
+  if(Iterations > 0){
+    return _mm512_mul_ps(x, Avx512InvSqrtVector(x, Iterations));
+  }
+  return _mm512_castsi512_ps(_mm512_add_epi32(
+      _mm512_srli_epi32(_mm512_castps_si512(x), 1),
+      _mm512_set1_epi32(MATRIX_SIMD_SQRT_MAGIC)));
+}
+
+
+SIMD_TARGET("avx512f") MATRIX_SIMD_NO_CONTRACT
+static void Avx512InvSqrt(const float *X, int32_t Size, int32_t Iterations,
+    float *Y)
+{
+  int32_t i;
+  for(i = 0; i + 16 <= Size; i += 16){
+    _mm512_storeu_ps(Y + i,
+        Avx512InvSqrtVector(_mm512_loadu_ps(X + i), Iterations));
+  }
+  if(i < Size){
+    __mmask16 m = (__mmask16)((1u << (Size - i)) - 1u);
+    _mm512_mask_storeu_ps(Y + i, m,
+        Avx512InvSqrtVector(_mm512_maskz_loadu_ps(m, X + i), Iterations));
+  }
+}
+
+
+SIMD_TARGET("avx512f") MATRIX_SIMD_NO_CONTRACT
+static void Avx512Sqrt(const float *X, int32_t Size, int32_t Iterations,
+    float *Y)
+{
+  int32_t i;
+  for(i = 0; i + 16 <= Size; i += 16){
+    _mm512_storeu_ps(Y + i,
+        Avx512SqrtVector(_mm512_loadu_ps(X + i), Iterations));
+  }
+  if(i < Size){
+    __mmask16 m = (__mmask16)((1u << (Size - i)) - 1u);
+    _mm512_mask_storeu_ps(Y + i, m,
+        Avx512SqrtVector(_mm512_maskz_loadu_ps(m, X + i), Iterations));
+  }
+}
+
+
+SIMD_TARGET("avx512f")
+static void Avx512Multiply(const float *A, const float *B, int32_t Size,
+    float *C)
+{
+  int32_t i;
+  for(i = 0; i + 16 <= Size; i += 16){
+    _mm512_storeu_ps(C + i, _mm512_mul_ps(_mm512_loadu_ps(A + i),
+        _mm512_loadu_ps(B + i)));
+  }
+  if(i < Size){
+    __mmask16 m = (__mmask16)((1u << (Size - i)) - 1u);
+    _mm512_mask_storeu_ps(C + i, m, _mm512_mul_ps(
+        _mm512_maskz_loadu_ps(m, A + i), _mm512_maskz_loadu_ps(m, B + i)));
+  }
+}
+
+
+static const MatrixSimd_t avx512Kernels = {
+    .Level = MATRIX_SIMD_AVX512,
+    .NormL1 = Avx512NormL1,
+    .NormL2Squared = Avx512NormL2Squared,
+    .Dot = Avx512Dot,
+    .Add = Avx512Add,
+    .Subtract = Avx512Subtract,
+    .Scale = Avx512Scale,
+    .Copy = Avx512Copy,
+    /* Every AVX-512 processor also implements AVX2 and FMA */
+    .GemmKernel = Avx2GemmKernel,
+    .TransposeTile = Avx2TransposeTile,
+    .InvSqrt = Avx512InvSqrt,
+    .Sqrt = Avx512Sqrt,
+    .NormalizeRows3 = Avx2NormalizeRows3,
+    .Multiply = Avx512Multiply,
+    .Deinterleave3 = Avx2Deinterleave3,
+    .Interleave3 = Avx2Interleave3,
+    .Dot3 = Avx2Dot3,
+    .Cross3 = Avx2Cross3,
+    .Rotate3 = Avx2Rotate3,
+};
+
+#endif /* MATRIX_SIMD_X86 */
+
+
+/******************************************************************************/
+/**                         Dispatch                                         **/
+/******************************************************************************/
+
+/* Read by every thread, written on first use and by MatrixSimd_SetLevel */
+static _Atomic(const MatrixSimd_t *) activeKernels = 0;
+
+
+/**
+ * @brief  Tells whether the running processor implements a level.
+ */
+static int32_t MatrixSimd_IsSupported(MatrixSimd_Level_t Level)
+{
+  switch(Level){
+  case MATRIX_SIMD_SCALAR:
+    return 1;
+#ifdef MATRIX_SIMD_X86
+  case MATRIX_SIMD_SSE2:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2") ? 1 : 0;
+  case MATRIX_SIMD_AVX2:
+    __builtin_cpu_init();
+    return (__builtin_cpu_supports("avx2") &&
+        __builtin_cpu_supports("fma")) ? 1 : 0;
+  case MATRIX_SIMD_AVX512:
+    __builtin_cpu_init();
+    return (__builtin_cpu_supports("avx512f") &&
+        __builtin_cpu_supports("avx2") &&
+        __builtin_cpu_supports("fma")) ? 1 : 0;
+#endif
+  default:
+    return 0;
+  }
+}
+
+
+/**
+ * @brief  Returns the kernel table of a level, NULL if not compiled in.
+ */
+static const MatrixSimd_t *MatrixSimd_Table(MatrixSimd_Level_t Level)
+{
+  switch(Level){
+  case MATRIX_SIMD_SCALAR:
+    return &scalarKernels;
+#ifdef MATRIX_SIMD_X86
+  case MATRIX_SIMD_SSE2:
+    return &sse2Kernels;
+  case MATRIX_SIMD_AVX2:
+    return &avx2Kernels;
+  case MATRIX_SIMD_AVX512:
+    return &avx512Kernels;
+#endif
+  default:
+    return 0;
+  }
+}
+
+
+const MatrixSimd_t *MatrixSimd_Get(void)
+{
+  const MatrixSimd_t *kernels =
+      atomic_load_explicit(&activeKernels, memory_order_acquire);
+  const MatrixSimd_t *expected = 0;
+  int32_t level;
+
+  if(kernels == 0){
+    for(level = MATRIX_SIMD_NUMBER_OF_LEVELS - 1; level > 0; level--){
+      if(MatrixSimd_Table(level) != 0 && MatrixSimd_IsSupported(level)){
+        break;
+      }
+    }
+    kernels = MatrixSimd_Table(level);
+    /* Keeps a table stored meanwhile by another thread or SetLevel */
+    if(atomic_compare_exchange_strong_explicit(&activeKernels, &expected,
+        kernels, memory_order_acq_rel, memory_order_acquire) == 0){
+      kernels = expected;
+    }
+  }
+  return kernels;
+}
+
+
+int32_t MatrixSimd_SetLevel(MatrixSimd_Level_t Level)
+{
+  if(MatrixSimd_Table(Level) == 0 || MatrixSimd_IsSupported(Level) == 0){
+    return 0;
+  }
+  atomic_store_explicit(&activeKernels, MatrixSimd_Table(Level),
+      memory_order_release);
+  return 1;
+}
+
+
+MatrixSimd_Level_t MatrixSimd_Select(uint32_t Levels)
+{
+  int32_t level = MatrixSimd_Get()->Level;
+
+  while(level > MATRIX_SIMD_SCALAR && (Levels & (1u << level)) == 0){
+    level--;
+  }
+  return level;
+}
@@ -0,0 +1,204 @@
+/**
+ * @file  matrix_simd.h
+ * @date  18-October-2026
+ * @brief Runtime dispatched SIMD kernels for the vector primitives.
+ *
+ *   On x86 targets built with GCC or Clang, the instruction set available
+ *   on the running processor (SSE2, AVX2 or AVX-512) is detected through
+ *   CPUID the first time a kernel is needed, and the widest matching set
+ *   of kernels is used from then on. On every other target, or when
+ *   MATRIX_SIMD_DISABLE is defined, only the portable scalar kernels are
+ *   compiled.
+ *
+ *   Modules with SIMD code of their own (the banks of pid_bank.h,
+ *   rls_bank.h, madgwick.h and kalman.h) pick it with MATRIX_SIMD_SELECT,
+ *   so the level selected here, or forced with MatrixSimd_SetLevel, holds
+ *   for every module. Their passes process one item (controller, filter or
+ *   stream) per lane and never fuse a multiplication with an addition, so
+ *   an item gets the same result, bit for bit, whichever pass computes it.
+ *   Where the passes also follow the order of operations of the function
+ *   handling a single item (PID_Compute, Madgwick_Update, KF_Update...),
+ *   they match it bit for bit as long as the module is not built with
+ *   multiply-add contraction (e.g. -mfma on x86).
+ *
+ * @author
+ * @author
+ */
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MATRIX_SIMD_H
+#define MATRIX_SIMD_H
+
+
+#define MATRIX_SIMD_VER_MAJOR                                               2026
+#define MATRIX_SIMD_VER_MINOR                                                 10
+#define MATRIX_SIMD_VER_PATCH                                                  1
+#define MATRIX_SIMD_BRANCH_MASTER
+
+
+#include <stdint.h>
+
+
+#if !defined(MATRIX_SIMD_DISABLE) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define MATRIX_SIMD_X86
+#endif
+
+
+/**
+ * @brief Rows and columns of the tiles of MatrixSimd_t.TransposeTile.
+ */
+#define MATRIX_SIMD_TILE                                                       8
+
+
+/**
+ * @brief Integer constants of the square root bit tricks: the float bits
+ *        shifted right once, added to (SQRT) or subtracted from (INVSQRT)
+ *        them give a first guess within a few percent.
+ */
+#define MATRIX_SIMD_SQRT_MAGIC                           (0x1FC00000 - 0x4B0D2)
+#define MATRIX_SIMD_INVSQRT_MAGIC                                   0x5f375a86
+
+
+/**
+ * @brief Floats in a 64-byte cache line.
+ */
+#define MATRIX_SIMD_LINE_FLOATS                                               16
+
+
+/**
+ * @brief Distance, in floats, between two elements of an item of a bank
+ *        of Count items stored in structure-of-arrays form (element e of
+ *        item i at [e * Stride + i]): an odd number of cache lines holding
+ *        Count floats. At a multiple of a large power of two, every element
+ *        of an item would fall in the same cache set and a pass over the
+ *        bank would slow down by a factor of 3 or more.
+ */
+#define MATRIX_SIMD_BANK_STRIDE(Count) \
+    ((((Count) + MATRIX_SIMD_LINE_FLOATS - 1) / MATRIX_SIMD_LINE_FLOATS | 1) \
+    * MATRIX_SIMD_LINE_FLOATS)
+
+
+#ifdef MATRIX_SIMD_X86
+/**
+ * @brief Attribute of a pass built for an instruction set that implies FMA
+ *        (AVX-512F), which the compiler would otherwise contract into.
+ */
+#define MATRIX_SIMD_NO_CONTRACT __attribute__((optimize("fp-contract=off")))
+#endif
+
+
+/**
+ * @brief Instruction set levels, from the narrowest to the widest.
+ */
+typedef enum
+{
+  MATRIX_SIMD_SCALAR = 0,  /*!< Portable C, 4 independent accumulators */
+  MATRIX_SIMD_SSE2,        /*!< 128 bits */
+  MATRIX_SIMD_AVX2,        /*!< 256 bits, with FMA */
+  MATRIX_SIMD_AVX512,      /*!< 512 bits */
+  MATRIX_SIMD_NUMBER_OF_LEVELS,
+}MatrixSimd_Level_t;
+
+
+/**
+ * @brief Table of kernels of one instruction set level.
+ */
+typedef struct
+{
+  MatrixSimd_Level_t Level;
+  float (*NormL1)(const float *V, int32_t Size);
+  float (*NormL2Squared)(const float *V, int32_t Size);
+  float (*Dot)(const float *V1, const float *V2, int32_t Size);
+  void  (*Add)(const float *A, const float *B, int32_t Size, float *C);
+  void  (*Subtract)(const float *A, const float *B, int32_t Size, float *C);
+  void  (*Scale)(const float *A, int32_t Size, float k, float *C);
+  void  (*Copy)(const float *A, int32_t Size, float *B);
+  /*!< GEMM micro-kernel (see matrix_gemm.c), NULL to use the portable one */
+  void  (*GemmKernel)(int kc, const float *Ap, const float *Bp, float *C,
+      int Ldc, int mr, int nr, float Alpha, float Beta);
+  /*!< C = A' for a MATRIX_SIMD_TILE square tile, rows Lda and Ldc apart */
+  void  (*TransposeTile)(const float *A, int Lda, float *C, int Ldc);
+  /*!< Y = 1 / sqrt(X) by the bit trick of InvSqrt_approx (fast_math.h),
+       then Iterations Newton steps */
+  void  (*InvSqrt)(const float *X, int32_t Size, int32_t Iterations,
+      float *Y);
+  /*!< Y = sqrt(X): Sqrt_approx for 0 Iterations, else X * InvSqrt */
+  void  (*Sqrt)(const float *X, int32_t Size, int32_t Iterations, float *Y);
+  /*!< Divides each row of a Rows x 3 matrix by its norm, see InvSqrt */
+  void  (*NormalizeRows3)(float *A, int32_t Rows, int32_t Iterations);
+  /*!< C = A .* B, element by element */
+  void  (*Multiply)(const float *A, const float *B, int32_t Size, float *C);
+  /*!< Size 3-vectors stored x, y, z, x, y, z... to and from three planes
+       (P[0] = x, P[1] = y, P[2] = z), see vector3.h */
+  void  (*Deinterleave3)(const float *A, int32_t Size, float *const P[3]);
+  void  (*Interleave3)(const float *const P[3], int32_t Size, float *A);
+  /*!< Products of 3-vectors stored as planes. C may be A or B */
+  void  (*Dot3)(const float *const A[3], const float *const B[3],
+      int32_t Size, float *D);
+  void  (*Cross3)(const float *const A[3], const float *const B[3],
+      int32_t Size, float *const C[3]);
+  /*!< C = R * A for a 3 x 3 row-major R */
+  void  (*Rotate3)(const float *R, const float *const A[3], int32_t Size,
+      float *const C[3]);
+}MatrixSimd_t;
+
+
+/**
+ * @brief  Returns the kernel table selected for the running processor.
+ * @retval const MatrixSimd_t *
+ * @note   The processor is inspected only on the first call. The selection
+ *         is held in an atomic pointer, so any thread may call this
+ *         function at any time, including concurrently with the first call
+ *         or with MatrixSimd_SetLevel.
+ */
+const MatrixSimd_t *MatrixSimd_Get(void);
+
+
+/**
+ * @brief  Forces the use of a given instruction set level.
+ * @param  Level : Desired level.
+ * @retval int32_t
+ * @note   Useful for benchmarking and testing the narrower kernels.
+ *         The function returns 1 on success, 0 if the level is not
+ *         supported by the processor (the selection is kept unchanged).
+ *         It is safe to call while other threads run kernels: each call
+ *         of MatrixSimd_Get returns either the old or the new table.
+ */
+int32_t MatrixSimd_SetLevel(MatrixSimd_Level_t Level);
+
+
+/**
+ * @brief  Returns the widest level among Levels not above the selected
+ *         one (see MatrixSimd_Get).
+ * @param  Levels : Bit mask, bit L set if a module implements level L.
+ *                  The scalar level is always implemented.
+ * @retval MatrixSimd_Level_t
+ * @note   Used through MATRIX_SIMD_SELECT.
+ */
+MatrixSimd_Level_t MatrixSimd_Select(uint32_t Levels);
+
+
+/**
+ * @brief Entry of Passes to run: Passes is an array indexed by
+ *        MatrixSimd_Level_t holding a module's implementations of one
+ *        routine, NULL for the levels it has no code for (the scalar entry
+ *        is required). The selection follows MatrixSimd_SetLevel.
+ */
+#define MATRIX_SIMD_SELECT(Passes) \
+    ((Passes)[MatrixSimd_Select( \
+        ((Passes)[MATRIX_SIMD_SSE2] != 0) << MATRIX_SIMD_SSE2 | \
+        ((Passes)[MATRIX_SIMD_AVX2] != 0) << MATRIX_SIMD_AVX2 | \
+        ((Passes)[MATRIX_SIMD_AVX512] != 0) << MATRIX_SIMD_AVX512)])
+
+#endif /* MATRIX_SIMD_H */
+
+
+
+#ifdef __cplusplus
+}
+#endif
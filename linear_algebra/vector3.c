@@ -0,0 +1,118 @@
+#include "vector3.h"
+#include "matrix_simd.h"
+
+
+/* Vector_t is read as 3 consecutive floats */
+typedef char Vector3_PackedCheck[(sizeof(Vector_t) == 3 * sizeof(float)) ?
+    1 : -1];
+
+
+void Vector3_ToPlanes(const Vector_t *V, uint32_t Size, VectorPlanes_t *P)
+{
+  float *const p[3] = {P->X, P->Y, P->Z};
+
+  MatrixSimd_Get()->Deinterleave3((const float *)V, (int32_t)Size, p);
+}
+
+
+void Vector3_FromPlanes(const VectorPlanes_t *P, uint32_t Size, Vector_t *V)
+{
+  const float *p[3] = {P->X, P->Y, P->Z};
+
+  MatrixSimd_Get()->Interleave3(p, (int32_t)Size, (float *)V);
+}
+
+
+void Vector3_Add(const VectorPlanes_t *A, const VectorPlanes_t *B,
+    uint32_t Size, VectorPlanes_t *C)
+{
+  const MatrixSimd_t *simd = MatrixSimd_Get();
+
+  simd->Add(A->X, B->X, (int32_t)Size, C->X);
+  simd->Add(A->Y, B->Y, (int32_t)Size, C->Y);
+  simd->Add(A->Z, B->Z, (int32_t)Size, C->Z);
+}
+
+
+void Vector3_Subtract(const VectorPlanes_t *A, const VectorPlanes_t *B,
+    uint32_t Size, VectorPlanes_t *C)
+{
+  const MatrixSimd_t *simd = MatrixSimd_Get();
+
+  simd->Subtract(A->X, B->X, (int32_t)Size, C->X);
+  simd->Subtract(A->Y, B->Y, (int32_t)Size, C->Y);
+  simd->Subtract(A->Z, B->Z, (int32_t)Size, C->Z);
+}
+
+
+void Vector3_Scale(const VectorPlanes_t *A, uint32_t Size, float k,
+    VectorPlanes_t *C)
+{
+  const MatrixSimd_t *simd = MatrixSimd_Get();
+
+  simd->Scale(A->X, (int32_t)Size, k, C->X);
+  simd->Scale(A->Y, (int32_t)Size, k, C->Y);
+  simd->Scale(A->Z, (int32_t)Size, k, C->Z);
+}
+
+
+void Vector3_Dot(const VectorPlanes_t *A, const VectorPlanes_t *B,
+    uint32_t Size, float *D)
+{
+  const float *a[3] = {A->X, A->Y, A->Z};
+  const float *b[3] = {B->X, B->Y, B->Z};
+
+  MatrixSimd_Get()->Dot3(a, b, (int32_t)Size, D);
+}
+
+
+void Vector3_Cross(const VectorPlanes_t *A, const VectorPlanes_t *B,
+    uint32_t Size, VectorPlanes_t *C)
+{
+  const float *a[3] = {A->X, A->Y, A->Z};
+  const float *b[3] = {B->X, B->Y, B->Z};
+  float *const c[3] = {C->X, C->Y, C->Z};
+
+  MatrixSimd_Get()->Cross3(a, b, (int32_t)Size, c);
+}
+
+
+void Vector3_Norm(const VectorPlanes_t *A, uint32_t Size,
+    FastMath_Accuracy_t Accuracy, float *N)
+{
+  const MatrixSimd_t *simd = MatrixSimd_Get();
+  const float *a[3] = {A->X, A->Y, A->Z};
+
+  simd->Dot3(a, a, (int32_t)Size, N);
+  simd->Sqrt(N, (int32_t)Size, (int32_t)Accuracy, N);
+}
+
+
+void Vector3_Normalize(const VectorPlanes_t *A, uint32_t Size,
+    FastMath_Accuracy_t Accuracy, VectorPlanes_t *C)
+{
+  const MatrixSimd_t *simd = MatrixSimd_Get();
+  float k[FAST_MATH_BLOCK];
+  uint32_t i, n;
+
+  /* Blocks of inverse norms stay in L1 between the passes */
+  for(i = 0; i < Size; i += FAST_MATH_BLOCK){
+    const float *a[3] = {A->X + i, A->Y + i, A->Z + i};
+    n = (Size - i < FAST_MATH_BLOCK) ? Size - i : FAST_MATH_BLOCK;
+    simd->Dot3(a, a, (int32_t)n, k);
+    simd->InvSqrt(k, (int32_t)n, (int32_t)Accuracy, k);
+    simd->Multiply(a[0], k, (int32_t)n, C->X + i);
+    simd->Multiply(a[1], k, (int32_t)n, C->Y + i);
+    simd->Multiply(a[2], k, (int32_t)n, C->Z + i);
+  }
+}
+
+
+void Vector3_Rotate(const float *R, const VectorPlanes_t *A, uint32_t Size,
+    VectorPlanes_t *C)
+{
+  const float *a[3] = {A->X, A->Y, A->Z};
+  float *const c[3] = {C->X, C->Y, C->Z};
+
+  MatrixSimd_Get()->Rotate3(R, a, (int32_t)Size, c);
+}
@@ -0,0 +1,176 @@
+/**
+ * @file  vector3.h
+ * @date  18-October-2026
+ * @brief Batch operations on 3-vectors (Vector_t samples).
+ *
+ *   A log of Vector_t (custom_types.h) is an array of structures: x, y and
+ *   z of a sample next to each other, 12 bytes apart from the next sample.
+ *   SIMD registers hold 4, 8 or 16 floats, so the operations below work on
+ *   planes instead: one array of x, one of y and one of z, where a register
+ *   holds the same axis of consecutive samples and a cross product or a
+ *   rotation is a few vertical multiply-adds.
+ *
+ *   Vector3_ToPlanes and Vector3_FromPlanes convert between both layouts
+ *   with shuffles in registers, so a log is converted once, processed by
+ *   any number of operations, and converted back.
+ *
+ * @author
+ * @author
+ */
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef VECTOR3_H
+#define VECTOR3_H
+
+
+#define VECTOR3_VER_MAJOR                                                   2026
+#define VECTOR3_VER_MINOR                                                     10
+#define VECTOR3_VER_PATCH                                                      1
+#define VECTOR3_BRANCH_MASTER
+
+
+#include <stdint.h>
+#include "custom_types.h"
+#include "fast_math.h"
+
+
+/**
+ * @brief Size 3-vectors stored as planes.
+ * @note  Sample i is {X[i], Y[i], Z[i]}. Each array has Size elements.
+ */
+typedef struct
+{
+  float *X;
+  float *Y;
+  float *Z;
+}VectorPlanes_t;
+
+
+/**
+ * @brief  Splits an array of Vector_t into planes.
+ * @param  V : Array of Size vectors.
+ * @param  Size : Number of vectors.
+ * @param  P : Planes receiving the vectors.
+ * @retval void
+ */
+void Vector3_ToPlanes(const Vector_t *V, uint32_t Size, VectorPlanes_t *P);
+
+
+/**
+ * @brief  Gathers planes back into an array of Vector_t.
+ * @param  P : Planes of Size vectors.
+ * @param  Size : Number of vectors.
+ * @param  V : Array receiving the vectors.
+ * @retval void
+ */
+void Vector3_FromPlanes(const VectorPlanes_t *P, uint32_t Size, Vector_t *V);
+
+
+/**
+ * @brief  C = A + B, for every vector.
+ * @param  A : First vectors.
+ * @param  B : Second vectors.
+ * @param  Size : Number of vectors.
+ * @param  C : Result, may be A or B.
+ * @retval void
+ */
+void Vector3_Add(const VectorPlanes_t *A, const VectorPlanes_t *B,
+    uint32_t Size, VectorPlanes_t *C);
+
+
+/**
+ * @brief  C = A - B, for every vector.
+ * @param  A : First vectors.
+ * @param  B : Second vectors.
+ * @param  Size : Number of vectors.
+ * @param  C : Result, may be A or B.
+ * @retval void
+ */
+void Vector3_Subtract(const VectorPlanes_t *A, const VectorPlanes_t *B,
+    uint32_t Size, VectorPlanes_t *C);
+
+
+/**
+ * @brief  C = k * A, for every vector.
+ * @param  A : Vectors.
+ * @param  Size : Number of vectors.
+ * @param  k : Scale factor.
+ * @param  C : Result, may be A.
+ * @retval void
+ */
+void Vector3_Scale(const VectorPlanes_t *A, uint32_t Size, float k,
+    VectorPlanes_t *C);
+
+
+/**
+ * @brief  D = A . B, for every vector.
+ * @param  A : First vectors.
+ * @param  B : Second vectors.
+ * @param  Size : Number of vectors.
+ * @param  D : Array of Size dot products.
+ * @retval void
+ */
+void Vector3_Dot(const VectorPlanes_t *A, const VectorPlanes_t *B,
+    uint32_t Size, float *D);
+
+
+/**
+ * @brief  C = A x B, for every vector.
+ * @param  A : First vectors.
+ * @param  B : Second vectors.
+ * @param  Size : Number of vectors.
+ * @param  C : Result, may be A or B.
+ * @retval void
+ */
+void Vector3_Cross(const VectorPlanes_t *A, const VectorPlanes_t *B,
+    uint32_t Size, VectorPlanes_t *C);
+
+
+/**
+ * @brief  Computes the euclidian norm of every vector.
+ * @param  A : Vectors.
+ * @param  Size : Number of vectors.
+ * @param  Accuracy : Newton steps of the square roots, see fast_math.h.
+ * @param  N : Array of Size norms.
+ * @retval void
+ */
+void Vector3_Norm(const VectorPlanes_t *A, uint32_t Size,
+    FastMath_Accuracy_t Accuracy, float *N);
+
+
+/**
+ * @brief  Divides every vector by its euclidian norm.
+ * @param  A : Vectors.
+ * @param  Size : Number of vectors.
+ * @param  Accuracy : Newton steps of the inverse square roots.
+ * @param  C : Result, may be A.
+ * @retval void
+ * @note   A vector of zeros stays zero.
+ */
+void Vector3_Normalize(const VectorPlanes_t *A, uint32_t Size,
+    FastMath_Accuracy_t Accuracy, VectorPlanes_t *C);
+
+
+/**
+ * @brief  C = R * A, for every vector.
+ * @param  R : 3 x 3 row-major matrix, e.g. a rotation from the sensor to
+ *             the body frame.
+ * @param  A : Vectors.
+ * @param  Size : Number of vectors.
+ * @param  C : Result, may be A.
+ * @retval void
+ */
+void Vector3_Rotate(const float *R, const VectorPlanes_t *A, uint32_t Size,
+    VectorPlanes_t *C);
+
+#endif /* VECTOR3_H */
+
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,587 @@
+#include <string.h>
+#include "kalman.h"
+
+#if defined(__GNUC__)
+#define KF_INLINE inline __attribute__((always_inline))
+#else
+#define KF_INLINE inline
+#endif
+
+#ifdef KF_BANK_SIMD_X86
+#define SIMD_TARGET(ISA) __attribute__((target(ISA)))
+#endif
+
+
+/* A step, for N states, F shared and h = H[m]:                         */
+/*  xn = F * x, x = xn                      (KF_Predict only)           */
+/*  T = F * P, rows of P added with the nonzero F[i][k]                 */
+/*  P[i][j] = T[i] . F[j] + Q[i][j], j >= i, mirrored                   */
+/*  e = z - h'*x, or e = innovation - h'*dx for the extended filter     */
+/*  g = P * h, s = h'*g + r                                             */
+/*  k = g / s, x = x + k*e                                              */
+/*  P[i][j] = P[i][j] - (k[i]*g[j] + g[i]*k[j]) + k[i]*s*k[j], j >= i  */
+/* Sums run over k ascending from zero, skipping zero F and h entries. */
+/*  The bank runs the same operations in the same order, one filter per */
+/*  lane, a lane whose s is not positive taking k = 0.                  */
+
+
+/**
+ * @brief  Position of element (i, j), i <= j, of a packed upper triangle.
+ */
+static KF_INLINE uint32_t KF_Packed(uint32_t i, uint32_t j, uint32_t n)
+{
+  return i * n - i * (i - 1) / 2 + (j - i);
+}
+
+
+/**
+ * @brief  P = F * P * F' + Q, with T = Work.
+ */
+static void KF_PredictCov(KF_t *Filter)
+{
+  uint32_t n = Filter->NumStates;
+  const float *F = Filter->F;
+  float *P = Filter->Cov;
+  float *T = Filter->Work;
+  float *t, *p;
+  float f, s;
+  uint32_t i, j, k;
+
+  /* T = F * P */
+  for(i = 0; i < n; i++){
+    t = T + i*n;
+    for(j = 0; j < n; j++){
+      t[j] = 0.0f;
+    }
+    for(k = 0; k < n; k++){
+      f = F[i*n + k];
+      if(f != 0.0f){
+        p = P + k*n;
+        for(j = 0; j < n; j++){
+          t[j] += f * p[j];
+        }
+      }
+    }
+  }
+
+  /* P = T * F' + Q, upper triangle, mirrored */
+  for(i = 0; i < n; i++){
+    t = T + i*n;
+    for(j = i; j < n; j++){
+      s = 0.0f;
+      for(k = 0; k < n; k++){
+        f = F[j*n + k];
+        if(f != 0.0f){
+          s += t[k] * f;
+        }
+      }
+      if(Filter->Q != NULL){
+        s += Filter->Q[i*n + j];
+      }
+      P[i*n + j] = s;
+      P[j*n + i] = s;
+    }
+  }
+}
+
+
+/**
+ * @brief  Update with one scalar measurement of innovation Innovation.
+ * @note   Dx, if not NULL, accumulates the change of the state.
+ */
+static int32_t KF_Scalar(const float *h, float Innovation, float r,
+    float *Dx, KF_t *Filter)
+{
+  uint32_t n = Filter->NumStates;
+  float *x = Filter->State;
+  float *P = Filter->Cov;
+  float *g = Filter->Work + n*n;
+  float *k = g + n;
+  float *p;
+  float s, a, ki, gi;
+  uint32_t i, j;
+
+  /* g = P * h, s = h'*g + r */
+  for(i = 0; i < n; i++){
+    p = P + i*n;
+    s = 0.0f;
+    for(j = 0; j < n; j++){
+      if(h[j] != 0.0f){
+        s += p[j] * h[j];
+      }
+    }
+    g[i] = s;
+  }
+  s = 0.0f;
+  for(i = 0; i < n; i++){
+    if(h[i] != 0.0f){
+      s += h[i] * g[i];
+    }
+  }
+  s = s + r;
+  if(!(s > 0.0f)){
+    Filter->Rejected++;
+    return 0;
+  }
+
+  /* k = g / s, x = x + k*e */
+  a = 1.0f / s;
+  for(i = 0; i < n; i++){
+    k[i] = g[i] * a;
+    x[i] = x[i] + k[i] * Innovation;
+    if(Dx != NULL){
+      Dx[i] = Dx[i] + k[i] * Innovation;
+    }
+  }
+
+  /* Joseph form, upper triangle, mirrored */
+  for(i = 0; i < n; i++){
+    ki = k[i];
+    gi = g[i];
+    p = P + i*n;
+    for(j = i; j < n; j++){
+      p[j] = p[j] - (ki * g[j] + gi * k[j]) + ki * s * k[j];
+      P[j*n + i] = p[j];
+    }
+  }
+  return 1;
+}
+
+
+void KF_Init(float InitialCov, KF_t *Filter)
+{
+  uint32_t n = Filter->NumStates;
+  uint32_t i;
+
+  memset(Filter->State, 0, sizeof(float) * n);
+  memset(Filter->Cov, 0, sizeof(float) * n * n);
+  for(i = 0; i < n; i++){
+    Filter->Cov[i*n + i] = InitialCov;
+  }
+  Filter->Rejected = 0;
+}
+
+
+void KF_Predict(KF_t *Filter)
+{
+  uint32_t n = Filter->NumStates;
+  const float *F = Filter->F;
+  float *xn = Filter->Work + n*n;
+  float f, s;
+  uint32_t i, k;
+
+  /* xn = F * x */
+  for(i = 0; i < n; i++){
+    s = 0.0f;
+    for(k = 0; k < n; k++){
+      f = F[i*n + k];
+      if(f != 0.0f){
+        s += f * Filter->State[k];
+      }
+    }
+    xn[i] = s;
+  }
+  memcpy(Filter->State, xn, sizeof(float) * n);
+
+  KF_PredictCov(Filter);
+}
+
+
+int32_t KF_Update(const float *Measurements, KF_t *Filter)
+{
+  uint32_t n = Filter->NumStates;
+  const float *h;
+  float s;
+  uint32_t m, k;
+  int32_t valid = 1;
+
+  for(m = 0; m < Filter->NumMeas; m++){
+    /* e = z - h'*x */
+    h = Filter->H + m*n;
+    s = 0.0f;
+    for(k = 0; k < n; k++){
+      if(h[k] != 0.0f){
+        s += h[k] * Filter->State[k];
+      }
+    }
+    valid &= KF_Scalar(h, Measurements[m] - s, Filter->R[m], NULL, Filter);
+  }
+  return valid;
+}
+
+
+void EKF_Predict(KF_t *Filter)
+{
+  KF_PredictCov(Filter);
+}
+
+
+int32_t EKF_Update(const float *Innovations, KF_t *Filter)
+{
+  uint32_t n = Filter->NumStates;
+  float *dx = Filter->Work + n*n + 2*n;
+  const float *h;
+  float s;
+  uint32_t m, k;
+  int32_t valid = 1;
+
+  memset(dx, 0, sizeof(float) * n);
+  for(m = 0; m < Filter->NumMeas; m++){
+    /* e = innovation - h'*dx */
+    h = Filter->H + m*n;
+    s = 0.0f;
+    for(k = 0; k < n; k++){
+      if(h[k] != 0.0f){
+        s += h[k] * dx[k];
+      }
+    }
+    valid &= KF_Scalar(h, Innovations[m] - s, Filter->R[m], dx, Filter);
+  }
+  return valid;
+}
+
+
+size_t KF_WorkspaceSize(uint32_t NumStates, uint32_t NumMeas)
+{
+  size_t n = NumStates;
+
+  return ARENA_ALIGN_UP(sizeof(float) * n) +
+      3 * ARENA_ALIGN_UP(sizeof(float) * n * n) +
+      ARENA_ALIGN_UP(sizeof(float) * NumMeas * n) +
+      ARENA_ALIGN_UP(sizeof(float) * NumMeas) +
+      ARENA_ALIGN_UP(sizeof(float) * KF_WORK_SIZE(n));
+}
+
+
+int32_t KF_AttachWorkspace(void *Workspace, uint32_t NumStates,
+    uint32_t NumMeas, float InitialCov, KF_t *Filter)
+{
+  Arena_t arena;
+  size_t n = NumStates;
+
+  if(Arena_InitWorkspace(&arena, Workspace,
+      KF_WorkspaceSize(NumStates, NumMeas)) != ANSWERED_REQUEST){
+    return 0;
+  }
+  Filter->State = Arena_Alloc(&arena, sizeof(float) * n);
+  Filter->Cov = Arena_Alloc(&arena, sizeof(float) * n * n);
+  Filter->F = Arena_Alloc(&arena, sizeof(float) * n * n);
+  Filter->Q = Arena_Alloc(&arena, sizeof(float) * n * n);
+  Filter->H = Arena_Alloc(&arena, sizeof(float) * NumMeas * n);
+  Filter->R = Arena_Alloc(&arena, sizeof(float) * NumMeas);
+  Filter->Work = Arena_Alloc(&arena, sizeof(float) * KF_WORK_SIZE(n));
+  Filter->NumStates = NumStates;
+  Filter->NumMeas = NumMeas;
+  KF_Init(InitialCov, Filter);
+  return 1;
+}
+
+
+void KF_BankInit(float InitialCov, KF_Bank_t *Bank)
+{
+  uint32_t n = Bank->NumStates;
+  uint32_t st = Bank->Stride;
+  uint32_t i, j, f;
+  float *p = Bank->Cov;
+
+  memset(Bank->State, 0, sizeof(float) * n * st);
+  for(i = 0; i < n; i++){
+    for(j = i; j < n; j++){
+      for(f = 0; f < st; f++){
+        p[f] = (i == j) ? InitialCov : 0.0f;
+      }
+      p += st;
+    }
+  }
+}
+
+
+void KF_BankLoad(uint32_t Index, const KF_t *Filter, KF_Bank_t *Bank)
+{
+  uint32_t n = Bank->NumStates;
+  uint32_t st = Bank->Stride;
+  uint32_t i, j;
+
+  for(i = 0; i < n; i++){
+    Bank->State[i*st + Index] = Filter->State[i];
+    for(j = i; j < n; j++){
+      Bank->Cov[KF_Packed(i, j, n)*st + Index] = Filter->Cov[i*n + j];
+    }
+  }
+}
+
+
+void KF_BankStore(uint32_t Index, KF_t *Filter, const KF_Bank_t *Bank)
+{
+  uint32_t n = Bank->NumStates;
+  uint32_t st = Bank->Stride;
+  uint32_t i, j;
+
+  for(i = 0; i < n; i++){
+    Filter->State[i] = Bank->State[i*st + Index];
+    for(j = i; j < n; j++){
+      Filter->Cov[i*n + j] = Bank->Cov[KF_Packed(i, j, n)*st + Index];
+      Filter->Cov[j*n + i] = Filter->Cov[i*n + j];
+    }
+  }
+}
+
+
+/* The blocks below update KF_BANK_LANES filters: x and P point to the  */
+/*  first of them, their loops over the lanes have a constant count and */
+/*  no aliasing, so the compiler turns each into SIMD instructions of   */
+/*  the target the calling pass is compiled for.                        */
+
+/**
+ * @brief  KF_Predict on one block of filters.
+ */
+static KF_INLINE void KF_BankPredictBlock(const float *restrict F,
+    const float *restrict Q, uint32_t n, uint32_t st, float *restrict x,
+    float *restrict P, float *restrict Work)
+{
+  float *restrict T = Work;
+  float *restrict xn = Work + n*n*KF_BANK_LANES;
+  float *t, *p, *a;
+  float f;
+  uint32_t i, j, k, l;
+
+  /* xn = F * x */
+  for(i = 0; i < n; i++){
+    a = xn + i*KF_BANK_LANES;
+    for(l = 0; l < KF_BANK_LANES; l++){
+      a[l] = 0.0f;
+    }
+    for(k = 0; k < n; k++){
+      f = F[i*n + k];
+      if(f != 0.0f){
+        for(l = 0; l < KF_BANK_LANES; l++){
+          a[l] += f * x[k*st + l];
+        }
+      }
+    }
+  }
+  for(i = 0; i < n; i++){
+    for(l = 0; l < KF_BANK_LANES; l++){
+      x[i*st + l] = xn[i*KF_BANK_LANES + l];
+    }
+  }
+
+  /* T = F * P */
+  for(i = 0; i < n; i++){
+    for(j = 0; j < n; j++){
+      t = T + (i*n + j)*KF_BANK_LANES;
+      for(l = 0; l < KF_BANK_LANES; l++){
+        t[l] = 0.0f;
+      }
+    }
+    for(k = 0; k < n; k++){
+      f = F[i*n + k];
+      if(f != 0.0f){
+        for(j = 0; j < n; j++){
+          t = T + (i*n + j)*KF_BANK_LANES;
+          p = P + ((k <= j) ? KF_Packed(k, j, n) : KF_Packed(j, k, n))*st;
+          for(l = 0; l < KF_BANK_LANES; l++){
+            t[l] += f * p[l];
+          }
+        }
+      }
+    }
+  }
+
+  /* P = T * F' + Q, upper triangle */
+  for(i = 0; i < n; i++){
+    for(j = i; j < n; j++){
+      a = xn;
+      for(l = 0; l < KF_BANK_LANES; l++){
+        a[l] = 0.0f;
+      }
+      for(k = 0; k < n; k++){
+        f = F[j*n + k];
+        if(f != 0.0f){
+          t = T + (i*n + k)*KF_BANK_LANES;
+          for(l = 0; l < KF_BANK_LANES; l++){
+            a[l] += t[l] * f;
+          }
+        }
+      }
+      if(Q != NULL){
+        f = Q[i*n + j];
+        for(l = 0; l < KF_BANK_LANES; l++){
+          a[l] += f;
+        }
+      }
+      p = P + KF_Packed(i, j, n)*st;
+      for(l = 0; l < KF_BANK_LANES; l++){
+        p[l] = a[l];
+      }
+    }
+  }
+}
+
+
+/**
+ * @brief  KF_Update on one block of filters.
+ */
+static KF_INLINE void KF_BankUpdateBlock(const float *restrict H,
+    const float *restrict R, uint32_t NumMeas, uint32_t n, uint32_t st,
+    const float *restrict z, float *restrict x, float *restrict P,
+    float *restrict Work)
+{
+  float *restrict g = Work;
+  float *restrict k = g + n*KF_BANK_LANES;
+  float *restrict s = k + n*KF_BANK_LANES;
+  float *restrict e = s + KF_BANK_LANES;
+  float *restrict a = e + KF_BANK_LANES;
+  const float *h;
+  float *p, *gi, *ki, *gj, *kj;
+  float hj;
+  uint32_t m, i, j, l;
+
+  for(m = 0; m < NumMeas; m++){
+    h = H + m*n;
+
+    /* e = z - h'*x */
+    for(l = 0; l < KF_BANK_LANES; l++){
+      s[l] = 0.0f;
+    }
+    for(j = 0; j < n; j++){
+      hj = h[j];
+      if(hj != 0.0f){
+        for(l = 0; l < KF_BANK_LANES; l++){
+          s[l] += hj * x[j*st + l];
+        }
+      }
+    }
+    for(l = 0; l < KF_BANK_LANES; l++){
+      e[l] = z[m*st + l] - s[l];
+    }
+
+    /* g = P * h, s = h'*g + r */
+    for(i = 0; i < n; i++){
+      gi = g + i*KF_BANK_LANES;
+      for(l = 0; l < KF_BANK_LANES; l++){
+        gi[l] = 0.0f;
+      }
+      for(j = 0; j < n; j++){
+        hj = h[j];
+        if(hj != 0.0f){
+          p = P + ((i <= j) ? KF_Packed(i, j, n) : KF_Packed(j, i, n))*st;
+          for(l = 0; l < KF_BANK_LANES; l++){
+            gi[l] += p[l] * hj;
+          }
+        }
+      }
+    }
+    for(l = 0; l < KF_BANK_LANES; l++){
+      s[l] = 0.0f;
+    }
+    for(i = 0; i < n; i++){
+      hj = h[i];
+      if(hj != 0.0f){
+        gi = g + i*KF_BANK_LANES;
+        for(l = 0; l < KF_BANK_LANES; l++){
+          s[l] += hj * gi[l];
+        }
+      }
+    }
+
+    /* k = g / s, x = x + k*e, k = 0 where s is not positive */
+    for(l = 0; l < KF_BANK_LANES; l++){
+      s[l] = s[l] + R[m];
+      a[l] = (s[l] > 0.0f) ? 1.0f / s[l] : 0.0f;
+    }
+    for(i = 0; i < n; i++){
+      gi = g + i*KF_BANK_LANES;
+      ki = k + i*KF_BANK_LANES;
+      for(l = 0; l < KF_BANK_LANES; l++){
+        ki[l] = gi[l] * a[l];
+        x[i*st + l] = x[i*st + l] + ki[l] * e[l];
+      }
+    }
+
+    /* Joseph form, upper triangle */
+    for(i = 0; i < n; i++){
+      gi = g + i*KF_BANK_LANES;
+      ki = k + i*KF_BANK_LANES;
+      for(j = i; j < n; j++){
+        gj = g + j*KF_BANK_LANES;
+        kj = k + j*KF_BANK_LANES;
+        p = P + KF_Packed(i, j, n)*st;
+        for(l = 0; l < KF_BANK_LANES; l++){
+          p[l] = p[l] - (ki[l] * gj[l] + gi[l] * kj[l]) +
+              ki[l] * s[l] * kj[l];
+        }
+      }
+    }
+  }
+}
+
+
+typedef void (*KF_BankPass_t)(KF_Bank_t *Bank, const float *Measurements);
+
+
+/**
+ * @brief  Predicts (Measurements NULL) or updates every filter of the
+ *         bank, one block after the other.
+ */
+static KF_INLINE void KF_BankRun(KF_Bank_t *Bank, const float *Measurements)
+{
+  uint32_t f;
+
+  for(f = 0; f < Bank->Stride; f += KF_BANK_LANES){
+    if(Measurements == NULL){
+      KF_BankPredictBlock(Bank->F, Bank->Q, Bank->NumStates, Bank->Stride,
+          Bank->State + f, Bank->Cov + f, Bank->Work);
+    }else{
+      KF_BankUpdateBlock(Bank->H, Bank->R, Bank->NumMeas, Bank->NumStates,
+          Bank->Stride, Measurements + f, Bank->State + f, Bank->Cov + f,
+          Bank->Work);
+    }
+  }
+}
+
+
+static void KF_BankPassDefault(KF_Bank_t *Bank, const float *Measurements)
+{
+  KF_BankRun(Bank, Measurements);
+}
+
+
+#ifdef KF_BANK_SIMD_X86
+
+SIMD_TARGET("avx2")
+static void KF_BankPassAvx2(KF_Bank_t *Bank, const float *Measurements)
+{
+  KF_BankRun(Bank, Measurements);
+}
+
+
+SIMD_TARGET("avx512f") MATRIX_SIMD_NO_CONTRACT
+static void KF_BankPassAvx512(KF_Bank_t *Bank, const float *Measurements)
+{
+  KF_BankRun(Bank, Measurements);
+}
+
+#endif /* KF_BANK_SIMD_X86 */
+
+
+/* The default pass is SSE2 on x86-64 */
+static const KF_BankPass_t passes[MATRIX_SIMD_NUMBER_OF_LEVELS] = {
+    [MATRIX_SIMD_SCALAR] = KF_BankPassDefault,
+#ifdef KF_BANK_SIMD_X86
+    [MATRIX_SIMD_AVX2] = KF_BankPassAvx2,
+    [MATRIX_SIMD_AVX512] = KF_BankPassAvx512,
+#endif
+};
+
+
+void KF_BankPredict(KF_Bank_t *Bank)
+{
+  MATRIX_SIMD_SELECT(passes)(Bank, NULL);
+}
+
+
+void KF_BankUpdate(const float *Measurements, KF_Bank_t *Bank)
+{
+  MATRIX_SIMD_SELECT(passes)(Bank, Measurements);
+}
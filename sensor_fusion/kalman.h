@@ -0,0 +1,284 @@
+/**
+ * @file  kalman.h
+ * @date  18-October-2026
+ * @brief Linear and extended Kalman filters, single or in banks.
+ *
+ *   The prediction is fused: P = F * P * F' + Q is taken as T = F * P
+ *   followed by the upper triangle of T * F' + Q, both read row by row,
+ *   mirrored into the lower one. Zero entries of F, most of them in
+ *   tracking models, are skipped, as are those of H in the update.
+ *
+ *   Measurements are processed one at a time as scalars, which is exact
+ *   when their noises are uncorrelated (R diagonal): each takes a gain
+ *   k = P * h / s with s = h' * P * h + r, so no matrix is inverted. The
+ *   covariance is updated in Joseph form, P = (I - k h') P (I - k h')' +
+ *   k r k', expanded for a scalar measurement as
+ *   P = P - k g' - g k' + s k k' with g = P * h: a rounding error in k only
+ *   affects P at second order and P stays symmetric. Correlated noises
+ *   can be decorrelated beforehand with the Cholesky factor of R.
+ *
+ *   Every buffer is held by the handle (KF_AttachWorkspace carves them from
+ *   one block), so a step allocates nothing.
+ *
+ *   KF_Bank_t runs many filters sharing one model (F, Q, H and R), e.g.
+ *   the tracks of a tracker, in structure-of-arrays form: element e of
+ *   every filter is contiguous and KF_BANK_LANES filters are updated at
+ *   once with SIMD instructions (AVX-512, AVX2 or SSE2, selected at
+ *   runtime with the level of matrix_simd.h, unless KF_BANK_SIMD_DISABLE
+ *   is defined). A filter of the bank gets the same result as KF_Predict
+ *   and KF_Update, bit for bit (see matrix_simd.h).
+ *
+ * @author
+ * @author
+ */
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef KALMAN_H
+#define KALMAN_H
+
+
+#define KALMAN_VER_MAJOR                                                    2026
+#define KALMAN_VER_MINOR                                                      10
+#define KALMAN_VER_PATCH                                                       1
+#define KALMAN_BRANCH_MASTER
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+#include "matrix_simd.h"
+
+
+#if !defined(KF_BANK_SIMD_DISABLE) && defined(MATRIX_SIMD_X86)
+#define KF_BANK_SIMD_X86
+#endif
+
+/**
+ * @brief Number of floats of KF_t.Work for the given number of states.
+ */
+#define KF_WORK_SIZE(NumStates) \
+    ((NumStates) * ((NumStates) + 3))
+
+/**
+ * @brief Filters of a bank updated together. Stride must be a multiple.
+ */
+#define KF_BANK_LANES                                    MATRIX_SIMD_LINE_FLOATS
+
+/**
+ * @brief Stride for NumFilters filters, see MATRIX_SIMD_BANK_STRIDE.
+ */
+#define KF_BANK_STRIDE(NumFilters) \
+    MATRIX_SIMD_BANK_STRIDE(NumFilters)
+
+/**
+ * @brief Number of floats of KF_Bank_t.Cov for the given dimensions.
+ */
+#define KF_BANK_COV_SIZE(NumStates, Stride) \
+    ((NumStates) * ((NumStates) + 1) / 2 * (Stride))
+
+/**
+ * @brief Number of floats of KF_Bank_t.Work for the given number of
+ *        states.
+ */
+#define KF_BANK_WORK_SIZE(NumStates) \
+    (((NumStates) * ((NumStates) + 2) + 2) * KF_BANK_LANES)
+
+
+/**
+ * @brief Structure used to operate a filter.
+ * @note  Matrices are row-major. For an extended filter, F and H hold the
+ *        Jacobians of the transition and measurement functions, updated by
+ *        the user before each step.
+ */
+typedef struct
+{
+  float *State;         /*!< 1-D array of size NumStates, estimate x */
+  float *Cov;           /*!< NumStates x NumStates, covariance P of the
+                             estimate. Both triangles are kept */
+  float *F;             /*!< NumStates x NumStates, state transition */
+  float *Q;             /*!< NumStates x NumStates, process noise
+                             covariance, NULL for none */
+  float *H;             /*!< NumMeas x NumStates, measurement model, one
+                             row per scalar measurement */
+  float *R;             /*!< 1-D array of size NumMeas, variance of the
+                             noise of each measurement */
+  float *Work;          /*!< 1-D array of size KF_WORK_SIZE(NumStates) */
+  uint32_t NumStates;   /*!< Dimension of the state */
+  uint32_t NumMeas;     /*!< Scalar measurements per update */
+  uint32_t Rejected;    /*!< Measurements skipped since h' P h + r <= 0 */
+}KF_t;
+
+
+/**
+ * @brief Structure used to operate a bank of filters.
+ * @note  Arrays are allocated by the user. Element e of filter f is stored
+ *        at [e * Stride + f]. The model is shared by every filter. Filters
+ *        past NumFilters (up to Stride) are computed too, so their
+ *        elements must hold finite numbers; KF_BankInit sets them.
+ */
+typedef struct
+{
+  float *State;         /*!< NumStates * Stride, as KF_t.State */
+  float *Cov;           /*!< KF_BANK_COV_SIZE(NumStates, Stride), upper
+                             triangle of each covariance packed row by row:
+                             (0,0), (0,1), ..., (0,N-1), (1,1), (1,2), ... */
+  const float *F;       /*!< As KF_t.F */
+  const float *Q;       /*!< As KF_t.Q */
+  const float *H;       /*!< As KF_t.H */
+  const float *R;       /*!< As KF_t.R */
+  float *Work;          /*!< KF_BANK_WORK_SIZE(NumStates) floats */
+  uint32_t NumStates;   /*!< Dimension of the state of every filter */
+  uint32_t NumMeas;     /*!< Scalar measurements per update */
+  uint32_t NumFilters;  /*!< Number of filters in the bank */
+  uint32_t Stride;      /*!< Distance between two elements of a filter,
+                             a multiple of KF_BANK_LANES >= NumFilters, see
+                             KF_BANK_STRIDE */
+}KF_Bank_t;
+
+
+/**
+ * @brief  Sets the estimate to zero and the covariance to InitialCov * I.
+ * @param  InitialCov : Initial variance of every state.
+ * @param  Filter : Handle with all needed variables.
+ * @retval void
+ * @note   The model (F, Q, H and R) is not changed.
+ */
+void KF_Init(float InitialCov, KF_t *Filter);
+
+
+/**
+ * @brief  Propagates the estimate: x = F * x, P = F * P * F' + Q.
+ * @param  Filter : Handle with all needed variables.
+ * @retval void
+ */
+void KF_Predict(KF_t *Filter);
+
+
+/**
+ * @brief  Corrects the estimate with NumMeas scalar measurements, z[m] =
+ *         H[m] * x + noise of variance R[m], processed in order.
+ * @param  Measurements : 1-D array of size NumMeas.
+ * @param  Filter : Handle with all needed variables.
+ * @retval int32_t
+ * @note   The function returns 1 on success, 0 if a measurement was
+ *         skipped because its innovation variance was not positive
+ *         (Rejected is incremented).
+ */
+int32_t KF_Update(const float *Measurements, KF_t *Filter);
+
+
+/**
+ * @brief  Propagates the covariance of an extended filter,
+ *         P = F * P * F' + Q.
+ * @param  Filter : Handle with all needed variables. State must already
+ *                  hold f(x) and F the Jacobian of f at the previous x.
+ * @retval void
+ */
+void EKF_Predict(KF_t *Filter);
+
+
+/**
+ * @brief  Corrects the estimate of an extended filter.
+ * @param  Innovations : 1-D array of size NumMeas, z[m] - h[m](x), with
+ *                       the measurement functions evaluated at the
+ *                       estimate before the update.
+ * @param  Filter : Handle with all needed variables. H holds the Jacobian
+ *                  of h at the same estimate.
+ * @retval int32_t
+ * @note   The innovations are corrected for the change of the estimate
+ *         made by the previous measurements, z[m] - h[m](x) - H[m] * dx,
+ *         so the result is that of the batch update linearized at the
+ *         estimate before the update. Returns as KF_Update.
+ */
+int32_t EKF_Update(const float *Innovations, KF_t *Filter);
+
+
+/**
+ * @brief  Returns the bytes of workspace needed by KF_AttachWorkspace.
+ * @param  NumStates : Dimension of the state.
+ * @param  NumMeas : Scalar measurements per update.
+ * @retval size_t : A multiple of ARENA_ALIGN.
+ */
+size_t KF_WorkspaceSize(uint32_t NumStates, uint32_t NumMeas);
+
+
+/**
+ * @brief  Points every buffer of a KF_t into one workspace, clears it and
+ *         starts the filter (KF_Init).
+ * @param  Workspace : ARENA_ALIGN aligned memory of
+ *                     KF_WorkspaceSize(NumStates, NumMeas) bytes.
+ * @param  NumStates : Dimension of the state.
+ * @param  NumMeas : Scalar measurements per update.
+ * @param  InitialCov : Initial variance of every state.
+ * @param  Filter : Handle to set up. F, Q, H and R point into the
+ *                  workspace, cleared, for the user to fill.
+ * @retval int32_t
+ * @note   The function returns 1 on success, 0 if Workspace is NULL or
+ *         not aligned.
+ */
+int32_t KF_AttachWorkspace(void *Workspace, uint32_t NumStates,
+    uint32_t NumMeas, float InitialCov, KF_t *Filter);
+
+
+/**
+ * @brief  Sets the estimate of every filter to zero and its covariance to
+ *         InitialCov * I.
+ * @param  InitialCov : Initial variance of every state.
+ * @param  Bank : Handle with all needed variables.
+ * @retval void
+ */
+void KF_BankInit(float InitialCov, KF_Bank_t *Bank);
+
+
+/**
+ * @brief  Copies the estimate of a filter into the bank.
+ * @param  Index : Position of the filter in the bank.
+ * @param  Filter : Filter with the bank's NumStates. Its State and the
+ *                  upper triangle of its Cov are copied.
+ * @param  Bank : Handle with all needed variables.
+ * @retval void
+ */
+void KF_BankLoad(uint32_t Index, const KF_t *Filter, KF_Bank_t *Bank);
+
+
+/**
+ * @brief  Copies the estimate of a filter of the bank to a KF_t.
+ * @param  Index : Position of the filter in the bank.
+ * @param  Filter : Filter to be updated. Both triangles of Cov are
+ *                  written.
+ * @param  Bank : Handle with all needed variables.
+ * @retval void
+ */
+void KF_BankStore(uint32_t Index, KF_t *Filter, const KF_Bank_t *Bank);
+
+
+/**
+ * @brief  Runs KF_Predict on every filter of the bank.
+ * @param  Bank : Handle with all needed variables.
+ * @retval void
+ */
+void KF_BankPredict(KF_Bank_t *Bank);
+
+
+/**
+ * @brief  Runs KF_Update on every filter of the bank.
+ * @param  Measurements : NumMeas * Stride, measurement m of filter f at
+ *                        [m * Stride + f].
+ * @param  Bank : Handle with all needed variables.
+ * @retval void
+ * @note   A measurement whose innovation variance is not positive leaves
+ *         its filter unchanged.
+ */
+void KF_BankUpdate(const float *Measurements, KF_Bank_t *Bank);
+
+#endif /* KALMAN_H */
+
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,487 @@
+#include <math.h>
+#include <stddef.h>
+#include "madgwick.h"
+
+#if defined(__GNUC__)
+#define MADGWICK_INLINE inline __attribute__((always_inline))
+#else
+#define MADGWICK_INLINE inline
+#endif
+
+#ifdef MADGWICK_SIMD_X86
+#define SIMD_TARGET(ISA) __attribute__((target(ISA)))
+#endif
+
+
+/* Every pass runs the same operations in the same order, one stream per  */
+/*  lane. With q = {q0, q1, q2, q3} and R(q) / 2 = r (rows r0, r1, r2):   */
+/*  qd = q * {0, w} / 2                        gyroscope rate             */
+/*  a = a / |a|, m = m / |m|                                              */
+/*  h = R(q) * m, b = {|hx hy|, 0, hz}         earth field direction      */
+/*  fa = R(q)' * {0, 0, 1} - a, fm = R(q)' * b - m                        */
+/*  s = J' * {fa, fm}, s = s / |s|             gradient of |fa|^2 + |fm|^2 */
+/*  qd = qd - beta * s, unless a = 0                                      */
+/*  q = q + qd * dt, q = q / |q|                                          */
+/* The Jacobian J is that of the paper, with B = 2 bx and Z = 2 bz.       */
+/* A magnetometer of zeros gives b = 0 and fm = 0: the inertial filter.   */
+
+
+/* Newton steps of the quaternion normalization, whatever the accuracy. */
+/*  Newton steps always land below 1 / sqrt(x), so a coarse tier would  */
+/*  leave |q| slightly under 1 at every sample, and that bias pulls the */
+/*  attitude away by degrees (30 with FAST_MATH_APPROX). Three steps are */
+/*  at float rounding.                                                   */
+#define MADGWICK_QUAT_ACCURACY                                 FAST_MATH_NEWTON3
+
+
+/* Streams per block of the SIMD passes. The values of a block are kept */
+/*  in planes on the stack between the InvSqrt kernel calls.            */
+#define MADGWICK_BLOCK                                                        64
+#define MADGWICK_PLANES                                                       26
+
+
+/**
+ * @brief  One sample of one stream.
+ * @note   Quaternion component c is read and written at Quat[c * Stride].
+ */
+static int32_t Madgwick_Step(float *Quat, uint32_t Stride, float gx,
+    float gy, float gz, float ax, float ay, float az, float mx, float my,
+    float mz, float Beta, float Dt, FastMath_Accuracy_t Accuracy)
+{
+  float q0 = Quat[0], q1 = Quat[Stride];
+  float q2 = Quat[2 * Stride], q3 = Quat[3 * Stride];
+  float qd0, qd1, qd2, qd3, n, k, t, hx, hy, hz, bx, bz;
+  float q0q1, q0q2, q0q3, q1q1, q1q2, q1q3, q2q2, q2q3, q3q3;
+  float r00, r01, r02, r10, r11, r12, r20, r21, r22;
+  float fa0, fa1, fa2, fm0, fm1, fm2, s0, s1, s2, s3;
+  int32_t valid;
+
+  qd0 = (q1 * gx + q2 * gy + q3 * gz) * -0.5f;
+  qd1 = (q0 * gx + q2 * gz - q3 * gy) * 0.5f;
+  qd2 = (q0 * gy - q1 * gz + q3 * gx) * 0.5f;
+  qd3 = (q0 * gz + q1 * gy - q2 * gx) * 0.5f;
+  n = ax * ax + ay * ay + az * az;
+  valid = (n > 0.0f) ? 1 : 0;
+  if(valid){
+    k = FastInvSqrt(n, Accuracy);
+    ax = ax * k;
+    ay = ay * k;
+    az = az * k;
+    k = FastInvSqrt(mx * mx + my * my + mz * mz, Accuracy);
+    mx = mx * k;
+    my = my * k;
+    mz = mz * k;
+    q0q1 = q0 * q1;
+    q0q2 = q0 * q2;
+    q0q3 = q0 * q3;
+    q1q1 = q1 * q1;
+    q1q2 = q1 * q2;
+    q1q3 = q1 * q3;
+    q2q2 = q2 * q2;
+    q2q3 = q2 * q3;
+    q3q3 = q3 * q3;
+    r00 = 0.5f - q2q2 - q3q3;
+    r01 = q1q2 - q0q3;
+    r02 = q1q3 + q0q2;
+    r10 = q1q2 + q0q3;
+    r11 = 0.5f - q1q1 - q3q3;
+    r12 = q2q3 - q0q1;
+    r20 = q1q3 - q0q2;
+    r21 = q2q3 + q0q1;
+    r22 = 0.5f - q1q1 - q2q2;
+    hx = r00 * mx + r01 * my + r02 * mz;
+    hy = r10 * mx + r11 * my + r12 * mz;
+    hz = r20 * mx + r21 * my + r22 * mz;
+    t = hx * hx + hy * hy;
+    bx = t * FastInvSqrt(t, Accuracy) * 2.0f;
+    bz = hz * 2.0f;
+    fa0 = r20 * 2.0f - ax;
+    fa1 = r21 * 2.0f - ay;
+    fa2 = r22 * 2.0f - az;
+    fm0 = (bx * r00 + bz * r20) * 2.0f - mx;
+    fm1 = (bx * r01 + bz * r21) * 2.0f - my;
+    fm2 = (bx * r02 + bz * r22) * 2.0f - mz;
+    s0 = q1 * fa1 - q2 * fa0 - bz * q2 * fm0 + (bz * q1 - bx * q3) * fm1 +
+        bx * q2 * fm2;
+    s1 = q3 * fa0 + q0 * fa1 - q1 * fa2 * 2.0f + bz * q3 * fm0 +
+        (bx * q2 + bz * q0) * fm1 + (bx * q3 - bz * q1 * 2.0f) * fm2;
+    s2 = q3 * fa1 - q0 * fa0 - q2 * fa2 * 2.0f -
+        (bx * q2 * 2.0f + bz * q0) * fm0 + (bx * q1 + bz * q3) * fm1 +
+        (bx * q0 - bz * q2 * 2.0f) * fm2;
+    s3 = q1 * fa0 + q2 * fa1 + (bz * q1 - bx * q3 * 2.0f) * fm0 +
+        (bz * q2 - bx * q0) * fm1 + bx * q1 * fm2;
+    k = FastInvSqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3, Accuracy);
+    qd0 = qd0 - Beta * (s0 * k);
+    qd1 = qd1 - Beta * (s1 * k);
+    qd2 = qd2 - Beta * (s2 * k);
+    qd3 = qd3 - Beta * (s3 * k);
+  }
+  q0 = q0 + qd0 * Dt;
+  q1 = q1 + qd1 * Dt;
+  q2 = q2 + qd2 * Dt;
+  q3 = q3 + qd3 * Dt;
+  k = FastInvSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3,
+      MADGWICK_QUAT_ACCURACY);
+  Quat[0] = q0 * k;
+  Quat[Stride] = q1 * k;
+  Quat[2 * Stride] = q2 * k;
+  Quat[3 * Stride] = q3 * k;
+  return valid;
+}
+
+
+typedef void (*Madgwick_Pass_t)(const VectorPlanes_t *Gyro,
+    const VectorPlanes_t *Accel, const VectorPlanes_t *Mag, uint32_t Begin,
+    uint32_t End, Madgwick_Bank_t *Bank);
+
+
+static void Madgwick_PassScalar(const VectorPlanes_t *Gyro,
+    const VectorPlanes_t *Accel, const VectorPlanes_t *Mag, uint32_t Begin,
+    uint32_t End, Madgwick_Bank_t *Bank)
+{
+  uint32_t s;
+
+  for(s = Begin; s < End; s++){
+    Madgwick_Step(Bank->Quat + s, Bank->NumStreams, Gyro->X[s], Gyro->Y[s],
+        Gyro->Z[s], Accel->X[s], Accel->Y[s], Accel->Z[s],
+        (Mag != 0) ? Mag->X[s] : 0.0f, (Mag != 0) ? Mag->Y[s] : 0.0f,
+        (Mag != 0) ? Mag->Z[s] : 0.0f, Bank->Beta, Bank->SamplePeriod,
+        Bank->Accuracy);
+  }
+}
+
+
+#ifdef MADGWICK_SIMD_X86
+
+/**
+ * @brief  Madgwick_Step on MADGWICK_BLOCK streams, each line looping over
+ *         the streams so that it is vectorized for the target of the
+ *         calling pass. The inverse square roots are those of the InvSqrt
+ *         kernel, which round as FastInvSqrt. Streams whose acceleration
+ *         is zero keep the gyroscope rate alone, as in Madgwick_Step.
+ * @note   Quaternion component c of stream l is at q[c * st + l], the
+ *         samples at g, a and m[axis][l]. Work holds MADGWICK_PLANES
+ *         planes of MADGWICK_BLOCK floats.
+ */
+static MADGWICK_INLINE void Madgwick_Block(float *restrict q, size_t st,
+    const float *restrict gx, const float *restrict gy,
+    const float *restrict gz, const float *restrict ax0,
+    const float *restrict ay0, const float *restrict az0,
+    const float *restrict mx0, const float *restrict my0,
+    const float *restrict mz0, float Beta, float Dt, int32_t it,
+    const MatrixSimd_t *Kernels, float *restrict Work)
+{
+  float q0, q1, q2, q3, k, bx, bz, fa0, fa1, fa2, fm0, fm1, fm2;
+  float q0q1, q0q2, q0q3, q1q1, q1q2, q1q3, q2q2, q2q3, q3q3;
+  float r10, r11, r12;
+  float *restrict qd0 = Work + 0 * MADGWICK_BLOCK;
+  float *restrict qd1 = Work + 1 * MADGWICK_BLOCK;
+  float *restrict qd2 = Work + 2 * MADGWICK_BLOCK;
+  float *restrict qd3 = Work + 3 * MADGWICK_BLOCK;
+  float *restrict na = Work + 4 * MADGWICK_BLOCK;
+  float *restrict ka = Work + 5 * MADGWICK_BLOCK;
+  float *restrict km = Work + 6 * MADGWICK_BLOCK;
+  float *restrict ax = Work + 7 * MADGWICK_BLOCK;
+  float *restrict ay = Work + 8 * MADGWICK_BLOCK;
+  float *restrict az = Work + 9 * MADGWICK_BLOCK;
+  float *restrict mx = Work + 10 * MADGWICK_BLOCK;
+  float *restrict my = Work + 11 * MADGWICK_BLOCK;
+  float *restrict mz = Work + 12 * MADGWICK_BLOCK;
+  float *restrict r00 = Work + 13 * MADGWICK_BLOCK;
+  float *restrict r01 = Work + 14 * MADGWICK_BLOCK;
+  float *restrict r02 = Work + 15 * MADGWICK_BLOCK;
+  float *restrict r20 = Work + 16 * MADGWICK_BLOCK;
+  float *restrict r21 = Work + 17 * MADGWICK_BLOCK;
+  float *restrict r22 = Work + 18 * MADGWICK_BLOCK;
+  float *restrict hz = Work + 19 * MADGWICK_BLOCK;
+  float *restrict t = Work + 20 * MADGWICK_BLOCK;
+  float *restrict kt = Work + 21 * MADGWICK_BLOCK;
+  float *restrict s0 = Work + 22 * MADGWICK_BLOCK;
+  float *restrict s1 = Work + 23 * MADGWICK_BLOCK;
+  float *restrict s2 = Work + 24 * MADGWICK_BLOCK;
+  float *restrict s3 = Work + 25 * MADGWICK_BLOCK;
+  float hx, hy;
+  uint32_t c, l;
+
+  for(l = 0; l < MADGWICK_BLOCK; l++){
+    q0 = q[l];
+    q1 = q[st + l];
+    q2 = q[2 * st + l];
+    q3 = q[3 * st + l];
+    qd0[l] = (q1 * gx[l] + q2 * gy[l] + q3 * gz[l]) * -0.5f;
+    qd1[l] = (q0 * gx[l] + q2 * gz[l] - q3 * gy[l]) * 0.5f;
+    qd2[l] = (q0 * gy[l] - q1 * gz[l] + q3 * gx[l]) * 0.5f;
+    qd3[l] = (q0 * gz[l] + q1 * gy[l] - q2 * gx[l]) * 0.5f;
+    na[l] = ax0[l] * ax0[l] + ay0[l] * ay0[l] + az0[l] * az0[l];
+    km[l] = mx0[l] * mx0[l] + my0[l] * my0[l] + mz0[l] * mz0[l];
+  }
+  Kernels->InvSqrt(na, MADGWICK_BLOCK, it, ka);
+  Kernels->InvSqrt(km, MADGWICK_BLOCK, it, km);
+
+  for(l = 0; l < MADGWICK_BLOCK; l++){
+    q0 = q[l];
+    q1 = q[st + l];
+    q2 = q[2 * st + l];
+    q3 = q[3 * st + l];
+    ax[l] = ax0[l] * ka[l];
+    ay[l] = ay0[l] * ka[l];
+    az[l] = az0[l] * ka[l];
+    mx[l] = mx0[l] * km[l];
+    my[l] = my0[l] * km[l];
+    mz[l] = mz0[l] * km[l];
+    q0q1 = q0 * q1;
+    q0q2 = q0 * q2;
+    q0q3 = q0 * q3;
+    q1q1 = q1 * q1;
+    q1q2 = q1 * q2;
+    q1q3 = q1 * q3;
+    q2q2 = q2 * q2;
+    q2q3 = q2 * q3;
+    q3q3 = q3 * q3;
+    r00[l] = 0.5f - q2q2 - q3q3;
+    r01[l] = q1q2 - q0q3;
+    r02[l] = q1q3 + q0q2;
+    r10 = q1q2 + q0q3;
+    r11 = 0.5f - q1q1 - q3q3;
+    r12 = q2q3 - q0q1;
+    r20[l] = q1q3 - q0q2;
+    r21[l] = q2q3 + q0q1;
+    r22[l] = 0.5f - q1q1 - q2q2;
+    hx = r00[l] * mx[l] + r01[l] * my[l] + r02[l] * mz[l];
+    hy = r10 * mx[l] + r11 * my[l] + r12 * mz[l];
+    hz[l] = r20[l] * mx[l] + r21[l] * my[l] + r22[l] * mz[l];
+    t[l] = hx * hx + hy * hy;
+  }
+  Kernels->InvSqrt(t, MADGWICK_BLOCK, it, kt);
+
+  for(l = 0; l < MADGWICK_BLOCK; l++){
+    q0 = q[l];
+    q1 = q[st + l];
+    q2 = q[2 * st + l];
+    q3 = q[3 * st + l];
+    bx = t[l] * kt[l] * 2.0f;
+    bz = hz[l] * 2.0f;
+    fa0 = r20[l] * 2.0f - ax[l];
+    fa1 = r21[l] * 2.0f - ay[l];
+    fa2 = r22[l] * 2.0f - az[l];
+    fm0 = (bx * r00[l] + bz * r20[l]) * 2.0f - mx[l];
+    fm1 = (bx * r01[l] + bz * r21[l]) * 2.0f - my[l];
+    fm2 = (bx * r02[l] + bz * r22[l]) * 2.0f - mz[l];
+    s0[l] = q1 * fa1 - q2 * fa0 - bz * q2 * fm0 +
+        (bz * q1 - bx * q3) * fm1 + bx * q2 * fm2;
+    s1[l] = q3 * fa0 + q0 * fa1 - q1 * fa2 * 2.0f + bz * q3 * fm0 +
+        (bx * q2 + bz * q0) * fm1 + (bx * q3 - bz * q1 * 2.0f) * fm2;
+    s2[l] = q3 * fa1 - q0 * fa0 - q2 * fa2 * 2.0f -
+        (bx * q2 * 2.0f + bz * q0) * fm0 + (bx * q1 + bz * q3) * fm1 +
+        (bx * q0 - bz * q2 * 2.0f) * fm2;
+    s3[l] = q1 * fa0 + q2 * fa1 + (bz * q1 - bx * q3 * 2.0f) * fm0 +
+        (bz * q2 - bx * q0) * fm1 + bx * q1 * fm2;
+    kt[l] = s0[l] * s0[l] + s1[l] * s1[l] + s2[l] * s2[l] + s3[l] * s3[l];
+  }
+  Kernels->InvSqrt(kt, MADGWICK_BLOCK, it, kt);
+
+  /* s = qd - beta * s / |s| is stored whatever a, so that the choice is */
+  /*  between two values and not a multiply the compiler cannot hoist.   */
+  for(l = 0; l < MADGWICK_BLOCK; l++){
+    k = kt[l];
+    s0[l] = qd0[l] - Beta * (s0[l] * k);
+    qd0[l] = (na[l] > 0.0f) ? s0[l] : qd0[l];
+    s1[l] = qd1[l] - Beta * (s1[l] * k);
+    qd1[l] = (na[l] > 0.0f) ? s1[l] : qd1[l];
+    s2[l] = qd2[l] - Beta * (s2[l] * k);
+    qd2[l] = (na[l] > 0.0f) ? s2[l] : qd2[l];
+    s3[l] = qd3[l] - Beta * (s3[l] * k);
+    qd3[l] = (na[l] > 0.0f) ? s3[l] : qd3[l];
+  }
+
+  for(l = 0; l < MADGWICK_BLOCK; l++){
+    qd0[l] = q[l] + qd0[l] * Dt;
+    qd1[l] = q[st + l] + qd1[l] * Dt;
+    qd2[l] = q[2 * st + l] + qd2[l] * Dt;
+    qd3[l] = q[3 * st + l] + qd3[l] * Dt;
+    kt[l] = qd0[l] * qd0[l] + qd1[l] * qd1[l] + qd2[l] * qd2[l] +
+        qd3[l] * qd3[l];
+  }
+  Kernels->InvSqrt(kt, MADGWICK_BLOCK, MADGWICK_QUAT_ACCURACY, kt);
+
+  /* One component per loop: the rows of q may be closer than a block */
+  for(c = 0; c < 4; c++){
+    for(l = 0; l < MADGWICK_BLOCK; l++){
+      q[c * st + l] = qd0[c * MADGWICK_BLOCK + l] * kt[l];
+    }
+  }
+}
+
+
+/**
+ * @brief  Runs Madgwick_Block on the whole blocks of streams of
+ *         [Begin, End), the streams left over with Madgwick_Step.
+ */
+static MADGWICK_INLINE void Madgwick_BankRun(const VectorPlanes_t *Gyro,
+    const VectorPlanes_t *Accel, const VectorPlanes_t *Mag, uint32_t Begin,
+    uint32_t End, Madgwick_Bank_t *Bank)
+{
+  static const float zeros[MADGWICK_BLOCK];
+  float work[MADGWICK_PLANES * MADGWICK_BLOCK];
+  const MatrixSimd_t *kernels = MatrixSimd_Get();
+  /* Read once: the kernel calls could change them as far as the compiler */
+  /*  knows, and a stride reloaded in each block defeats vectorization.   */
+  const uint32_t st = Bank->NumStreams;
+  const int32_t it = (int32_t)Bank->Accuracy;
+  const float beta = Bank->Beta, dt = Bank->SamplePeriod;
+  float *quat = Bank->Quat;
+  uint32_t s = Begin;
+
+  for(; s + MADGWICK_BLOCK <= End; s += MADGWICK_BLOCK){
+    Madgwick_Block(quat + s, st, Gyro->X + s, Gyro->Y + s, Gyro->Z + s,
+        Accel->X + s, Accel->Y + s, Accel->Z + s,
+        (Mag != 0) ? Mag->X + s : zeros, (Mag != 0) ? Mag->Y + s : zeros,
+        (Mag != 0) ? Mag->Z + s : zeros, beta, dt, it, kernels, work);
+  }
+  Madgwick_PassScalar(Gyro, Accel, Mag, s, End, Bank);
+}
+
+
+SIMD_TARGET("sse2")
+static void Madgwick_PassSse2(const VectorPlanes_t *Gyro,
+    const VectorPlanes_t *Accel, const VectorPlanes_t *Mag, uint32_t Begin,
+    uint32_t End, Madgwick_Bank_t *Bank)
+{
+  Madgwick_BankRun(Gyro, Accel, Mag, Begin, End, Bank);
+}
+
+
+SIMD_TARGET("avx2")
+static void Madgwick_PassAvx2(const VectorPlanes_t *Gyro,
+    const VectorPlanes_t *Accel, const VectorPlanes_t *Mag, uint32_t Begin,
+    uint32_t End, Madgwick_Bank_t *Bank)
+{
+  Madgwick_BankRun(Gyro, Accel, Mag, Begin, End, Bank);
+}
+
+
+SIMD_TARGET("avx512f") MATRIX_SIMD_NO_CONTRACT
+static void Madgwick_PassAvx512(const VectorPlanes_t *Gyro,
+    const VectorPlanes_t *Accel, const VectorPlanes_t *Mag, uint32_t Begin,
+    uint32_t End, Madgwick_Bank_t *Bank)
+{
+  Madgwick_BankRun(Gyro, Accel, Mag, Begin, End, Bank);
+}
+
+#endif /* MADGWICK_SIMD_X86 */
+
+
+static const Madgwick_Pass_t passes[MATRIX_SIMD_NUMBER_OF_LEVELS] = {
+    [MATRIX_SIMD_SCALAR] = Madgwick_PassScalar,
+#ifdef MADGWICK_SIMD_X86
+    [MATRIX_SIMD_SSE2] = Madgwick_PassSse2,
+    [MATRIX_SIMD_AVX2] = Madgwick_PassAvx2,
+    [MATRIX_SIMD_AVX512] = Madgwick_PassAvx512,
+#endif
+};
+
+
+void Madgwick_Init(Madgwick_t *Filter)
+{
+  Filter->Quat[0] = 1.0f;
+  Filter->Quat[1] = 0.0f;
+  Filter->Quat[2] = 0.0f;
+  Filter->Quat[3] = 0.0f;
+  Filter->AngVel.x = 0.0f;
+  Filter->AngVel.y = 0.0f;
+  Filter->AngVel.z = 0.0f;
+}
+
+
+int32_t Madgwick_Update(const IMU_Data_t *Data, Madgwick_t *Filter,
+    AHRS_t *Ahrs)
+{
+  const float *q = Filter->Quat;
+  const Vector_t *a = &Data->LinAccel;
+  float r[9], cosTilt, invDt;
+  int32_t valid;
+
+  valid = Madgwick_Step(Filter->Quat, 1, Data->AngVel.x, Data->AngVel.y,
+      Data->AngVel.z, a->x, a->y, a->z, Data->MagField.x, Data->MagField.y,
+      Data->MagField.z, Filter->Beta, Filter->SamplePeriod,
+      Filter->Accuracy);
+
+  if(Ahrs != 0){
+    /* R(q), from the sensor to the earth frame */
+    r[0] = 1.0f - 2.0f * (q[2] * q[2] + q[3] * q[3]);
+    r[1] = 2.0f * (q[1] * q[2] - q[0] * q[3]);
+    r[2] = 2.0f * (q[1] * q[3] + q[0] * q[2]);
+    r[3] = 2.0f * (q[1] * q[2] + q[0] * q[3]);
+    r[4] = 1.0f - 2.0f * (q[1] * q[1] + q[3] * q[3]);
+    r[5] = 2.0f * (q[2] * q[3] - q[0] * q[1]);
+    r[6] = 2.0f * (q[1] * q[3] - q[0] * q[2]);
+    r[7] = 2.0f * (q[2] * q[3] + q[0] * q[1]);
+    r[8] = 1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]);
+
+    /* Roll, pitch and yaw (z-y-x) */
+    Ahrs->AngPos.x = atan2f(r[7], r[8]);
+    Ahrs->AngPos.y = asinf(fmaxf(-1.0f, fminf(1.0f, -r[6])));
+    Ahrs->AngPos.z = atan2f(r[3], r[0]);
+    cosTilt = fmaxf(-1.0f, fminf(1.0f, r[8]));
+    Ahrs->Tilt = acosf(cosTilt);
+
+    invDt = (Filter->SamplePeriod > 0.0f) ? 1.0f / Filter->SamplePeriod :
+        0.0f;
+    Ahrs->AngVel = Data->AngVel;
+    Ahrs->AngAccel.x = (Data->AngVel.x - Filter->AngVel.x) * invDt;
+    Ahrs->AngAccel.y = (Data->AngVel.y - Filter->AngVel.y) * invDt;
+    Ahrs->AngAccel.z = (Data->AngVel.z - Filter->AngVel.z) * invDt;
+
+    Ahrs->LinAccel.x = r[0] * a->x + r[1] * a->y + r[2] * a->z;
+    Ahrs->LinAccel.y = r[3] * a->x + r[4] * a->y + r[5] * a->z;
+    Ahrs->LinAccel.z = r[6] * a->x + r[7] * a->y + r[8] * a->z -
+        Filter->Gravity;
+  }
+  Filter->AngVel = Data->AngVel;
+
+  return valid;
+}
+
+
+void Madgwick_BankInit(Madgwick_Bank_t *Bank)
+{
+  uint32_t s;
+
+  for(s = 0; s < Bank->NumStreams; s++){
+    Bank->Quat[s] = 1.0f;
+    Bank->Quat[Bank->NumStreams + s] = 0.0f;
+    Bank->Quat[2 * Bank->NumStreams + s] = 0.0f;
+    Bank->Quat[3 * Bank->NumStreams + s] = 0.0f;
+  }
+}
+
+
+void Madgwick_BankUpdate(const VectorPlanes_t *Gyro,
+    const VectorPlanes_t *Accel, const VectorPlanes_t *Mag,
+    Madgwick_Bank_t *Bank)
+{
+  MATRIX_SIMD_SELECT(passes)(Gyro, Accel, Mag, 0, Bank->NumStreams,
+      Bank);
+}
+
+
+void Madgwick_BankLoad(uint32_t Index, const Madgwick_t *Filter,
+    Madgwick_Bank_t *Bank)
+{
+  uint32_t c;
+
+  for(c = 0; c < 4; c++){
+    Bank->Quat[c * Bank->NumStreams + Index] = Filter->Quat[c];
+  }
+}
+
+
+void Madgwick_BankStore(uint32_t Index, Madgwick_t *Filter,
+    const Madgwick_Bank_t *Bank)
+{
+  uint32_t c;
+
+  for(c = 0; c < 4; c++){
+    Filter->Quat[c] = Bank->Quat[c * Bank->NumStreams + Index];
+  }
+}
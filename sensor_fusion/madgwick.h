@@ -0,0 +1,180 @@
+/**
+ * @file  madgwick.h
+ * @date  18-October-2026
+ * @brief Attitude and heading estimation (AHRS) with Madgwick's filter.
+ *
+ *   The attitude is a unit quaternion integrated from the gyroscope and
+ *   pulled, by one gradient descent step per sample, towards the attitude
+ *   at which gravity and the earth magnetic field would be measured as the
+ *   accelerometer and the magnetometer do (S. Madgwick, "An efficient
+ *   orientation filter for inertial and inertial/magnetic sensor arrays",
+ *   2010). Every normalization (accelerometer, magnetometer, gradient and
+ *   quaternion) uses the inverse square roots of fast_math.h, so a sample
+ *   issues no square root or divide instruction.
+ *
+ *   Madgwick_Update runs the filter on one stream in real time and fills an
+ *   AHRS_t. Madgwick_BankUpdate runs it on many streams at once, e.g. to
+ *   replay recorded logs: the state is kept in structure-of-arrays form and
+ *   the streams are updated in blocks with SIMD instructions, the inverse
+ *   square roots by the InvSqrt kernel of matrix_simd.h. A stream of the
+ *   bank gives the same quaternions as Madgwick_Update, bit for bit (see
+ *   matrix_simd.h).
+ *
+ *   The SSE2, AVX2 or AVX-512 pass is selected at runtime with the level
+ *   of matrix_simd.h. When it is scalar, or MADGWICK_SIMD_DISABLE is
+ *   defined, a portable loop is used.
+ *
+ *   Frames: the earth frame has x towards the magnetic north (horizontal)
+ *   and z up, so a sensor lying flat and at rest measures +1 g on z.
+ *
+ * @author
+ * @author
+ */
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MADGWICK_H
+#define MADGWICK_H
+
+
+#define MADGWICK_VER_MAJOR                                                  2026
+#define MADGWICK_VER_MINOR                                                    10
+#define MADGWICK_VER_PATCH                                                     1
+#define MADGWICK_BRANCH_MASTER
+
+
+#include <stdint.h>
+#include "custom_types.h"
+#include "fast_math.h"
+#include "vector3.h"
+#include "matrix_simd.h"
+
+
+#if !defined(MADGWICK_SIMD_DISABLE) && defined(MATRIX_SIMD_X86)
+#define MADGWICK_SIMD_X86
+#endif
+
+
+/**
+ * @brief Structure used to operate the filter on one stream.
+ */
+typedef struct
+{
+  float Quat[4];        /*!< Attitude {w, x, y, z}, rotating sensor frame
+                             vectors into the earth frame */
+  Vector_t AngVel;      /*!< Angular velocity of the last sample */
+  float Beta;           /*!< Gradient step, in rad/s. About sqrt(3/4)
+                             times the gyroscope noise, e.g. 0.04 */
+  float SamplePeriod;   /*!< Time between samples, in seconds */
+  float Gravity;        /*!< Norm of gravity in accelerometer units (e.g.
+                             1 or 9.80665), removed from AHRS_t.LinAccel */
+  FastMath_Accuracy_t Accuracy; /*!< Newton steps of the sensor and
+                                     gradient normalizations. The
+                                     quaternion always takes three */
+}Madgwick_t;
+
+
+/**
+ * @brief Structure used to operate the filter on many streams.
+ * @note  Quat is allocated by the user, component c of stream s at
+ *        [c * NumStreams + s]. Every stream shares the parameters.
+ */
+typedef struct
+{
+  float *Quat;          /*!< 4 * NumStreams, as Madgwick_t.Quat */
+  float Beta;           /*!< As Madgwick_t.Beta */
+  float SamplePeriod;   /*!< As Madgwick_t.SamplePeriod */
+  FastMath_Accuracy_t Accuracy; /*!< As Madgwick_t.Accuracy */
+  uint32_t NumStreams;  /*!< Number of streams in the bank */
+}Madgwick_Bank_t;
+
+
+/**
+ * @brief  Sets the attitude to the identity (sensor frame = earth frame).
+ * @param  Filter : Handle with all needed variables.
+ * @retval void
+ * @note   Beta, SamplePeriod, Gravity and Accuracy are not changed. The
+ *         filter converges from any attitude; a larger Beta for the first
+ *         samples makes it faster.
+ */
+void Madgwick_Init(Madgwick_t *Filter);
+
+
+/**
+ * @brief  Updates the attitude with a new sample.
+ * @param  Data : Sample. AngVel in rad/s, LinAccel and MagField in any
+ *                units. A MagField of zeros gives the inertial (IMU only)
+ *                filter, without heading reference.
+ * @param  Filter : Handle with all needed variables.
+ * @param  Ahrs : Receives the estimate, NULL to skip it. AngPos holds roll
+ *                (x), pitch (y) and yaw (z) in rad, AngVel and AngAccel
+ *                the sensor rates, LinAccel the acceleration in the earth
+ *                frame without gravity and Tilt the angle between the
+ *                sensor z axis and the vertical. LinPos and LinVel are not
+ *                estimated and are left unchanged.
+ * @retval int32_t
+ * @note   The function returns 1 on success, 0 if LinAccel was zero (the
+ *         gyroscope alone was integrated).
+ */
+int32_t Madgwick_Update(const IMU_Data_t *Data, Madgwick_t *Filter,
+    AHRS_t *Ahrs);
+
+
+/**
+ * @brief  Sets the attitude of every stream to the identity.
+ * @param  Bank : Handle with all needed variables.
+ * @retval void
+ */
+void Madgwick_BankInit(Madgwick_Bank_t *Bank);
+
+
+/**
+ * @brief  Updates every stream with its next sample.
+ * @param  Gyro : Angular velocities, in rad/s, one per stream.
+ * @param  Accel : Accelerations, one per stream.
+ * @param  Mag : Magnetic fields, one per stream, NULL for the inertial
+ *               filter on every stream.
+ * @param  Bank : Handle with all needed variables.
+ * @retval void
+ * @note   Samples are given as planes of NumStreams vectors (see
+ *         vector3.h); a time step of Vector_t samples is converted with
+ *         Vector3_ToPlanes. A stream whose acceleration is zero only
+ *         integrates its gyroscope, as in Madgwick_Update.
+ */
+void Madgwick_BankUpdate(const VectorPlanes_t *Gyro,
+    const VectorPlanes_t *Accel, const VectorPlanes_t *Mag,
+    Madgwick_Bank_t *Bank);
+
+
+/**
+ * @brief  Copies the attitude of a single filter into the bank.
+ * @param  Index : Position of the stream in the bank.
+ * @param  Filter : Filter to copy.
+ * @param  Bank : Handle with all needed variables.
+ * @retval void
+ */
+void Madgwick_BankLoad(uint32_t Index, const Madgwick_t *Filter,
+    Madgwick_Bank_t *Bank);
+
+
+/**
+ * @brief  Copies the attitude of a stream of the bank to a single filter,
+ *         e.g. to go on with it in real time.
+ * @param  Index : Position of the stream in the bank.
+ * @param  Filter : Filter to update.
+ * @param  Bank : Handle with all needed variables.
+ * @retval void
+ */
+void Madgwick_BankStore(uint32_t Index, Madgwick_t *Filter,
+    const Madgwick_Bank_t *Bank);
+
+#endif /* MADGWICK_H */
+
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,201 @@
+/**
+ * @file  arena.h
+ * @date  18-October-2026
+ * @brief Bump (arena) allocator handing out cache line aligned blocks.
+ *
+ * @author
+ * @author
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+/***** FIRMWARE VERSION ***************************************************** */
+#define COMMON_ARENA_VER_MAJOR                                              2026
+#define COMMON_ARENA_VER_MINOR                                                10
+#define COMMON_ARENA_VER_PATCH                                                 1
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stdstatus.h"
+
+
+/* An arena is one block of memory from which many buffers are carved in    */
+/*  order, e.g. every buffer of tens of thousands of filters created at     */
+/*  startup. Carving is a pointer increment and the whole arena is released */
+/*  at once, so there is one allocation and one free instead of several per */
+/*  filter. Every block starts on a cache line and its size is rounded up  */
+/*  to whole lines, so aligned SIMD loads can be used on it and two blocks  */
+/*  never share a line (no false sharing between threads).                  */
+
+
+/**
+ * @brief Alignment, in bytes, of every block given by the arena.
+ */
+#ifndef ARENA_ALIGN
+#define ARENA_ALIGN                                                           64
+#endif
+
+
+/**
+ * @brief Rounds SIZE up to a multiple of ARENA_ALIGN.
+ */
+#define ARENA_ALIGN_UP(SIZE) \
+    (((size_t)(SIZE) + (ARENA_ALIGN - 1)) & ~(size_t)(ARENA_ALIGN - 1))
+
+
+/**
+ * @brief Structure used to operate an arena.
+ */
+typedef struct
+{
+  uint8_t *Base;    /*!< First aligned byte */
+  size_t Size;      /*!< Bytes available from Base */
+  size_t Used;      /*!< Bytes already handed out */
+  void *Allocation; /*!< Pointer given by malloc, NULL for user memory */
+}Arena_t;
+
+
+/**
+ * @brief  Sets up an arena over memory provided by the caller.
+ * @param  Arena : Arena to set up.
+ * @param  Buffer : Memory used by the arena, of any alignment.
+ * @param  Size : Bytes in Buffer.
+ * @retval EStatus_t
+ * @note   Returns ERR_NULL_POINTER if Buffer is NULL, ERR_BUFFER_SIZE if
+ *         it can not hold a single aligned line.
+ */
+static inline EStatus_t Arena_Init(Arena_t *Arena, void *Buffer, size_t Size)
+{
+  uintptr_t start = (uintptr_t)Buffer;
+  uintptr_t aligned = (start + (ARENA_ALIGN - 1)) &
+      ~(uintptr_t)(ARENA_ALIGN - 1);
+
+  Arena->Base = NULL;
+  Arena->Size = 0;
+  Arena->Used = 0;
+  Arena->Allocation = NULL;
+  if(Buffer == NULL){
+    return ERR_NULL_POINTER;
+  }
+  if(Size < (aligned - start) + ARENA_ALIGN){
+    return ERR_BUFFER_SIZE;
+  }
+  Arena->Base = (uint8_t *)aligned;
+  Arena->Size = (Size - (aligned - start)) & ~(size_t)(ARENA_ALIGN - 1);
+  return ANSWERED_REQUEST;
+}
+
+
+/**
+ * @brief  Allocates an arena of at least Size usable bytes.
+ * @param  Arena : Arena to set up.
+ * @param  Size : Bytes needed, e.g. the sum of the workspace sizes of the
+ *                filters that will be carved from it.
+ * @retval EStatus_t
+ * @note   One malloc call, released by Arena_Destroy. Returns
+ *         ERR_RESOURCE_DEPLETED if the memory could not be allocated.
+ */
+static inline EStatus_t Arena_Create(Arena_t *Arena, size_t Size)
+{
+  size_t total = ARENA_ALIGN_UP(Size) + ARENA_ALIGN;
+  void *mem = malloc(total);
+
+  if(mem == NULL){
+    Arena->Base = NULL;
+    Arena->Size = 0;
+    Arena->Used = 0;
+    Arena->Allocation = NULL;
+    return ERR_RESOURCE_DEPLETED;
+  }
+  Arena_Init(Arena, mem, total);
+  Arena->Allocation = mem;
+  return ANSWERED_REQUEST;
+}
+
+
+/**
+ * @brief  Sets up an arena over a workspace whose layout is known to its
+ *         owner, e.g. one sized by the X_WorkspaceSize query of a filter,
+ *         and clears it.
+ * @param  Arena : Arena to set up.
+ * @param  Workspace : ARENA_ALIGN aligned memory.
+ * @param  Size : Bytes in Workspace.
+ * @retval EStatus_t
+ * @note   Unlike Arena_Init, the start is never moved, so blocks carved in
+ *         the order of the size query fill the workspace exactly. Returns
+ *         ERR_NULL_POINTER if Workspace is NULL, ERR_PARAM_VALUE if it is
+ *         not aligned.
+ */
+static inline EStatus_t Arena_InitWorkspace(Arena_t *Arena, void *Workspace,
+    size_t Size)
+{
+  Arena->Base = NULL;
+  Arena->Size = 0;
+  Arena->Used = 0;
+  Arena->Allocation = NULL;
+  if(Workspace == NULL){
+    return ERR_NULL_POINTER;
+  }
+  if(((uintptr_t)Workspace & (ARENA_ALIGN - 1)) != 0){
+    return ERR_PARAM_VALUE;
+  }
+  memset(Workspace, 0, Size);
+  Arena->Base = (uint8_t *)Workspace;
+  Arena->Size = Size;
+  return ANSWERED_REQUEST;
+}
+
+
+/**
+ * @brief  Releases the memory of an arena made by Arena_Create. Every
+ *         block carved from it becomes invalid.
+ * @param  Arena : Arena to release.
+ * @retval void
+ */
+static inline void Arena_Destroy(Arena_t *Arena)
+{
+  free(Arena->Allocation);
+  Arena->Base = NULL;
+  Arena->Size = 0;
+  Arena->Used = 0;
+  Arena->Allocation = NULL;
+}
+
+
+/**
+ * @brief  Carves a block from the arena.
+ * @param  Arena : Arena to carve from.
+ * @param  Size : Bytes needed, rounded up to whole lines.
+ * @retval void * : ARENA_ALIGN aligned block, NULL if the arena is full.
+ * @note   The block is not cleared.
+ */
+static inline void *Arena_Alloc(Arena_t *Arena, size_t Size)
+{
+  size_t bytes = ARENA_ALIGN_UP(Size);
+  void *block;
+
+  if(Arena->Base == NULL || bytes > Arena->Size - Arena->Used){
+    return NULL;
+  }
+  block = Arena->Base + Arena->Used;
+  Arena->Used += bytes;
+  return block;
+}
+
+
+/**
+ * @brief  Returns every block to the arena, keeping its memory.
+ * @param  Arena : Arena to reset.
+ * @retval void
+ */
+static inline void Arena_Reset(Arena_t *Arena)
+{
+  Arena->Used = 0;
+}
+
+
+#endif /* ARENA_H */
@@ -0,0 +1,556 @@
+/**
+ * @file  ring_buffer.h
+ * @date  18-October-2026
+ * @brief Lock-free ring buffers of fixed-size records (C11 atomics).
+ *
+ * @author
+ * @author
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+/***** FIRMWARE VERSION ***************************************************** */
+#define COMMON_RING_BUFFER_VER_MAJOR                                        2026
+#define COMMON_RING_BUFFER_VER_MINOR                                          10
+#define COMMON_RING_BUFFER_VER_PATCH                                           1
+
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "stdstatus.h"
+
+
+/* Records (an IMU_Data_t, a regressor and its output...) are copied into */
+/*  a power of two number of slots and taken out in order, without locks: */
+/*  a producer never waits for the consumer or the other way round. A     */
+/*  full ring is reported as ERR_OVERFLOW and an empty one as             */
+/*  OPERATION_IDLE, and the caller decides whether to drop, retry or      */
+/*  sleep.                                                                */
+/*                                                                        */
+/* RingSPSC_t has one producer thread and one consumer thread. Each side  */
+/*  owns a position in a cache line of its own and keeps a copy of the    */
+/*  other side's, reloaded only when the ring looks full (or empty), so   */
+/*  a push or a pop touches no line written by the other thread.          */
+/*                                                                        */
+/* RingMPSC_t has any number of producer threads and one consumer (D.     */
+/*  Vyukov's bounded queue). Producers claim slots with a compare and     */
+/*  swap, then publish each slot through its sequence number; a slot      */
+/*  claimed but not yet published holds back the records behind it.       */
+/*                                                                        */
+/* Batches are pushed whole or not at all. Peek gives the consumer the    */
+/*  records in place, up to the end of the slots, so it can e.g. run      */
+/*  RLS_Compute on them before Release hands the slots back.              */
+/*                                                                        */
+/* The handles are RING_BUFFER_ALIGN aligned: declare them statically or  */
+/*  allocate them with aligned_alloc or an Arena_t.                       */
+
+
+/**
+ * @brief Cache line size, in bytes, separating the positions of the
+ *        producers and of the consumer.
+ */
+#ifndef RING_BUFFER_ALIGN
+#define RING_BUFFER_ALIGN                                                     64
+#endif
+
+
+/**
+ * @brief Bytes of the buffer given to RingMPSC_Init: the sequence numbers,
+ *        then the records from a multiple of RING_BUFFER_ALIGN.
+ */
+#define RING_MPSC_BUFFER_SIZE(RecordSize, Capacity) \
+    ((((size_t)(Capacity) * sizeof(atomic_size_t) + RING_BUFFER_ALIGN - 1) & \
+    ~(size_t)(RING_BUFFER_ALIGN - 1)) + (size_t)(Capacity) * (RecordSize))
+
+
+/**
+ * @brief Structure used to operate a single-producer, single-consumer
+ *        ring.
+ */
+typedef struct
+{
+  _Alignas(RING_BUFFER_ALIGN) atomic_size_t Head; /*!< Records pushed */
+  size_t CachedTail;    /*!< Producer's copy of Tail */
+  _Alignas(RING_BUFFER_ALIGN) atomic_size_t Tail; /*!< Records popped */
+  size_t CachedHead;    /*!< Consumer's copy of Head */
+  _Alignas(RING_BUFFER_ALIGN) uint8_t *Data; /*!< Capacity records */
+  size_t RecordSize;    /*!< Bytes per record */
+  size_t Capacity;      /*!< Number of slots, a power of two */
+}RingSPSC_t;
+
+
+/**
+ * @brief Structure used to operate a multiple-producer, single-consumer
+ *        ring.
+ */
+typedef struct
+{
+  _Alignas(RING_BUFFER_ALIGN) atomic_size_t EnqueuePos; /*!< Slots claimed */
+  _Alignas(RING_BUFFER_ALIGN) size_t DequeuePos; /*!< Records popped */
+  _Alignas(RING_BUFFER_ALIGN) atomic_size_t *Seq; /*!< Sequence number of
+                                                       each slot */
+  uint8_t *Data;        /*!< Capacity records */
+  size_t RecordSize;    /*!< Bytes per record */
+  size_t Capacity;      /*!< Number of slots, a power of two >= 2 */
+}RingMPSC_t;
+
+
+/**
+ * @brief  Copies Count records from Records to the slots from Pos on,
+ *         wrapping around the end of the slots.
+ */
+static inline void Ring_CopyIn(uint8_t *Data, size_t RecordSize,
+    size_t Capacity, size_t Pos, const void *Records, size_t Count)
+{
+  size_t index = Pos & (Capacity - 1);
+  size_t first = (Count < Capacity - index) ? Count : Capacity - index;
+
+  memcpy(Data + index * RecordSize, Records, first * RecordSize);
+  memcpy(Data, (const uint8_t *)Records + first * RecordSize,
+      (Count - first) * RecordSize);
+}
+
+
+/**
+ * @brief  Copies Count records from the slots from Pos on to Records,
+ *         wrapping around the end of the slots.
+ */
+static inline void Ring_CopyOut(const uint8_t *Data, size_t RecordSize,
+    size_t Capacity, size_t Pos, void *Records, size_t Count)
+{
+  size_t index = Pos & (Capacity - 1);
+  size_t first = (Count < Capacity - index) ? Count : Capacity - index;
+
+  memcpy(Records, Data + index * RecordSize, first * RecordSize);
+  memcpy((uint8_t *)Records + first * RecordSize, Data,
+      (Count - first) * RecordSize);
+}
+
+
+/**
+ * @brief  Sets up an empty single-producer, single-consumer ring.
+ * @param  Ring : Ring to set up, before any thread uses it.
+ * @param  Buffer : Capacity * RecordSize bytes for the records.
+ * @param  RecordSize : Bytes per record, e.g. sizeof(IMU_Data_t).
+ * @param  Capacity : Number of slots, a power of two.
+ * @retval EStatus_t
+ * @note   Returns ERR_NULL_POINTER if Buffer is NULL, ERR_PARAM_VALUE if
+ *         RecordSize is zero or Capacity is not a power of two.
+ */
+static inline EStatus_t RingSPSC_Init(RingSPSC_t *Ring, void *Buffer,
+    size_t RecordSize, size_t Capacity)
+{
+  if(Buffer == NULL){
+    return ERR_NULL_POINTER;
+  }
+  if(RecordSize == 0 || Capacity == 0 || (Capacity & (Capacity - 1)) != 0){
+    return ERR_PARAM_VALUE;
+  }
+  atomic_init(&Ring->Head, 0);
+  atomic_init(&Ring->Tail, 0);
+  Ring->CachedTail = 0;
+  Ring->CachedHead = 0;
+  Ring->Data = Buffer;
+  Ring->RecordSize = RecordSize;
+  Ring->Capacity = Capacity;
+  return ANSWERED_REQUEST;
+}
+
+
+/**
+ * @brief  Returns the number of free slots seen by the producer, reloading
+ *         the consumer's position if fewer than Needed look free.
+ */
+static inline size_t RingSPSC_Free(RingSPSC_t *Ring, size_t Head,
+    size_t Needed)
+{
+  size_t free = Ring->Capacity - (Head - Ring->CachedTail);
+
+  if(free < Needed){
+    Ring->CachedTail = atomic_load_explicit(&Ring->Tail,
+        memory_order_acquire);
+    free = Ring->Capacity - (Head - Ring->CachedTail);
+  }
+  return free;
+}
+
+
+/**
+ * @brief  Returns the number of records seen by the consumer, reloading
+ *         the producer's position if fewer than Needed look ready.
+ */
+static inline size_t RingSPSC_Ready(RingSPSC_t *Ring, size_t Tail,
+    size_t Needed)
+{
+  size_t ready = Ring->CachedHead - Tail;
+
+  if(ready < Needed){
+    Ring->CachedHead = atomic_load_explicit(&Ring->Head,
+        memory_order_acquire);
+    ready = Ring->CachedHead - Tail;
+  }
+  return ready;
+}
+
+
+/**
+ * @brief  Pushes Count records, from the producer thread.
+ * @param  Ring : Ring to push to.
+ * @param  Records : Count records of RecordSize bytes, one after the
+ *                   other.
+ * @param  Count : Number of records.
+ * @retval EStatus_t
+ * @note   Returns ERR_OVERFLOW, pushing nothing, if fewer than Count
+ *         slots are free.
+ */
+static inline EStatus_t RingSPSC_PushBatch(RingSPSC_t *Ring,
+    const void *Records, size_t Count)
+{
+  size_t head = atomic_load_explicit(&Ring->Head, memory_order_relaxed);
+
+  if(RingSPSC_Free(Ring, head, Count) < Count){
+    return ERR_OVERFLOW;
+  }
+  Ring_CopyIn(Ring->Data, Ring->RecordSize, Ring->Capacity, head, Records,
+      Count);
+  atomic_store_explicit(&Ring->Head, head + Count, memory_order_release);
+  return ANSWERED_REQUEST;
+}
+
+
+/**
+ * @brief  Pushes one record, from the producer thread.
+ * @param  Ring : Ring to push to.
+ * @param  Record : RecordSize bytes.
+ * @retval EStatus_t
+ * @note   Returns ERR_OVERFLOW if the ring is full.
+ */
+static inline EStatus_t RingSPSC_Push(RingSPSC_t *Ring, const void *Record)
+{
+  return RingSPSC_PushBatch(Ring, Record, 1);
+}
+
+
+/**
+ * @brief  Gives the producer the free slots to fill in place.
+ * @param  Ring : Ring to push to.
+ * @param  Slots : Receives the first free slot.
+ * @param  Count : Receives the number of free slots from *Slots on, up to
+ *                 the end of the slots.
+ * @retval EStatus_t
+ * @note   Returns ERR_OVERFLOW if the ring is full. Filled slots are
+ *         pushed by RingSPSC_Commit.
+ */
+static inline EStatus_t RingSPSC_Reserve(RingSPSC_t *Ring, void **Slots,
+    size_t *Count)
+{
+  size_t head = atomic_load_explicit(&Ring->Head, memory_order_relaxed);
+  size_t index = head & (Ring->Capacity - 1);
+  size_t free = RingSPSC_Free(Ring, head, Ring->Capacity - index);
+
+  *Slots = Ring->Data + index * Ring->RecordSize;
+  *Count = (free < Ring->Capacity - index) ? free : Ring->Capacity - index;
+  return (*Count != 0) ? ANSWERED_REQUEST : ERR_OVERFLOW;
+}
+
+
+/**
+ * @brief  Pushes the first Count slots given by RingSPSC_Reserve.
+ * @param  Ring : Ring to push to.
+ * @param  Count : Slots filled, up to the Count given by RingSPSC_Reserve.
+ * @retval void
+ */
+static inline void RingSPSC_Commit(RingSPSC_t *Ring, size_t Count)
+{
+  size_t head = atomic_load_explicit(&Ring->Head, memory_order_relaxed);
+
+  atomic_store_explicit(&Ring->Head, head + Count, memory_order_release);
+}
+
+
+/**
+ * @brief  Pops up to MaxCount records, from the consumer thread.
+ * @param  Ring : Ring to pop from.
+ * @param  Records : Room for MaxCount records.
+ * @param  MaxCount : Most records to pop.
+ * @param  Count : Receives the number of records popped, may be NULL.
+ * @retval EStatus_t
+ * @note   Returns OPERATION_IDLE if the ring is empty.
+ */
+static inline EStatus_t RingSPSC_PopBatch(RingSPSC_t *Ring, void *Records,
+    size_t MaxCount, size_t *Count)
+{
+  size_t tail = atomic_load_explicit(&Ring->Tail, memory_order_relaxed);
+  size_t ready = RingSPSC_Ready(Ring, tail, MaxCount);
+
+  ready = (ready < MaxCount) ? ready : MaxCount;
+  if(Count != NULL){
+    *Count = ready;
+  }
+  if(ready == 0){
+    return OPERATION_IDLE;
+  }
+  Ring_CopyOut(Ring->Data, Ring->RecordSize, Ring->Capacity, tail, Records,
+      ready);
+  atomic_store_explicit(&Ring->Tail, tail + ready, memory_order_release);
+  return ANSWERED_REQUEST;
+}
+
+
+/**
+ * @brief  Pops one record, from the consumer thread.
+ * @param  Ring : Ring to pop from.
+ * @param  Record : Room for RecordSize bytes.
+ * @retval EStatus_t
+ * @note   Returns OPERATION_IDLE if the ring is empty.
+ */
+static inline EStatus_t RingSPSC_Pop(RingSPSC_t *Ring, void *Record)
+{
+  return RingSPSC_PopBatch(Ring, Record, 1, NULL);
+}
+
+
+/**
+ * @brief  Gives the consumer the records in place, without copying them.
+ * @param  Ring : Ring to read.
+ * @param  Records : Receives the oldest record.
+ * @param  Count : Receives the number of records from *Records on, up to
+ *                 the end of the slots.
+ * @retval EStatus_t
+ * @note   Returns OPERATION_IDLE if the ring is empty. The records stay
+ *         in the ring until RingSPSC_Release.
+ */
+static inline EStatus_t RingSPSC_Peek(RingSPSC_t *Ring, void **Records,
+    size_t *Count)
+{
+  size_t tail = atomic_load_explicit(&Ring->Tail, memory_order_relaxed);
+  size_t index = tail & (Ring->Capacity - 1);
+  size_t ready = RingSPSC_Ready(Ring, tail, Ring->Capacity - index);
+
+  *Records = Ring->Data + index * Ring->RecordSize;
+  *Count = (ready < Ring->Capacity - index) ? ready : Ring->Capacity - index;
+  return (*Count != 0) ? ANSWERED_REQUEST : OPERATION_IDLE;
+}
+
+
+/**
+ * @brief  Pops the first Count records given by RingSPSC_Peek.
+ * @param  Ring : Ring to pop from.
+ * @param  Count : Records consumed, up to the Count given by
+ *                 RingSPSC_Peek.
+ * @retval void
+ */
+static inline void RingSPSC_Release(RingSPSC_t *Ring, size_t Count)
+{
+  size_t tail = atomic_load_explicit(&Ring->Tail, memory_order_relaxed);
+
+  atomic_store_explicit(&Ring->Tail, tail + Count, memory_order_release);
+}
+
+
+/**
+ * @brief  Sets up an empty multiple-producer, single-consumer ring.
+ * @param  Ring : Ring to set up, before any thread uses it.
+ * @param  Buffer : RING_MPSC_BUFFER_SIZE(RecordSize, Capacity) bytes,
+ *                  aligned for a size_t (RING_BUFFER_ALIGN preferably).
+ * @param  RecordSize : Bytes per record, e.g. sizeof(IMU_Data_t).
+ * @param  Capacity : Number of slots, a power of two, at least 2.
+ * @retval EStatus_t
+ * @note   Returns ERR_NULL_POINTER if Buffer is NULL, ERR_PARAM_VALUE if
+ *         RecordSize is zero, Capacity is not a power of two or is 1, or
+ *         Buffer is not aligned. With one slot, a published slot (sequence
+ *         pos + 1) would look free for the next lap (pos + Capacity).
+ */
+static inline EStatus_t RingMPSC_Init(RingMPSC_t *Ring, void *Buffer,
+    size_t RecordSize, size_t Capacity)
+{
+  size_t i;
+
+  if(Buffer == NULL){
+    return ERR_NULL_POINTER;
+  }
+  if(RecordSize == 0 || Capacity < 2 || (Capacity & (Capacity - 1)) != 0 ||
+      ((uintptr_t)Buffer & (_Alignof(atomic_size_t) - 1)) != 0){
+    return ERR_PARAM_VALUE;
+  }
+  Ring->Seq = Buffer;
+  Ring->Data = (uint8_t *)Buffer + RING_MPSC_BUFFER_SIZE(RecordSize,
+      Capacity) - Capacity * RecordSize;
+  for(i = 0; i < Capacity; i++){
+    atomic_init(&Ring->Seq[i], i);
+  }
+  atomic_init(&Ring->EnqueuePos, 0);
+  Ring->DequeuePos = 0;
+  Ring->RecordSize = RecordSize;
+  Ring->Capacity = Capacity;
+  return ANSWERED_REQUEST;
+}
+
+
+/**
+ * @brief  Pushes Count records, from any producer thread.
+ * @param  Ring : Ring to push to.
+ * @param  Records : Count records of RecordSize bytes, one after the
+ *                   other.
+ * @param  Count : Number of records, taking consecutive slots.
+ * @retval EStatus_t
+ * @note   Returns ERR_OVERFLOW, pushing nothing, if fewer than Count
+ *         slots are free.
+ */
+static inline EStatus_t RingMPSC_PushBatch(RingMPSC_t *Ring,
+    const void *Records, size_t Count)
+{
+  size_t mask = Ring->Capacity - 1;
+  size_t pos = atomic_load_explicit(&Ring->EnqueuePos, memory_order_relaxed);
+  size_t last, seq, i;
+  intptr_t dif;
+
+  if(Count == 0){
+    return ANSWERED_REQUEST;
+  }
+  if(Count > Ring->Capacity){
+    return ERR_OVERFLOW;
+  }
+  /* The consumer frees slots in order, so if the last slot of the batch */
+  /*  is free for this lap, the ones before it are too                   */
+  for(;;){
+    last = pos + Count - 1;
+    seq = atomic_load_explicit(&Ring->Seq[last & mask],
+        memory_order_acquire);
+    dif = (intptr_t)(seq - last);
+    if(dif == 0){
+      if(atomic_compare_exchange_weak_explicit(&Ring->EnqueuePos, &pos,
+          pos + Count, memory_order_relaxed, memory_order_relaxed)){
+        break;
+      }
+    }else if(dif < 0){
+      return ERR_OVERFLOW;
+    }else{
+      pos = atomic_load_explicit(&Ring->EnqueuePos, memory_order_relaxed);
+    }
+  }
+  Ring_CopyIn(Ring->Data, Ring->RecordSize, Ring->Capacity, pos, Records,
+      Count);
+  for(i = 0; i < Count; i++){
+    atomic_store_explicit(&Ring->Seq[(pos + i) & mask], pos + i + 1,
+        memory_order_release);
+  }
+  return ANSWERED_REQUEST;
+}
+
+
+/**
+ * @brief  Pushes one record, from any producer thread.
+ * @param  Ring : Ring to push to.
+ * @param  Record : RecordSize bytes.
+ * @retval EStatus_t
+ * @note   Returns ERR_OVERFLOW if the ring is full.
+ */
+static inline EStatus_t RingMPSC_Push(RingMPSC_t *Ring, const void *Record)
+{
+  return RingMPSC_PushBatch(Ring, Record, 1);
+}
+
+
+/**
+ * @brief  Gives the consumer the published records in place, without
+ *         copying them.
+ * @param  Ring : Ring to read.
+ * @param  Records : Receives the oldest record.
+ * @param  Count : Receives the number of published records from *Records
+ *                 on, up to the end of the slots.
+ * @retval EStatus_t
+ * @note   Returns OPERATION_IDLE if the oldest record is not published
+ *         yet. The records stay in the ring until RingMPSC_Release.
+ */
+static inline EStatus_t RingMPSC_Peek(RingMPSC_t *Ring, void **Records,
+    size_t *Count)
+{
+  size_t pos = Ring->DequeuePos;
+  size_t index = pos & (Ring->Capacity - 1);
+  size_t n = 0;
+
+  while(index + n < Ring->Capacity &&
+      atomic_load_explicit(&Ring->Seq[index + n], memory_order_acquire) ==
+      pos + n + 1){
+    n++;
+  }
+  *Records = Ring->Data + index * Ring->RecordSize;
+  *Count = n;
+  return (n != 0) ? ANSWERED_REQUEST : OPERATION_IDLE;
+}
+
+
+/**
+ * @brief  Pops the first Count records given by RingMPSC_Peek.
+ * @param  Ring : Ring to pop from.
+ * @param  Count : Records consumed, up to the Count given by
+ *                 RingMPSC_Peek.
+ * @retval void
+ */
+static inline void RingMPSC_Release(RingMPSC_t *Ring, size_t Count)
+{
+  size_t mask = Ring->Capacity - 1;
+  size_t pos = Ring->DequeuePos;
+  size_t i;
+
+  for(i = 0; i < Count; i++){
+    atomic_store_explicit(&Ring->Seq[(pos + i) & mask],
+        pos + i + Ring->Capacity, memory_order_release);
+  }
+  Ring->DequeuePos = pos + Count;
+}
+
+
+/**
+ * @brief  Pops up to MaxCount published records, from the consumer thread.
+ * @param  Ring : Ring to pop from.
+ * @param  Records : Room for MaxCount records.
+ * @param  MaxCount : Most records to pop.
+ * @param  Count : Receives the number of records popped, may be NULL.
+ * @retval EStatus_t
+ * @note   Returns OPERATION_IDLE if the oldest record is not published
+ *         yet.
+ */
+static inline EStatus_t RingMPSC_PopBatch(RingMPSC_t *Ring, void *Records,
+    size_t MaxCount, size_t *Count)
+{
+  size_t mask = Ring->Capacity - 1;
+  size_t pos = Ring->DequeuePos;
+  size_t n = 0;
+
+  while(n < MaxCount && atomic_load_explicit(&Ring->Seq[(pos + n) & mask],
+      memory_order_acquire) == pos + n + 1){
+    n++;
+  }
+  if(Count != NULL){
+    *Count = n;
+  }
+  if(n == 0){
+    return OPERATION_IDLE;
+  }
+  Ring_CopyOut(Ring->Data, Ring->RecordSize, Ring->Capacity, pos, Records,
+      n);
+  RingMPSC_Release(Ring, n);
+  return ANSWERED_REQUEST;
+}
+
+
+/**
+ * @brief  Pops one published record, from the consumer thread.
+ * @param  Ring : Ring to pop from.
+ * @param  Record : Room for RecordSize bytes.
+ * @retval EStatus_t
+ * @note   Returns OPERATION_IDLE if the oldest record is not published
+ *         yet.
+ */
+static inline EStatus_t RingMPSC_Pop(RingMPSC_t *Ring, void *Record)
+{
+  return RingMPSC_PopBatch(Ring, Record, 1, NULL);
+}
+
+
+#endif /* RING_BUFFER_H */
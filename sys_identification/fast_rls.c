@@ -0,0 +1,284 @@
+#include <math.h>
+#include <string.h>
+#include "fast_rls.h"
+
+#if defined(__GNUC__)
+#define FRLS_INLINE inline __attribute__((always_inline))
+#else
+#define FRLS_INLINE inline
+#endif
+
+
+/* Notation, for N = Order * Channels coefficients and p = Channels:      */
+/*  phi : delay line (N), newest channel vector z = {u[n], y[n-1]} first  */
+/*  A, D : forward and backward predictors of the line (N x p)            */
+/*  E : forward prediction error energy (p x p)                           */
+/*  k : gain (N), so that coeffs = coeffs + k * erro                      */
+/*  gamma = 1 - k'*phi : conversion factor, 0 < gamma <= 1                */
+/*                                                                        */
+/*  e = z + A'*phi                   a priori forward error               */
+/*  A = A - k*e', eps = gamma*e      a posteriori forward error           */
+/*  E = lambda*E + eps*e'                                                 */
+/*  kbar = [inv(E)*eps; k + A*inv(E)*eps] = [m; mu]   extended gain (N+p) */
+/*  phi = [z; phi], psi = part shifted out of the line                    */
+/*  eta = psi + D'*phi               a priori backward error              */
+/*  D = (D - m*eta')*inv(I - mu*eta'), k = m - D*mu                       */
+/*                                                                        */
+/* With s = 1 - eta'*mu and Dt = D - m*eta', Sherman-Morrison gives        */
+/*  v = Dt*mu/s, D = Dt + v*eta' and k = m - v, one pass over D.           */
+/*                                                                        */
+/* Predictors restarted on a full line see it as prewindowed: the rows of */
+/*  A, D and k past the samples seen since the restart stay zero, so only */
+/*  psi has to be masked until the line is refilled. The coefficients keep */
+/*  using the whole line.                                                  */
+
+
+/**
+ * @brief Pointers into FRLS_t.Work.
+ */
+typedef struct
+{
+  double *A;      /*!< N x p */
+  double *D;      /*!< N x p */
+  double *Gain;   /*!< N */
+  double *Line;   /*!< N + p, the delay line then the part shifted out */
+  double *Kbar;   /*!< N + p */
+  double *E;      /*!< p x p */
+  double *LastOutput;
+  double *Gamma;
+  double *Filled; /*!< Samples seen by the predictors, up to Order */
+}FRLS_Work_t;
+
+
+static void FRLS_GetWork(FRLS_t *Parameters, FRLS_Work_t *W)
+{
+  uint32_t p = Parameters->Channels;
+  uint32_t n = Parameters->Order * p;
+
+  W->A = Parameters->Work;
+  W->D = W->A + n*p;
+  W->Gain = W->D + n*p;
+  W->Line = W->Gain + n;
+  W->Kbar = W->Line + n + p;
+  W->E = W->Kbar + n + p;
+  W->LastOutput = W->E + p*p;
+  W->Gamma = W->LastOutput + 1;
+  W->Filled = W->Gamma + 1;
+}
+
+
+/**
+ * @brief  Restarts the predictors: zero predictors and gain, energy
+ *         1 / InitialCov, and no sample of the line seen yet.
+ */
+static void FRLS_Restart(FRLS_t *Parameters, FRLS_Work_t *W)
+{
+  uint32_t p = Parameters->Channels;
+  uint32_t n = Parameters->Order * p;
+  uint32_t i;
+  double energy = (Parameters->InitialCov > 0.0f) ?
+      1.0 / Parameters->InitialCov : 1.0;
+
+  memset(W->A, 0, sizeof(double) * n * p);
+  memset(W->D, 0, sizeof(double) * n * p);
+  memset(W->Gain, 0, sizeof(double) * n);
+  memset(W->E, 0, sizeof(double) * p * p);
+  for(i = 0; i < p; i++){
+    W->E[i*p + i] = energy;
+  }
+  *W->Gamma = 1.0;
+  *W->Filled = 0.0;
+}
+
+
+int32_t FRLS_Init(float InitialCov, FRLS_t *Parameters)
+{
+  FRLS_Work_t w;
+  uint32_t p = Parameters->Channels;
+  uint32_t n = Parameters->Order * p;
+
+  if(p != 1 && p != 2){
+    return 0;
+  }
+  FRLS_GetWork(Parameters, &w);
+  Parameters->InitialCov = InitialCov;
+  Parameters->Rescues = 0;
+  Parameters->Error = 0.0f;
+  memset(w.Line, 0, sizeof(double) * (n + p));
+  *w.LastOutput = 0.0;
+  FRLS_Restart(Parameters, &w);
+  return 1;
+}
+
+
+/**
+ * @brief  One sample of the fast RLS. Called with a constant number of
+ *         channels, so the compiler drops the loops over them.
+ */
+static FRLS_INLINE int32_t FRLS_Step(float SysInput, float SysOutput,
+    FRLS_t *Parameters, const uint32_t p)
+{
+  FRLS_Work_t w;
+  uint32_t n = Parameters->Order * p;
+  uint32_t i, c;
+  double lambda = (Parameters->Lambda > 0.0f) ? Parameters->Lambda : 1.0;
+  double z[2], e[2], eps[2], wv[2], eta[2];
+  double *a, *d, *m, *mu;
+  double gamma, det, s, v, err;
+  int valid;
+
+  FRLS_GetWork(Parameters, &w);
+  z[0] = SysInput;
+  z[1] = *w.LastOutput;
+  gamma = *w.Gamma;
+
+  /* e = z + A'*phi */
+  e[0] = z[0];
+  e[1] = z[1];
+  for(i = 0; i < n; i++){
+    a = w.A + i*p;
+    for(c = 0; c < p; c++){
+      e[c] += a[c] * w.Line[i];
+    }
+  }
+
+  /* E = lambda*E + gamma*e*e', wv = inv(E)*eps */
+  eps[0] = gamma * e[0];
+  eps[1] = gamma * e[1];
+  if(p == 1){
+    w.E[0] = lambda * w.E[0] + eps[0] * e[0];
+    det = w.E[0];
+    wv[0] = eps[0] / w.E[0];
+  }else{
+    w.E[0] = lambda * w.E[0] + eps[0] * e[0];
+    w.E[1] = lambda * w.E[1] + eps[0] * e[1];
+    w.E[2] = w.E[1];
+    w.E[3] = lambda * w.E[3] + eps[1] * e[1];
+    det = w.E[0] * w.E[3] - w.E[1] * w.E[2];
+    wv[0] = (w.E[3] * eps[0] - w.E[1] * eps[1]) / det;
+    wv[1] = (w.E[0] * eps[1] - w.E[2] * eps[0]) / det;
+  }
+
+  /* A = A - k*e', kbar = [wv; k + A*wv] */
+  for(c = 0; c < p; c++){
+    w.Kbar[c] = wv[c];
+  }
+  for(i = 0; i < n; i++){
+    a = w.A + i*p;
+    v = w.Gain[i];
+    for(c = 0; c < p; c++){
+      a[c] -= w.Gain[i] * e[c];
+      v += a[c] * wv[c];
+    }
+    w.Kbar[p + i] = v;
+  }
+  m = w.Kbar;
+  mu = w.Kbar + n;
+
+  /* Shift the line, eta = psi + D'*phi, psi counted only once the */
+  /*  predictors have seen the whole line                          */
+  memmove(w.Line + p, w.Line, sizeof(double) * n);
+  for(c = 0; c < p; c++){
+    w.Line[c] = z[c];
+    eta[c] = (*w.Filled >= Parameters->Order) ? w.Line[n + c] : 0.0;
+  }
+  if(*w.Filled < Parameters->Order){
+    *w.Filled += 1.0;
+  }
+  for(i = 0; i < n; i++){
+    d = w.D + i*p;
+    for(c = 0; c < p; c++){
+      eta[c] += d[c] * w.Line[i];
+    }
+  }
+  s = 1.0;
+  for(c = 0; c < p; c++){
+    s -= eta[c] * mu[c];
+  }
+
+  /* Dt = D - m*eta', v = Dt*mu/s, D = Dt + v*eta', k = m - v, */
+  /*  gamma = 1 - k'*phi for the next sample                    */
+  valid = (det > 0.0 && s > 0.0 && isfinite(det) && isfinite(s));
+  if(valid){
+    s = 1.0 / s;
+    gamma = 1.0;
+    for(i = 0; i < n; i++){
+      d = w.D + i*p;
+      v = 0.0;
+      for(c = 0; c < p; c++){
+        d[c] -= m[i] * eta[c];
+        v += d[c] * mu[c];
+      }
+      v *= s;
+      for(c = 0; c < p; c++){
+        d[c] += v * eta[c];
+      }
+      w.Gain[i] = m[i] - v;
+      gamma -= w.Gain[i] * w.Line[i];
+    }
+    valid = (gamma > 0.0 && gamma <= 1.0);
+    *w.Gamma = gamma;
+  }
+  if(!valid){
+    /* Lost positivity, restart the predictors before the gain is used */
+    FRLS_Restart(Parameters, &w);
+    Parameters->Rescues++;
+  }
+
+  /* erro = y - coeffs'*phi, coeffs = coeffs + k*erro */
+  err = SysOutput;
+  for(i = 0; i < n; i++){
+    err -= Parameters->SysCoeffs[i] * w.Line[i];
+  }
+  for(i = 0; i < n; i++){
+    Parameters->SysCoeffs[i] += (float)(w.Gain[i] * err);
+  }
+  Parameters->Error = (float)err;
+  *w.LastOutput = SysOutput;
+
+  return valid ? 1 : 0;
+}
+
+
+int32_t FRLS_Compute(float SysInput, float SysOutput, FRLS_t *Parameters)
+{
+  if(Parameters->Channels == 1){
+    return FRLS_Step(SysInput, SysOutput, Parameters, 1);
+  }
+  if(Parameters->Channels == 2){
+    return FRLS_Step(SysInput, SysOutput, Parameters, 2);
+  }
+  return 0;
+}
+
+
+size_t FRLS_WorkspaceSize(uint32_t Order, uint32_t Channels)
+{
+  if(Channels != 1 && Channels != 2){
+    return 0;
+  }
+  return ARENA_ALIGN_UP(sizeof(float) * Order * Channels) +
+      ARENA_ALIGN_UP(sizeof(double) * FRLS_WORK_SIZE(Order, Channels));
+}
+
+
+int32_t FRLS_AttachWorkspace(void *Workspace, uint32_t Order,
+    uint32_t Channels, float InitialCov, FRLS_t *Parameters)
+{
+  Arena_t arena;
+
+  if(Channels != 1 && Channels != 2){
+    return 0;
+  }
+  if(Arena_InitWorkspace(&arena, Workspace,
+      FRLS_WorkspaceSize(Order, Channels)) != ANSWERED_REQUEST){
+    return 0;
+  }
+  Parameters->SysCoeffs = Arena_Alloc(&arena,
+      sizeof(float) * Order * Channels);
+  Parameters->Work = Arena_Alloc(&arena,
+      sizeof(double) * FRLS_WORK_SIZE(Order, Channels));
+  Parameters->Order = Order;
+  Parameters->Channels = Channels;
+  return FRLS_Init(InitialCov, Parameters);
+}
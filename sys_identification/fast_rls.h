@@ -0,0 +1,137 @@
+/**
+ * @file  fast_rls.h
+ * @date  18-October-2026
+ * @brief Fast (O(N) per sample) RLS for tapped delay line regressors.
+ *
+ *   When the regressor vector is a delay line of past inputs (FIR) or past
+ *   inputs and outputs (ARX), the RLS gain can be propagated from forward
+ *   and backward linear predictors of the line instead of a N x N
+ *   covariance: the multichannel fast Kalman algorithm (Falconer and
+ *   Ljung, 1978). A sample costs about 10 * N * Channels operations,
+ *   against 3 * N^2 for RLS_Compute, and the delay line is managed here,
+ *   so only the new input and output are passed in.
+ *
+ *   Fast RLS recursions can lose positivity in single precision after
+ *   long runs. The conversion factor and the error energies are checked
+ *   at every sample; when they leave their valid range the predictors are
+ *   restarted (rescue) while the coefficients and the delay line are kept.
+ *
+ * @author
+ * @author
+ */
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef FAST_RLS_H
+#define FAST_RLS_H
+
+
+#define FAST_RLS_VER_MAJOR                                                  2026
+#define FAST_RLS_VER_MINOR                                                    10
+#define FAST_RLS_VER_PATCH                                                     1
+#define FAST_RLS_BRANCH_MASTER
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+
+
+/**
+ * @brief Number of doubles of FRLS_t.Work for the given model.
+ */
+#define FRLS_WORK_SIZE(Order, Channels) \
+    ((Order) * (Channels) * (2 * (Channels) + 3) + \
+     (Channels) * ((Channels) + 2) + 3)
+
+
+/**
+ * @brief Structure used to operate the fast RLS.
+ * @note  With Channels = 1 (FIR), y[n] = sum b[k] * u[n - k], k = 0 to
+ *        Order - 1, and SysCoeffs = {b[0], b[1], ..., b[Order - 1]}.
+ *        With Channels = 2 (ARX), y[n] = sum b[k] * u[n - k] +
+ *        sum a[k] * y[n - 1 - k], k = 0 to Order - 1, and SysCoeffs holds
+ *        the pairs {b[0], a[0], b[1], a[1], ..., b[Order-1], a[Order-1]}.
+ */
+typedef struct
+{
+  float *SysCoeffs;     /*!< 1-D array of size Order * Channels */
+  double *Work;         /*!< 1-D array of size FRLS_WORK_SIZE(Order,
+                             Channels): predictors, gain and delay line */
+  float Error;          /*!< A priori error of the last sample */
+  float Lambda;         /*!< Forgetting factor, 0 < Lambda <= 1. Zero is
+                             taken as 1 (infinite memory) */
+  float InitialCov;     /*!< Initial variance of the coefficients, also
+                             used when the predictors are restarted */
+  uint32_t Order;       /*!< Taps of each channel */
+  uint32_t Channels;    /*!< 1 for FIR, 2 for ARX models */
+  uint32_t Rescues;     /*!< Times the predictors were restarted */
+}FRLS_t;
+
+
+/**
+ * @brief  Clears the delay line and starts the predictors.
+ * @param  InitialCov : Initial variance of every coefficient, as the
+ *                      diagonal of Cov in RLS_Compute.
+ * @param  Parameters : Handle with all needed variables.
+ * @retval int32_t
+ * @note   SysCoeffs are not changed, so they may hold an initial guess.
+ *         The function returns 1 on success, 0 if Channels is not 1 or 2
+ *         (nothing is written).
+ */
+int32_t FRLS_Init(float InitialCov, FRLS_t *Parameters);
+
+
+/**
+ * @brief  Pushes a new sample into the delay line and updates the
+ *         coefficients.
+ * @param  SysInput : Newest input u[n].
+ * @param  SysOutput : Newest output y[n].
+ * @param  Parameters : Handle with all needed variables.
+ * @retval int32_t
+ * @note   Same estimate as RLS_Compute fed with the delay line as
+ *         SysInputs (prewindowed, i.e. samples before the first one taken
+ *         as zero), up to rounding and to the initialization.
+ *         The function returns 1 on success, 0 if the predictors had to
+ *         be restarted (Rescues is incremented, SysCoeffs are kept) or if
+ *         Channels is not 1 or 2 (nothing is updated).
+ */
+int32_t FRLS_Compute(float SysInput, float SysOutput, FRLS_t *Parameters);
+
+
+/**
+ * @brief  Returns the bytes of workspace needed by FRLS_AttachWorkspace.
+ * @param  Order : Taps of each channel.
+ * @param  Channels : 1 for FIR, 2 for ARX models.
+ * @retval size_t : A multiple of ARENA_ALIGN, 0 if Channels is not 1 or 2.
+ */
+size_t FRLS_WorkspaceSize(uint32_t Order, uint32_t Channels);
+
+
+/**
+ * @brief  Points SysCoeffs and Work of a FRLS_t into one workspace, clears
+ *         it and calls FRLS_Init.
+ * @param  Workspace : ARENA_ALIGN aligned memory of
+ *                     FRLS_WorkspaceSize(Order, Channels) bytes, e.g.
+ *                     carved from an Arena_t (arena.h).
+ * @param  Order : Taps of each channel.
+ * @param  Channels : 1 for FIR, 2 for ARX models.
+ * @param  InitialCov : As in FRLS_Init.
+ * @param  Parameters : Handle to set up. Lambda is left to the caller.
+ * @retval int32_t
+ * @note   The function returns 1 on success, 0 if Channels is not 1 or 2
+ *         or if Workspace is NULL or not aligned.
+ */
+int32_t FRLS_AttachWorkspace(void *Workspace, uint32_t Order,
+    uint32_t Channels, float InitialCov, FRLS_t *Parameters);
+
+#endif /* FAST_RLS_H */
+
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,14 +1,157 @@
+#include <stdlib.h>
 #include <string.h>
+#include <float.h>
+#include <math.h>
 #include "least_squares.h"
 #include "matrix_math.h"
+#include "matrix_gemm.h"
+
+
+/**
+ * @brief Samples of X'Y accumulated per GemmMatrix call in
+ *        LMS_ComputeMulti, the partial sums being added in double.
+ */
+#define LMS_RHS_BLOCK                                                       4096
+
+
+/**
+ * @brief  Factorizes a symmetric positive semi-definite Gram matrix (both
+ *         triangles filled) in place.
+ * @param  Diag : 1-D array of size NumCoeff, scratch.
+ * @note   Cholesky is tried first. When it fails, Gram is restored from its
+ *         untouched upper triangle and a copy of the diagonal, and LDL' is
+ *         used instead.
+ *         The function returns the factorization left in Gram,
+ *         LMS_FACTOR_NONE when LDL' finds no non-zero pivot (rank 0).
+ */
+static LMS_Factor_t LMS_Factorize(float *Gram, int32_t *Pivots,
+    uint32_t NumCoeff, float *Diag)
+{
+  uint32_t k, j;
+
+  for(k = 0; k < NumCoeff; k++){
+    Diag[k] = Gram[k + k * NumCoeff];
+  }
+
+  if(CholeskyDecomposition(Gram, NumCoeff) == 1){
+    return LMS_FACTOR_CHOLESKY;
+  }
+
+  for(k = 0; k < NumCoeff; k++){
+    Gram[k + k * NumCoeff] = Diag[k];
+    for(j = 0; j < k; j++){
+      Gram[j + k * NumCoeff] = Gram[k + j * NumCoeff];
+    }
+  }
+  if(LDLDecomposition(Gram, NumCoeff, Pivots,
+      (float)NumCoeff * FLT_EPSILON) == 0){
+    return LMS_FACTOR_NONE;
+  }
+  return LMS_FACTOR_LDL;
+}
+
+
+/**
+ * @brief  Solves Gram * X = B with the factorization computed by
+ *         LMS_Factorize, store X in B (NumCoeff x NumRhs).
+ */
+static void LMS_SolveFactored(float *Gram, int32_t *Pivots,
+    uint32_t NumCoeff, LMS_Factor_t Factor, float *B, int NumRhs)
+{
+  if(Factor == LMS_FACTOR_CHOLESKY){
+    CholeskySolve(Gram, NumCoeff, B, NumRhs);
+  }else{
+    LDLSolve(Gram, NumCoeff, Pivots, B, NumRhs);
+  }
+}
+
+
+/**
+ * @brief  Solves Gram * Coeffs = Rhs for a symmetric positive semi-definite
+ *         Gram matrix (both triangles filled), which is overwritten by its
+ *         factorization.
+ * @note   The function returns the factorization used, LMS_FACTOR_NONE
+ *         when Gram has numerical rank 0 (Coeffs is then undefined).
+ */
+static LMS_Factor_t LMS_Solve(float *Gram, float *Rhs, int32_t *Pivots,
+    uint32_t NumCoeff, float *Coeffs)
+{
+  LMS_Factor_t factor;
+
+  /* Coeffs holds the diagonal while Cholesky runs */
+  factor = LMS_Factorize(Gram, Pivots, NumCoeff, Coeffs);
+  if(factor != LMS_FACTOR_NONE){
+    CopyMatrix(Rhs, NumCoeff, 1, Coeffs);
+    LMS_SolveFactored(Gram, Pivots, NumCoeff, factor, Coeffs, 1);
+  }
+  return factor;
+}
+
+
+/**
+ * @brief  Lower triangle of X'X and X'Y streaming each sample once, used
+ *         when SyrkMatrix can not allocate its buffers.
+ */
+static void LMS_AccumulateRows(MatrixView_t *SysInputs,
+    MatrixView_t *SysOutputs, LMS_t *Parameters)
+{
+  uint32_t i, k, j;
+  uint32_t numCoeff = Parameters->NumCoeff;
+  float *sums = Parameters->SumXkiXji;
+  float *row, *sumk;
+  float xk, yi;
+
+  for(k = 0; k < numCoeff; k++){
+    Parameters->SumYiXji[k] = 0;
+    for(j = 0; j <= k; j++){
+      sums[j + k * numCoeff] = 0;
+    }
+  }
+  for(i = 0; i < Parameters->NumSamples; i++){
+    row = SysInputs->Data + (int64_t)i * SysInputs->Stride;
+    yi = SysOutputs->Data[(int64_t)i * SysOutputs->Stride];
+    for(k = 0; k < numCoeff; k++){
+      xk = row[k];
+      sumk = sums + k * numCoeff;
+      for(j = 0; j <= k; j++){
+        sumk[j] += xk * row[j];
+      }
+      Parameters->SumYiXji[k] += yi * xk;
+    }
+  }
+}
+
+
+void LMS_Init(LMS_t *Parameters)
+{
+  Parameters->Factor = LMS_FACTOR_NONE;
+}
 
 
 int32_t LMS_Compute(float* SysInputs, float *SysOutputs, LMS_t *Parameters)
 {
-  int32_t returnvalue;
+  MatrixView_t inputs, outputs;
+
+  MatrixViewInit(&inputs, SysInputs, Parameters->NumSamples,
+      Parameters->NumCoeff, Parameters->NumCoeff);
+  MatrixViewInit(&outputs, SysOutputs, Parameters->NumSamples, 1, 1);
+  return LMS_ComputeView(&inputs, &outputs, Parameters);
+}
+
+
+int32_t LMS_ComputeView(MatrixView_t *SysInputs, MatrixView_t *SysOutputs,
+    LMS_t *Parameters)
+{
   uint32_t numCoeff = Parameters->NumCoeff;
   uint32_t numSamples = Parameters->NumSamples;
 
+  /* SumXkiXji is overwritten below, whatever happens to the solve */
+  Parameters->Factor = LMS_FACTOR_NONE;
+  if(SysInputs->Rows != (int)numSamples || SysInputs->Cols != (int)numCoeff ||
+      SysOutputs->Rows != (int)numSamples || SysOutputs->Cols != 1){
+    return 0;
+  }
+
   /**
    * Matrix of sum of product of inputs and outputs (Y)
    * Syx0 Syx1 Syx2 Syx3
@@ -22,81 +165,786 @@ int32_t LMS_Compute(float* SysInputs, float *SysOutputs, LMS_t *Parameters)
    * Sx3x0  Sx3x1  Sx3x2  Sx3x3
    */
 
+  /* Lower triangle, each sample row read once (blocked, multithreaded) */
+  if(SyrkMatrix(SysInputs->Data, SysOutputs->Data, numSamples, numCoeff,
+      SysInputs->Stride, SysOutputs->Stride, Parameters->SumXkiXji,
+      numCoeff, Parameters->SumYiXji) == 0){
+    LMS_AccumulateRows(SysInputs, SysOutputs, Parameters);
+  }
   for(uint32_t k = 0; k < numCoeff; k++){
-    for(uint32_t j = 0; j <= k; j++){
-      Parameters->SumXkiXji[j + k * numCoeff] = 0;
-      Parameters->SumYiXji[j] = 0;
-      for(uint32_t i = 0; i < numSamples; i++){
-
-        /* Sum of products between SysOutputs and SysInputs */
-        if(k == numCoeff - 1)
-        {
-          Parameters->SumYiXji[j] += SysOutputs[i] *
-              SysInputs[j + i * numCoeff];
-        }
+    for(uint32_t j = 0; j < k; j++){
+      Parameters->SumXkiXji[k + j * numCoeff] =
+          Parameters->SumXkiXji[j + k * numCoeff];
+    }
+  }
+
+
+  /**
+   * Coefficients: X * A = Y
+   */
+  Parameters->Factor = LMS_Solve(Parameters->SumXkiXji,
+      Parameters->SumYiXji, Parameters->Pivots, numCoeff,
+      Parameters->SysCoeffs);
+
+  return (Parameters->Factor != LMS_FACTOR_NONE) ? 1 : 0;
 
-        /* Sum of products between SysOutputs */
-        Parameters->SumXkiXji[j + k * numCoeff] +=
-            SysInputs[k + i * numCoeff] *
-            SysInputs[j + i * numCoeff];
-        if(j != k){
-          Parameters->SumXkiXji[k + j * numCoeff] =
-              Parameters->SumXkiXji[j + k * numCoeff];
+}
+
+
+/**
+ * @brief  Coeffs = X'Y (NumCoeff x NumOutputs). Blocks of samples are
+ *         transposed and multiplied with GemmMatrix, each block product
+ *         being added to double precision totals. The block holds at most
+ *         NumSamples rows, so short records allocate little.
+ *         The function returns 1 on success, 0 if the buffers could not
+ *         be allocated.
+ */
+static int32_t LMS_AccumulateRhs(float *SysInputs, float *SysOutputs,
+    uint32_t NumOutputs, float *Coeffs, LMS_t *Parameters)
+{
+  uint32_t i, k, o, rows;
+  uint32_t numCoeff = Parameters->NumCoeff;
+  uint32_t numRhs = numCoeff * NumOutputs;
+  uint32_t maxRows = (Parameters->NumSamples < LMS_RHS_BLOCK) ?
+      Parameters->NumSamples : LMS_RHS_BLOCK;
+  double *totals;
+  float *block, *product, *row;
+  int32_t ok = 1;
+
+  totals = malloc(sizeof(double) * numRhs);
+  block = malloc(sizeof(float) * ((size_t)numCoeff * maxRows + numRhs));
+  if(totals == NULL || block == NULL){
+    free(totals);
+    free(block);
+    return 0;
+  }
+  product = block + (size_t)numCoeff * maxRows;
+
+  for(k = 0; k < numRhs; k++){
+    totals[k] = 0.0;
+  }
+  for(i = 0; i < Parameters->NumSamples && ok; i += rows){
+    rows = Parameters->NumSamples - i;
+    rows = (rows < maxRows) ? rows : maxRows;
+    /* block = X(i:i+rows, :)' */
+    for(o = 0; o < rows; o++){
+      row = SysInputs + (size_t)(i + o) * numCoeff;
+      for(k = 0; k < numCoeff; k++){
+        block[k * rows + o] = row[k];
+      }
+    }
+    ok = GemmMatrix(block, SysOutputs + (size_t)i * NumOutputs, numCoeff,
+        rows, NumOutputs, product, rows, NumOutputs, NumOutputs,
+        1.0f, 0.0f);
+    for(k = 0; k < numRhs && ok; k++){
+      totals[k] += product[k];
+    }
+  }
+  for(k = 0; k < numRhs && ok; k++){
+    Coeffs[k] = (float)totals[k];
+  }
+
+  free(totals);
+  free(block);
+  return ok;
+}
+
+
+int32_t LMS_ComputeMulti(float *SysInputs, float *SysOutputs,
+    uint32_t NumOutputs, float *SysCoeffs, LMS_t *Parameters)
+{
+  MatrixView_t inputs, outputs;
+  uint32_t i, k, o;
+  uint32_t numCoeff = Parameters->NumCoeff;
+  float *row, *rhs;
+  float xk;
+
+  if(NumOutputs == 0){
+    return 0;
+  }
+  if(Parameters->Factor == LMS_FACTOR_NONE){
+    /* Same X'X as LMS_ComputeView */
+    MatrixViewInit(&inputs, SysInputs, Parameters->NumSamples, numCoeff,
+        numCoeff);
+    MatrixViewInit(&outputs, SysOutputs, Parameters->NumSamples, 1,
+        NumOutputs);
+    if(SyrkMatrix(SysInputs, NULL, Parameters->NumSamples, numCoeff,
+        numCoeff, 1, Parameters->SumXkiXji, numCoeff, NULL) == 0){
+      LMS_AccumulateRows(&inputs, &outputs, Parameters);
+    }
+    for(k = 0; k < numCoeff; k++){
+      for(i = 0; i < k; i++){
+        Parameters->SumXkiXji[k + i * numCoeff] =
+            Parameters->SumXkiXji[i + k * numCoeff];
+      }
+    }
+    /* SumYiXji, unused here, holds the diagonal while Cholesky runs */
+    Parameters->Factor = LMS_Factorize(Parameters->SumXkiXji,
+        Parameters->Pivots, numCoeff, Parameters->SumYiXji);
+    if(Parameters->Factor == LMS_FACTOR_NONE){
+      return 0;
+    }
+  }
+
+  /* X'Y, then one pair of triangular solves for all the outputs */
+  if(LMS_AccumulateRhs(SysInputs, SysOutputs, NumOutputs, SysCoeffs,
+      Parameters) == 0){
+    for(k = 0; k < numCoeff * NumOutputs; k++){
+      SysCoeffs[k] = 0.0f;
+    }
+    for(i = 0; i < Parameters->NumSamples; i++){
+      row = SysInputs + (size_t)i * numCoeff;
+      for(k = 0; k < numCoeff; k++){
+        xk = row[k];
+        rhs = SysCoeffs + k * NumOutputs;
+        for(o = 0; o < NumOutputs; o++){
+          rhs[o] += xk * SysOutputs[(size_t)i * NumOutputs + o];
         }
       }
     }
   }
+  LMS_SolveFactored(Parameters->SumXkiXji, Parameters->Pivots, numCoeff,
+      Parameters->Factor, SysCoeffs, NumOutputs);
+
+  return 1;
+}
+
+
+/**
+ * @brief  Cholesky factorization and solve of the (double) Hankel system
+ *         of LMS_PolyCompute, in place. Directions whose pivot is below
+ *         Tolerance get a zero component, as with LDLSolve.
+ *         The function returns the number of non-zero pivots.
+ */
+static uint32_t LMS_PolySolve(double *Gram, double *Rhs, uint32_t n,
+    double Tolerance)
+{
+  uint32_t i, j, m, rank = 0;
+  double sum;
+
+  for(j = 0; j < n; j++){
+    sum = Gram[j * n + j];
+    for(m = 0; m < j; m++){
+      sum -= Gram[j * n + m] * Gram[j * n + m];
+    }
+    if(sum <= Tolerance){
+      for(i = j; i < n; i++){
+        Gram[i * n + j] = 0.0;
+      }
+      continue;
+    }
+    rank++;
+    Gram[j * n + j] = sqrt(sum);
+    for(i = j + 1; i < n; i++){
+      sum = Gram[i * n + j];
+      for(m = 0; m < j; m++){
+        sum -= Gram[i * n + m] * Gram[j * n + m];
+      }
+      Gram[i * n + j] = sum / Gram[j * n + j];
+    }
+  }
+
+  /* L * z = Rhs, then L' * b = z */
+  for(j = 0; j < n; j++){
+    sum = Rhs[j];
+    for(m = 0; m < j; m++){
+      sum -= Gram[j * n + m] * Rhs[m];
+    }
+    Rhs[j] = (Gram[j * n + j] > 0.0) ? sum / Gram[j * n + j] : 0.0;
+  }
+  for(j = n; j-- > 0;){
+    sum = Rhs[j];
+    for(m = j + 1; m < n; m++){
+      sum -= Gram[m * n + j] * Rhs[m];
+    }
+    Rhs[j] = (Gram[j * n + j] > 0.0) ? sum / Gram[j * n + j] : 0.0;
+  }
+  return rank;
+}
+
+
+/**
+ * @brief  Adds the powers t^j (times p, the lane weight) of one group of
+ *         LMS_POLY_LANES samples to the power sums of LMS_PolyCompute.
+ */
+static inline void LMS_PolyAccumulate(double *p, double *t, double *y,
+    uint32_t NumCoeff, double *Sums, double *RhsSums)
+{
+  uint32_t j, l;
+
+  for(j = 0; j < NumCoeff; j++){
+    for(l = 0; l < LMS_POLY_LANES; l++){
+      Sums[j * LMS_POLY_LANES + l] += p[l];
+      RhsSums[j * LMS_POLY_LANES + l] += y[l] * p[l];
+      p[l] *= t[l];
+    }
+  }
+  for(; j < 2 * NumCoeff - 1; j++){
+    for(l = 0; l < LMS_POLY_LANES; l++){
+      Sums[j * LMS_POLY_LANES + l] += p[l];
+      p[l] *= t[l];
+    }
+  }
+}
+
+
+int32_t LMS_PolyCompute(float *x, float *y, LMS_Poly_t *Parameters)
+{
+  uint32_t i, j, l, k = Parameters->NumCoeff;
+  uint32_t numSamples = Parameters->NumSamples;
+  uint32_t numSums = 2 * k - 1;
+  double *sums = Parameters->Work;
+  double *rhsSums = sums + numSums * LMS_POLY_LANES;
+  double *gram = rhsSums + k * LMS_POLY_LANES;
+  double *rhs = gram + k * k;
+  double p[LMS_POLY_LANES], t[LMS_POLY_LANES], yl[LMS_POLY_LANES];
+  double center, scale, invScale, tol;
+  float xmin, xmax;
+
+  if(k == 0 || numSamples == 0){
+    return 0;
+  }
+
+  /* t = (x - center) / scale in [-1, 1] keeps the power sums in range */
+  xmin = x[0];
+  xmax = x[0];
+  for(i = 1; i < numSamples; i++){
+    xmin = (x[i] < xmin) ? x[i] : xmin;
+    xmax = (x[i] > xmax) ? x[i] : xmax;
+  }
+  center = 0.5 * ((double)xmax + xmin);
+  scale = 0.5 * ((double)xmax - xmin);
+  scale = (scale > 0.0) ? scale : 1.0;
+  invScale = 1.0 / scale;
+
+  /* S[j] = sum t^j, j < 2k - 1, and R[j] = sum y * t^j, j < k, each lane */
+  /*  summing its own samples so the loops over the lanes vectorize      */
+  for(j = 0; j < (numSums + k) * LMS_POLY_LANES; j++){
+    sums[j] = 0.0;
+  }
+  for(i = 0; i + LMS_POLY_LANES <= numSamples; i += LMS_POLY_LANES){
+    for(l = 0; l < LMS_POLY_LANES; l++){
+      p[l] = 1.0;
+      t[l] = (x[i + l] - center) * invScale;
+      yl[l] = y[i + l];
+    }
+    LMS_PolyAccumulate(p, t, yl, k, sums, rhsSums);
+  }
+  if(i < numSamples){
+    for(l = 0; l < LMS_POLY_LANES; l++){
+      /* A padding lane has p = 0, so it adds nothing */
+      p[l] = (i + l < numSamples) ? 1.0 : 0.0;
+      t[l] = (i + l < numSamples) ? (x[i + l] - center) * invScale : 0.0;
+      yl[l] = (i + l < numSamples) ? y[i + l] : 0.0;
+    }
+    LMS_PolyAccumulate(p, t, yl, k, sums, rhsSums);
+  }
+  for(j = 0; j < numSums + k; j++){
+    for(l = 1; l < LMS_POLY_LANES; l++){
+      sums[j * LMS_POLY_LANES] += sums[j * LMS_POLY_LANES + l];
+    }
+  }
+
+  /* X'X is Hankel: gram[i][j] = S[i + j] */
+  for(i = 0; i < k; i++){
+    for(j = 0; j < k; j++){
+      gram[i * k + j] = sums[(i + j) * LMS_POLY_LANES];
+    }
+    rhs[i] = rhsSums[i * LMS_POLY_LANES];
+  }
+  tol = (double)k * DBL_EPSILON * 1e3 * sums[0];
+  if(LMS_PolySolve(gram, rhs, k, tol) == 0){
+    return 0;
+  }
+
+  /* Back to powers of x: b[j] / scale^j are the coefficients in powers */
+  /*  of (x - center), then a Taylor shift by center                     */
+  for(j = 1, tol = 1.0; j < k; j++){
+    tol *= invScale;
+    rhs[j] *= tol;
+  }
+  for(i = 0; i + 1 < k; i++){
+    for(j = k - 1; j-- > i;){
+      rhs[j] -= center * rhs[j + 1];
+    }
+  }
+  for(j = 0; j < k; j++){
+    Parameters->SysCoeffs[j] = (float)rhs[j];
+  }
 
+  return 1;
+}
+
+
+void LMS_IncReset(LMS_Inc_t *Parameters)
+{
+  uint32_t i;
+  uint32_t numCoeff = Parameters->NumCoeff;
+
+  for(i = 0; i < numCoeff * numCoeff; i++){
+    Parameters->SumXkiXji[i] = 0.0;
+  }
+  for(i = 0; i < numCoeff; i++){
+    Parameters->SumYiXji[i] = 0.0;
+  }
+  Parameters->NumSamples = 0;
+}
+
+
+/**
+ * @brief  Adds Sign times the products of one sample to the running sums.
+ */
+static void LMS_IncAccumulate(float *SysInputs, float SysOutput, double Sign,
+    LMS_Inc_t *Parameters)
+{
+  uint32_t k, j;
+  uint32_t numCoeff = Parameters->NumCoeff;
+  double *row;
+  double xk;
+
+  for(k = 0; k < numCoeff; k++){
+    row = Parameters->SumXkiXji + k * numCoeff;
+    xk = Sign * SysInputs[k];
+    for(j = 0; j <= k; j++){
+      row[j] += xk * SysInputs[j];
+    }
+    Parameters->SumYiXji[k] += Sign * SysOutput * SysInputs[k];
+  }
+}
+
+
+void LMS_IncAdd(float *SysInputs, float SysOutput, LMS_Inc_t *Parameters)
+{
+  LMS_IncAccumulate(SysInputs, SysOutput, 1.0, Parameters);
+  Parameters->NumSamples++;
+}
+
+
+void LMS_IncRemove(float *SysInputs, float SysOutput,
+    LMS_Inc_t *Parameters)
+{
+  LMS_IncAccumulate(SysInputs, SysOutput, -1.0, Parameters);
+  Parameters->NumSamples--;
+}
+
+
+int32_t LMS_IncCompute(LMS_Inc_t *Parameters)
+{
+  int32_t returnvalue;
+  uint32_t k, j;
+  uint32_t numCoeff = Parameters->NumCoeff;
+  float *work = Parameters->Work;
+  float *rhs = Parameters->Work + numCoeff * numCoeff;
+
+  /* The solver works in place, so the sums are copied (and mirrored) */
+  for(k = 0; k < numCoeff; k++){
+    for(j = 0; j <= k; j++){
+      work[j + k * numCoeff] = (float)Parameters->SumXkiXji[j + k * numCoeff];
+      work[k + j * numCoeff] = work[j + k * numCoeff];
+    }
+  }
 
   /**
-   * Coefficients: A = inv(X) * Y
+   * Coefficients: X * A = Y
    */
-  returnvalue = InvertMatrix(Parameters->SumXkiXji, numCoeff);
-  if(returnvalue == 1){
-    MultiplyMatrix(Parameters->SumXkiXji, Parameters->SumYiXji,
-        numCoeff, numCoeff, 1, Parameters->SysCoeffs);
+  for(k = 0; k < numCoeff; k++){
+    rhs[k] = (float)Parameters->SumYiXji[k];
   }
+  returnvalue = (LMS_Solve(work, rhs, NULL, numCoeff,
+      Parameters->SysCoeffs) != LMS_FACTOR_NONE) ? 1 : 0;
 
   return returnvalue;
+}
+
+
+/**
+ * @brief  Common part of the RLS updates: g = cov*X and
+ *         cov = (cov - g*g'/(lambda + X'*g))/lambda, upper triangle only.
+ * @retval 1/(lambda + X'*g), so that k = g/(lambda + X'*g).
+ */
+static float RLS_UpdateCov(float *SysInputs, float *Cov, float *Gain,
+    uint32_t NumCoeff, float Lambda)
+{
+  uint32_t i, j;
+  float *row;
+  float auxf, gi, xi;
+  float lambda = (Lambda > 0.0) ? Lambda : 1.0;
+
+  /* g = cov*X, reading only the upper triangle of cov */
+  for(i = 0; i < NumCoeff; i++){
+    Gain[i] = 0.0;
+  }
+  for(i = 0; i < NumCoeff; i++){
+    row = Cov + i * NumCoeff;
+    xi = SysInputs[i];
+    for(j = i + 1; j < NumCoeff; j++){
+      Gain[j] += row[j] * xi;
+    }
+    DotProduct(row + i, SysInputs + i, NumCoeff - i, &auxf);
+    Gain[i] += auxf;
+  }
 
+  /* k = g/(lambda + X'*g) */
+  DotProduct(Gain, SysInputs, NumCoeff, &auxf);
+  auxf = 1.0/(lambda + auxf);
+
+  /* p = (p - k*X'*p)/lambda = (p - g*g'/(lambda + X'*g))/lambda, */
+  /*  upper triangle only */
+  if(lambda == 1.0){
+    for(i = 0; i < NumCoeff; i++){
+      row = Cov + i * NumCoeff;
+      gi = Gain[i] * auxf;
+      for(j = i; j < NumCoeff; j++){
+        row[j] -= gi * Gain[j];
+      }
+    }
+  }else{
+    xi = 1.0/lambda;
+    for(i = 0; i < NumCoeff; i++){
+      row = Cov + i * NumCoeff;
+      gi = Gain[i] * auxf;
+      for(j = i; j < NumCoeff; j++){
+        row[j] = (row[j] - gi * Gain[j]) * xi;
+      }
+    }
+  }
+
+  return auxf;
 }
 
 
 int32_t RLS_Compute(float *SysInputs, float SysOutput, RLS_t *Parameters)
 {
+  uint32_t numCoeff = Parameters->NumCoeff;
+  float *gain = Parameters->Gain;
   float auxf;
   /* computing */
   /* y = a0x0 + a1*x1 + a2*x2 + ... + an*xn */
   /* X = [x0, x1, x2, ..., xn] */
   /* erro = y - coeffs'*X */
-  /* k = cov*X/(1 + X'*cov*X) */
+  /* k = cov*X/(lambda + X'*cov*X) */
+  /* coeffs = coeffs + k*erro */
+  /* p = (p - k*X'*p)/lambda */
+
+  /* erro = y - coeffs'*X */
+  DotProduct(Parameters->SysCoeffs, SysInputs, numCoeff,
+      &Parameters->Error);
+  Parameters->Error = SysOutput - Parameters->Error;
+
+  auxf = RLS_UpdateCov(SysInputs, Parameters->Cov, gain, numCoeff,
+      Parameters->Lambda);
+
+  /* coeffs = coeffs + k*erro */
+  ScaleMatrix(gain, numCoeff, 1, auxf * Parameters->Error, gain);
+  AddMatrix(Parameters->SysCoeffs, gain, numCoeff, 1,
+      Parameters->SysCoeffs);
+
+  return 0;
+}
+
+
+int32_t RLS_MO_Compute(float *SysInputs, float *SysOutputs,
+    RLS_MO_t *Parameters)
+{
+  uint32_t i, o;
+  uint32_t numCoeff = Parameters->NumCoeff;
+  float *gain = Parameters->Gain;
+  float *coeffs;
+  float auxf, err;
+
+  /* One gain and covariance update for every output */
+  auxf = RLS_UpdateCov(SysInputs, Parameters->Cov, gain, numCoeff,
+      Parameters->Lambda);
+  ScaleMatrix(gain, numCoeff, 1, auxf, gain);
+
+  /* erro[o] = y[o] - coeffs[o]'*X, coeffs[o] = coeffs[o] + k*erro[o] */
+  for(o = 0; o < Parameters->NumOutputs; o++){
+    coeffs = Parameters->SysCoeffs + o * numCoeff;
+    DotProduct(coeffs, SysInputs, numCoeff, &err);
+    err = SysOutputs[o] - err;
+    Parameters->Error[o] = err;
+    for(i = 0; i < numCoeff; i++){
+      coeffs[i] += gain[i] * err;
+    }
+  }
+
+  return 1;
+}
+
+
+void RLS_MirrorCov(RLS_t *Parameters)
+{
+  uint32_t i, j;
+  uint32_t numCoeff = Parameters->NumCoeff;
+  float *cov = Parameters->Cov;
+
+  for(i = 0; i < numCoeff; i++){
+    for(j = i + 1; j < numCoeff; j++){
+      cov[j * numCoeff + i] = cov[i * numCoeff + j];
+    }
+  }
+}
+
+
+void RLS_UD_Init(float InitialCov, RLS_UD_t *Parameters)
+{
+  uint32_t i, j;
+  float *col = Parameters->UD;
+
+  for(j = 0; j < Parameters->NumCoeff; j++){
+    for(i = 0; i < j; i++){
+      col[i] = 0.0;
+    }
+    col[j] = InitialCov;
+    col += j + 1;
+  }
+}
+
+
+int32_t RLS_UD_Compute(float *SysInputs, float SysOutput,
+    RLS_UD_t *Parameters)
+{
+  uint32_t i, j;
+  uint32_t numCoeff = Parameters->NumCoeff;
+  float *col = Parameters->UD;
+  float *gain = Parameters->Gain;
+  float lambda = (Parameters->Lambda > 0.0) ? Parameters->Lambda : 1.0;
+  float invLambda = 1.0/lambda;
+  float alpha, alphaOld, f, v, p, uij;
+  /* computing, with cov = U*D*U' */
+  /* erro = y - coeffs'*X */
+  /* f = U'*X, v = D*f */
+  /* alpha = lambda + X'*cov*X, accumulated one column at a time */
+  /* U, D = factors of (cov - cov*X*X'*cov/alpha)/lambda */
+  /* k = cov*X/alpha = U*v/alpha, built in gain along the way */
   /* coeffs = coeffs + k*erro */
-  /* p = p - k*X'*p */
 
   /* erro = y - coeffs'*X */
-  DotProduct(Parameters->SysCoeffs, SysInputs, Parameters->NumCoeff,
+  DotProduct(Parameters->SysCoeffs, SysInputs, numCoeff,
       &Parameters->Error);
   Parameters->Error = SysOutput - Parameters->Error;
-  /* k = cov*X/(1 + X'*cov*X) */
-  MultiplyMatrix(Parameters->Cov, SysInputs, Parameters->NumCoeff,
-      Parameters->NumCoeff, 1, Parameters->Gain);
-  DotProduct(Parameters->Gain, SysInputs, Parameters->NumCoeff, &auxf);
-  auxf = 1.0/(1.0 + auxf);
-  ScaleMatrix(Parameters->Gain, Parameters->NumCoeff, 1, auxf,
-      Parameters->Gain);
-  /* p = p - k*X'*p */
-  MultiplyMatrix(SysInputs, Parameters->Cov, 1, Parameters->NumCoeff,
-      Parameters->NumCoeff, Parameters->Aux1);
-  MultiplyMatrix(Parameters->Gain, Parameters->Aux1, Parameters->NumCoeff, 1,
-      Parameters->NumCoeff, Parameters->Aux2);
-  SubtractMatrix(Parameters->Cov, Parameters->Aux2, Parameters->NumCoeff,
-      Parameters->NumCoeff, Parameters->Cov);
+
+  /* Bierman's measurement update, column by column */
+  alpha = lambda;
+  for(j = 0; j < numCoeff; j++){
+    /* f[j] uses column j of U before it is updated */
+    DotProduct(col, SysInputs, j, &f);
+    f += SysInputs[j];
+    v = col[j] * f;
+
+    alphaOld = alpha;
+    alpha += f * v;
+    col[j] *= alphaOld / alpha * invLambda;
+    p = -f / alphaOld;
+    for(i = 0; i < j; i++){
+      uij = col[i];
+      col[i] = uij + gain[i] * p;
+      gain[i] += uij * v;
+    }
+    gain[j] = v;
+    col += j + 1;
+  }
 
   /* coeffs = coeffs + k*erro */
-  ScaleMatrix(Parameters->Gain, Parameters->NumCoeff, 1, Parameters->Error,
-      Parameters->Gain);
-  AddMatrix(Parameters->SysCoeffs, Parameters->Gain, Parameters->NumCoeff, 1,
+  ScaleMatrix(gain, numCoeff, 1, Parameters->Error / alpha, gain);
+  AddMatrix(Parameters->SysCoeffs, gain, numCoeff, 1,
       Parameters->SysCoeffs);
 
   return 0;
 }
+
+
+void RLS_UD_GetCov(RLS_UD_t *Parameters, float *Cov)
+{
+  uint32_t i, j, k;
+  uint32_t numCoeff = Parameters->NumCoeff;
+  float *ud = Parameters->UD;
+  float sum, uik, ujk;
+
+  /* cov[i][j] = sum over k >= max(i,j) of U[i][k] * D[k] * U[j][k] */
+  for(i = 0; i < numCoeff; i++){
+    for(j = i; j < numCoeff; j++){
+      sum = 0.0;
+      for(k = j; k < numCoeff; k++){
+        uik = (i == k) ? 1.0 : ud[k * (k + 1) / 2 + i];
+        ujk = (j == k) ? 1.0 : ud[k * (k + 1) / 2 + j];
+        sum += uik * ud[k * (k + 1) / 2 + k] * ujk;
+      }
+      Cov[i * numCoeff + j] = sum;
+      Cov[j * numCoeff + i] = sum;
+    }
+  }
+}
+
+
+size_t LMS_WorkspaceSize(uint32_t NumCoeff)
+{
+  return 2 * ARENA_ALIGN_UP(sizeof(float) * NumCoeff) +
+      ARENA_ALIGN_UP(sizeof(float) * NumCoeff * NumCoeff) +
+      ARENA_ALIGN_UP(sizeof(int32_t) * NumCoeff);
+}
+
+
+int32_t LMS_AttachWorkspace(void *Workspace, uint32_t NumCoeff,
+    uint32_t NumSamples, LMS_t *Parameters)
+{
+  Arena_t arena;
+
+  if(Arena_InitWorkspace(&arena, Workspace,
+      LMS_WorkspaceSize(NumCoeff)) != ANSWERED_REQUEST){
+    return 0;
+  }
+  Parameters->SysCoeffs = Arena_Alloc(&arena, sizeof(float) * NumCoeff);
+  Parameters->SumYiXji = Arena_Alloc(&arena, sizeof(float) * NumCoeff);
+  Parameters->SumXkiXji = Arena_Alloc(&arena,
+      sizeof(float) * NumCoeff * NumCoeff);
+  Parameters->Pivots = Arena_Alloc(&arena, sizeof(int32_t) * NumCoeff);
+  Parameters->NumCoeff = NumCoeff;
+  Parameters->NumSamples = NumSamples;
+  Parameters->Factor = LMS_FACTOR_NONE;
+  return 1;
+}
+
+
+size_t LMS_IncWorkspaceSize(uint32_t NumCoeff)
+{
+  return ARENA_ALIGN_UP(sizeof(float) * NumCoeff) +
+      ARENA_ALIGN_UP(sizeof(double) * NumCoeff) +
+      ARENA_ALIGN_UP(sizeof(double) * NumCoeff * NumCoeff) +
+      ARENA_ALIGN_UP(sizeof(float) * NumCoeff * (NumCoeff + 1));
+}
+
+
+int32_t LMS_IncAttachWorkspace(void *Workspace, uint32_t NumCoeff,
+    LMS_Inc_t *Parameters)
+{
+  Arena_t arena;
+
+  if(Arena_InitWorkspace(&arena, Workspace,
+      LMS_IncWorkspaceSize(NumCoeff)) != ANSWERED_REQUEST){
+    return 0;
+  }
+  Parameters->SysCoeffs = Arena_Alloc(&arena, sizeof(float) * NumCoeff);
+  Parameters->SumYiXji = Arena_Alloc(&arena, sizeof(double) * NumCoeff);
+  Parameters->SumXkiXji = Arena_Alloc(&arena,
+      sizeof(double) * NumCoeff * NumCoeff);
+  Parameters->Work = Arena_Alloc(&arena,
+      sizeof(float) * NumCoeff * (NumCoeff + 1));
+  Parameters->NumCoeff = NumCoeff;
+  Parameters->NumSamples = 0;
+  return 1;
+}
+
+
+size_t LMS_PolyWorkspaceSize(uint32_t NumCoeff)
+{
+  return ARENA_ALIGN_UP(sizeof(float) * NumCoeff) +
+      ARENA_ALIGN_UP(sizeof(double) * LMS_POLY_WORK_SIZE(NumCoeff));
+}
+
+
+int32_t LMS_PolyAttachWorkspace(void *Workspace, uint32_t NumCoeff,
+    uint32_t NumSamples, LMS_Poly_t *Parameters)
+{
+  Arena_t arena;
+
+  if(Arena_InitWorkspace(&arena, Workspace,
+      LMS_PolyWorkspaceSize(NumCoeff)) != ANSWERED_REQUEST){
+    return 0;
+  }
+  Parameters->SysCoeffs = Arena_Alloc(&arena, sizeof(float) * NumCoeff);
+  Parameters->Work = Arena_Alloc(&arena,
+      sizeof(double) * LMS_POLY_WORK_SIZE(NumCoeff));
+  Parameters->NumCoeff = NumCoeff;
+  Parameters->NumSamples = NumSamples;
+  return 1;
+}
+
+
+size_t RLS_WorkspaceSize(uint32_t NumCoeff)
+{
+  return 2 * ARENA_ALIGN_UP(sizeof(float) * NumCoeff) +
+      ARENA_ALIGN_UP(sizeof(float) * NumCoeff * NumCoeff);
+}
+
+
+int32_t RLS_AttachWorkspace(void *Workspace, uint32_t NumCoeff,
+    float InitialCov, RLS_t *Parameters)
+{
+  Arena_t arena;
+  uint32_t i;
+
+  if(Arena_InitWorkspace(&arena, Workspace,
+      RLS_WorkspaceSize(NumCoeff)) != ANSWERED_REQUEST){
+    return 0;
+  }
+  Parameters->SysCoeffs = Arena_Alloc(&arena, sizeof(float) * NumCoeff);
+  Parameters->Cov = Arena_Alloc(&arena, sizeof(float) * NumCoeff * NumCoeff);
+  Parameters->Gain = Arena_Alloc(&arena, sizeof(float) * NumCoeff);
+  for(i = 0; i < NumCoeff; i++){
+    Parameters->Cov[i * NumCoeff + i] = InitialCov;
+  }
+  Parameters->Error = 0.0f;
+  Parameters->NumCoeff = NumCoeff;
+  return 1;
+}
+
+
+size_t RLS_MO_WorkspaceSize(uint32_t NumCoeff, uint32_t NumOutputs)
+{
+  return ARENA_ALIGN_UP(sizeof(float) * NumCoeff * NumOutputs) +
+      ARENA_ALIGN_UP(sizeof(float) * NumCoeff * NumCoeff) +
+      ARENA_ALIGN_UP(sizeof(float) * NumCoeff) +
+      ARENA_ALIGN_UP(sizeof(float) * NumOutputs);
+}
+
+
+int32_t RLS_MO_AttachWorkspace(void *Workspace, uint32_t NumCoeff,
+    uint32_t NumOutputs, float InitialCov, RLS_MO_t *Parameters)
+{
+  Arena_t arena;
+  uint32_t i;
+
+  if(Arena_InitWorkspace(&arena, Workspace,
+      RLS_MO_WorkspaceSize(NumCoeff, NumOutputs)) != ANSWERED_REQUEST){
+    return 0;
+  }
+  Parameters->SysCoeffs = Arena_Alloc(&arena,
+      sizeof(float) * NumCoeff * NumOutputs);
+  Parameters->Cov = Arena_Alloc(&arena, sizeof(float) * NumCoeff * NumCoeff);
+  Parameters->Gain = Arena_Alloc(&arena, sizeof(float) * NumCoeff);
+  Parameters->Error = Arena_Alloc(&arena, sizeof(float) * NumOutputs);
+  for(i = 0; i < NumCoeff; i++){
+    Parameters->Cov[i * NumCoeff + i] = InitialCov;
+  }
+  Parameters->NumCoeff = NumCoeff;
+  Parameters->NumOutputs = NumOutputs;
+  return 1;
+}
+
+
+size_t RLS_UD_WorkspaceSize(uint32_t NumCoeff)
+{
+  return 2 * ARENA_ALIGN_UP(sizeof(float) * NumCoeff) +
+      ARENA_ALIGN_UP(sizeof(float) * NumCoeff * (NumCoeff + 1) / 2);
+}
+
+
+int32_t RLS_UD_AttachWorkspace(void *Workspace, uint32_t NumCoeff,
+    float InitialCov, RLS_UD_t *Parameters)
+{
+  Arena_t arena;
+
+  if(Arena_InitWorkspace(&arena, Workspace,
+      RLS_UD_WorkspaceSize(NumCoeff)) != ANSWERED_REQUEST){
+    return 0;
+  }
+  Parameters->SysCoeffs = Arena_Alloc(&arena, sizeof(float) * NumCoeff);
+  Parameters->UD = Arena_Alloc(&arena,
+      sizeof(float) * NumCoeff * (NumCoeff + 1) / 2);
+  Parameters->Gain = Arena_Alloc(&arena, sizeof(float) * NumCoeff);
+  Parameters->Error = 0.0f;
+  Parameters->NumCoeff = NumCoeff;
+  RLS_UD_Init(InitialCov, Parameters);
+  return 1;
+}
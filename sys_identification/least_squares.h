@@ -19,14 +19,27 @@ extern "C" {
 
 
 #define LEAST_SQUARES_VER_MAJOR                                             2021
-#define LEAST_SQUARES_VER_MINOR                                                1
-#define LEAST_SQUARES_VER_PATCH                                                3
+#define LEAST_SQUARES_VER_MINOR                                                7
+#define LEAST_SQUARES_VER_PATCH                                                0
 #define LEAST_SQUARES_BRANCH_MASTER
 
 
+#include <stddef.h>
+#include "arena.h"
 #include "matrix_math.h"
 
 
+/**
+ * Factorization of X'X kept in LMS_t.SumXkiXji.
+ */
+typedef enum
+{
+  LMS_FACTOR_NONE = 0,     /*!< Not factorized, or the inputs changed */
+  LMS_FACTOR_CHOLESKY,     /*!< L * L' in the lower triangle */
+  LMS_FACTOR_LDL,          /*!< L * D * L', with Pivots when set */
+}LMS_Factor_t;
+
+
 /**
  * Structure used to operate LMS.
  */
@@ -34,29 +47,127 @@ typedef struct
 {
   float *SysCoeffs;    /*!< 1-D array of size NumCoeff */
   float *SumYiXji;     /*!< 1-D array of size NumCoeff */
-  float *SumXkiXji;    /*!< 2-D array of size NumSamples * NumCoeff
-                            float A[NumSamples * NumCoeff]
-                            float A[NumSamples][NumCoeff]*/
+  float *SumXkiXji;    /*!< 2-D array of size NumCoeff * NumCoeff
+                            float A[NumCoeff * NumCoeff]
+                            float A[NumCoeff][NumCoeff]*/
   uint32_t NumCoeff;   /*!< Number coefficients to discover */
   uint32_t NumSamples; /*!< Number of points */
+  LMS_Factor_t Factor; /*!< Factorization left in SumXkiXji by the last
+                            call, LMS_FACTOR_NONE after LMS_Init. Call
+                            LMS_Init when SysInputs change, so that
+                            LMS_ComputeMulti refactorizes */
+  int32_t *Pivots;     /*!< Optional 1-D array of size NumCoeff. When set,
+                            the LDL' fallback uses diagonal pivoting */
 }LMS_t;
 
 
+/**
+ * @brief Samples summed side by side by LMS_PolyCompute.
+ */
+#define LMS_POLY_LANES                                                         8
+
+
+/**
+ * @brief Number of doubles of LMS_Poly_t.Work for NumCoeff coefficients.
+ */
+#define LMS_POLY_WORK_SIZE(NumCoeff) \
+    ((3 * (NumCoeff) - 1) * LMS_POLY_LANES + (NumCoeff) * ((NumCoeff) + 1))
+
+
+/**
+ * Structure used to operate the polynomial LMS.
+ */
+typedef struct
+{
+  float  *SysCoeffs;   /*!< 1-D array of size NumCoeff, {a0, a1, ..., an}
+                            for y = a0 + a1*x + ... + an*x^n */
+  double *Work;        /*!< 1-D array of size LMS_POLY_WORK_SIZE(NumCoeff) */
+  uint32_t NumCoeff;   /*!< Polynomial degree + 1 */
+  uint32_t NumSamples; /*!< Number of points */
+}LMS_Poly_t;
+
+
+/**
+ * Structure used to operate the incremental (streaming) LMS.
+ */
+typedef struct
+{
+  float  *SysCoeffs;   /*!< 1-D array of size NumCoeff */
+  double *SumYiXji;    /*!< 1-D array of size NumCoeff */
+  double *SumXkiXji;   /*!< 2-D array of size NumCoeff * NumCoeff, only the
+                            lower triangle is accumulated */
+  float  *Work;        /*!< 1-D array of size NumCoeff * (NumCoeff + 1),
+                            scratch used by LMS_IncCompute */
+  uint32_t NumCoeff;   /*!< Number coefficients to discover */
+  uint32_t NumSamples; /*!< Number of samples currently accumulated */
+}LMS_Inc_t;
+
+
 /**
  * Structure used to operate RLS.
  */
 typedef struct
 {
   float *SysCoeffs;    /*!< 1-D array of size NumCoeff */
-  float *Cov;          /*!< 2-D array of size NumCoeff * NumCoeff */
+  float *Cov;          /*!< 2-D array of size NumCoeff * NumCoeff, only
+                            the upper triangle is kept up to date */
   float *Gain;         /*!< 1-D array of size NumCoeff */
-  float *Aux1;         /*!< 1-D array of size NumCoeff for intermediate vars */
-  float *Aux2;         /*!< size of Cov */
   float Error;
+  float Lambda;        /*!< Forgetting factor, 0 < Lambda <= 1. Zero is
+                            taken as 1 (infinite memory) */
   uint32_t NumCoeff;   /*!< Number coefficients to discover */
 }RLS_t;
 
 
+/**
+ * Structure used to operate the multi-output RLS: NumOutputs lines with
+ * the same inputs, sharing one covariance and gain.
+ */
+typedef struct
+{
+  float *SysCoeffs;    /*!< 2-D array of size NumOutputs * NumCoeff, the
+                            coefficients of output o in row o */
+  float *Cov;          /*!< 2-D array of size NumCoeff * NumCoeff, only
+                            the upper triangle is kept up to date */
+  float *Gain;         /*!< 1-D array of size NumCoeff */
+  float *Error;        /*!< 1-D array of size NumOutputs */
+  float Lambda;        /*!< Forgetting factor, 0 < Lambda <= 1. Zero is
+                            taken as 1 (infinite memory) */
+  uint32_t NumCoeff;   /*!< Number coefficients to discover per output */
+  uint32_t NumOutputs; /*!< Number of outputs */
+}RLS_MO_t;
+
+
+/**
+ * Structure used to operate the UD factorized (Bierman) RLS.
+ */
+typedef struct
+{
+  float *SysCoeffs;    /*!< 1-D array of size NumCoeff */
+  float *UD;           /*!< 1-D array of size NumCoeff * (NumCoeff + 1) / 2
+                            holding Cov = U * D * U' packed column by
+                            column: the strictly upper part of column j of
+                            the unit upper triangular U, followed by D[j] */
+  float *Gain;         /*!< 1-D array of size NumCoeff */
+  float Error;
+  float Lambda;        /*!< Forgetting factor, 0 < Lambda <= 1. Zero is
+                            taken as 1 (infinite memory) */
+  uint32_t NumCoeff;   /*!< Number coefficients to discover */
+}RLS_UD_t;
+
+
+/**
+ * @brief  Drops the factorization cached in SumXkiXji, so that the next
+ *         LMS_ComputeMulti accumulates and factorizes X'X again.
+ * @param  Parameters : Handle with all needed variables.
+ * @retval void
+ * @note   Call it once before the first LMS_ComputeMulti (Factor of a
+ *         structure declared without initializer is undefined), and every
+ *         time SysInputs or NumSamples change between calls.
+ */
+void LMS_Init(LMS_t *Parameters);
+
+
 /**
  * @brief  Uses the least mean squares algorithm to find the coefficients of
  *         a multidimensional line.
@@ -71,7 +182,8 @@ typedef struct
  *                   NumSamples is the number of points used, >= NumCoeff
  *         SysOutputs is a 1-D array of size NumSamples
  *                   can be defined as float y[NumSamples]
- *         The function returns 1 on success, 0 on failure.
+ *         The function returns 1 on success, 0 when X'X has numerical
+ *         rank 0 (e.g. every input is zero in every sample).
  *
  *         If there is a line of the form:
  *         y = a0 + a1*x1 + a2*x2 + ... + an*xn
@@ -87,10 +199,131 @@ typedef struct
  *         SysOutputs = {y1, y2, ..., yk},
  *         k = Parameters.NumSamples
  *         NumSamples must be equal to or bigger than NumCoeff.
+ *
+ *         The normal equations (X'X) * A = X'Y are solved through the
+ *         Cholesky factorization of X'X, which is left in SumXkiXji. If
+ *         X'X is not numerically positive definite, a LDL' factorization
+ *         is used instead and coefficients along singular directions are
+ *         set to zero (e.g. y = 5*x^2 fitted with {1, x, x^2} where the
+ *         first two inputs are always zero gives {0, 0, 5}).
  */
 int32_t LMS_Compute(float* SysInputs, float *SysOutputs, LMS_t *Parameters);
 
 
+/**
+ * @brief  Same as LMS_Compute, reading the samples in place through views.
+ * @param  SysInputs : View of NumSamples rows and NumCoeff columns.
+ * @param  SysOutputs : View of NumSamples rows and 1 column.
+ * @param  Parameters : Handle with all needed variables.
+ * @retval int32_t
+ * @note   Lets a fit run over a window of a sample log without copying
+ *         it, e.g. with log rows {1, x1, x2, y}, SysInputs covers the
+ *         first three columns and SysOutputs the last one, both with the
+ *         log row size as Stride. The window must be contiguous: a ring
+ *         buffer whose window wraps around can be written twice (at i and
+ *         i + Capacity) so every window is a plain view.
+ *         The function returns 1 on success, 0 on failure (also when the
+ *         view sizes do not match NumSamples and NumCoeff).
+ */
+int32_t LMS_ComputeView(MatrixView_t *SysInputs, MatrixView_t *SysOutputs,
+    LMS_t *Parameters);
+
+
+/**
+ * @brief  Same as LMS_Compute for several outputs of the same inputs,
+ *         solved from one factorization of X'X.
+ * @param  SysInputs : 2-D array of size NumSamples * NumCoeff.
+ * @param  SysOutputs : 2-D array of size NumSamples * NumOutputs, the
+ *                      samples of output o in column o.
+ * @param  NumOutputs : Number of outputs.
+ * @param  SysCoeffs : 2-D array of size NumCoeff * NumOutputs, receives
+ *                     the coefficients of output o in column o.
+ * @param  Parameters : Handle with all needed variables.
+ * @retval int32_t
+ * @note   X'X is accumulated and factorized only when Factor is
+ *         LMS_FACTOR_NONE (see LMS_Init); otherwise the factorization left
+ *         in SumXkiXji by a previous LMS_Compute or LMS_ComputeMulti over
+ *         the same SysInputs is reused. Each call then only costs X'Y and two
+ *         triangular solves with NumOutputs right-hand sides.
+ *         Parameters->SysCoeffs is not changed, Parameters->SumYiXji is
+ *         used as scratch.
+ *         The function returns 1 on success, 0 on failure (also when
+ *         NumOutputs is 0).
+ */
+int32_t LMS_ComputeMulti(float *SysInputs, float *SysOutputs,
+    uint32_t NumOutputs, float *SysCoeffs, LMS_t *Parameters);
+
+
+/**
+ * @brief  Fits a polynomial y = a0 + a1*x + ... + an*x^n to raw samples.
+ * @param  x : 1-D array of size NumSamples.
+ * @param  y : 1-D array of size NumSamples.
+ * @param  Parameters : Handle with all needed variables.
+ * @retval int32_t
+ * @note   Same fit as LMS_Compute with SysInputs rows {1, x, x^2, ...},
+ *         without building them: X'X of a polynomial is a Hankel matrix
+ *         holding the 2 * NumCoeff - 1 power sums of x, which are taken
+ *         in one pass over the samples together with the sums of y * x^j.
+ *         x is first mapped to [-1, 1] and the sums are kept in double,
+ *         so the system stays far better conditioned than the raw one.
+ *         It is solved by Cholesky in double, and the result is mapped
+ *         back to powers of x. As with LMS_Compute, coefficients along
+ *         directions the samples can not tell apart (fewer distinct x
+ *         than NumCoeff) are set to zero.
+ *         The function returns 1 on success, 0 on failure.
+ */
+int32_t LMS_PolyCompute(float *x, float *y, LMS_Poly_t *Parameters);
+
+
+/**
+ * @brief  Clears the sums accumulated by the incremental LMS.
+ * @param  Parameters : Handle with all needed variables.
+ * @retval void
+ */
+void LMS_IncReset(LMS_Inc_t *Parameters);
+
+
+/**
+ * @brief  Adds one sample to the sums of the incremental LMS.
+ * @param  SysInputs : Values applied on the input of the line equation
+ *                     (1-D array of size NumCoeff).
+ * @param  SysOutput : Line equation response to applied SysInputs.
+ * @param  Parameters : Handle with all needed variables.
+ * @retval void
+ * @note   Costs NumCoeff * (NumCoeff + 3) / 2 multiply-adds, regardless of
+ *         the number of samples already accumulated.
+ */
+void LMS_IncAdd(float *SysInputs, float SysOutput, LMS_Inc_t *Parameters);
+
+
+/**
+ * @brief  Removes one previously added sample from the sums of the
+ *         incremental LMS.
+ * @param  SysInputs : Values passed to LMS_IncAdd for this sample.
+ * @param  SysOutput : Value passed to LMS_IncAdd for this sample.
+ * @param  Parameters : Handle with all needed variables.
+ * @retval void
+ * @note   Combined with LMS_IncAdd, implements a sliding window: add the
+ *         newest sample and remove the one that left the window. The sums
+ *         are kept in double precision so that long add/remove sequences
+ *         do not drift.
+ */
+void LMS_IncRemove(float *SysInputs, float SysOutput,
+    LMS_Inc_t *Parameters);
+
+
+/**
+ * @brief  Solves the normal equations for the samples accumulated so far
+ *         and stores the result in SysCoeffs.
+ * @param  Parameters : Handle with all needed variables.
+ * @retval int32_t
+ * @note   Same result as LMS_Compute over the accumulated samples, without
+ *         going through them again. Work receives the factorization.
+ *         The function returns 1 on success, 0 on failure.
+ */
+int32_t LMS_IncCompute(LMS_Inc_t *Parameters);
+
+
 /**
  * @brief  Uses the recursive least squares algorithm to find the coefficients
  *         of a multidimensional line.
@@ -102,9 +335,203 @@ int32_t LMS_Compute(float* SysInputs, float *SysOutputs, LMS_t *Parameters);
  *         SysInputs and SysOutput, until an stop condition tested by the
  *         caller is satisfied (Parameters->Error sufficiently small or other
  *         desired condition)
+ *         Cov must be initialized with a symmetric matrix. Since it stays
+ *         symmetric, the update reads and writes only its upper triangle,
+ *         in place. Call RLS_MirrorCov before reading the lower triangle.
+ *
+ *         With a forgetting factor Lambda < 1, past samples are weighted
+ *         by Lambda^age, so Cov does not collapse over long runs:
+ *         k = cov*X/(Lambda + X'*cov*X)
+ *         p = (p - k*X'*p)/Lambda
  */
 int32_t RLS_Compute(float *SysInputs, float SysOutput, RLS_t *Parameters);
 
+
+/**
+ * @brief  Recursive least squares for several outputs driven by the same
+ *         inputs (e.g. a MIMO plant or sensors sharing one excitation).
+ * @param  SysInputs : Values applied on the input of the line equations
+ *                     (1-D array of size NumCoeff).
+ * @param  SysOutputs : Response of each line equation to SysInputs
+ *                      (1-D array of size NumOutputs).
+ * @param  Parameters : Handle with all needed variables.
+ * @retval int32_t
+ * @note   Gain and Cov only depend on the inputs, so they are updated once
+ *         per sample and shared by every output: the cost is
+ *         O(NumCoeff^2 + NumOutputs * NumCoeff) instead of NumOutputs
+ *         times RLS_Compute. Row o of SysCoeffs gets the same estimate as
+ *         a RLS_t fed with SysOutputs[o] and the same initial Cov.
+ *         After the call Gain holds k = cov*X/(Lambda + X'*cov*X) and
+ *         Error the a priori error of each output.
+ *         The function returns 1 on success.
+ */
+int32_t RLS_MO_Compute(float *SysInputs, float *SysOutputs,
+    RLS_MO_t *Parameters);
+
+
+/**
+ * @brief  Copies the upper triangle of the RLS covariance matrix into its
+ *         lower triangle.
+ * @param  Parameters : Handle with all needed variables.
+ * @retval void
+ */
+void RLS_MirrorCov(RLS_t *Parameters);
+
+
+/**
+ * @brief  Initializes the UD factors with Cov = InitialCov * I.
+ * @param  InitialCov : Initial variance of every coefficient.
+ * @param  Parameters : Handle with all needed variables.
+ * @retval void
+ * @note   SysCoeffs are not changed, so they may hold an initial guess.
+ */
+void RLS_UD_Init(float InitialCov, RLS_UD_t *Parameters);
+
+
+/**
+ * @brief  Uses the UD factorized recursive least squares algorithm (Bierman)
+ *         to find the coefficients of a multidimensional line.
+ * @param  SysInput : Values applied on the input of the line equation.
+ * @param  SysOutput : Line equation response to applied SysInput.
+ * @param  Parameters : Handle with all needed variables.
+ * @retval int32_t
+ * @note   Same use as RLS_Compute. The covariance is propagated as
+ *         Cov = U * D * U', with U unit upper triangular and D diagonal,
+ *         which keeps it symmetric and positive definite by construction:
+ *         no symmetrization or reset is ever required. It takes half the
+ *         memory of Cov and about the same number of operations as
+ *         RLS_Compute.
+ */
+int32_t RLS_UD_Compute(float *SysInputs, float SysOutput,
+    RLS_UD_t *Parameters);
+
+
+/**
+ * @brief  Rebuilds the full covariance matrix from the UD factors.
+ * @param  Parameters : Handle with all needed variables.
+ * @param  Cov : 2-D array of size NumCoeff * NumCoeff, receives U*D*U'.
+ * @retval void
+ */
+void RLS_UD_GetCov(RLS_UD_t *Parameters, float *Cov);
+
+/**
+ * @brief  Returns the bytes of workspace needed by LMS_AttachWorkspace.
+ * @param  NumCoeff : Number coefficients to discover.
+ * @retval size_t : A multiple of ARENA_ALIGN.
+ */
+size_t LMS_WorkspaceSize(uint32_t NumCoeff);
+
+
+/**
+ * @brief  Points every buffer of a LMS_t into one workspace and clears it.
+ * @param  Workspace : ARENA_ALIGN aligned memory of
+ *                     LMS_WorkspaceSize(NumCoeff) bytes, e.g. carved from
+ *                     an Arena_t (arena.h).
+ * @param  NumCoeff : Number coefficients to discover.
+ * @param  NumSamples : Number of points.
+ * @param  Parameters : Handle to set up (Pivots included).
+ * @retval int32_t
+ * @note   Each buffer starts on a ARENA_ALIGN boundary.
+ *         The function returns 1 on success, 0 if Workspace is NULL or
+ *         not aligned.
+ */
+int32_t LMS_AttachWorkspace(void *Workspace, uint32_t NumCoeff,
+    uint32_t NumSamples, LMS_t *Parameters);
+
+
+/**
+ * @brief  Returns the bytes of workspace needed by LMS_IncAttachWorkspace.
+ * @param  NumCoeff : Number coefficients to discover.
+ * @retval size_t : A multiple of ARENA_ALIGN.
+ */
+size_t LMS_IncWorkspaceSize(uint32_t NumCoeff);
+
+
+/**
+ * @brief  Points every buffer of a LMS_Inc_t into one workspace and clears
+ *         it, see LMS_AttachWorkspace.
+ * @retval int32_t
+ * @note   The sums start empty, as after LMS_IncReset.
+ */
+int32_t LMS_IncAttachWorkspace(void *Workspace, uint32_t NumCoeff,
+    LMS_Inc_t *Parameters);
+
+
+/**
+ * @brief  Returns the bytes of workspace needed by LMS_PolyAttachWorkspace.
+ * @param  NumCoeff : Polynomial degree + 1.
+ * @retval size_t : A multiple of ARENA_ALIGN.
+ */
+size_t LMS_PolyWorkspaceSize(uint32_t NumCoeff);
+
+
+/**
+ * @brief  Points every buffer of a LMS_Poly_t into one workspace and
+ *         clears it, see LMS_AttachWorkspace.
+ * @retval int32_t
+ */
+int32_t LMS_PolyAttachWorkspace(void *Workspace, uint32_t NumCoeff,
+    uint32_t NumSamples, LMS_Poly_t *Parameters);
+
+
+/**
+ * @brief  Returns the bytes of workspace needed by RLS_AttachWorkspace.
+ * @param  NumCoeff : Number coefficients to discover.
+ * @retval size_t : A multiple of ARENA_ALIGN.
+ */
+size_t RLS_WorkspaceSize(uint32_t NumCoeff);
+
+
+/**
+ * @brief  Points every buffer of a RLS_t into one workspace and starts the
+ *         filter: zero coefficients and Cov = InitialCov * I.
+ * @param  Workspace : ARENA_ALIGN aligned memory of
+ *                     RLS_WorkspaceSize(NumCoeff) bytes.
+ * @param  NumCoeff : Number coefficients to discover.
+ * @param  InitialCov : Initial variance of every coefficient.
+ * @param  Parameters : Handle to set up. Lambda is not changed.
+ * @retval int32_t
+ * @note   The function returns 1 on success, 0 if Workspace is NULL or
+ *         not aligned.
+ */
+int32_t RLS_AttachWorkspace(void *Workspace, uint32_t NumCoeff,
+    float InitialCov, RLS_t *Parameters);
+
+
+/**
+ * @brief  Returns the bytes of workspace needed by RLS_MO_AttachWorkspace.
+ * @param  NumCoeff : Number coefficients to discover per output.
+ * @param  NumOutputs : Number of outputs.
+ * @retval size_t : A multiple of ARENA_ALIGN.
+ */
+size_t RLS_MO_WorkspaceSize(uint32_t NumCoeff, uint32_t NumOutputs);
+
+
+/**
+ * @brief  Points every buffer of a RLS_MO_t into one workspace and starts
+ *         the filter, see RLS_AttachWorkspace.
+ * @retval int32_t
+ */
+int32_t RLS_MO_AttachWorkspace(void *Workspace, uint32_t NumCoeff,
+    uint32_t NumOutputs, float InitialCov, RLS_MO_t *Parameters);
+
+
+/**
+ * @brief  Returns the bytes of workspace needed by RLS_UD_AttachWorkspace.
+ * @param  NumCoeff : Number coefficients to discover.
+ * @retval size_t : A multiple of ARENA_ALIGN.
+ */
+size_t RLS_UD_WorkspaceSize(uint32_t NumCoeff);
+
+
+/**
+ * @brief  Points every buffer of a RLS_UD_t into one workspace and starts
+ *         the filter (RLS_UD_Init), see RLS_AttachWorkspace.
+ * @retval int32_t
+ */
+int32_t RLS_UD_AttachWorkspace(void *Workspace, uint32_t NumCoeff,
+    float InitialCov, RLS_UD_t *Parameters);
+
 #endif /* LEAST_SQUARES_H */
 
 
@@ -0,0 +1,109 @@
+/**
+ * @file  least_squares.hpp
+ * @date  18-October-2026
+ * @brief Recursive least squares with the number of coefficients fixed at
+ *        compile time (C++).
+ *
+ *   Header-only counterpart of RLS_Compute built on matrix_fixed.hpp. With
+ *   N known by the compiler, the whole update is unrolled and the small
+ *   covariance matrix can live in registers.
+ *
+ * @author
+ * @author
+ */
+
+
+#ifndef LEAST_SQUARES_HPP
+#define LEAST_SQUARES_HPP
+
+
+#define LEAST_SQUARES_HPP_VER_MAJOR                                         2026
+#define LEAST_SQUARES_HPP_VER_MINOR                                           10
+#define LEAST_SQUARES_HPP_VER_PATCH                                            1
+#define LEAST_SQUARES_HPP_BRANCH_MASTER
+
+
+#include "matrix_fixed.hpp"
+
+
+namespace sys_identification {
+
+
+/**
+ * @brief Recursive least squares over N coefficients.
+ */
+template<size_t N, typename T = float>
+class RLS
+{
+public:
+  linear_algebra::Vector<T, N> SysCoeffs;
+  linear_algebra::Matrix<T, N, N> Cov;   /*!< Kept symmetric, both halves */
+  linear_algebra::Vector<T, N> Gain;
+  T Error;
+  T Lambda;        /*!< Forgetting factor, 0 < Lambda <= 1 */
+
+  /**
+   * @brief  Zeroes the coefficients and sets Cov = InitialCov * I.
+   * @param  InitialCov : Initial variance of every coefficient.
+   * @param  ForgettingFactor : Value of Lambda.
+   */
+  void Init(T InitialCov, T ForgettingFactor = T(1))
+  {
+    SysCoeffs = linear_algebra::Vector<T, N>::Zero();
+    Cov = linear_algebra::Matrix<T, N, N>::Identity() * InitialCov;
+    Gain = linear_algebra::Vector<T, N>::Zero();
+    Error = T(0);
+    Lambda = ForgettingFactor;
+  }
+
+  /**
+   * @brief  Same update as RLS_Compute.
+   * @param  SysInputs : Values applied on the input of the line equation.
+   * @param  SysOutput : Line equation response to applied SysInputs.
+   */
+  void Compute(const linear_algebra::Vector<T, N> &SysInputs, T SysOutput)
+  {
+    const T lambda = (Lambda > T(0)) ? Lambda : T(1);
+    const T scale = T(1) / lambda;
+    T alpha, gi, v;
+
+    /* erro = y - coeffs'*X */
+    Error = SysOutput - linear_algebra::Dot(SysCoeffs, SysInputs);
+
+    /* g = cov*X, k = g/(lambda + X'*g) */
+    Gain = Cov * SysInputs;
+    alpha = T(1) / (lambda + linear_algebra::Dot(Gain, SysInputs));
+
+    /* p = (p - g*g'/(lambda + X'*g))/lambda, mirrored to stay symmetric */
+    MATRIX_FIXED_UNROLL
+    for(size_t i = 0; i < N; i++){
+      gi = Gain[i] * alpha;
+      MATRIX_FIXED_UNROLL
+      for(size_t j = i; j < N; j++){
+        v = (Cov(i, j) - gi * Gain[j]) * scale;
+        Cov(i, j) = v;
+        Cov(j, i) = v;
+      }
+    }
+
+    /* coeffs = coeffs + k*erro */
+    SysCoeffs += Gain * (alpha * Error);
+  }
+
+  /**
+   * @brief  Same as above, with the inputs in a plain array of size N.
+   */
+  void Compute(const T *SysInputs, T SysOutput)
+  {
+    linear_algebra::Vector<T, N> x;
+    MATRIX_FIXED_UNROLL
+    for(size_t k = 0; k < N; k++){
+      x[k] = SysInputs[k];
+    }
+    Compute(x, SysOutput);
+  }
+};
+
+} /* namespace sys_identification */
+
+#endif /* LEAST_SQUARES_HPP */
@@ -0,0 +1,433 @@
+#include "rls_bank.h"
+
+#ifdef RLS_BANK_SIMD_X86
+#include <immintrin.h>
+#define SIMD_TARGET(ISA) __attribute__((target(ISA)))
+#endif
+
+
+/* Every pass runs the same operations in the same order, one filter per */
+/*  lane:                                                                */
+/*  erro = y - coeffs'*X                                                 */
+/*  g = cov*X, each element of the packed upper triangle read once       */
+/*  a = 1/(lambda + X'*g)                                                */
+/*  p = (p - g*a*g')/lambda                                              */
+/*  k = g*a*erro, coeffs = coeffs + k                                    */
+
+/**
+ * @brief  Distance between two elements of a filter.
+ */
+static uint32_t RLS_BankStride(RLS_Bank_t *Bank)
+{
+  return (Bank->Stride != 0) ? Bank->Stride : Bank->NumFilters;
+}
+
+
+typedef void (*RLS_BankPass_t)(float *SysInputs, float *SysOutputs,
+    uint32_t Begin, uint32_t End, RLS_Bank_t *Bank);
+
+
+static void RLS_BankPassScalar(float *SysInputs, float *SysOutputs,
+    uint32_t Begin, uint32_t End, RLS_Bank_t *Bank)
+{
+  uint32_t n = Bank->NumCoeff;
+  uint32_t st = RLS_BankStride(Bank);
+  uint32_t f, i, j;
+  float *x, *c, *g, *p;
+  float s, err, xi, gi, a, lambda, invLambda;
+
+  for(f = Begin; f < End; f++){
+    x = SysInputs + f;
+    c = Bank->SysCoeffs + f;
+    g = Bank->Gain + f;
+
+    s = 0.0f;
+    for(i = 0; i < n; i++){
+      s += c[i*st] * x[i*st];
+    }
+    err = SysOutputs[f] - s;
+
+    for(i = 0; i < n; i++){
+      g[i*st] = 0.0f;
+    }
+    p = Bank->Cov + f;
+    for(i = 0; i < n; i++){
+      xi = x[i*st];
+      gi = g[i*st] + p[0] * xi;
+      p += st;
+      for(j = i + 1; j < n; j++){
+        gi += p[0] * x[j*st];
+        g[j*st] += p[0] * xi;
+        p += st;
+      }
+      g[i*st] = gi;
+    }
+
+    s = 0.0f;
+    for(i = 0; i < n; i++){
+      s += g[i*st] * x[i*st];
+    }
+    lambda = (Bank->Lambda[f] > 0.0f) ? Bank->Lambda[f] : 1.0f;
+    a = 1.0f / (lambda + s);
+    invLambda = 1.0f / lambda;
+
+    p = Bank->Cov + f;
+    for(i = 0; i < n; i++){
+      gi = g[i*st] * a;
+      for(j = i; j < n; j++){
+        p[0] = (p[0] - gi * g[j*st]) * invLambda;
+        p += st;
+      }
+    }
+
+    Bank->Error[f] = err;
+    a = a * err;
+    for(i = 0; i < n; i++){
+      g[i*st] = g[i*st] * a;
+      c[i*st] += g[i*st];
+    }
+  }
+}
+
+
+#ifdef RLS_BANK_SIMD_X86
+
+SIMD_TARGET("sse2")
+static void RLS_BankPassSse2(float *SysInputs, float *SysOutputs,
+    uint32_t Begin, uint32_t End, RLS_Bank_t *Bank)
+{
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  uint32_t n = Bank->NumCoeff;
+  uint32_t st = RLS_BankStride(Bank);
+  uint32_t f = Begin;
+  uint32_t i, j;
+  float *x, *c, *g, *p;
+  __m128 s, err, xi, gi, pij, a, lambda, invLambda, valid;
+
+  for(; f + 4 <= End; f += 4){
+    x = SysInputs + f;
+    c = Bank->SysCoeffs + f;
+    g = Bank->Gain + f;
+
+    s = zero;
+    for(i = 0; i < n; i++){
+      s = _mm_add_ps(s, _mm_mul_ps(_mm_loadu_ps(c + i*st),
+          _mm_loadu_ps(x + i*st)));
+    }
+    err = _mm_sub_ps(_mm_loadu_ps(SysOutputs + f), s);
+
+    for(i = 0; i < n; i++){
+      _mm_storeu_ps(g + i*st, zero);
+    }
+    p = Bank->Cov + f;
+    for(i = 0; i < n; i++){
+      xi = _mm_loadu_ps(x + i*st);
+      gi = _mm_add_ps(_mm_loadu_ps(g + i*st), _mm_mul_ps(_mm_loadu_ps(p), xi));
+      p += st;
+      for(j = i + 1; j < n; j++){
+        pij = _mm_loadu_ps(p);
+        gi = _mm_add_ps(gi, _mm_mul_ps(pij, _mm_loadu_ps(x + j*st)));
+        _mm_storeu_ps(g + j*st,
+            _mm_add_ps(_mm_loadu_ps(g + j*st), _mm_mul_ps(pij, xi)));
+        p += st;
+      }
+      _mm_storeu_ps(g + i*st, gi);
+    }
+
+    s = zero;
+    for(i = 0; i < n; i++){
+      s = _mm_add_ps(s, _mm_mul_ps(_mm_loadu_ps(g + i*st),
+          _mm_loadu_ps(x + i*st)));
+    }
+    lambda = _mm_loadu_ps(Bank->Lambda + f);
+    valid = _mm_cmpgt_ps(lambda, zero);
+    lambda = _mm_or_ps(_mm_and_ps(valid, lambda), _mm_andnot_ps(valid, one));
+    a = _mm_div_ps(one, _mm_add_ps(lambda, s));
+    invLambda = _mm_div_ps(one, lambda);
+
+    p = Bank->Cov + f;
+    for(i = 0; i < n; i++){
+      gi = _mm_mul_ps(_mm_loadu_ps(g + i*st), a);
+      for(j = i; j < n; j++){
+        _mm_storeu_ps(p, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p),
+            _mm_mul_ps(gi, _mm_loadu_ps(g + j*st))), invLambda));
+        p += st;
+      }
+    }
+
+    _mm_storeu_ps(Bank->Error + f, err);
+    a = _mm_mul_ps(a, err);
+    for(i = 0; i < n; i++){
+      gi = _mm_mul_ps(_mm_loadu_ps(g + i*st), a);
+      _mm_storeu_ps(g + i*st, gi);
+      _mm_storeu_ps(c + i*st, _mm_add_ps(_mm_loadu_ps(c + i*st), gi));
+    }
+  }
+  RLS_BankPassScalar(SysInputs, SysOutputs, f, End, Bank);
+}
+
+
+SIMD_TARGET("avx2")
+static void RLS_BankPassAvx2(float *SysInputs, float *SysOutputs,
+    uint32_t Begin, uint32_t End, RLS_Bank_t *Bank)
+{
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 one = _mm256_set1_ps(1.0f);
+  uint32_t n = Bank->NumCoeff;
+  uint32_t st = RLS_BankStride(Bank);
+  uint32_t f = Begin;
+  uint32_t i, j;
+  float *x, *c, *g, *p;
+  __m256 s, err, xi, gi, pij, a, lambda, invLambda;
+
+  for(; f + 8 <= End; f += 8){
+    x = SysInputs + f;
+    c = Bank->SysCoeffs + f;
+    g = Bank->Gain + f;
+
+    s = zero;
+    for(i = 0; i < n; i++){
+      s = _mm256_add_ps(s, _mm256_mul_ps(_mm256_loadu_ps(c + i*st),
+          _mm256_loadu_ps(x + i*st)));
+    }
+    err = _mm256_sub_ps(_mm256_loadu_ps(SysOutputs + f), s);
+
+    for(i = 0; i < n; i++){
+      _mm256_storeu_ps(g + i*st, zero);
+    }
+    p = Bank->Cov + f;
+    for(i = 0; i < n; i++){
+      xi = _mm256_loadu_ps(x + i*st);
+      gi = _mm256_add_ps(_mm256_loadu_ps(g + i*st),
+          _mm256_mul_ps(_mm256_loadu_ps(p), xi));
+      p += st;
+      for(j = i + 1; j < n; j++){
+        pij = _mm256_loadu_ps(p);
+        gi = _mm256_add_ps(gi, _mm256_mul_ps(pij, _mm256_loadu_ps(x + j*st)));
+        _mm256_storeu_ps(g + j*st, _mm256_add_ps(_mm256_loadu_ps(g + j*st),
+            _mm256_mul_ps(pij, xi)));
+        p += st;
+      }
+      _mm256_storeu_ps(g + i*st, gi);
+    }
+
+    s = zero;
+    for(i = 0; i < n; i++){
+      s = _mm256_add_ps(s, _mm256_mul_ps(_mm256_loadu_ps(g + i*st),
+          _mm256_loadu_ps(x + i*st)));
+    }
+    lambda = _mm256_loadu_ps(Bank->Lambda + f);
+    lambda = _mm256_blendv_ps(one, lambda,
+        _mm256_cmp_ps(lambda, zero, _CMP_GT_OQ));
+    a = _mm256_div_ps(one, _mm256_add_ps(lambda, s));
+    invLambda = _mm256_div_ps(one, lambda);
+
+    p = Bank->Cov + f;
+    for(i = 0; i < n; i++){
+      gi = _mm256_mul_ps(_mm256_loadu_ps(g + i*st), a);
+      for(j = i; j < n; j++){
+        _mm256_storeu_ps(p, _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(p),
+            _mm256_mul_ps(gi, _mm256_loadu_ps(g + j*st))), invLambda));
+        p += st;
+      }
+    }
+
+    _mm256_storeu_ps(Bank->Error + f, err);
+    a = _mm256_mul_ps(a, err);
+    for(i = 0; i < n; i++){
+      gi = _mm256_mul_ps(_mm256_loadu_ps(g + i*st), a);
+      _mm256_storeu_ps(g + i*st, gi);
+      _mm256_storeu_ps(c + i*st, _mm256_add_ps(_mm256_loadu_ps(c + i*st), gi));
+    }
+  }
+  RLS_BankPassSse2(SysInputs, SysOutputs, f, End, Bank);
+}
+
+
+SIMD_TARGET("avx512f") MATRIX_SIMD_NO_CONTRACT
+static void RLS_BankPassAvx512(float *SysInputs, float *SysOutputs,
+    uint32_t Begin, uint32_t End, RLS_Bank_t *Bank)
+{
+  const __m512 zero = _mm512_setzero_ps();
+  const __m512 one = _mm512_set1_ps(1.0f);
+  uint32_t n = Bank->NumCoeff;
+  uint32_t st = RLS_BankStride(Bank);
+  uint32_t f = Begin;
+  uint32_t i, j;
+  float *x, *c, *g, *p;
+  __m512 s, err, xi, gi, pij, a, lambda, invLambda;
+
+  for(; f + 16 <= End; f += 16){
+    x = SysInputs + f;
+    c = Bank->SysCoeffs + f;
+    g = Bank->Gain + f;
+
+    s = zero;
+    for(i = 0; i < n; i++){
+      s = _mm512_add_ps(s, _mm512_mul_ps(_mm512_loadu_ps(c + i*st),
+          _mm512_loadu_ps(x + i*st)));
+    }
+    err = _mm512_sub_ps(_mm512_loadu_ps(SysOutputs + f), s);
+
+    for(i = 0; i < n; i++){
+      _mm512_storeu_ps(g + i*st, zero);
+    }
+    p = Bank->Cov + f;
+    for(i = 0; i < n; i++){
+      xi = _mm512_loadu_ps(x + i*st);
+      gi = _mm512_add_ps(_mm512_loadu_ps(g + i*st),
+          _mm512_mul_ps(_mm512_loadu_ps(p), xi));
+      p += st;
+      for(j = i + 1; j < n; j++){
+        pij = _mm512_loadu_ps(p);
+        gi = _mm512_add_ps(gi, _mm512_mul_ps(pij, _mm512_loadu_ps(x + j*st)));
+        _mm512_storeu_ps(g + j*st, _mm512_add_ps(_mm512_loadu_ps(g + j*st),
+            _mm512_mul_ps(pij, xi)));
+        p += st;
+      }
+      _mm512_storeu_ps(g + i*st, gi);
+    }
+
+    s = zero;
+    for(i = 0; i < n; i++){
+      s = _mm512_add_ps(s, _mm512_mul_ps(_mm512_loadu_ps(g + i*st),
+          _mm512_loadu_ps(x + i*st)));
+    }
+    lambda = _mm512_loadu_ps(Bank->Lambda + f);
+    lambda = _mm512_mask_blend_ps(
+        _mm512_cmp_ps_mask(lambda, zero, _CMP_GT_OQ), one, lambda);
+    a = _mm512_div_ps(one, _mm512_add_ps(lambda, s));
+    invLambda = _mm512_div_ps(one, lambda);
+
+    p = Bank->Cov + f;
+    for(i = 0; i < n; i++){
+      gi = _mm512_mul_ps(_mm512_loadu_ps(g + i*st), a);
+      for(j = i; j < n; j++){
+        _mm512_storeu_ps(p, _mm512_mul_ps(_mm512_sub_ps(_mm512_loadu_ps(p),
+            _mm512_mul_ps(gi, _mm512_loadu_ps(g + j*st))), invLambda));
+        p += st;
+      }
+    }
+
+    _mm512_storeu_ps(Bank->Error + f, err);
+    a = _mm512_mul_ps(a, err);
+    for(i = 0; i < n; i++){
+      gi = _mm512_mul_ps(_mm512_loadu_ps(g + i*st), a);
+      _mm512_storeu_ps(g + i*st, gi);
+      _mm512_storeu_ps(c + i*st, _mm512_add_ps(_mm512_loadu_ps(c + i*st), gi));
+    }
+  }
+  RLS_BankPassSse2(SysInputs, SysOutputs, f, End, Bank);
+}
+
+#endif /* RLS_BANK_SIMD_X86 */
+
+
+static const RLS_BankPass_t passes[MATRIX_SIMD_NUMBER_OF_LEVELS] = {
+    [MATRIX_SIMD_SCALAR] = RLS_BankPassScalar,
+#ifdef RLS_BANK_SIMD_X86
+    [MATRIX_SIMD_SSE2] = RLS_BankPassSse2,
+    [MATRIX_SIMD_AVX2] = RLS_BankPassAvx2,
+    [MATRIX_SIMD_AVX512] = RLS_BankPassAvx512,
+#endif
+};
+
+
+void RLS_BankInit(float InitialCov, RLS_Bank_t *Bank)
+{
+  uint32_t i, j, f;
+  uint32_t st = RLS_BankStride(Bank);
+  float *p = Bank->Cov;
+
+  for(i = 0; i < Bank->NumCoeff; i++){
+    for(j = i; j < Bank->NumCoeff; j++){
+      for(f = 0; f < Bank->NumFilters; f++){
+        p[f] = (i == j) ? InitialCov : 0.0f;
+      }
+      p += st;
+    }
+  }
+}
+
+
+void RLS_BankLoad(uint32_t Index, RLS_t *Rls, RLS_Bank_t *Bank)
+{
+  uint32_t i, j;
+  uint32_t n = Bank->NumCoeff;
+  uint32_t st = RLS_BankStride(Bank);
+  float *p = Bank->Cov + Index;
+
+  for(i = 0; i < n; i++){
+    Bank->SysCoeffs[i*st + Index] = Rls->SysCoeffs[i];
+    Bank->Gain[i*st + Index] = Rls->Gain[i];
+    for(j = i; j < n; j++){
+      *p = Rls->Cov[i*n + j];
+      p += st;
+    }
+  }
+  Bank->Error[Index] = Rls->Error;
+  Bank->Lambda[Index] = Rls->Lambda;
+}
+
+
+void RLS_BankStore(uint32_t Index, RLS_t *Rls, RLS_Bank_t *Bank)
+{
+  uint32_t i, j;
+  uint32_t n = Bank->NumCoeff;
+  uint32_t st = RLS_BankStride(Bank);
+  float *p = Bank->Cov + Index;
+
+  for(i = 0; i < n; i++){
+    Rls->SysCoeffs[i] = Bank->SysCoeffs[i*st + Index];
+    Rls->Gain[i] = Bank->Gain[i*st + Index];
+    for(j = i; j < n; j++){
+      Rls->Cov[i*n + j] = *p;
+      Rls->Cov[j*n + i] = *p;
+      p += st;
+    }
+  }
+  Rls->Error = Bank->Error[Index];
+  Rls->Lambda = Bank->Lambda[Index];
+}
+
+
+void RLS_BankCompute(float *SysInputs, float *SysOutputs, RLS_Bank_t *Bank)
+{
+  MATRIX_SIMD_SELECT(passes)(SysInputs, SysOutputs, 0, Bank->NumFilters,
+      Bank);
+}
+
+
+size_t RLS_BankWorkspaceSize(uint32_t NumCoeff, uint32_t NumFilters)
+{
+  size_t st = RLS_BANK_STRIDE(NumFilters);
+
+  return 2 * ARENA_ALIGN_UP(sizeof(float) * NumCoeff * st) +
+      ARENA_ALIGN_UP(sizeof(float) * RLS_BANK_COV_SIZE(NumCoeff, st)) +
+      2 * ARENA_ALIGN_UP(sizeof(float) * NumFilters);
+}
+
+
+int32_t RLS_BankAttachWorkspace(void *Workspace, uint32_t NumCoeff,
+    uint32_t NumFilters, float InitialCov, RLS_Bank_t *Bank)
+{
+  Arena_t arena;
+  size_t st = RLS_BANK_STRIDE(NumFilters);
+
+  if(Arena_InitWorkspace(&arena, Workspace,
+      RLS_BankWorkspaceSize(NumCoeff, NumFilters)) != ANSWERED_REQUEST){
+    return 0;
+  }
+  Bank->SysCoeffs = Arena_Alloc(&arena, sizeof(float) * NumCoeff * st);
+  Bank->Cov = Arena_Alloc(&arena,
+      sizeof(float) * RLS_BANK_COV_SIZE(NumCoeff, st));
+  Bank->Gain = Arena_Alloc(&arena, sizeof(float) * NumCoeff * st);
+  Bank->Error = Arena_Alloc(&arena, sizeof(float) * NumFilters);
+  Bank->Lambda = Arena_Alloc(&arena, sizeof(float) * NumFilters);
+  Bank->NumCoeff = NumCoeff;
+  Bank->NumFilters = NumFilters;
+  Bank->Stride = (uint32_t)st;
+  RLS_BankInit(InitialCov, Bank);
+  return 1;
+}
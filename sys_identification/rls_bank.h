@@ -0,0 +1,165 @@
+/**
+ * @file  rls_bank.h
+ * @date  18-October-2026
+ * @brief Bank of independent RLS filters updated in one vectorized pass.
+ *
+ *   Many small models with the same number of coefficients (one per
+ *   channel) are identified together. The state is interleaved: element e
+ *   of every filter is contiguous, so one SIMD instruction updates element
+ *   e of 4, 8 or 16 filters at once and no pointer is chased per filter.
+ *   Each filter follows RLS_Compute (forgetting factor included) and its
+ *   covariance stays symmetric, only its upper triangle being stored.
+ *
+ *   Elements of a filter are Stride floats apart; pick the Stride with
+ *   RLS_BANK_STRIDE.
+ *
+ *   The SSE2, AVX2 or AVX-512 pass is selected at runtime with the level
+ *   of matrix_simd.h. When it is scalar, or RLS_BANK_SIMD_DISABLE is
+ *   defined, a portable loop is used. A filter gets the same result
+ *   whichever lane or pass updates it (see matrix_simd.h).
+ *
+ * @author
+ * @author
+ */
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef RLS_BANK_H
+#define RLS_BANK_H
+
+
+#define RLS_BANK_VER_MAJOR                                                  2026
+#define RLS_BANK_VER_MINOR                                                    10
+#define RLS_BANK_VER_PATCH                                                     1
+#define RLS_BANK_BRANCH_MASTER
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+#include "least_squares.h"
+#include "matrix_simd.h"
+
+
+#if !defined(RLS_BANK_SIMD_DISABLE) && defined(MATRIX_SIMD_X86)
+#define RLS_BANK_SIMD_X86
+#endif
+
+/**
+ * @brief Stride for NumFilters filters, see MATRIX_SIMD_BANK_STRIDE.
+ */
+#define RLS_BANK_STRIDE(NumFilters) \
+    MATRIX_SIMD_BANK_STRIDE(NumFilters)
+
+/**
+ * @brief Number of floats of RLS_Bank_t.Cov for the given dimensions.
+ */
+#define RLS_BANK_COV_SIZE(NumCoeff, Stride) \
+    ((NumCoeff) * ((NumCoeff) + 1) / 2 * (Stride))
+
+
+/**
+ * @brief List of RLS bank variables.
+ * @note  Arrays are allocated by the user, or carved from one workspace by
+ *        RLS_BankAttachWorkspace. Element e of filter f is stored
+ *        at [e * Stride + f].
+ */
+typedef struct
+{
+  float *SysCoeffs;     /*!< NumCoeff * Stride, coefficient k is element k */
+  float *Cov;           /*!< RLS_BANK_COV_SIZE(NumCoeff, Stride), upper
+                             triangle of each covariance packed row by row:
+                             (0,0), (0,1), ..., (0,N-1), (1,1), (1,2), ... */
+  float *Gain;          /*!< NumCoeff * Stride, as RLS_t.Gain */
+  float *Error;         /*!< NumFilters, as RLS_t.Error */
+  float *Lambda;        /*!< NumFilters forgetting factors, 0 < Lambda <= 1.
+                             Zero is taken as 1 (infinite memory) */
+  uint32_t NumCoeff;    /*!< Number coefficients of every filter */
+  uint32_t NumFilters;  /*!< Number of filters in the bank */
+  uint32_t Stride;      /*!< Distance between two elements of a filter,
+                             >= NumFilters, 0 to use NumFilters */
+}RLS_Bank_t;
+
+
+/**
+ * @brief  Sets the covariance of every filter to InitialCov * I.
+ * @param  InitialCov : Initial variance of every coefficient.
+ * @param  Bank : List of RLS bank parameters.
+ * @retval void
+ * @note   SysCoeffs and Lambda are not changed.
+ */
+void RLS_BankInit(float InitialCov, RLS_Bank_t *Bank);
+
+
+/**
+ * @brief  Copies a filter into the bank.
+ * @param  Index : Position of the filter in the bank.
+ * @param  Rls : Filter with the bank's NumCoeff. The upper triangle of its
+ *               Cov, its SysCoeffs and Lambda are copied.
+ * @param  Bank : List of RLS bank parameters.
+ * @retval void
+ */
+void RLS_BankLoad(uint32_t Index, RLS_t *Rls, RLS_Bank_t *Bank);
+
+
+/**
+ * @brief  Copies a filter of the bank back to a RLS_t.
+ * @param  Index : Position of the filter in the bank.
+ * @param  Rls : Filter to be updated. Both triangles of Cov are written.
+ * @param  Bank : List of RLS bank parameters.
+ * @retval void
+ */
+void RLS_BankStore(uint32_t Index, RLS_t *Rls, RLS_Bank_t *Bank);
+
+
+/**
+ * @brief  Runs one RLS update on every filter of the bank.
+ * @param  SysInputs : Interleaved inputs, NumCoeff * Stride, input k of
+ *                     filter f at [k * Stride + f].
+ * @param  SysOutputs : 1-D array of size NumFilters, output of each system.
+ * @param  Bank : List of RLS bank parameters.
+ * @retval void
+ * @note   Filter f ends as RLS_Compute would leave it after the same
+ *         sample, up to rounding (the sums are taken in another order).
+ */
+void RLS_BankCompute(float *SysInputs, float *SysOutputs, RLS_Bank_t *Bank);
+
+
+/**
+ * @brief  Returns the bytes of workspace needed by RLS_BankAttachWorkspace.
+ * @param  NumCoeff : Number coefficients of every filter.
+ * @param  NumFilters : Number of filters in the bank.
+ * @retval size_t : A multiple of ARENA_ALIGN.
+ */
+size_t RLS_BankWorkspaceSize(uint32_t NumCoeff, uint32_t NumFilters);
+
+
+/**
+ * @brief  Points every buffer of a RLS_Bank_t into one workspace, clears
+ *         it and calls RLS_BankInit.
+ * @param  Workspace : ARENA_ALIGN aligned memory of
+ *                     RLS_BankWorkspaceSize(NumCoeff, NumFilters) bytes,
+ *                     e.g. carved from an Arena_t (arena.h).
+ * @param  NumCoeff : Number coefficients of every filter.
+ * @param  NumFilters : Number of filters in the bank.
+ * @param  InitialCov : Initial variance of every coefficient.
+ * @param  Bank : Bank to set up. Stride is set to
+ *                RLS_BANK_STRIDE(NumFilters).
+ * @retval int32_t
+ * @note   Lambda is cleared, i.e. infinite memory, until the caller fills
+ *         it. The function returns 1 on success, 0 if Workspace is NULL or
+ *         not aligned.
+ */
+int32_t RLS_BankAttachWorkspace(void *Workspace, uint32_t NumCoeff,
+    uint32_t NumFilters, float InitialCov, RLS_Bank_t *Bank);
+
+#endif /* RLS_BANK_H */
+
+
+
+#ifdef __cplusplus
+}
+#endif